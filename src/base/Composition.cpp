@@ -1616,23 +1616,54 @@ Composition::calculateTempoTimestamps() const
 static int DEBUG_silence_recursive_tempo_printout = 0;
 #endif
 
+namespace
+{
+    // Nanoseconds per tick is (60 * 100000 * 1000000000) / (tempo * cdur),
+    // tempo being in qpm * 100000.  These keep that as a ratio of
+    // integers so that the conversions are exact.
+    const long long tempoNumerator = 60LL * 100000 * nanoSecondsPerSecond;
+
+#ifdef __SIZEOF_INT128__
+    typedef __int128 WideInt;
+#else
+    typedef long double WideInt;
+#endif
+
+    /// Nanoseconds elapsed at tick t, truncated towards zero.
+    long long ticksToNanoseconds(timeT t, long long tempoTimesCdur)
+    {
+        if (t < 0)
+            return -ticksToNanoseconds(-t, tempoTimesCdur);
+        return static_cast<long long>(
+                WideInt(t) * tempoNumerator / tempoTimesCdur);
+    }
+
+    /// The last tick whose ticksToNanoseconds() is not after ns.
+    /**
+     * This is the exact inverse of ticksToNanoseconds(), so that ticks
+     * survive the round trip.
+     */
+    timeT nanosecondsToTicks(long long ns, long long tempoTimesCdur)
+    {
+        if (ns < 0)
+            return -nanosecondsToTicks(-ns, tempoTimesCdur);
+        const WideInt scaled = WideInt(ns + 1) * tempoTimesCdur - 1;
+        return static_cast<timeT>(scaled / tempoNumerator);
+    }
+}
+
 RealTime
 Composition::time2RealTime(timeT t, tempoT tempo)
 {
     static timeT cdur = Note(Note::Crotchet).getDuration();
 
-    double dt = (double(t) * 100000 * 60) / (double(tempo) * cdur);
-
-    int sec = int(dt);
-    int nsec = int((dt - sec) * 1000000000);
-
-    RealTime rt(sec, nsec);
+    RealTime rt = RealTime::fromNanoseconds(
+            ticksToNanoseconds(t, (long long)(tempo) * cdur));
 
 #ifdef DEBUG_TEMPO_STUFF
     if (!DEBUG_silence_recursive_tempo_printout) {
-        RG_DEBUG << "time2RealTime(): t " << t << ", sec " << sec << ", nsec "
-             << nsec << ", tempo " << tempo
-             << ", cdur " << cdur << ", dt " << dt << ", rt " << rt;
+        RG_DEBUG << "time2RealTime(): t " << t << ", tempo " << tempo
+             << ", cdur " << cdur << ", rt " << rt;
         DEBUG_silence_recursive_tempo_printout = 1;
         timeT ct = realTime2Time(rt, tempo);
         timeT et = t - ct;
@@ -1701,17 +1732,13 @@ Composition::realTime2Time(RealTime rt, tempoT tempo)
 {
     static timeT cdur = Note(Note::Crotchet).getDuration();
 
-    double tsec = (double(rt.sec) * cdur) * (tempo / (60.0 * 100000.0));
-    double tnsec = (double(rt.nsec) * cdur) * (tempo / 100000.0);
-
-    double dt = tsec + (tnsec / 60000000000.0);
-    timeT t = (timeT)(dt + (dt < 0 ? -1e-6 : 1e-6));
+    timeT t = nanosecondsToTicks(rt.toNanoseconds(),
+                                 (long long)(tempo) * cdur);
 
 #ifdef DEBUG_TEMPO_STUFF
     if (!DEBUG_silence_recursive_tempo_printout) {
-        RG_DEBUG << "realTime2Time(): rt.sec " << rt.sec << ", rt.nsec "
-             << rt.nsec << ", tempo " << tempo
-             << ", cdur " << cdur << ", tsec " << tsec << ", tnsec " << tnsec << ", dt " << dt << ", t " << t;
+        RG_DEBUG << "realTime2Time(): rt " << rt << ", tempo " << tempo
+             << ", cdur " << cdur << ", t " << t;
         DEBUG_silence_recursive_tempo_printout = 1;
         RealTime crt = time2RealTime(t, tempo);
         RealTime ert = rt - crt;
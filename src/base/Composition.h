@@ -699,6 +699,16 @@ public:
         else         return getElapsedRealTime(t0) - getElapsedRealTime(t1);
     }
 
+    /**
+     * Return the real time taken by t units at the given tempo, or
+     * during a smooth change from tempo to targetTempo that takes
+     * targetTime units.  Not dependent on any Composition, so safe on
+     * any thread.
+     */
+    static RealTime time2RealTime(timeT t, tempoT tempo);
+    static RealTime time2RealTime(timeT time, tempoT tempo,
+                                  timeT targetTime, tempoT targetTempo);
+
     static tempoT
         timeRatioToTempo(RealTime &realTime,
                          timeT beatTime, tempoT rampTo);
@@ -1077,9 +1087,6 @@ protected:
     /// affects m_tempoSegment
     void calculateTempoTimestamps() const;
     mutable bool m_tempoTimestampsNeedCalculating;
-    static RealTime time2RealTime(timeT t, tempoT tempo);
-    static RealTime time2RealTime(timeT time, tempoT tempo,
-                                  timeT targetTime, tempoT targetTempo);
     static timeT realTime2Time(RealTime rt, tempoT tempo);
     static timeT realTime2Time(RealTime rt, tempoT tempo,
                                timeT targetTime, tempoT targetTempo);
@@ -0,0 +1,124 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#include "CompositionSnapshot.h"
+
+#include "base/Segment.h"
+
+
+namespace Rosegarden
+{
+
+
+CompositionSnapshotter::CompositionSnapshotter(const Composition &composition) :
+    m_composition(composition)
+{
+}
+
+CompositionSnapshot::Ptr
+CompositionSnapshotter::takeSnapshot(unsigned version)
+{
+    std::shared_ptr<CompositionSnapshot> snapshot(new CompositionSnapshot);
+
+    snapshot->m_version = version;
+    snapshot->m_startMarker = m_composition.getStartMarker();
+    snapshot->m_endMarker = m_composition.getEndMarker();
+    snapshot->m_copyrightNote = m_composition.getCopyrightNote();
+
+    const Composition::TrackMap &tracks = m_composition.getTracks();
+    for (Composition::TrackMap::const_iterator i = tracks.begin();
+         i != tracks.end();
+         ++i) {
+        const Track *track = i->second;
+        CompositionSnapshot::TrackInfo info;
+        info.id = i->first;
+        info.position = track->getPosition();
+        info.instrument = track->getInstrument();
+        info.label = track->getLabel();
+        info.muted = track->isMuted();
+        info.archived = track->isArchived();
+        snapshot->m_tracks[info.id] = info;
+    }
+
+    const int tempoCount = m_composition.getTempoChangeCount();
+    snapshot->m_tempoChanges.reserve(tempoCount);
+    for (int i = 0; i < tempoCount; ++i)
+        snapshot->m_tempoChanges.push_back(m_composition.getTempoChange(i));
+
+    const int timeSignatureCount = m_composition.getTimeSignatureCount();
+    snapshot->m_timeSignatureChanges.reserve(timeSignatureCount);
+    for (int i = 0; i < timeSignatureCount; ++i)
+        snapshot->m_timeSignatureChanges.push_back(
+                m_composition.getTimeSignatureChange(i));
+
+    // Anything not seen this time has gone from the composition.
+    std::map<int, CachedSegment> cache;
+
+    snapshot->m_segments.reserve(m_composition.getNbSegments());
+
+    for (Composition::const_iterator i = m_composition.begin();
+         i != m_composition.end();
+         ++i) {
+        Segment *segment = *i;
+
+        CompositionSnapshot::SegmentInfo info;
+        info.runtimeId = segment->getRuntimeId();
+        info.track = segment->getTrack();
+        info.label = segment->getLabel();
+        info.startTime = segment->getStartTime();
+        info.endMarkerTime = segment->getEndMarkerTime();
+        info.repeating = segment->isRepeating();
+        info.delay = segment->getDelay();
+        info.transpose = segment->getTranspose();
+
+        std::map<int, CachedSegment>::iterator found =
+                m_cache.find(info.runtimeId);
+
+        CachedSegment cached;
+
+        if (found == m_cache.end()) {
+            cached.refreshStatusId = segment->getNewRefreshStatusId();
+        } else {
+            cached = found->second;
+
+            // The start and end checks are belt and braces; changing
+            // them should set the refresh status anyway.
+            SegmentRefreshStatus &status =
+                    segment->getRefreshStatus(cached.refreshStatusId);
+            if (status.needsRefresh()  ||
+                cached.events->getStartTime() != info.startTime  ||
+                cached.events->getEndMarkerTime() != info.endMarkerTime)
+                cached.events.reset();
+        }
+
+        if (!cached.events) {
+            segment->getRefreshStatus(cached.refreshStatusId).
+                    setNeedsRefresh(false);
+            cached.events = SegmentSnapshot::create(*segment);
+        }
+
+        info.events = cached.events;
+        cache[info.runtimeId] = cached;
+
+        snapshot->m_segments.push_back(info);
+    }
+
+    m_cache.swap(cache);
+
+    return snapshot;
+}
+
+
+}
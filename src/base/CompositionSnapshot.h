@@ -0,0 +1,151 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#ifndef RG_COMPOSITION_SNAPSHOT_H
+#define RG_COMPOSITION_SNAPSHOT_H
+
+#include "base/Composition.h"
+#include "base/SegmentSnapshot.h"
+#include "base/TimeSignature.h"
+#include "base/TimeT.h"
+#include "base/Track.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <rosegardenprivate_export.h>
+
+namespace Rosegarden
+{
+
+
+/// An immutable copy of a Composition for use off the GUI thread.
+/**
+ * Composition and Segment may only be touched on the GUI thread.  Work
+ * that wants to run elsewhere (export, analysis, ...) takes one of these
+ * instead, on the GUI thread, and hands it to the worker.  The worker
+ * can hold on to it for as long as it likes while the user goes on
+ * editing; it will keep seeing the document exactly as it was.
+ *
+ * Get them from a CompositionSnapshotter, which shares the event data
+ * of segments that haven't changed between snapshots, so taking one
+ * after a small edit costs little more than copying the segment list.
+ */
+class ROSEGARDENPRIVATE_EXPORT CompositionSnapshot
+{
+public:
+    typedef std::shared_ptr<const CompositionSnapshot> Ptr;
+
+    struct TrackInfo
+    {
+        TrackId id;
+        int position;
+        InstrumentId instrument;
+        std::string label;
+        bool muted;
+        bool archived;
+    };
+
+    struct SegmentInfo
+    {
+        /// Segment::getRuntimeId().  Stable for the life of the Segment.
+        int runtimeId;
+        TrackId track;
+        std::string label;
+        timeT startTime;
+        timeT endMarkerTime;
+        bool repeating;
+        timeT delay;
+        int transpose;
+        /// The events.  Shared with other snapshots if unchanged.
+        SegmentSnapshot::Ptr events;
+    };
+
+    /// Which edit this snapshot was taken at.
+    /**
+     * The caller's choice; the document uses
+     * CommandHistory::getVersion().  Two snapshots with the same
+     * version taken from the same document are identical.
+     */
+    unsigned getVersion() const  { return m_version; }
+
+    timeT getStartMarker() const  { return m_startMarker; }
+    timeT getEndMarker() const  { return m_endMarker; }
+
+    const std::string &getCopyrightNote() const  { return m_copyrightNote; }
+
+    /// In Composition (i.e. track then start time) order.
+    const std::vector<SegmentInfo> &getSegments() const
+        { return m_segments; }
+    const std::map<TrackId, TrackInfo> &getTracks() const
+        { return m_tracks; }
+
+    const std::vector<std::pair<timeT, tempoT> > &getTempoChanges() const
+        { return m_tempoChanges; }
+    const std::vector<std::pair<timeT, TimeSignature> > &
+            getTimeSignatureChanges() const
+        { return m_timeSignatureChanges; }
+
+private:
+    friend class CompositionSnapshotter;
+    CompositionSnapshot() : m_version(0), m_startMarker(0), m_endMarker(0) { }
+
+    unsigned m_version;
+    timeT m_startMarker;
+    timeT m_endMarker;
+    std::string m_copyrightNote;
+
+    std::vector<SegmentInfo> m_segments;
+    std::map<TrackId, TrackInfo> m_tracks;
+    std::vector<std::pair<timeT, tempoT> > m_tempoChanges;
+    std::vector<std::pair<timeT, TimeSignature> > m_timeSignatureChanges;
+};
+
+
+/// Takes CompositionSnapshots of one Composition.
+/**
+ * Keeps the SegmentSnapshot of each segment from the last snapshot and
+ * uses the Segment's refresh status (see Segment::getRefreshStatus())
+ * to tell whether it can be used again.  Keep one of these for as long
+ * as the Composition to get the most sharing.
+ *
+ * GUI thread only, as it reads the Composition.
+ */
+class ROSEGARDENPRIVATE_EXPORT CompositionSnapshotter
+{
+public:
+    explicit CompositionSnapshotter(const Composition &composition);
+
+    CompositionSnapshot::Ptr takeSnapshot(unsigned version);
+
+private:
+    const Composition &m_composition;
+
+    struct CachedSegment
+    {
+        unsigned refreshStatusId;
+        SegmentSnapshot::Ptr events;
+    };
+    /// By Segment::getRuntimeId(), as addresses can be reused.
+    std::map<int, CachedSegment> m_cache;
+};
+
+
+}
+
+#endif
@@ -19,6 +19,7 @@
 
 // !!!TODO: handle timeslices
 
+#include <algorithm>
 #include <list>
 #include <utility>
 
@@ -40,7 +41,8 @@ CompositionTimeSliceAdapter::CompositionTimeSliceAdapter(Composition *c,
 							 timeT end) :
     m_composition(c),
     m_begin(begin),
-    m_end(end)
+    m_end(end),
+    m_mergeStarted(false)
 {
     if (begin == end) {
 	m_begin = 0;
@@ -59,7 +61,8 @@ CompositionTimeSliceAdapter::CompositionTimeSliceAdapter(Composition *c,
 							 timeT end) :
     m_composition(c),
     m_begin(begin),
-    m_end(end)
+    m_end(end),
+    m_mergeStarted(false)
 {
     if (begin == end) {
 	m_begin = 0;
@@ -80,7 +83,8 @@ CompositionTimeSliceAdapter::CompositionTimeSliceAdapter(Composition *c,
 							 timeT end) :
     m_composition(c),
     m_begin(begin),
-    m_end(end)
+    m_end(end),
+    m_mergeStarted(false)
 {
     if (begin == end) {
 	m_begin = 0;
@@ -98,11 +102,8 @@ CompositionTimeSliceAdapter::CompositionTimeSliceAdapter(Composition *c,
 CompositionTimeSliceAdapter::iterator
 CompositionTimeSliceAdapter::begin() const
 {
-    if (m_beginItr.m_a == nullptr) {
-	m_beginItr = iterator(this);
-	fill(m_beginItr, false);
-    }
-    return m_beginItr;
+    if (!haveMerged(0)) return end();
+    return iterator(this, 0);
 }
 
 CompositionTimeSliceAdapter::iterator
@@ -111,49 +112,96 @@ CompositionTimeSliceAdapter::end() const
     return iterator(this);
 }
 
+CompositionTimeSliceAdapter::iterator
+CompositionTimeSliceAdapter::findTime(timeT t) const
+{
+    // Merge until we have something at or after t, or run out.
+    while (m_merged.empty() || m_merged.back().event->getAbsoluteTime() < t) {
+        if (!mergeNext()) break;
+    }
+
+    std::vector<MergedEvent>::const_iterator i =
+        std::lower_bound(m_merged.begin(), m_merged.end(), t,
+                         [](const MergedEvent &m, timeT time) {
+                             return m.event->getAbsoluteTime() < time;
+                         });
+
+    if (i == m_merged.end()) return end();
+    return iterator(this, i - m_merged.begin());
+}
+
 void
-CompositionTimeSliceAdapter::fill(iterator &i, bool atEnd) const
+CompositionTimeSliceAdapter::startMerge() const
 {
     // The segment iterators should all point to events starting at or
-    // after m_begin (if atEnd false) or at or before m_end (if atEnd true).
+    // after m_begin.
+
+    m_heads.reserve(m_segmentList.size());
+    m_heap.reserve(m_segmentList.size());
 
     for (size_t k = 0; k < m_segmentList.size(); ++k) {
-	Segment::iterator j = m_segmentList[k]->findTime(atEnd ? m_end : m_begin);
-	i.m_segmentItrList.push_back(j);
+        m_heads.push_back(m_segmentList[k]->findTime(m_begin));
+        if (m_segmentList[k]->isBeforeEndMarker(m_heads[k])) {
+            m_heap.push_back(k);
+        }
     }
 
-    // fill m_curEvent & m_curTrack
-    if (!atEnd) ++i;
+    std::make_heap(m_heap.begin(), m_heap.end(),
+                   [this](size_t k1, size_t k2) {
+                       return headGreaterThan(k1, k2);
+                   });
+
+    m_mergeStarted = true;
 }
 
-CompositionTimeSliceAdapter::iterator&
-CompositionTimeSliceAdapter::iterator::operator=(const iterator &i)
+bool
+CompositionTimeSliceAdapter::mergeNext() const
 {
-    if (&i == this) return *this;
-    m_segmentItrList.clear();
+    if (!m_mergeStarted) startMerge();
+
+    if (m_heap.empty()) return false;
+
+    // The top of the heap is an Event* less than or equal to any that
+    // we haven't already merged.
+    const size_t k = m_heap.front();
+    Event *e = *m_heads[k];
 
-    for (segmentitrlist::const_iterator j = i.m_segmentItrList.begin(); 
-	 j != i.m_segmentItrList.end(); ++j) {
-	m_segmentItrList.push_back(Segment::iterator(*j));
+    // Check whether we're past the end time, if there is one
+    if (e->getAbsoluteTime() >= m_end) {
+        m_heap.clear();
+        return false;
     }
 
-    m_a = i.m_a;
-    m_curTrack = i.m_curTrack;
-    m_curEvent = i.m_curEvent;
-    m_needFill = i.m_needFill;
-    return *this;
+    m_merged.push_back(MergedEvent{e, int(m_segmentList[k]->getTrack())});
+
+    const auto greater = [this](size_t k1, size_t k2) {
+        return headGreaterThan(k1, k2);
+    };
+
+    std::pop_heap(m_heap.begin(), m_heap.end(), greater);
+    ++m_heads[k];
+    if (m_segmentList[k]->isBeforeEndMarker(m_heads[k])) {
+        std::push_heap(m_heap.begin(), m_heap.end(), greater);
+    } else {
+        m_heap.pop_back();
+    }
+
+    return true;
 }
 
-CompositionTimeSliceAdapter::iterator::iterator(const iterator &i) :
-    m_a(i.m_a),
-    m_curEvent(i.m_curEvent),
-    m_curTrack(i.m_curTrack),
-    m_needFill(i.m_needFill)
+bool
+CompositionTimeSliceAdapter::haveMerged(size_t index) const
 {
-    for (segmentitrlist::const_iterator j = i.m_segmentItrList.begin(); 
-	 j != i.m_segmentItrList.end(); ++j) {
-	m_segmentItrList.push_back(Segment::iterator(*j));
+    while (m_merged.size() <= index) {
+        if (!mergeNext()) return false;
     }
+    return true;
+}
+
+bool
+CompositionTimeSliceAdapter::headGreaterThan(size_t k1, size_t k2) const
+{
+    return strictLessThan(*m_heads[k2], *m_heads[k1]);
 }
 
 CompositionTimeSliceAdapter::iterator&
@@ -161,39 +209,10 @@ CompositionTimeSliceAdapter::iterator::operator++()
 {
     assert(m_a != nullptr);
 
-    // needFill is only set true for iterators created at end()
-    if (m_needFill) {
-	m_a->fill(*this, true);
-	m_needFill = false;
-    }
-
-    Event *e = nullptr;
-    size_t pos = 0;
-
-    for (size_t i = 0; i < m_a->m_segmentList.size(); ++i) {
-
-	if (!m_a->m_segmentList[i]->isBeforeEndMarker(m_segmentItrList[i])) continue;
-
-        if (!e || strictLessThan(*m_segmentItrList[i], e)) {
-            e = *m_segmentItrList[i];
-	    m_curTrack = m_a->m_segmentList[i]->getTrack();
-            pos = i;
-        }
-    }
-
-    // Check whether we're past the end time, if there is one
-    if (!e || e->getAbsoluteTime() >= m_a->m_end) {
-        m_curEvent = nullptr;
-	m_curTrack = -1;
-        return *this;
-    }
+    if (m_index == End) return *this;
 
-    // e is now an Event* less than or equal to any that the iterator
-    // hasn't already passed over
-    m_curEvent = e;
-
-    // m_segmentItrList[pos] is a segment::iterator that points to e
-    ++m_segmentItrList[pos];
+    ++m_index;
+    if (!m_a->haveMerged(m_index)) m_index = End;
 
     return *this;
 }
@@ -203,38 +222,14 @@ CompositionTimeSliceAdapter::iterator::operator--()
 {
     assert(m_a != nullptr);
 
-    // needFill is only set true for iterators created at end()
-    if (m_needFill) {
-	m_a->fill(*this, true);
-	m_needFill = false;
-    }
-
-    Event *e = nullptr;
-    int pos = -1;
-
-    // Decrement is more subtle than increment.  We have to scan the
-    // iterators available, and decrement the one that points to
-    // m_curEvent.  Then to fill m_curEvent we need to find the next
-    // greatest event back that is not itself m_curEvent.
-
-    for (size_t i = 0; i < m_a->m_segmentList.size(); ++i) {
-
-	if (m_segmentItrList[i] == m_a->m_segmentList[i]->begin()) continue;
-
-	Segment::iterator si(m_segmentItrList[i]);
-	--si;
-
-	if (*si == m_curEvent) {
-	    pos = i;
-	} else if (!e || !strictLessThan(*si, e)) {
-	    e = *si;
-	    m_curTrack = m_a->m_segmentList[i]->getTrack();
-	}
-    }
-
-    if (e) m_curEvent = e;
-    if (pos >= 0) {
-	--m_segmentItrList[pos];
+    if (m_index == End) {
+        // Back from the end: merge everything to find the last event.
+        while (m_a->mergeNext()) { }
+        if (!m_a->m_merged.empty()) m_index = m_a->m_merged.size() - 1;
+    } else if (m_index == 0) {
+        m_index = End;
+    } else {
+        --m_index;
     }
 
     return *this;
@@ -242,7 +237,7 @@ CompositionTimeSliceAdapter::iterator::operator--()
 
 bool
 CompositionTimeSliceAdapter::iterator::operator==(const iterator& other) const {
-    return m_a == other.m_a && m_curEvent == other.m_curEvent;
+    return m_a == other.m_a && m_index == other.m_index;
 }
 
 bool
@@ -252,21 +247,23 @@ CompositionTimeSliceAdapter::iterator::operator!=(const iterator& other) const {
 
 Event *
 CompositionTimeSliceAdapter::iterator::operator*() const {
-    return m_curEvent;
+    if (m_index == End) return nullptr;
+    return m_a->m_merged[m_index].event;
 }
 
 Event &
 CompositionTimeSliceAdapter::iterator::operator->() const {
-    return *m_curEvent;
+    return *m_a->m_merged[m_index].event;
 }
 
 int
 CompositionTimeSliceAdapter::iterator::getTrack() const {
-    return m_curTrack;
+    if (m_index == End) return -1;
+    return m_a->m_merged[m_index].track;
 }
 
 bool
-CompositionTimeSliceAdapter::iterator::strictLessThan(Event *e1, Event *e2) {
+CompositionTimeSliceAdapter::strictLessThan(Event *e1, Event *e2) {
     // We need a complete ordering of events -- we can't cope with two events
     // comparing equal.  i.e. one of e1 < e2 and e2 < e1 must be true.  The
     // ordering can be arbitrary -- we just compare addresses for events the
@@ -22,6 +22,7 @@
 
 #include <list>
 #include <utility>
+#include <vector>
 
 #include "base/Segment.h"
 #include "base/Selection.h"
@@ -88,20 +89,30 @@ public:
     iterator begin() const;
     iterator end() const;
 
+    /**
+     * Return an iterator pointing to the first event at or after the
+     * given time, or end() if there is none.  This only merges as much
+     * of the composition as it needs to reach that time, and reuses
+     * whatever any earlier iteration has already merged.
+     */
+    iterator findTime(timeT t) const;
+
     typedef std::vector<Segment *> segmentlist;
     typedef std::vector<Segment::iterator> segmentitrlist;
 
     Composition *getComposition() { return m_composition; }
 
+    /**
+     * An iterator is just a position in the adapter's merged sequence,
+     * so it is cheap to copy.  The segments must not be changed while
+     * the adapter is in use.
+     */
     class iterator {
         friend class CompositionTimeSliceAdapter;
 
     public:
         explicit iterator(const CompositionTimeSliceAdapter *a = nullptr) :
-            m_a(a), m_curEvent(nullptr), m_curTrack(-1), m_needFill(true) { }
-        iterator(const iterator &);
-        iterator &operator=(const iterator &);
-        ~iterator() {}
+            m_a(a), m_index(End) { }
 
         iterator &operator++();
         iterator &operator--();
@@ -115,13 +126,13 @@ public:
         int getTrack() const;
 
     private:
-        segmentitrlist m_segmentItrList;
-        const CompositionTimeSliceAdapter *m_a;
-        Event*  m_curEvent;
-        int     m_curTrack;
-        bool    m_needFill;
+        iterator(const CompositionTimeSliceAdapter *a, size_t index) :
+            m_a(a), m_index(index) { }
+
+        static const size_t End = size_t(-1);
 
-        static bool strictLessThan(Event *, Event *);
+        const CompositionTimeSliceAdapter *m_a;
+        size_t  m_index;
     };
 
 
@@ -129,13 +140,33 @@ private:
     friend class iterator;
 
     Composition* m_composition;
-    mutable iterator m_beginItr;
     timeT m_begin;
     timeT m_end;
 
     segmentlist m_segmentList;
 
-    void fill(iterator &, bool atEnd) const;
+    // The events of all the segments are merged in time order on
+    // demand.  m_heads holds the next unmerged event of each segment,
+    // and m_heap is a min-heap of the indices of the segments that
+    // still have one.
+
+    struct MergedEvent
+    {
+        Event *event;
+        int track;
+    };
+
+    mutable std::vector<MergedEvent> m_merged;
+    mutable segmentitrlist m_heads;
+    mutable std::vector<size_t> m_heap;
+    mutable bool m_mergeStarted;
+
+    void startMerge() const;
+    bool mergeNext() const;
+    bool haveMerged(size_t index) const;
+
+    bool headGreaterThan(size_t k1, size_t k2) const;
+    static bool strictLessThan(Event *, Event *);
 };
 
 }
@@ -33,7 +33,7 @@ PropertyName Event::EventData::NotationTime("!notationtime");
 PropertyName Event::EventData::NotationDuration("!notationduration");
 
 
-Event::EventData::EventData(const std::string &type, timeT absoluteTime,
+Event::EventData::EventData(const EventTypeName &type, timeT absoluteTime,
                             timeT duration, short subOrdering) :
     m_refCount(1),
     m_type(type),
@@ -45,7 +45,7 @@ Event::EventData::EventData(const std::string &type, timeT absoluteTime,
     // empty
 }
 
-Event::EventData::EventData(const std::string &type, timeT absoluteTime,
+Event::EventData::EventData(const EventTypeName &type, timeT absoluteTime,
                             timeT duration, short subOrdering,
                             const PropertyMap *properties) :
     m_refCount(1),
@@ -216,8 +216,8 @@ Event::toXmlString(timeT expectedTime) const
 
     out << "<event";
 
-    if (getType().length() != 0) {
-        out << " type=\"" << getType() << "\"";
+    if (!m_data->m_type.getName().empty()) {
+        out << " type=\"" << m_data->m_type.getName() << "\"";
     }
 
     // Check for zero note durations and fix it (fixing in setters and
@@ -387,7 +387,7 @@ Event::unsafeChangeTime(timeT offset)
 size_t
 Event::getStorageSize() const
 {
-    size_t s = sizeof(Event) + sizeof(EventData) + m_data->m_type.size();
+    size_t s = sizeof(Event) + sizeof(EventData);
     if (m_data->m_properties) {
         for (PropertyMap::const_iterator i = m_data->m_properties->begin();
              i != m_data->m_properties->end(); ++i) {
@@ -430,7 +430,7 @@ operator<(const Event &a, const Event &b)
 // cppcheck-suppress unusedFunction
 QDebug operator<<(QDebug dbg, const Event &event)
 {
-    dbg << "Event type :" << event.m_data->m_type << "\n";
+    dbg << "Event type :" << event.m_data->m_type.getName() << "\n";
     dbg << "  Absolute Time :" << event.m_data->m_absoluteTime << "\n";
     dbg << "  Duration :" << event.m_data->m_duration << "\n";
     dbg << "  Sub-ordering :" << event.m_data->m_subOrdering << "\n";
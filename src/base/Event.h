@@ -17,6 +17,7 @@
 #ifndef RG_EVENT_H
 #define RG_EVENT_H
 
+#include "EventTypeName.h"
 #include "PropertyMap.h"
 #include "Exception.h"
 #include "TimeT.h"
@@ -102,13 +103,13 @@ public:
 
     // *** Constructors
 
-    Event(const std::string &type,
+    Event(const EventTypeName &type,
           timeT absoluteTime, timeT duration = 0, short subOrdering = 0) :
         m_data(new EventData(type, absoluteTime, duration, subOrdering)),
         m_nonPersistentProperties(nullptr)
     { }
 
-    Event(const std::string &type,
+    Event(const EventTypeName &type,
           timeT absoluteTime, timeT duration, short subOrdering,
           timeT notationAbsoluteTime, timeT notationDuration) :
         m_data(new EventData(type, absoluteTime, duration, subOrdering)),
@@ -217,18 +218,32 @@ public:
     /// Type of the Event (E.g. Note, Accidental, Key, etc...)
     /**
      * See NotationTypes.h and MidiTypes.h for more examples.
+     *
+     * Converts to a std::string as needed.  Comparing it with another
+     * EventTypeName (e.g. Note::EventType) is an int compare.
      */
-    std::string getType() const
+    EventTypeName getType() const
     {
         if (!m_data) {
             // cppcheck-suppress ConfigurationNotChecked
             RG_DEBUG << "Event::getType(): FATAL: m_data == nullptr.  Crash likely.";
-            return "";
+            return EventTypeName();
         }
         return m_data->m_type;
     }
     /// Check Event type.
-    bool isa(const std::string &type) const  { return (m_data->m_type == type); }
+    /**
+     * Pass the EventType constants (e.g. Note::EventType) where you can,
+     * as that is an int compare.
+     */
+    bool isa(const EventTypeName &type) const
+            { return m_data->m_type == type; }
+    /// Check Event type against a string.  Compares the strings.
+    bool isa(const std::string &type) const
+            { return m_data->m_type.getName() == type; }
+    /// Check Event type against a string.  Compares the strings.
+    bool isa(const char *type) const
+            { return m_data->m_type.getName() == type; }
 
     timeT getAbsoluteTime() const  { return m_data->m_absoluteTime; }
     timeT getNotationAbsoluteTime() const  { return m_data->getNotationTime(); }
@@ -384,11 +399,11 @@ protected:
     // Interface for subclasses such as XmlStorableEvent.
 
     Event() :
-        m_data(new EventData("", 0, 0, 0)),
+        m_data(new EventData(EventTypeName(), 0, 0, 0)),
         m_nonPersistentProperties(nullptr)
     { }
 
-    void setType(const std::string &t) { unshare(); m_data->m_type = t; }
+    void setType(const EventTypeName &t) { unshare(); m_data->m_type = t; }
     void setAbsoluteTime(timeT t)      { unshare(); m_data->m_absoluteTime = t; }
     void setDuration(timeT d)          { unshare(); m_data->m_duration = d; }
     void setSubOrdering(short o)       { unshare(); m_data->m_subOrdering = o; }
@@ -401,9 +416,9 @@ private:
     /// Data that are shared between shallow-copied instances
     struct EventData
     {
-        EventData(const std::string &type,
+        EventData(const EventTypeName &type,
                   timeT absoluteTime, timeT duration, short subOrdering);
-        EventData(const std::string &type,
+        EventData(const EventTypeName &type,
                   timeT absoluteTime, timeT duration, short subOrdering,
                   const PropertyMap *properties);
         /// Make a unique copy.  Used for Copy On Write.
@@ -411,7 +426,7 @@ private:
         ~EventData();
         unsigned int m_refCount;
 
-        std::string m_type;
+        EventTypeName m_type;
         timeT m_absoluteTime;
         timeT m_duration;
         short m_subOrdering;
@@ -0,0 +1,133 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#include "base/EventTypeName.h"
+#include "base/Exception.h"
+
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+
+
+namespace Rosegarden
+{
+
+
+namespace
+{
+    // The names are kept in fixed-size chunks that never move, so
+    // getName() can read them without taking the lock while another
+    // thread adds a new type.
+    const unsigned ChunkSize = 256;
+    const unsigned MaxChunks = 4096;
+
+    typedef std::atomic<const std::string *> NameSlot;
+
+    struct Registry
+    {
+        Registry() : count(0)
+        {
+            for (unsigned i = 0; i < MaxChunks; ++i)
+                chunks[i].store(nullptr);
+            // "" is always 0.
+            getId("");
+        }
+
+        // Get the existing ID for a name, or if not found, create
+        // a new ID and add it.
+        unsigned getId(const std::string &name)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            NameToIDMap::const_iterator idIter = ids.find(name);
+            // Found it?  Return it.
+            if (idIter != ids.end())
+                return idIter->second;
+
+            // Not found.  Create a new ID.
+
+            const unsigned newId = count.load();
+            const unsigned chunk = newId / ChunkSize;
+            if (chunk >= MaxChunks)
+                throw Exception("Too many Event types");
+
+            if (!chunks[chunk].load())
+                chunks[chunk].store(new NameSlot[ChunkSize]());
+
+            chunks[chunk].load()[newId % ChunkSize].store(
+                    new std::string(name));
+            ids.insert(NameToIDMap::value_type(name, newId));
+            count.store(newId + 1);
+
+            return newId;
+        }
+
+        const std::string &getName(unsigned id) const
+        {
+            return *chunks[id / ChunkSize].load()[id % ChunkSize].load();
+        }
+
+        std::mutex mutex;
+
+        typedef std::unordered_map<std::string, unsigned> NameToIDMap;
+        NameToIDMap ids;
+
+        std::atomic<NameSlot *> chunks[MaxChunks];
+        std::atomic<unsigned> count;
+    };
+
+    Registry &getRegistry()
+    {
+        // Create on first use to avoid static init order fiasco.
+        // Note: This is a deliberate memory leak since we cannot be sure
+        //       who might access this as we are going down.
+        static Registry *registry = new Registry;
+        return *registry;
+    }
+}
+
+
+EventTypeName::EventTypeName(const char *name) :
+    m_id(getRegistry().getId(name))
+{
+}
+
+EventTypeName::EventTypeName(const std::string &name) :
+    m_id(getRegistry().getId(name))
+{
+}
+
+const std::string &
+EventTypeName::getName() const
+{
+    return getRegistry().getName(m_id);
+}
+
+unsigned
+EventTypeName::getTypeCount()
+{
+    return getRegistry().count.load();
+}
+
+std::ostream &
+operator<<(std::ostream &out, const EventTypeName &t)
+{
+    out << t.getName();
+    return out;
+}
+
+
+}
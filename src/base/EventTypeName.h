@@ -0,0 +1,104 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#ifndef RG_EVENT_TYPE_NAME_H
+#define RG_EVENT_TYPE_NAME_H
+
+#include <iosfwd>
+#include <string>
+
+#include <rosegardenprivate_export.h>
+
+namespace Rosegarden
+{
+
+
+/// Event type ID class optimized for speed.
+/**
+ * Maps an Event type (e.g. "note", Note::EventType) to a small serial ID
+ * for use *only* at runtime, in the same way PropertyName does for
+ * property names.  Every Event holds one of these, so Event::isa() and
+ * comparing types are int compares instead of string compares.  The
+ * type strings are what get stored in the .rg file.
+ *
+ * Unlike PropertyName, this converts implicitly both from and to a
+ * std::string, as Event types have always been plain strings and are
+ * used that way all over.  The one thing to watch for is that
+ * constructing from a string looks the string up in a map, so in a loop
+ * construct once outside it (or use the EventType constants) rather
+ * than passing a string to Event::isa() every time.
+ *
+ * Types can be made on any thread.  The empty type "" always has ID 0,
+ * so a default-constructed (or zero-initialized) EventTypeName is "".
+ *
+ * As with PropertyName, the IDs depend on the order in which types are
+ * first seen, so don't persist them.
+ */
+class ROSEGARDENPRIVATE_EXPORT EventTypeName
+{
+public:
+    EventTypeName() : m_id(0)  { }
+    EventTypeName(const char *name);
+    EventTypeName(const std::string &name);
+
+    bool operator==(const EventTypeName &t) const  { return m_id == t.m_id; }
+    bool operator!=(const EventTypeName &t) const  { return m_id != t.m_id; }
+    /// Orders by ID, which is not alphabetical.
+    bool operator<(const EventTypeName &t) const  { return m_id < t.m_id; }
+
+    /// The type string.  The reference is good for the life of the process.
+    const std::string &getName() const;
+    operator const std::string &() const  { return getName(); }
+
+    unsigned getId() const  { return m_id; }
+
+    /// Number of distinct types seen so far.  IDs are less than this.
+    static unsigned getTypeCount();
+
+private:
+    unsigned m_id;
+};
+
+// Comparisons with plain strings compare the strings, so that existing
+// code like "event->getType() == Note::EventType" keeps working.
+
+inline bool operator==(const EventTypeName &t, const std::string &s)
+        { return t.getName() == s; }
+inline bool operator==(const std::string &s, const EventTypeName &t)
+        { return t.getName() == s; }
+inline bool operator!=(const EventTypeName &t, const std::string &s)
+        { return t.getName() != s; }
+inline bool operator!=(const std::string &s, const EventTypeName &t)
+        { return t.getName() != s; }
+
+inline bool operator==(const EventTypeName &t, const char *s)
+        { return t.getName() == s; }
+inline bool operator==(const char *s, const EventTypeName &t)
+        { return t.getName() == s; }
+inline bool operator!=(const EventTypeName &t, const char *s)
+        { return t.getName() != s; }
+inline bool operator!=(const char *s, const EventTypeName &t)
+        { return t.getName() != s; }
+
+inline std::string operator+(const std::string &s, const EventTypeName &t)
+        { return s + t.getName(); }
+
+ROSEGARDENPRIVATE_EXPORT
+std::ostream &operator<<(std::ostream &out, const EventTypeName &t);
+
+
+}
+
+#endif
@@ -214,43 +214,12 @@ Instrument::isProgramValid() const
         return false;
 
     // Check the bank against the list of valid banks.
-
-    BankList validBanks = md->getBanks(isPercussion());
-
-    bool bankValid = false;
-
-    // For each valid bank
-    for (BankList::const_iterator oBankIter = validBanks.begin();
-         oBankIter != validBanks.end();
-         ++oBankIter)
-    {
-        if (oBankIter->compareKey(m_program.getBank())) {
-            bankValid = true;
-            break;
-        }
-    }
-
-    if (!bankValid)
+    if (!md->hasBank(m_program.getBank()))
         return false;
 
     // Check the program change against the list of program changes
     // for this bank.
-
-    ProgramList programList = md->getPrograms(m_program.getBank());
-
-    bool programChangeValid = false;
-
-    // For each program in this bank
-    for (ProgramList::const_iterator programIter = programList.begin();
-         programIter != programList.end();
-         ++programIter) {
-        if (programIter->partialCompare(m_program)) {
-            programChangeValid = true;
-            break;
-        }
-    }
-
-    if (!programChangeValid)
+    if (!md->findProgram(m_program))
         return false;
 
     return true;
@@ -276,7 +245,7 @@ Instrument::sendsProgramChange() const
         //RG_DEBUG << "  percussion banks:" << midiDevice->getBanks(true).size();
 
         // No percussion banks?  Don't send PC.
-        if (midiDevice->getBanks(true).empty())
+        if (midiDevice->getBankView(true).empty())
             return false;
     }
 
@@ -326,19 +295,19 @@ Instrument::pickFirstProgram(bool percussion)
     if (!md)
         return;
 
-    BankList banks = md->getBanks(percussion);
+    BankView banks = md->getBankView(percussion);
     if (banks.empty())
         return;
 
     // Get the programs for the first bank.
-    ProgramList programs = md->getPrograms(banks.front());
+    ProgramView programs = md->getProgramView(banks.front());
     if (programs.empty())
         return;
 
     // setProgram() will notify the rest of the system of this change.
     m_sendBankSelect = true;
     m_sendProgramChange = true;
-    setProgram(programs.front());
+    setProgram(MidiProgram(programs.front()));
 }
 
 void
@@ -143,6 +143,10 @@ MidiDevice::MidiDevice(const MidiDevice &dev) :
 
     // generate presentation instruments
     generatePresentationList();
+
+    rebuildProgramIndex();
+    rebuildBankIndex();
+    rebuildKeyMappingIndex();
 }
 
 #if 0
@@ -317,6 +321,7 @@ void
 MidiDevice::clearBankList()
 {
     m_bankList.clear();
+    rebuildBankIndex();
     notifyDeviceModified();
 }
 
@@ -324,6 +329,7 @@ void
 MidiDevice::clearProgramList()
 {
     m_programList.clear();
+    rebuildProgramIndex();
     notifyDeviceModified();
 }
 
@@ -331,6 +337,7 @@ void
 MidiDevice::clearKeyMappingList()
 {
     m_keyMappingList.clear();
+    rebuildKeyMappingIndex();
     notifyDeviceModified();
 }
 
@@ -353,12 +360,11 @@ void
 MidiDevice::addProgram(const MidiProgram &prog)
 {
     // Refuse duplicates
-    for (ProgramList::const_iterator it = m_programList.begin();
-         it != m_programList.end(); ++it) {
-        if (it->partialCompare(prog)) return;
-    }
+    if (findProgram(prog))
+        return;
 
     m_programList.push_back(prog);
+    indexProgram(m_programList.size() - 1);
     notifyDeviceModified();
 }
 
@@ -366,6 +372,7 @@ void
 MidiDevice::addBank(const MidiBank &bank)
 {
     m_bankList.push_back(bank);
+    indexBank(m_bankList.size() - 1);
     notifyDeviceModified();
 }
 
@@ -380,14 +387,19 @@ MidiDevice::setMetronome(const MidiMetronome &metronome)
 BankList
 MidiDevice::getBanks(bool percussion) const
 {
-    BankList banks;
+    return getBankView(percussion).toList();
+}
 
-    for (BankList::const_iterator it = m_bankList.begin();
-         it != m_bankList.end(); ++it) {
-        if (it->isPercussion() == percussion) banks.push_back(*it);
-    }
+BankView
+MidiDevice::getBankView(bool percussion) const
+{
+    return BankView(m_bankList, m_banksByPercussion[percussion ? 1 : 0]);
+}
 
-    return banks;
+bool
+MidiDevice::hasBank(const MidiBank &bank) const
+{
+    return m_bankIndex.find(bankKey(bank)) != m_bankIndex.end();
 }
 
 BankList
@@ -395,10 +407,9 @@ MidiDevice::getBanksByMSB(bool percussion, MidiByte msb) const
 {
     BankList banks;
 
-    for (BankList::const_iterator it = m_bankList.begin();
-         it != m_bankList.end(); ++it) {
-        if (it->isPercussion() == percussion && it->getMSB() == msb)
-            banks.push_back(*it);
+    for (const MidiBank &bank : getBankView(percussion)) {
+        if (bank.getMSB() == msb)
+            banks.push_back(bank);
     }
 
     return banks;
@@ -409,10 +420,9 @@ MidiDevice::getBanksByLSB(bool percussion, MidiByte lsb) const
 {
     BankList banks;
 
-    for (BankList::const_iterator it = m_bankList.begin();
-         it != m_bankList.end(); ++it) {
-        if (it->isPercussion() == percussion && it->getLSB() == lsb)
-            banks.push_back(*it);
+    for (const MidiBank &bank : getBankView(percussion)) {
+        if (bank.getLSB() == lsb)
+            banks.push_back(bank);
     }
 
     return banks;
@@ -421,11 +431,11 @@ MidiDevice::getBanksByLSB(bool percussion, MidiByte lsb) const
 const MidiBank *
 MidiDevice::getBankByName(const std::string &name) const
 {
-    for (BankList::const_iterator i = m_bankList.begin();
-         i != m_bankList.end(); ++i) {
-        if (i->getName() == name) return &(*i);
-    }
-    return nullptr;
+    std::unordered_map<std::string, size_t>::const_iterator it =
+            m_bankNameIndex.find(name);
+    if (it == m_bankNameIndex.end())
+        return nullptr;
+    return &m_bankList[it->second];
 }
 
 MidiByteList
@@ -433,10 +443,8 @@ MidiDevice::getDistinctMSBs(bool percussion, int lsb) const
 {
     std::set<MidiByte> msbs;
 
-    for (BankList::const_iterator it = m_bankList.begin();
-         it != m_bankList.end(); ++it) {
-        if (it->isPercussion() == percussion &&
-            (lsb == -1 || it->getLSB() == lsb)) msbs.insert(it->getMSB());
+    for (const MidiBank &bank : getBankView(percussion)) {
+        if (lsb == -1 || bank.getLSB() == lsb) msbs.insert(bank.getMSB());
     }
 
     MidiByteList v;
@@ -452,10 +460,8 @@ MidiDevice::getDistinctLSBs(bool percussion, int msb) const
 {
     std::set<MidiByte> lsbs;
 
-    for (BankList::const_iterator it = m_bankList.begin();
-         it != m_bankList.end(); ++it) {
-        if (it->isPercussion() == percussion &&
-            (msb == -1 || it->getMSB() == msb)) lsbs.insert(it->getLSB());
+    for (const MidiBank &bank : getBankView(percussion)) {
+        if (msb == -1 || bank.getMSB() == msb) lsbs.insert(bank.getLSB());
     }
 
     MidiByteList v;
@@ -469,14 +475,27 @@ MidiDevice::getDistinctLSBs(bool percussion, int msb) const
 ProgramList
 MidiDevice::getPrograms(const MidiBank &bank) const
 {
-    ProgramList programs;
+    return getProgramView(bank).toList();
+}
 
-    for (ProgramList::const_iterator it = m_programList.begin();
-         it != m_programList.end(); ++it) {
-        if (it->getBank().compareKey(bank)) programs.push_back(*it);
-    }
+ProgramView
+MidiDevice::getProgramView(const MidiBank &bank) const
+{
+    std::unordered_map<unsigned, ProgramView::Indices>::const_iterator it =
+            m_programsByBank.find(bankKey(bank));
+    if (it == m_programsByBank.end())
+        return ProgramView();
+    return ProgramView(m_programList, it->second);
+}
 
-    return programs;
+const MidiProgram *
+MidiDevice::findProgram(const MidiProgram &program) const
+{
+    std::unordered_map<unsigned, size_t>::const_iterator it =
+            m_programIndex.find(programKey(program));
+    if (it == m_programIndex.end())
+        return nullptr;
+    return &m_programList[it->second];
 }
 
 ProgramList
@@ -519,33 +538,31 @@ MidiDevice::addKeyMapping(const MidiKeyMapping &mapping)
 {
     //!!! handle dup names
     m_keyMappingList.push_back(mapping);
+    m_keyMappingNameIndex.emplace(mapping.getName(),
+                                  m_keyMappingList.size() - 1);
     notifyDeviceModified();
 }
 
 const MidiKeyMapping *
 MidiDevice::getKeyMappingByName(const std::string &name) const
 {
-    for (KeyMappingList::const_iterator i = m_keyMappingList.begin();
-         i != m_keyMappingList.end(); ++i) {
-        if (i->getName() == name) return &(*i);
-    }
-    return nullptr;
+    std::unordered_map<std::string, size_t>::const_iterator it =
+            m_keyMappingNameIndex.find(name);
+    if (it == m_keyMappingNameIndex.end())
+        return nullptr;
+    return &m_keyMappingList[it->second];
 }
 
 const MidiKeyMapping *
 MidiDevice::getKeyMappingForProgram(const MidiProgram &program) const
 {
-    ProgramList::const_iterator it;
-
-    for (it = m_programList.begin(); it != m_programList.end(); ++it) {
-        if (it->partialCompare(program)) {
-            std::string kmn = it->getKeyMapping();
-            if (kmn == "") return nullptr;
-            return getKeyMappingByName(kmn);
-        }
-    }
+    const MidiProgram *found = findProgram(program);
+    if (!found)
+        return nullptr;
 
-    return nullptr;
+    const std::string &kmn = found->getKeyMapping();
+    if (kmn == "") return nullptr;
+    return getKeyMappingByName(kmn);
 }
 
 std::string
@@ -590,7 +607,6 @@ MidiDevice::toXmlString() const
     //
     BankList::const_iterator it;
     InstrumentList::const_iterator iit;
-    ProgramList::const_iterator pt;
 
     for (it = m_bankList.begin(); it != m_bankList.end(); ++it)
     {
@@ -601,21 +617,16 @@ MidiDevice::toXmlString() const
                    << "lsb=\"" << (int)it->getLSB() << "\">"
                    << std::endl;
 
-        // Not terribly efficient
-        //
-        for (pt = m_programList.begin(); pt != m_programList.end(); ++pt)
+        for (const MidiProgram &program : getProgramView(*it))
         {
-            if (pt->getBank().compareKey(*it))
-            {
-                midiDevice << "            <program "
-                           << "id=\"" << (int)pt->getProgram() << "\" "
-                           << "name=\"" << encode(pt->getName()) << "\" ";
-                if (!pt->getKeyMapping().empty()) {
-                    midiDevice << "keymapping=\""
-                               << encode(pt->getKeyMapping()) << "\" ";
-                }
-                midiDevice << "/>" << std::endl;
+            midiDevice << "            <program "
+                       << "id=\"" << (int)program.getProgram() << "\" "
+                       << "name=\"" << encode(program.getName()) << "\" ";
+            if (!program.getKeyMapping().empty()) {
+                midiDevice << "keymapping=\""
+                           << encode(program.getKeyMapping()) << "\" ";
             }
+            midiDevice << "/>" << std::endl;
         }
 
         midiDevice << "        </bank>" << std::endl << std::endl;
@@ -698,12 +709,8 @@ MidiDevice::addInstrument(Instrument *instrument)
 std::string
 MidiDevice::getProgramName(const MidiProgram &program) const
 {
-    ProgramList::const_iterator it;
-
-    for (it = m_programList.begin(); it != m_programList.end(); ++it)
-    {
-        if (it->partialCompare(program)) return it->getName();
-    }
+    const MidiProgram *found = findProgram(program);
+    if (found) return found->getName();
 
     return std::string("");
 }
@@ -712,6 +719,7 @@ void
 MidiDevice::replaceBankList(const BankList &bankList)
 {
     m_bankList = bankList;
+    rebuildBankIndex();
     notifyDeviceModified();
 }
 
@@ -719,6 +727,7 @@ void
 MidiDevice::replaceProgramList(const ProgramList &programList)
 {
     m_programList = programList;
+    rebuildProgramIndex();
     notifyDeviceModified();
 }
 
@@ -726,6 +735,7 @@ void
 MidiDevice::replaceKeyMappingList(const KeyMappingList &keyMappingList)
 {
     m_keyMappingList = keyMappingList;
+    rebuildKeyMappingIndex();
     notifyDeviceModified();
 }
 
@@ -736,24 +746,11 @@ void
 MidiDevice::mergeBankList(const BankList &bankList)
 {
     BankList::const_iterator it;
-    BankList::iterator oIt;
-    bool clash = false;
 
     for (it = bankList.begin(); it != bankList.end(); ++it)
     {
-        for (oIt = m_bankList.begin(); oIt != m_bankList.end(); ++oIt)
-        {
-            if ((*it).compareKey(*oIt))
-            {
-                clash = true;
-                break;
-            }
-        }
-
-        if (clash == false)
+        if (!hasBank(*it))
             addBank(*it);
-        else
-            clash = false;
     }
     notifyDeviceModified();
 }
@@ -762,25 +759,10 @@ void
 MidiDevice::mergeProgramList(const ProgramList &programList)
 {
     ProgramList::const_iterator it;
-    ProgramList::iterator oIt;
-    bool clash = false;
 
+    // addProgram() refuses duplicates.
     for (it = programList.begin(); it != programList.end(); ++it)
-    {
-        for (oIt = m_programList.begin(); oIt != m_programList.end(); ++oIt)
-        {
-            if (it->partialCompare(*oIt))
-            {
-                clash = true;
-                break;
-            }
-        }
-
-        if (clash == false)
-            addProgram(*it);
-        else
-            clash = false;
-    }
+        addProgram(*it);
     notifyDeviceModified();
 }
 
@@ -788,24 +770,11 @@ void
 MidiDevice::mergeKeyMappingList(const KeyMappingList &keyMappingList)
 {
     KeyMappingList::const_iterator it;
-    KeyMappingList::iterator oIt;
-    bool clash = false;
 
     for (it = keyMappingList.begin(); it != keyMappingList.end(); ++it)
     {
-        for (oIt = m_keyMappingList.begin(); oIt != m_keyMappingList.end(); ++oIt)
-        {
-            if (it->getName() == oIt->getName())
-            {
-                clash = true;
-                break;
-            }
-        }
-
-        if (clash == false)
+        if (!getKeyMappingByName(it->getName()))
             addKeyMapping(*it);
-        else
-            clash = false;
     }
     notifyDeviceModified();
 }
@@ -1147,5 +1116,71 @@ MidiDevice::makeNewKeyMappingName() const
     return name;
 }
 
+unsigned
+MidiDevice::bankKey(const MidiBank &bank)
+{
+    return (bank.isPercussion() ? 0x10000u : 0u) |
+           (unsigned(bank.getMSB()) << 8) |
+           unsigned(bank.getLSB());
+}
+
+unsigned
+MidiDevice::programKey(const MidiProgram &program)
+{
+    return (bankKey(program.getBank()) << 8) | unsigned(program.getProgram());
+}
+
+void
+MidiDevice::indexProgram(size_t index)
+{
+    const MidiProgram &program = m_programList[index];
+
+    // emplace() leaves an existing entry alone, so duplicates resolve to
+    // the first.
+    m_programIndex.emplace(programKey(program), index);
+    m_programsByBank[bankKey(program.getBank())].push_back(index);
+}
+
+void
+MidiDevice::rebuildProgramIndex()
+{
+    m_programIndex.clear();
+    m_programsByBank.clear();
+
+    for (size_t i = 0; i < m_programList.size(); ++i)
+        indexProgram(i);
+}
+
+void
+MidiDevice::indexBank(size_t index)
+{
+    const MidiBank &bank = m_bankList[index];
+
+    m_bankIndex.emplace(bankKey(bank), index);
+    m_bankNameIndex.emplace(bank.getName(), index);
+    m_banksByPercussion[bank.isPercussion() ? 1 : 0].push_back(index);
+}
+
+void
+MidiDevice::rebuildBankIndex()
+{
+    m_bankIndex.clear();
+    m_bankNameIndex.clear();
+    m_banksByPercussion[0].clear();
+    m_banksByPercussion[1].clear();
+
+    for (size_t i = 0; i < m_bankList.size(); ++i)
+        indexBank(i);
+}
+
+void
+MidiDevice::rebuildKeyMappingIndex()
+{
+    m_keyMappingNameIndex.clear();
+
+    for (size_t i = 0; i < m_keyMappingList.size(); ++i)
+        m_keyMappingNameIndex.emplace(m_keyMappingList[i].getName(), i);
+}
+
 
 }
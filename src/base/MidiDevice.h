@@ -17,6 +17,7 @@
 #define RG_MIDIDEVICE_H
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "Device.h"
@@ -34,6 +35,82 @@ typedef std::vector<MidiByte> MidiByteList;
 
 class AllocateChannels;
 
+
+/// Read-only view of some of the elements of a vector, in order.
+/**
+ * Used by MidiDevice to hand out e.g. the programs in one bank without
+ * copying them.  A view is invalidated by any change to the device's
+ * lists, so don't hold on to one.
+ */
+template <typename T>
+class IndexedListView
+{
+public:
+    typedef std::vector<size_t> Indices;
+
+    IndexedListView() : m_list(nullptr), m_indices(&noIndices())  { }
+    IndexedListView(const std::vector<T> &list, const Indices &indices) :
+        m_list(&list),
+        m_indices(&indices)
+    { }
+
+    class const_iterator
+    {
+    public:
+        const_iterator(const std::vector<T> *list,
+                       Indices::const_iterator i) :
+            m_list(list),
+            m_i(i)
+        { }
+
+        const T &operator*() const  { return (*m_list)[*m_i]; }
+        const T *operator->() const  { return &(*m_list)[*m_i]; }
+        const_iterator &operator++()  { ++m_i; return *this; }
+        bool operator==(const const_iterator &rhs) const
+            { return m_i == rhs.m_i; }
+        bool operator!=(const const_iterator &rhs) const
+            { return m_i != rhs.m_i; }
+
+    private:
+        const std::vector<T> *m_list;
+        Indices::const_iterator m_i;
+    };
+
+    const_iterator begin() const
+        { return const_iterator(m_list, m_indices->begin()); }
+    const_iterator end() const
+        { return const_iterator(m_list, m_indices->end()); }
+
+    size_t size() const  { return m_indices->size(); }
+    bool empty() const  { return size() == 0; }
+    const T &operator[](size_t i) const  { return (*m_list)[(*m_indices)[i]]; }
+    const T &front() const  { return operator[](0); }
+
+    /// Copy the elements out.
+    std::vector<T> toList() const
+    {
+        std::vector<T> list;
+        list.reserve(size());
+        for (const T &t : *this)
+            list.push_back(t);
+        return list;
+    }
+
+private:
+    const std::vector<T> *m_list;
+    const Indices *m_indices;
+
+    static const Indices &noIndices()
+    {
+        static const Indices none;
+        return none;
+    }
+};
+
+typedef IndexedListView<MidiBank> BankView;
+typedef IndexedListView<MidiProgram> ProgramView;
+
+
 class MidiDevice : public Device, public Controllable
 {
 public:
@@ -83,6 +160,10 @@ public:
 
     const BankList &getBanks() const { return m_bankList; }
     BankList getBanks(bool percussion) const;
+    /// The percussion or non-percussion banks, without copying.
+    BankView getBankView(bool percussion) const;
+    /// Whether there is a bank with the same percussion flag, MSB and LSB.
+    bool hasBank(const MidiBank &bank) const;
     BankList getBanksByMSB(bool percussion, MidiByte msb) const;
     BankList getBanksByLSB(bool percussion, MidiByte lsb) const;
     const MidiBank *getBankByName(const std::string &) const;
@@ -95,6 +176,13 @@ public:
 
     const ProgramList &getPrograms() const { return m_programList; }
     ProgramList getPrograms(const MidiBank &bank) const;
+    /// The programs in a bank, without copying.
+    ProgramView getProgramView(const MidiBank &bank) const;
+    /// The program with the same bank and program number, if any.
+    /**
+     * See MidiProgram::partialCompare().
+     */
+    const MidiProgram *findProgram(const MidiProgram &program) const;
     /// Used by the UI to display all programs in variations mode.
     ProgramList getPrograms0thVariation(bool percussion, const MidiBank &bank) const;
 
@@ -272,6 +360,33 @@ protected:
     AllocateChannels  *m_allocator;
 
 private:
+    // Indexes into m_programList, m_bankList and m_keyMappingList so
+    // that lookups don't scan lists that may hold thousands of
+    // programs.  The rebuild*() and add*() functions keep these up to
+    // date.  Where a list has duplicates, the index refers to the first,
+    // which is what a linear search would find.
+
+    /// Percussion, MSB and LSB packed into one number.
+    static unsigned bankKey(const MidiBank &bank);
+    /// bankKey() plus the program number.
+    static unsigned programKey(const MidiProgram &program);
+
+    std::unordered_map<unsigned, size_t> m_programIndex;
+    std::unordered_map<unsigned, IndexedListView<MidiProgram>::Indices>
+            m_programsByBank;
+    void indexProgram(size_t index);
+    void rebuildProgramIndex();
+
+    std::unordered_map<unsigned, size_t> m_bankIndex;
+    std::unordered_map<std::string, size_t> m_bankNameIndex;
+    /// Non-percussion banks, then percussion banks.
+    IndexedListView<MidiBank>::Indices m_banksByPercussion[2];
+    void indexBank(size_t index);
+    void rebuildBankIndex();
+
+    std::unordered_map<std::string, size_t> m_keyMappingNameIndex;
+    void rebuildKeyMappingIndex();
+
     // not used
     MidiDevice &operator=(const MidiDevice &);
 };
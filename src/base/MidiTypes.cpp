@@ -26,7 +26,7 @@ namespace Rosegarden
 // PitchBend
 //////////////////////////////////////////////////////////////////////
 
-const std::string PitchBend::EventType = "pitchbend";
+const EventTypeName PitchBend::EventType = "pitchbend";
 
 const PropertyName PitchBend::MSB("msb");
 const PropertyName PitchBend::LSB("lsb");
@@ -45,7 +45,7 @@ Event *PitchBend::makeEvent(timeT absoluteTime, MidiByte msb, MidiByte lsb)
 // Controller
 //////////////////////////////////////////////////////////////////////
 
-const char *Controller::EventType{"controller"};
+const EventTypeName Controller::EventType = "controller";
 
 const PropertyName Controller::NUMBER{"number"};
 const PropertyName Controller::VALUE{"value"};
@@ -65,7 +65,7 @@ Controller::makeEvent(timeT absoluteTime, MidiByte number, MidiByte value)
 // RPN
 //////////////////////////////////////////////////////////////////////
 
-const char *RPN::EventType{"rpn"};
+const EventTypeName RPN::EventType = "rpn";
 
 const PropertyName RPN::NUMBER{"number"};
 const PropertyName RPN::VALUE{"value"};
@@ -89,7 +89,7 @@ RPN::makeEvent(timeT absoluteTime, int number, int value)
 // NRPN
 //////////////////////////////////////////////////////////////////////
 
-const char *NRPN::EventType{"nrpn"};
+const EventTypeName NRPN::EventType = "nrpn";
 
 const PropertyName NRPN::NUMBER{"number"};
 const PropertyName NRPN::VALUE{"value"};
@@ -113,7 +113,7 @@ NRPN::makeEvent(timeT absoluteTime, int number, int value)
 // Key Pressure
 //////////////////////////////////////////////////////////////////////
 
-const std::string KeyPressure::EventType = "keypressure";
+const EventTypeName KeyPressure::EventType = "keypressure";
 
 const PropertyName KeyPressure::PITCH("pitch");
 const PropertyName KeyPressure::PRESSURE("pressure");
@@ -133,7 +133,7 @@ KeyPressure::makeEvent(timeT absoluteTime, MidiByte pitch, MidiByte pressure)
 // Channel Pressure
 //////////////////////////////////////////////////////////////////////
 
-const std::string ChannelPressure::EventType = "channelpressure";
+const EventTypeName ChannelPressure::EventType = "channelpressure";
 
 const PropertyName ChannelPressure::PRESSURE("pressure");
 
@@ -151,7 +151,7 @@ ChannelPressure::makeEvent(timeT absoluteTime, MidiByte pressure)
 // ProgramChange
 //////////////////////////////////////////////////////////////////////
 
-const std::string ProgramChange::EventType = "programchange";
+const EventTypeName ProgramChange::EventType = "programchange";
 
 const PropertyName ProgramChange::PROGRAM("program");
 
@@ -190,7 +190,7 @@ namespace
 
 }
 
-const std::string SystemExclusive::EventType = "systemexclusive";
+const EventTypeName SystemExclusive::EventType = "systemexclusive";
 
 const PropertyName SystemExclusive::DATABLOCK("datablock");
 
@@ -17,6 +17,7 @@
 #define RG_MIDITYPES_H
 
 #include "Exception.h"
+#include "EventTypeName.h"
 #include "MidiProgram.h"  // For MidiByte
 #include "PropertyName.h"
 #include "TimeT.h"
@@ -40,7 +41,7 @@ class Event;
 
 namespace PitchBend
 {
-    extern const std::string EventType;
+    extern const EventTypeName EventType;
     constexpr int EventSubOrdering = -5;
 
     extern const PropertyName MSB;
@@ -54,7 +55,7 @@ namespace PitchBend
 
 namespace Controller
 {
-    extern const char *EventType;
+    extern const EventTypeName EventType;
     constexpr int EventSubOrdering = -5;
 
     extern const PropertyName NUMBER;
@@ -68,7 +69,7 @@ namespace Controller
 // Registered Parameter Numbers
 namespace RPN
 {
-    extern const char *EventType;
+    extern const EventTypeName EventType;
     constexpr int EventSubOrdering = -5;
 
     extern const PropertyName NUMBER;
@@ -82,7 +83,7 @@ namespace RPN
 // Non-Registered Parameter Numbers
 namespace NRPN
 {
-    extern const char *EventType;
+    extern const EventTypeName EventType;
     constexpr int EventSubOrdering = -5;
 
     extern const PropertyName NUMBER;
@@ -96,7 +97,7 @@ namespace NRPN
 
 namespace KeyPressure
 {
-    extern const std::string EventType;
+    extern const EventTypeName EventType;
     constexpr int EventSubOrdering = -5;
 
     extern const PropertyName PITCH;
@@ -110,7 +111,7 @@ namespace KeyPressure
 
 namespace ChannelPressure
 {
-    extern const std::string EventType;
+    extern const EventTypeName EventType;
     constexpr int EventSubOrdering = -5;
 
     extern const PropertyName PRESSURE;
@@ -123,7 +124,7 @@ namespace ChannelPressure
 
 namespace ProgramChange
 {
-    extern const std::string EventType;
+    extern const EventTypeName EventType;
     constexpr int EventSubOrdering = -5;
 
     extern const PropertyName PROGRAM;
@@ -136,7 +137,7 @@ namespace ProgramChange
 
 namespace SystemExclusive
 {
-    extern const std::string EventType;
+    extern const EventTypeName EventType;
     constexpr int EventSubOrdering = -5;
 
     struct BadEncoding : public Exception {
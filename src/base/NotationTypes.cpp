@@ -22,6 +22,7 @@
 #include <limits.h> // for SHRT_MIN
 #include <sstream>
 #include <cstdio> // needed for sprintf()
+#include <algorithm>
 
 //dmm This will make everything excruciatingly slow if defined:
 //#define DEBUG_PITCH
@@ -311,7 +312,7 @@ using namespace Marks;
 // Clef
 //////////////////////////////////////////////////////////////////////
 
-const string Clef::EventType = "clefchange";
+const EventTypeName Clef::EventType = "clefchange";
 const int Clef::EventSubOrdering = -250;
 const PropertyName Clef::ClefPropertyName("clef");
 const PropertyName Clef::OctaveOffsetPropertyName("octaveoffset");
@@ -327,11 +328,50 @@ const string Clef::Bass = "bass";
 const string Clef::Subbass = "subbass";
 const string Clef::TwoBar = "twobar";
 
+namespace
+{
+    struct ClefDetails {
+        const char *name;
+        int pitchOffset;
+        int octave;
+        int axisHeight;
+    };
+
+    // Indexed by Clef::m_type.  The first entry is also used for any
+    // clef name that isn't one of these, so a Clef that has somehow
+    // been left with no name (zero m_type) still matches it.
+    const ClefDetails clefDetails[] = {
+        { "undefined",    -2, -1, 6 },
+        { "treble",        0,  0, 2 },
+        { "french",       -2,  0, 0 },
+        { "soprano",      -5, -1, 0 },
+        { "mezzosoprano", -3, -1, 2 },
+        { "alto",         -1, -1, 4 },
+        { "tenor",         1, -1, 6 },
+        { "baritone",      3, -1, 8 },
+        { "varbaritone",  -4, -2, 4 },
+        { "bass",         -2, -2, 6 },
+        { "subbass",       0, -2, 8 },
+        { "twobar",        0, -1, 4 },
+    };
+
+    const int clefCount = sizeof(clefDetails) / sizeof(clefDetails[0]);
+}
+
 const Clef Clef::DefaultClef = Clef("treble");
 const Clef Clef::UndefinedClef = Clef("undefined");
 
+int Clef::findClef(const std::string &name)
+{
+    for (int i = 1; i < clefCount; ++i) {
+        if (name == clefDetails[i].name) return i;
+    }
+    return 0;
+}
+
 Clef::Clef(const Event &e) :
     m_clef(DefaultClef.m_clef),
+    m_type(DefaultClef.m_type),
     m_octaveOffset(0)
 {
     if (e.getType() != EventType) {
@@ -344,7 +384,9 @@ Clef::Clef(const Event &e) :
     std::string s;
     e.get<String>(ClefPropertyName, s);
 
-    if (s != Treble && s != Soprano && s != French && s != Mezzosoprano && s != Alto && s != Tenor && s != Baritone && s != Bass && s != Varbaritone && s != Subbass && s != TwoBar) {
+    // "undefined" isn't allowed here.
+    const int type = findClef(s);
+    if (type == 0) {
         std::cerr << BadClefName("No such clef as \"" + s + "\"").getMessage()
                   << std::endl;
             return;
@@ -354,19 +396,19 @@ Clef::Clef(const Event &e) :
     (void)e.get<Int>(OctaveOffsetPropertyName, octaveOffset);
 
     m_clef = s;
+    m_type = type;
     m_octaveOffset = octaveOffset;
 }
 
 Clef::Clef(const std::string &s, int octaveOffset)
     // throw (BadClefName)
 {
-    if (s != Treble && s != Soprano && s != French && s != Mezzosoprano
-        && s != Alto && s != Tenor && s != Baritone && s != Bass
-        && s != Varbaritone && s != Subbass && s != TwoBar && s != "undefined") {
-
+    const int type = findClef(s);
+    if (type == 0  &&  s != "undefined") {
         throw BadClefName("No such clef as \"" + s + "\"");
     }
     m_clef = s;
+    m_type = type;
     m_octaveOffset = octaveOffset;
 }
 
@@ -374,6 +416,7 @@ Clef &Clef::operator=(const Clef &c)
 {
     if (this != &c) {
         m_clef = c.m_clef;
+        m_type = c.m_type;
         m_octaveOffset = c.m_octaveOffset;
     }
     return *this;
@@ -385,9 +428,7 @@ bool Clef::isValid(const Event &e)
 
     std::string s;
     e.get<String>(ClefPropertyName, s);
-    if (s != Treble && s != Soprano && s != French && s != Mezzosoprano && s != Alto && s != Tenor && s != Baritone && s != Bass && s != Varbaritone && s != Subbass && s != TwoBar) return false;
-
-    return true;
+    return findClef(s) != 0;
 }
 
 int Clef::getTranspose() const
@@ -398,41 +439,17 @@ int Clef::getTranspose() const
 
 int Clef::getOctave() const
 {
-    if (m_clef == Treble || m_clef == French) return 0 + m_octaveOffset;
-    else if (m_clef == Bass || m_clef == Varbaritone || m_clef == Subbass) return -2 + m_octaveOffset;
-    else return -1 + m_octaveOffset;
+    return clefDetails[m_type].octave + m_octaveOffset;
 }
 
 int Clef::getPitchOffset() const
 {
-    if (m_clef == Treble) return 0;
-    else if (m_clef == French) return -2;
-    else if (m_clef == Soprano) return -5;
-    else if (m_clef == Mezzosoprano) return -3;
-    else if (m_clef == Alto) return -1;
-    else if (m_clef == Tenor) return 1;
-    else if (m_clef == Baritone) return 3;
-    else if (m_clef == Varbaritone) return -4;
-    else if (m_clef == Bass) return -2;
-    else if (m_clef == Subbass) return 0;
-    else if (m_clef == TwoBar) return 0;
-    else return -2;
+    return clefDetails[m_type].pitchOffset;
 }
 
 int Clef::getAxisHeight() const
 {
-    if (m_clef == Treble) return 2;
-    else if (m_clef == French) return 0;
-    else if (m_clef == Soprano) return 0;
-    else if (m_clef == Mezzosoprano) return 2;
-    else if (m_clef == Alto) return 4;
-    else if (m_clef == Tenor) return 6;
-    else if (m_clef == Baritone) return 8;
-    else if (m_clef == Varbaritone) return 4;
-    else if (m_clef == Bass) return 6;
-    else if (m_clef == Subbass) return 8;
-    else if (m_clef == TwoBar) return 4;
-    else return 6;
+    return clefDetails[m_type].axisHeight;
 }
 
 Clef::ClefList
@@ -466,9 +483,52 @@ Event *Clef::getAsEvent(timeT absoluteTime) const
 // Key
 //////////////////////////////////////////////////////////////////////
 
-Key::KeyDetailMap Key::m_keyDetailMap = Key::KeyDetailMap();
-
-const string Key::EventType = "keychange";
+const Key::KeyDetails Key::m_keyDetails[KeyCount + 1] = {
+    // name        sharps minor  count equivalence rg2name           tonic
+    { "A major",   true,  false, 3, "F# minor", "A  maj / F# min",  9 },
+    { "A minor",   false, true,  0, "C major",  "C  maj / A  min",  9 },
+    { "A# minor",  true,  true,  7, "C# major", "C# maj / A# min", 10 },
+    { "Ab major",  false, false, 4, "F minor",  "Ab maj / F  min",  8 },
+    { "Ab minor",  false, true,  7, "Cb major", "Cb maj / Ab min",  8 },
+    { "B major",   true,  false, 5, "G# minor", "B  maj / G# min", 11 },
+    { "B minor",   true,  true,  2, "D major",  "D  maj / B  min", 11 },
+    { "Bb major",  false, false, 2, "G minor",  "Bb maj / G  min", 10 },
+    { "Bb minor",  false, true,  5, "Db major", "Db maj / Bb min", 10 },
+    { "C major",   true,  false, 0, "A minor",  "C  maj / A  min",  0 },
+    { "C minor",   false, true,  3, "Eb major", "Eb maj / C  min",  0 },
+    { "C# major",  true,  false, 7, "A# minor", "C# maj / A# min",  1 },
+    { "C# minor",  true,  true,  4, "E major",  "E  maj / C# min",  1 },
+    { "Cb major",  false, false, 7, "Ab minor", "Cb maj / Ab min", 11 },
+    { "D major",   true,  false, 2, "B minor",  "D  maj / B  min",  2 },
+    { "D minor",   false, true,  1, "F major",  "F  maj / D  min",  2 },
+    { "D# minor",  true,  true,  6, "F# major", "F# maj / D# min",  3 },
+    { "Db major",  false, false, 5, "Bb minor", "Db maj / Bb min",  1 },
+    { "E major",   true,  false, 4, "C# minor", "E  maj / C# min",  4 },
+    { "E minor",   true,  true,  1, "G major",  "G  maj / E  min",  4 },
+    { "Eb major",  false, false, 3, "C minor",  "Eb maj / C  min",  3 },
+    { "Eb minor",  false, true,  6, "Gb major", "Gb maj / Eb min",  3 },
+    { "F major",   false, false, 1, "D minor",  "F  maj / D  min",  5 },
+    { "F minor",   false, true,  4, "Ab major", "Ab maj / F  min",  5 },
+    { "F# major",  true,  false, 6, "D# minor", "F# maj / D# min",  6 },
+    { "F# minor",  true,  true,  3, "A major",  "A  maj / F# min",  6 },
+    { "G major",   true,  false, 1, "E minor",  "G  maj / E  min",  7 },
+    { "G minor",   false, true,  2, "Bb major", "Bb maj / G  min",  7 },
+    { "G# minor",  true,  true,  5, "B major",  "B  maj / G# min",  8 },
+    { "Gb major",  false, false, 6, "Eb minor", "Gb maj / Eb min",  6 },
+    { "undefined", true,  false, 0, "A minor",  "C  maj / A  min",  0 }, //=default
+    // UnknownKey
+    { "",          false, false, 0, "",         "",                 0 }
+};
+
+namespace
+{
+    // Heights-on-staff of the accidentals in the signatures, in the
+    // order they are added.  A key with n accidentals has the first n.
+    const int sharpHeights[] = { 8, 5, 9, 6, 3, 7, 4 };
+    const int flatHeights[]  = { 4, 7, 3, 6, 2, 5, 1 };
+}
+
+const EventTypeName Key::EventType = "keychange";
 const int Key::EventSubOrdering = -200;
 const PropertyName Key::KeyPropertyName("key");
 const Key Key::DefaultKey = Key("C major");
@@ -476,17 +536,15 @@ const Key Key::UndefinedKey = Key("undefined");
 
 Key::Key() :
     m_name(DefaultKey.m_name),
-    m_accidentalHeights(nullptr)
+    m_id(DefaultKey.m_id)
 {
-    checkMap();
 }
 
 
 Key::Key(const Event &e) :
     m_name(""),
-    m_accidentalHeights(nullptr)
+    m_id(UnknownKey)
 {
-    checkMap();
     if (e.getType() != EventType) {
         std::cerr << Event::BadType
             ("Key model event", EventType, e.getType()).getMessage()
@@ -494,7 +552,8 @@ Key::Key(const Event &e) :
         return;
     }
     e.get<String>(KeyPropertyName, m_name);
-    if (m_keyDetailMap.find(m_name) == m_keyDetailMap.end()) {
+    m_id = findKey(m_name);
+    if (m_id == UnknownKey) {
         std::cerr << BadKeyName
             ("No such key as \"" + m_name + "\"").getMessage() << std::endl;
         return;
@@ -503,26 +562,24 @@ Key::Key(const Event &e) :
 
 Key::Key(const std::string &name) :
     m_name(name),
-    m_accidentalHeights(nullptr)
+    m_id(findKey(name))
 {
-    if (name == "undefined") return;
-    checkMap();
-    if (m_keyDetailMap.find(m_name) == m_keyDetailMap.end()) {
+    if (m_id == UnknownKey) {
         throw BadKeyName("No such key as \"" + m_name + "\"");
     }
 }
 
 Key::Key(int accidentalCount, bool isSharp, bool isMinor) :
-    m_accidentalHeights(nullptr)
-{
-    checkMap();
-    for (KeyDetailMap::const_iterator i = m_keyDetailMap.begin();
-         i != m_keyDetailMap.end(); ++i) {
-        if ((*i).second.m_sharpCount == accidentalCount &&
-            (*i).second.m_minor == isMinor &&
-            ((*i).second.m_sharps == isSharp ||
-             (*i).second.m_sharpCount == 0)) {
-            m_name = (*i).first;
+    m_id(UnknownKey)
+{
+    for (int i = 0; i < KeyCount; ++i) {
+        const KeyDetails &details = m_keyDetails[i];
+        if (details.m_sharpCount == accidentalCount &&
+            details.m_minor == isMinor &&
+            (details.m_sharps == isSharp ||
+             details.m_sharpCount == 0)) {
+            m_name = details.m_name;
+            m_id = i;
             return;
         }
     }
@@ -540,14 +597,14 @@ Key::Key(int accidentalCount, bool isSharp, bool isMinor) :
 // with that signature.  Not quite sure what's the best solution.
 
 Key::Key(int tonicPitch, bool isMinor) :
-    m_accidentalHeights(nullptr)
-{
-        checkMap();
-    for (KeyDetailMap::const_iterator i = m_keyDetailMap.begin();
-         i != m_keyDetailMap.end(); ++i) {
-        if ((*i).second.m_tonicPitch == tonicPitch &&
-            (*i).second.m_minor == isMinor) {
-            m_name = (*i).first;
+    m_id(UnknownKey)
+{
+    for (int i = 0; i < KeyCount; ++i) {
+        const KeyDetails &details = m_keyDetails[i];
+        if (details.m_tonicPitch == tonicPitch &&
+            details.m_minor == isMinor) {
+            m_name = details.m_name;
+            m_id = i;
             return;
         }
     }
@@ -560,18 +617,17 @@ Key::Key(int tonicPitch, bool isMinor) :
     throw BadKeySpec(os.str());
 }
 
-
-Key::Key(const Key &kc) :
-    m_name(kc.m_name),
-    m_accidentalHeights(nullptr)
+int Key::findKey(const std::string &name)
 {
-}
+    // m_keyDetails is sorted by name.
+    const KeyDetails *end = m_keyDetails + KeyCount;
+    const KeyDetails *i = std::lower_bound(
+            m_keyDetails, end, name,
+            [](const KeyDetails &details, const std::string &n)
+                    { return n.compare(details.m_name) > 0; });
 
-Key& Key::operator=(const Key &kc)
-{
-    m_name = kc.m_name;
-    m_accidentalHeights = nullptr;
-    return *this;
+    if (i == end  ||  name != i->m_name) return UnknownKey;
+    return int(i - m_keyDetails);
 }
 
 bool Key::isValid(const Event &e)
@@ -579,18 +635,15 @@ bool Key::isValid(const Event &e)
     if (e.getType() != EventType) return false;
     std::string name;
     e.get<String>(KeyPropertyName, name);
-    if (m_keyDetailMap.find(name) == m_keyDetailMap.end()) return false;
-    return true;
+    return findKey(name) != UnknownKey;
 }
 
 Key::KeyList Key::getKeys(bool minor)
 {
-    checkMap();
     KeyList result;
-    for (KeyDetailMap::const_iterator i = m_keyDetailMap.begin();
-         i != m_keyDetailMap.end(); ++i) {
-        if ((*i).second.m_minor == minor) {
-            result.push_back(Key((*i).first));
+    for (int i = 0; i < KeyCount; ++i) {
+        if (m_keyDetails[i].m_minor == minor) {
+            result.push_back(Key(std::string(m_keyDetails[i].m_name)));
         }
     }
     return result;
@@ -606,12 +659,14 @@ Key Key::transpose(int pitchDelta, int heightDelta)
 
 Accidental Key::getAccidentalAtHeight(int height, const Clef &clef) const
 {
-    checkAccidentalHeights();
-    height = canonicalHeight(height);
-    for (size_t i = 0; i < m_accidentalHeights->size(); ++i) {
-        if (height ==static_cast<int>(canonicalHeight((*m_accidentalHeights)[i] +
-                                                     clef.getPitchOffset()))) {
-            return isSharp() ? Sharp : Flat;
+    const KeyDetails &details = m_keyDetails[m_id];
+    const int *heights = details.m_sharps ? sharpHeights : flatHeights;
+
+    // Same as comparing with each accidental height plus the offset.
+    height = canonicalHeight(height - clef.getPitchOffset());
+    for (int i = 0; i < details.m_sharpCount; ++i) {
+        if (height == static_cast<int>(canonicalHeight(heights[i]))) {
+            return details.m_sharps ? Sharp : Flat;
         }
     }
     return NoAccidental;
@@ -648,8 +703,9 @@ Accidental Key::getAccidentalForStep(int steps) const
 vector<int> Key::getAccidentalHeights(const Clef &clef) const
 {
     // staff positions of accidentals
-    checkAccidentalHeights();
-    vector<int> v(*m_accidentalHeights);
+    const KeyDetails &details = m_keyDetails[m_id];
+    const int *heights = details.m_sharps ? sharpHeights : flatHeights;
+    vector<int> v(heights, heights + details.m_sharpCount);
     int offset = clef.getPitchOffset();
 
     for (unsigned int i = 0; i < v.size(); ++i) {
@@ -660,22 +716,6 @@ vector<int> Key::getAccidentalHeights(const Clef &clef) const
     return v;
 }
 
-void Key::checkAccidentalHeights() const
-{
-    if (m_accidentalHeights) return;
-    m_accidentalHeights = new vector<int>;
-
-    bool sharp = isSharp();
-    int accidentals = getAccidentalCount();
-    int height = sharp ? 8 : 4;
-
-    for (int i = 0; i < accidentals; ++i) {
-        m_accidentalHeights->push_back(height);
-        if (sharp) { height -= 3; if (height < 3) height += 7; }
-        else       { height += 3; if (height > 7) height -= 7; }
-    }
-}
-
 int Key::convertFrom(int p, const Key &previousKey,
                      const Accidental &explicitAccidental) const
 {
@@ -701,79 +741,11 @@ Event *Key::getAsEvent(timeT absoluteTime) const
 }
 
 
-void Key::checkMap() {
-    if (!m_keyDetailMap.empty()) return;
-
-    m_keyDetailMap["A major" ] = KeyDetails(true,  false, 3, "F# minor", "A  maj / F# min", 9);
-    m_keyDetailMap["F# minor"] = KeyDetails(true,  true,  3, "A major",  "A  maj / F# min", 6);
-    m_keyDetailMap["Ab major"] = KeyDetails(false, false, 4, "F minor",  "Ab maj / F  min", 8);
-    m_keyDetailMap["F minor" ] = KeyDetails(false, true,  4, "Ab major", "Ab maj / F  min", 5);
-    m_keyDetailMap["B major" ] = KeyDetails(true,  false, 5, "G# minor", "B  maj / G# min", 11);
-    m_keyDetailMap["G# minor"] = KeyDetails(true,  true,  5, "B major",  "B  maj / G# min", 8);
-    m_keyDetailMap["Bb major"] = KeyDetails(false, false, 2, "G minor",  "Bb maj / G  min", 10);
-    m_keyDetailMap["G minor" ] = KeyDetails(false, true,  2, "Bb major", "Bb maj / G  min", 7);
-    m_keyDetailMap["C major" ] = KeyDetails(true,  false, 0, "A minor",  "C  maj / A  min", 0);
-    m_keyDetailMap["A minor" ] = KeyDetails(false, true,  0, "C major",  "C  maj / A  min", 9);
-    m_keyDetailMap["Cb major"] = KeyDetails(false, false, 7, "Ab minor", "Cb maj / Ab min", 11);
-    m_keyDetailMap["Ab minor"] = KeyDetails(false, true,  7, "Cb major", "Cb maj / Ab min", 8);
-    m_keyDetailMap["C# major"] = KeyDetails(true,  false, 7, "A# minor", "C# maj / A# min", 1);
-    m_keyDetailMap["A# minor"] = KeyDetails(true,  true,  7, "C# major", "C# maj / A# min", 10);
-    m_keyDetailMap["D major" ] = KeyDetails(true,  false, 2, "B minor",  "D  maj / B  min", 2);
-    m_keyDetailMap["B minor" ] = KeyDetails(true,  true,  2, "D major",  "D  maj / B  min", 11);
-    m_keyDetailMap["Db major"] = KeyDetails(false, false, 5, "Bb minor", "Db maj / Bb min", 1);
-    m_keyDetailMap["Bb minor"] = KeyDetails(false, true,  5, "Db major", "Db maj / Bb min", 10);
-    m_keyDetailMap["E major" ] = KeyDetails(true,  false, 4, "C# minor", "E  maj / C# min", 4);
-    m_keyDetailMap["C# minor"] = KeyDetails(true,  true,  4, "E major",  "E  maj / C# min", 1);
-    m_keyDetailMap["Eb major"] = KeyDetails(false, false, 3, "C minor",  "Eb maj / C  min", 3);
-    m_keyDetailMap["C minor" ] = KeyDetails(false, true,  3, "Eb major", "Eb maj / C  min", 0);
-    m_keyDetailMap["F major" ] = KeyDetails(false, false, 1, "D minor",  "F  maj / D  min", 5);
-    m_keyDetailMap["D minor" ] = KeyDetails(false, true,  1, "F major",  "F  maj / D  min", 2);
-    m_keyDetailMap["F# major"] = KeyDetails(true,  false, 6, "D# minor", "F# maj / D# min", 6);
-    m_keyDetailMap["D# minor"] = KeyDetails(true,  true,  6, "F# major", "F# maj / D# min", 3);
-    m_keyDetailMap["G major" ] = KeyDetails(true,  false, 1, "E minor",  "G  maj / E  min", 7);
-    m_keyDetailMap["E minor" ] = KeyDetails(true,  true,  1, "G major",  "G  maj / E  min", 4);
-    m_keyDetailMap["Gb major"] = KeyDetails(false, false, 6, "Eb minor", "Gb maj / Eb min", 6);
-    m_keyDetailMap["Eb minor"] = KeyDetails(false, true,  6, "Gb major", "Gb maj / Eb min", 3);
-    m_keyDetailMap["undefined"] = KeyDetails(true,  false, 0, "A minor",  "C  maj / A  min", 0); //=default
-}
-
-
-Key::KeyDetails::KeyDetails()
-    : m_sharps(false), m_minor(false), m_sharpCount(0),
-      m_equivalence(""), m_rg2name(""), m_tonicPitch(0)
-{
-}
-
-Key::KeyDetails::KeyDetails(bool sharps, bool minor, int sharpCount,
-                            const std::string& equivalence,
-                            const std::string& rg2name,
-                            int tonicPitch)
-    : m_sharps(sharps), m_minor(minor), m_sharpCount(sharpCount),
-      m_equivalence(equivalence), m_rg2name(rg2name), m_tonicPitch(tonicPitch)
-{
-}
-
-Key::KeyDetails::KeyDetails(const Key::KeyDetails &d)
-    : m_sharps(d.m_sharps), m_minor(d.m_minor),
-      m_sharpCount(d.m_sharpCount), m_equivalence(d.m_equivalence),
-      m_rg2name(d.m_rg2name), m_tonicPitch(d.m_tonicPitch)
-{
-}
-
-Key::KeyDetails& Key::KeyDetails::operator=(const Key::KeyDetails &d)
-{
-    if (&d == this) return *this;
-    m_sharps = d.m_sharps; m_minor = d.m_minor;
-    m_sharpCount = d.m_sharpCount; m_equivalence = d.m_equivalence;
-    m_rg2name = d.m_rg2name; m_tonicPitch = d.m_tonicPitch;
-    return *this;
-}
-
 //////////////////////////////////////////////////////////////////////
 // Indication
 //////////////////////////////////////////////////////////////////////
 
-const std::string Indication::EventType = "indication";
+const EventTypeName Indication::EventType = "indication";
 const int Indication::EventSubOrdering = -50;
 const PropertyName Indication::IndicationTypePropertyName("indicationtype");
 //const PropertyName Indication::IndicationDurationPropertyName = "indicationduration";
@@ -862,7 +834,7 @@ Indication::isValid(const std::string &s)
 // Text
 //////////////////////////////////////////////////////////////////////
 
-const std::string Text::EventType = "text";
+const EventTypeName Text::EventType = "text";
 const int Text::EventSubOrdering = -70;
 const PropertyName Text::TextPropertyName("text");
 const PropertyName Text::TextTypePropertyName("type");
@@ -1377,6 +1349,123 @@ resolveSpecifiedAccidental(int pitch,
 
 }
 
+namespace
+{
+    // The accidentals the spelling tables cover, by index.  Anything
+    // else (the quarter-tones) takes the long way round.
+    const int spelledAccidentalCount = 6;
+
+    const Accidental &getSpelledAccidental(int index)
+    {
+        switch (index) {
+        case 1: return Sharp;
+        case 2: return Flat;
+        case 3: return Natural;
+        case 4: return DoubleSharp;
+        case 5: return DoubleFlat;
+        default: return NoAccidental;
+        }
+    }
+
+    /// -1 if not one of the above.
+    int getSpelledAccidentalIndex(const Accidental &accidental)
+    {
+        for (int i = 0; i < spelledAccidentalCount; ++i) {
+            if (accidental == getSpelledAccidental(i)) return i;
+        }
+        return -1;
+    }
+
+    const int strategyCount = UseKey + 1;
+
+    /// resolveSpecifiedAccidental() results for one pitch in one key.
+    struct Spelling
+    {
+        signed char height;
+        signed char octaveDelta;
+        /// Index of the accidental to display, -1 for none.
+        signed char accidental;
+    };
+
+    /**
+     * What rawPitchToDisplayPitch() works out for each pitch in the
+     * octave, in each key, with each accidental and strategy.  Worked
+     * out once, by calling resolveNoAccidental() and
+     * resolveSpecifiedAccidental() for every combination, so the
+     * results are the same as calling them every time.
+     */
+    class SpellingTable
+    {
+    public:
+        /// keys[id] is the Key whose m_id is id.
+        explicit SpellingTable(const std::vector<Key> &keys) :
+            m_keyCount(int(keys.size())),
+            m_resolved(m_keyCount * 12 * spelledAccidentalCount *
+                       strategyCount),
+            m_spellings(m_keyCount * 12 * spelledAccidentalCount)
+        {
+            for (int key = 0; key < m_keyCount; ++key) {
+                for (int pitch = 0; pitch < 12; ++pitch) {
+                    for (int acc = 0; acc < spelledAccidentalCount; ++acc) {
+                        build(keys[key], key, pitch, acc);
+                    }
+                }
+            }
+        }
+
+        /// Index of the accidental to spell the pitch with.
+        int getResolved(int key, int pitch, int accidental,
+                        NoAccidentalStrategy strategy) const
+        {
+            return m_resolved[
+                    ((key * 12 + pitch) * spelledAccidentalCount +
+                     accidental) * strategyCount + strategy];
+        }
+
+        const Spelling &getSpelling(int key, int pitch,
+                                    int resolved) const
+        {
+            return m_spellings[
+                    (key * 12 + pitch) * spelledAccidentalCount + resolved];
+        }
+
+    private:
+        void build(const Key &key, int keyId, int pitch, int acc)
+        {
+            Accidental input = getSpelledAccidental(acc);
+
+            for (int strategy = 0; strategy < strategyCount; ++strategy) {
+                int resolved = acc;
+                if (input == NoAccidental  ||
+                    !Pitch(pitch, input).validAccidental()) {
+                    resolved = getSpelledAccidentalIndex(resolveNoAccidental(
+                            pitch, key, NoAccidentalStrategy(strategy)));
+                }
+                m_resolved[((keyId * 12 + pitch) * spelledAccidentalCount +
+                            acc) * strategyCount + strategy] =
+                        static_cast<signed char>(resolved);
+            }
+
+            int height = 0;
+            int octave = 0;
+            Accidental output = "";
+            resolveSpecifiedAccidental(pitch, Clef(), key,
+                                       height, octave, input, output);
+
+            Spelling &spelling = m_spellings[
+                    (keyId * 12 + pitch) * spelledAccidentalCount + acc];
+            spelling.height = static_cast<signed char>(height);
+            spelling.octaveDelta = static_cast<signed char>(octave);
+            spelling.accidental = static_cast<signed char>(
+                    output == "" ? -1 : getSpelledAccidentalIndex(output));
+        }
+
+        int m_keyCount;
+        std::vector<signed char> m_resolved;
+        std::vector<Spelling> m_spellings;
+    };
+}
+
 bool
 Pitch::validAccidental() const
 {
@@ -1500,18 +1589,50 @@ Pitch::rawPitchToDisplayPitch(int rawpitch,
     Accidental userAccidental = accidental;
     accidental = "";
 
-    if (userAccidental == NoAccidental || !Pitch(rawpitch, userAccidental).validAccidental())
-    {
-        userAccidental = resolveNoAccidental(pitch, key, noAccidentalStrategy);
-        //std::cout << "Chose accidental " << userAccidental << " for pitch " << pitch <<
-        //      " in key " << key.getName() << std::endl;
-    }
-    //else
-    //{
-    //  std::cout << "Accidental was specified, as " << userAccidental << std::endl;
-    //}
+    // 4. and 5. for the usual accidentals come from the tables, built
+    // for every key the first time through.
+    static const SpellingTable spellings([]() {
+        std::vector<Key> keys(Key::KeyCount + 1);
+        for (int id = 0; id < Key::KeyCount; ++id) {
+            keys[id] = Key(std::string(Key::m_keyDetails[id].m_name));
+        }
+        keys[Key::UnknownKey].m_name = "";
+        keys[Key::UnknownKey].m_id = Key::UnknownKey;
+        return keys;
+    }());
 
-    resolveSpecifiedAccidental(pitch, clef, key, height, octave, userAccidental, accidental);
+    const int input = getSpelledAccidentalIndex(userAccidental);
+
+    if (pitch >= 0  &&  input >= 0  &&
+        noAccidentalStrategy >= 0  &&  noAccidentalStrategy < strategyCount) {
+
+        const int resolved = spellings.getResolved(
+                key.m_id, pitch, input, noAccidentalStrategy);
+        const Spelling &spelling =
+                spellings.getSpelling(key.m_id, pitch, resolved);
+
+        height = spelling.height;
+        octave += spelling.octaveDelta;
+        if (spelling.accidental >= 0)
+            accidental = getSpelledAccidental(spelling.accidental);
+        if (resolved != input)
+            userAccidental = getSpelledAccidental(resolved);
+
+    } else {
+
+        if (userAccidental == NoAccidental || !Pitch(rawpitch, userAccidental).validAccidental())
+        {
+            userAccidental = resolveNoAccidental(pitch, key, noAccidentalStrategy);
+            //std::cout << "Chose accidental " << userAccidental << " for pitch " << pitch <<
+            //      " in key " << key.getName() << std::endl;
+        }
+        //else
+        //{
+        //  std::cout << "Accidental was specified, as " << userAccidental << std::endl;
+        //}
+
+        resolveSpecifiedAccidental(pitch, clef, key, height, octave, userAccidental, accidental);
+    }
 
     // Failsafe...  If this ever executes, there's trouble to fix...
 // WIP - DMM - munged up to explore #937389, which is temporarily deferred,
@@ -1921,8 +2042,8 @@ Pitch Pitch::transpose(const Key &key, int pitchDelta, int heightDelta) const
 // Note
 //////////////////////////////////////////////////////////////////////
 
-const string Note::EventType = "note";
-const string Note::EventRestType = "rest";
+const EventTypeName Note::EventType = "note";
+const EventTypeName Note::EventRestType = "rest";
 const int Note::EventRestSubOrdering = 10;
 
 const timeT Note::m_shortestTime = basePPQ / 16;
@@ -2189,7 +2310,7 @@ AccidentalTable::newClef(const Clef &clef)
 // Symbol
 //////////////////////////////////////////////////////////////////////
 
-const std::string Symbol::EventType = "symbol";
+const EventTypeName Symbol::EventType = "symbol";
 const int Symbol::EventSubOrdering = -70;
 const PropertyName Symbol::SymbolTypePropertyName("type");
 
@@ -266,7 +266,7 @@ namespace Marks
 class ROSEGARDENPRIVATE_EXPORT Clef
 {
 public:
-    static const std::string EventType;
+    static const EventTypeName EventType;
     static const int EventSubOrdering;
     static const PropertyName ClefPropertyName;
     static const PropertyName OctaveOffsetPropertyName;
@@ -289,7 +289,11 @@ public:
     /**
      * Construct the default clef (treble).
      */
-    Clef() : m_clef(DefaultClef.m_clef), m_octaveOffset(0) { }
+    Clef() :
+        m_clef(DefaultClef.m_clef),
+        m_type(DefaultClef.m_type),
+        m_octaveOffset(0)
+    { }
 
     /**
      * Construct a Clef from the clef data in the given event.  If the
@@ -306,8 +310,11 @@ public:
      */
     Clef(const std::string &s, int octaveOffset = 0);
 
-    Clef(const Clef &c) : m_clef(c.m_clef), m_octaveOffset(c.m_octaveOffset) {
-    }
+    Clef(const Clef &c) :
+        m_clef(c.m_clef),
+        m_type(c.m_type),
+        m_octaveOffset(c.m_octaveOffset)
+    { }
 
     Clef &operator=(const Clef &c);
 
@@ -375,7 +382,12 @@ public:
 
 private:
     std::string m_clef;
+    /// Index into the clef table in NotationTypes.cpp.
+    int m_type;
     int m_octaveOffset;
+
+    /// Index of the named clef, or 0 (the "undefined" clef) if none.
+    static int findClef(const std::string &name);
 };
 
 /**
@@ -389,7 +401,7 @@ private:
 class ROSEGARDENPRIVATE_EXPORT Key
 {
 public:
-    static const std::string EventType;
+    static const EventTypeName EventType;
     static const int EventSubOrdering;
     static const PropertyName KeyPropertyName;
     static const Key DefaultKey;
@@ -428,14 +440,6 @@ public:
      */
     Key(int tonicPitch, bool isMinor);
 
-    Key(const Key &kc);
-
-    ~Key() {
-        delete m_accidentalHeights;
-    }
-
-    Key &operator=(const Key &kc);
-
     bool operator==(const Key &k) const {
         return k.m_name == m_name;
     }
@@ -460,7 +464,7 @@ public:
      * same signature.
      */
     bool isMinor() const {
-        return m_keyDetailMap[m_name].m_minor;
+        return m_keyDetails[m_id].m_minor;
     }
 
     /**
@@ -468,7 +472,7 @@ public:
      * sharps, false if flats.
      */
     bool isSharp() const {
-        return m_keyDetailMap[m_name].m_sharps;
+        return m_keyDetails[m_id].m_sharps;
     }
 
     /**
@@ -478,14 +482,14 @@ public:
      * e.g. 0 for the C in C major.
      */
     int getTonicPitch() const {
-        return m_keyDetailMap[m_name].m_tonicPitch;
+        return m_keyDetails[m_id].m_tonicPitch;
     }
 
     /**
      * Return the number of sharps or flats in the key's signature.
      */
     int getAccidentalCount() const {
-        return m_keyDetailMap[m_name].m_sharpCount;
+        return m_keyDetails[m_id].m_sharpCount;
     }
 
     /**
@@ -494,7 +498,7 @@ public:
      * returns A minor.
      */
     Key getEquivalent() const {
-        return Key(m_keyDetailMap[m_name].m_equivalence);
+        return Key(std::string(m_keyDetails[m_id].m_equivalence));
     }
 
     /**
@@ -509,7 +513,7 @@ public:
      * Return the name of the key, in the form used by X11 RG2.1.
      */
     std::string getRosegarden2Name() const {
-        return m_keyDetailMap[m_name].m_rg2name;
+        return m_keyDetails[m_id].m_rg2name;
     }
 
     /**
@@ -581,33 +585,38 @@ public:
 
 private:
     std::string m_name;
-    mutable std::vector<int> *m_accidentalHeights;
+    /// Index into m_keyDetails.
+    int m_id;
 
     struct KeyDetails {
+        const char *m_name;
         bool   m_sharps;
         bool   m_minor;
         int    m_sharpCount;
-        std::string m_equivalence;
-        std::string m_rg2name;
+        const char *m_equivalence;
+        const char *m_rg2name;
         int    m_tonicPitch;
+    };
 
-        KeyDetails(); // ctor needed in order to live in a map
-
-        KeyDetails(bool sharps, bool minor, int sharpCount,
-                   const std::string& equivalence, const std::string& rg2name,
-                   int tonicPitch);
-
-        KeyDetails(const KeyDetails &d);
-
-        KeyDetails &operator=(const KeyDetails &d);
+    enum {
+        /// Number of keys, including "undefined".
+        KeyCount = 31,
+        /// A name that isn't a key gets the details at this index.
+        UnknownKey = KeyCount
     };
 
+    /**
+     * The keys in order of name, then the details for UnknownKey.  All
+     * the per-key lookups index this by m_id instead of searching for
+     * the name.
+     */
+    static const KeyDetails m_keyDetails[KeyCount + 1];
 
-    typedef std::map<std::string, KeyDetails> KeyDetailMap;
-    static KeyDetailMap m_keyDetailMap;
-    static void checkMap();
-    void checkAccidentalHeights() const;
+    /// Index of the named key, or UnknownKey.
+    static int findKey(const std::string &name);
 
+    // Pitch indexes its spelling tables by m_id.
+    friend class Pitch;
 };
 
 
@@ -621,7 +630,7 @@ private:
 class Indication
 {
 public:
-    static const std::string EventType;
+    static const EventTypeName EventType;
     static const int EventSubOrdering;
     static const PropertyName IndicationTypePropertyName;
     typedef Exception BadIndicationName;
@@ -689,7 +698,7 @@ private:
 class Text
 {
 public:
-    static const std::string EventType;
+    static const EventTypeName EventType;
     static const int EventSubOrdering;
     static const PropertyName TextPropertyName;
     static const PropertyName TextTypePropertyName;
@@ -1046,8 +1055,8 @@ private:
 class ROSEGARDENPRIVATE_EXPORT Note
 {
 public:
-    static const std::string EventType;
-    static const std::string EventRestType;
+    static const EventTypeName EventType;
+    static const EventTypeName EventRestType;
     static const int EventRestSubOrdering;
 
     typedef int Type; // not an enum, too much arithmetic at stake
@@ -1213,7 +1222,7 @@ private:
 class ROSEGARDENPRIVATE_EXPORT Symbol
 {
 public:
-    static const std::string EventType;
+    static const EventTypeName EventType;
     static const int EventSubOrdering;
     static const PropertyName SymbolTypePropertyName;
 
@@ -64,6 +64,22 @@ struct ROSEGARDENPRIVATE_EXPORT RealTime
     double toSeconds() const
         { return sec + static_cast<double>(nsec) / nanoSecondsPerSecond; }
 
+    /// The whole time as a single count of nanoseconds.
+    long long toNanoseconds() const
+        { return static_cast<long long>(sec) * nanoSecondsPerSecond + nsec; }
+    /// Inverse of toNanoseconds().
+    /**
+     * Division truncates towards zero, so sec and nsec always come out
+     * with matching signs and no further normalisation is needed.
+     */
+    static RealTime fromNanoseconds(long long ns)
+    {
+        RealTime rt;
+        rt.sec = static_cast<int>(ns / nanoSecondsPerSecond);
+        rt.nsec = static_cast<int>(ns % nanoSecondsPerSecond);
+        return rt;
+    }
+
     static RealTime fromMilliseconds(int msec);
     // ??? Profiler is the only user.  Maybe move it there?
     static RealTime fromTimeval(const struct timeval &);
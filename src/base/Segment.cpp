@@ -76,7 +76,6 @@ Segment::Segment(SegmentType segmentType, timeT startTime) :
     m_highestPlayable(127),
     m_lowestPlayable(0),
     m_percussionPitch(-1),
-    m_clefKeyList(nullptr),
     m_notifyResizeLocked(false),
     m_memoStart(0),
     m_memoEndMarkerTime(nullptr),
@@ -126,7 +125,6 @@ Segment::Segment(const Segment &segment):
     m_highestPlayable(127),
     m_lowestPlayable(0),
     m_percussionPitch(-1),
-    m_clefKeyList(nullptr),
     m_notifyResizeLocked(false),  // To copy a segment while notifications
     m_memoStart(0),               // are locked doesn't sound as a good
     m_memoEndMarkerTime(nullptr),       // idea.
@@ -182,12 +180,6 @@ Segment::~Segment()
 
     if (m_composition) m_composition->detachSegment(this);
 
-    if (m_clefKeyList) {
-        // don't delete contents of m_clefKeyList: the pointers
-        // are just aliases for events in the main segment
-        delete m_clefKeyList;
-    }
-
     // delete content
     for (iterator it = begin(); it != end(); ++it) delete (*it);
 
@@ -410,7 +402,7 @@ Segment::setStartTime(timeT t)
 	5. updateRefreshStatuses
         6. Thru notifyRemove, notify observers eventRemoved
         7. Thru notifyRemove, remove clefs and keys from
-	   m_clefKeyList
+	   m_clefChanges and m_keyChanges
 
       1 is done explicitly here.  3, 4, 5, and 7 are done en masse
       below.  6 is accomplished via allEventsChanged.  2 is no longer
@@ -430,7 +422,8 @@ Segment::setStartTime(timeT t)
     }
     base::clear();
 
-    if (m_clefKeyList) { m_clefKeyList->clear(); }
+    m_clefChanges.clear();
+    m_keyChanges.clear();
 
     m_endTime = previousEndTime + dt;
     if (m_endMarkerTime) *m_endMarkerTime += dt;
@@ -447,7 +440,8 @@ Segment::setStartTime(timeT t)
 	4. Set the TMP property if applicable
 	5. updateRefreshStatuses
         6. Thru notifyAdd, notified observers eventAdded
-        7. Thru notifyAdd, added clefs and keys to m_clefKeyList
+        7. Thru notifyAdd, added clefs and keys to m_clefChanges
+           and m_keyChanges
 
         1 and 7 are done explicitly here.  2, 3 & 5 are done en masse.
         6 is accomplished via allEventsChanged.  4 works because we
@@ -627,6 +621,61 @@ Segment::insert(Event *e)
 }
 
 
+void
+Segment::insertEvents(std::vector<Event *> &events)
+{
+    if (events.empty())
+        return;
+
+    std::stable_sort(events.begin(), events.end(), Event::EventCmp());
+
+    const bool wasEmpty = (begin() == end());
+
+    timeT minStart = events.front()->getAbsoluteTime();
+    timeT maxEnd = minStart;
+    // As for insert(), zero-duration events still need refreshing.
+    timeT refreshEnd = minStart + 1;
+    for (Event *e : events) {
+        Q_CHECK_PTR(e);
+        const timeT t0 = e->getAbsoluteTime();
+        const timeT t1 = t0 + e->getGreaterDuration();
+        if (t0 < minStart) minStart = t0;
+        if (t1 > maxEnd) maxEnd = t1;
+        refreshEnd = std::max(refreshEnd, (t1 == t0 ? t1 + 1 : t1));
+    }
+
+    // Same outcome as insert() would have had one event at a time.
+    if (minStart < m_startTime  ||  (wasEmpty  &&  minStart > m_startTime)) {
+        if (m_composition) m_composition->setSegmentStartTime(this, minStart);
+        else m_startTime = minStart;
+        notifyStartChanged(m_startTime);
+    }
+
+    if (maxEnd > m_endTime  ||  wasEmpty) {
+        timeT oldTime = m_endTime;
+        m_endTime = maxEnd;
+        notifyEndMarkerChange(m_endTime < oldTime);
+    }
+
+    const bool tmp = isTmp();
+    const Event::EventCmp less;
+
+    for (Event *e : events) {
+        if (tmp) e->set<Bool>(BaseProperties::TMP, true, false);
+
+        // If the event sorts after the current last one, it goes at the
+        // end, so the hint saves the search.
+        if (begin() == end()  ||  !less(e, *rbegin()))
+            EventContainer::insert(end(), e);
+        else
+            EventContainer::insert(e);
+
+        notifyAdd(e);
+    }
+
+    updateRefreshStatuses(minStart, refreshEnd);
+}
+
 void
 Segment::updateEndTime()
 {
@@ -1234,11 +1283,55 @@ Segment::setLabel(const std::string &label)
     notifyAppearanceChange();
 }
 
-bool
-Segment::ClefKeyCmp::operator()(const Event *e1, const Event *e2) const
-{
-    if (e1->getType() == e2->getType()) return Event::EventCmp()(e1, e2);
-    else return e1->getType() < e2->getType();
+namespace
+{
+    // Helpers for Segment's ClefChangeList and KeyChangeList.
+
+    /// First change after time.
+    template <class ChangeList>
+    typename ChangeList::const_iterator
+    changeAfter(const ChangeList &changes, timeT time)
+    {
+        typedef typename ChangeList::value_type Change;
+        return std::upper_bound(
+                changes.begin(), changes.end(), time,
+                [](timeT t, const Change &change)
+                        { return t < change.time; });
+    }
+
+    /// Add a change after any others at the same time and sub-ordering,
+    /// which is where the Segment's multiset puts the Event.
+    template <class ChangeList>
+    void insertChange(ChangeList &changes,
+                      const typename ChangeList::value_type &change)
+    {
+        typedef typename ChangeList::value_type Change;
+        changes.insert(std::upper_bound(
+                changes.begin(), changes.end(), change,
+                [](const Change &c1, const Change &c2) {
+                    if (c1.time != c2.time) return c1.time < c2.time;
+                    return c1.subOrdering < c2.subOrdering;
+                }), change);
+    }
+
+    template <class ChangeList>
+    void removeChange(ChangeList &changes, const Event *e)
+    {
+        // Can't be before the first change at e's time.
+        typename ChangeList::iterator i = std::lower_bound(
+                changes.begin(), changes.end(), e->getAbsoluteTime(),
+                [](const typename ChangeList::value_type &change, timeT t)
+                        { return change.time < t; });
+
+        // There may be duplicates at the same time (bug#1485643), so
+        // match the Event itself.
+        for (; i != changes.end(); ++i) {
+            if (i->event == e) {
+                changes.erase(i);
+                return;
+            }
+        }
+    }
 }
 
 Clef
@@ -1251,50 +1344,25 @@ Segment::getClefAtTime(timeT time) const
 Clef
 Segment::getClefAtTime(timeT time, timeT &ctime) const
 {
-    if (!m_clefKeyList) return Clef();
-
-    Event ec(Clef::EventType, time);
-    ClefKeyList::iterator i = m_clefKeyList->lower_bound(&ec);
-
-    while (i == m_clefKeyList->end() ||
-           (*i)->getAbsoluteTime() > time ||
-           (*i)->getType() != Clef::EventType) {
-
-        if (i == m_clefKeyList->begin()) {
-            ctime = getStartTime();
-            return Clef();
-        }
-        --i;
-    }
-
-    try {
-        ctime = (*i)->getAbsoluteTime();
-        return Clef(**i);
-    } catch (const Exception &e) {
-        RG_WARNING << "getClefAtTime(" << time << "): bogus clef in ClefKeyList: event dump follows:";
-        RG_WARNING << (*i);
+    ClefChangeList::const_iterator i = changeAfter(m_clefChanges, time);
 
+    if (i == m_clefChanges.begin()) {
+        ctime = getStartTime();
         return Clef();
     }
+
+    --i;
+    ctime = i->time;
+    return i->value;
 }
 
 bool
 Segment::getNextClefTime(timeT time, timeT &nextTime) const
 {
-    if (!m_clefKeyList) return false;
-
-    Event ec(Clef::EventType, time);
-    ClefKeyList::iterator i = m_clefKeyList->lower_bound(&ec);
-
-    while (i != m_clefKeyList->end() &&
-           ((*i)->getAbsoluteTime() <= time ||
-            (*i)->getType() != Clef::EventType)) {
-        ++i;
-    }
+    ClefChangeList::const_iterator i = changeAfter(m_clefChanges, time);
+    if (i == m_clefChanges.end()) return false;
 
-    if (i == m_clefKeyList->end()) return false;
-
-    nextTime = (*i)->getAbsoluteTime();
+    nextTime = i->time;
 
     return true;
 }
@@ -1309,52 +1377,25 @@ Segment::getKeyAtTime(timeT time) const
 Key
 Segment::getKeyAtTime(timeT time, timeT &ktime) const
 {
-    if (!m_clefKeyList) return Key();
-
-    Event ek(Key::EventType, time);
-    ClefKeyList::iterator i = m_clefKeyList->lower_bound(&ek);
-
-    while (i == m_clefKeyList->end() ||
-           (*i)->getAbsoluteTime() > time ||
-           (*i)->getType() != Key::EventType) {
-
-        if (i == m_clefKeyList->begin()) {
-            ktime = getStartTime();
-            return Key();
-        }
-        --i;
-    }
-
-    try {
-        ktime = (*i)->getAbsoluteTime();
-        Key k(**i);
-        //RG_DEBUG << "getKeyAtTime(): Requested time " << time << ", found key " << k.getName() << " at time " << ktime;
-        return k;
-    } catch (const Exception &e) {
-        RG_WARNING << "getKeyAtTime(" << time << "): bogus key in ClefKeyList: event dump follows:";
-        RG_WARNING << (*i);
+    KeyChangeList::const_iterator i = changeAfter(m_keyChanges, time);
 
+    if (i == m_keyChanges.begin()) {
+        ktime = getStartTime();
         return Key();
     }
+
+    --i;
+    ktime = i->time;
+    return i->value;
 }
 
 bool
 Segment::getNextKeyTime(timeT time, timeT &nextTime) const
 {
-    if (!m_clefKeyList) return false;
+    KeyChangeList::const_iterator i = changeAfter(m_keyChanges, time);
+    if (i == m_keyChanges.end()) return false;
 
-    Event ec(Key::EventType, time);
-    ClefKeyList::iterator i = m_clefKeyList->lower_bound(&ec);
-
-    while (i != m_clefKeyList->end() &&
-           ((*i)->getAbsoluteTime() <= time ||
-            (*i)->getType() != Key::EventType)) {
-        ++i;
-    }
-
-    if (i == m_clefKeyList->end()) return false;
-
-    nextTime = (*i)->getAbsoluteTime();
+    nextTime = i->time;
 
     return true;
 }
@@ -1465,12 +1506,41 @@ void
 Segment::
 checkInsertAsClefKey(Event *e) const
 {
-    if (e->isa(Clef::EventType) || e->isa(Key::EventType)) {
-        if (!m_clefKeyList) m_clefKeyList = new ClefKeyList;
-        m_clefKeyList->insert(e);
+    // Decode now so the lookups don't have to.  A bogus clef or key
+    // reads as the default from its time on, as it always has.
+
+    if (e->isa(Clef::EventType)) {
+        Clef clef;
+        try {
+            clef = Clef(*e);
+        } catch (const Exception &) {
+            RG_WARNING << "checkInsertAsClefKey(): bogus clef at" << e->getAbsoluteTime() << ": event dump follows:";
+            RG_WARNING << e;
+        }
+        insertChange(m_clefChanges, ClefKeyChange<Clef>(e, clef));
+
+    } else if (e->isa(Key::EventType)) {
+        Key key;
+        try {
+            key = Key(*e);
+        } catch (const Exception &) {
+            RG_WARNING << "checkInsertAsClefKey(): bogus key at" << e->getAbsoluteTime() << ": event dump follows:";
+            RG_WARNING << e;
+        }
+        insertChange(m_keyChanges, ClefKeyChange<Key>(e, key));
     }
 }
 
+void
+Segment::
+checkRemoveAsClefKey(Event *e) const
+{
+    if (e->isa(Clef::EventType))
+        removeChange(m_clefChanges, e);
+    else if (e->isa(Key::EventType))
+        removeChange(m_keyChanges, e);
+}
+
 void
 Segment::notifyAdd(Event *e) const
 {
@@ -1489,16 +1559,7 @@ Segment::notifyRemove(Event *e) const
 {
     Profiler profiler("Segment::notifyRemove()");
 
-    if (m_clefKeyList && (e->isa(Clef::EventType) || e->isa(Key::EventType))) {
-        ClefKeyList::iterator i;
-        for (i = m_clefKeyList->find(e); i != m_clefKeyList->end(); ++i) {
-            // fix for bug#1485643 (crash erasing a duplicated key signature)
-            if ((*i) == e) {
-                m_clefKeyList->erase(i);
-                break;
-            }
-        }
-    }
+    checkRemoveAsClefKey(e);
 
     for (ObserverList::const_iterator i = m_observers.begin();
          i != m_observers.end(); ++i) {
@@ -21,6 +21,7 @@
 #include <list>
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "Track.h"
 #include "Event.h"
@@ -401,6 +402,16 @@ public:
     /// Insert a single Event
     iterator insert(Event *e);
 
+    /// Insert several Events at once.
+    /**
+     * Equivalent to calling insert() for each Event, but the start and
+     * end times and the refresh statuses are only updated once for the
+     * whole batch.  The events are inserted in time order so that
+     * appending to the end of the segment is cheap.  The vector is
+     * sorted in place.
+     */
+    void insertEvents(std::vector<Event *> &events);
+
     /// Erase a single Event
     void erase(iterator pos);
 
@@ -931,6 +942,7 @@ public:
 
 private:
     void checkInsertAsClefKey(Event *e) const;
+    void checkRemoveAsClefKey(Event *e) const;
 
     /**
      * (Re)compute the internally remembered verse count.
@@ -976,11 +988,32 @@ private:
 
     RefreshStatusArray<SegmentRefreshStatus> m_refreshStatusArray;
 
-    struct ClefKeyCmp {
-        bool operator()(const Event *e1, const Event *e2) const;
+    /// A clef or key change, decoded once when its Event is added.
+    template <class T>
+    struct ClefKeyChange
+    {
+        ClefKeyChange(const Event *e, const T &v) :
+            time(e->getAbsoluteTime()),
+            subOrdering(e->getSubOrdering()),
+            event(e),
+            value(v)
+        { }
+
+        timeT time;
+        short subOrdering;
+        /// Alias for the Event in the Segment.  Only used for removal.
+        const Event *event;
+        T value;
     };
-    typedef std::multiset<Event*, ClefKeyCmp> ClefKeyList;
-    mutable ClefKeyList *m_clefKeyList;
+
+    // In the same order as the Events (time, then sub-ordering), so
+    // finding the change in effect at a time, or the next one after
+    // it, is a binary search with no Event to construct or parse.
+    // Maintained by notifyAdd() and notifyRemove().
+    typedef std::vector<ClefKeyChange<Clef> > ClefChangeList;
+    typedef std::vector<ClefKeyChange<Key> > KeyChangeList;
+    mutable ClefChangeList m_clefChanges;
+    mutable KeyChangeList m_keyChanges;
 
     /// Marking for AddLayerCommand.  See setMarking().
     QString m_marking;
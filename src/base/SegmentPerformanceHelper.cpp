@@ -267,6 +267,14 @@ SegmentPerformanceHelper::getSoundingDuration(Segment::iterator i)
 	if (getGraceNoteTimeAndDuration(true, i, discard, d)) return d;
     }
 
+    return getTiedDuration(i);
+}
+
+timeT
+SegmentPerformanceHelper::getTiedDuration(Segment::iterator i)
+{
+    timeT d = 0;
+
     if ((*i)->has(TIED_BACKWARD)) {
 
 	// Formerly we just returned d in this case, but now we check
@@ -305,6 +313,43 @@ SegmentPerformanceHelper::getSoundingDuration(Segment::iterator i)
 }
 
 
+void
+SegmentPerformanceHelper::getSoundingTime(Segment::iterator i,
+                                          timeT &t, timeT &d)
+{
+    // getGraceNoteTimeAndDuration() gives the same answer however
+    // often it is asked, and only changes anything when it succeeds,
+    // so one call does for both getSoundingAbsoluteTime() and
+    // getSoundingDuration().
+
+    if ((*i)->has(IS_GRACE_NOTE)) {
+        if (getGraceNoteTimeAndDuration(false, i, t, d)) return;
+    }
+
+    if ((*i)->has(MAY_HAVE_GRACE_NOTES)) {
+        if (getGraceNoteTimeAndDuration(true, i, t, d)) return;
+    }
+
+    t = (*i)->getAbsoluteTime();
+    d = getTiedDuration(i);
+}
+
+void
+SegmentPerformanceHelper::getSoundingTimes(SoundingTimeMap &times)
+{
+    times.clear();
+    times.reserve(segment().size());
+
+    for (Segment::iterator i = begin();
+         isBeforeEndMarker(i); ++i) {
+        if ((*i)->isa(Note::EventRestType)) continue;
+
+        SoundingTime &sounding = times[*i];
+        getSoundingTime(i, sounding.absoluteTime, sounding.duration);
+    }
+}
+
+
 // In theory we can do better with tuplets, because real time has
 // finer precision than timeT time.  With a timeT resolution of 960ppq
 // however the difference is probably not audible
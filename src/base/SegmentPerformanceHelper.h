@@ -20,6 +20,8 @@
 #include "base/Segment.h"
 #include "Composition.h" // for RealTime
 
+#include <unordered_map>
+
 namespace Rosegarden
 {
 
@@ -86,6 +88,29 @@ public:
      */
     timeT getSoundingDuration(Segment::iterator i);
 
+    /// Sounding time and duration of an event.  See getSoundingTimes().
+    struct SoundingTime
+    {
+        timeT absoluteTime;
+        timeT duration;
+    };
+    typedef std::unordered_map<const Event *, SoundingTime> SoundingTimeMap;
+
+    /**
+     * Works out getSoundingAbsoluteTime() and getSoundingDuration() for
+     * every event before the end marker except rests, in one pass
+     * through the Segment.  Going through a whole Segment, and more so
+     * going through it more than once, use this rather than asking
+     * for each event: grace note groups are then looked up once per
+     * note rather than twice, and nothing is looked up again on later
+     * passes.
+     *
+     * The results are the same as calling getSoundingAbsoluteTime()
+     * then getSoundingDuration() for each event in order, as this
+     * does, side effects on bogus ties included.
+     */
+    void getSoundingTimes(SoundingTimeMap &times);
+
     /**
      * Returns the absolute time of the event pointed to by i,
      * in microseconds elapsed since the start of the Composition.
@@ -113,6 +138,13 @@ public:
      * the function returns true.
      */
     bool getGraceNoteTimeAndDuration(bool host, Segment::iterator i, timeT &t, timeT &d);
+
+private:
+    /// getSoundingAbsoluteTime() and getSoundingDuration() together.
+    void getSoundingTime(Segment::iterator i, timeT &t, timeT &d);
+
+    /// getSoundingDuration() for a note that isn't a grace or host note.
+    timeT getTiedDuration(Segment::iterator i);
 };
 
 }
@@ -0,0 +1,120 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#include "SegmentSnapshot.h"
+
+#include "base/BaseProperties.h"
+#include "base/Event.h"
+#include "base/Segment.h"
+
+#include <algorithm>
+
+
+namespace Rosegarden
+{
+
+
+const long SegmentSnapshot::NoValue = std::numeric_limits<long>::min();
+const SegmentSnapshot::TypeId SegmentSnapshot::NoType =
+        std::numeric_limits<SegmentSnapshot::TypeId>::max();
+
+SegmentSnapshot::SegmentSnapshot(const Segment &segment,
+                                 const std::vector<PropertyName> &properties) :
+    m_startTime(segment.getStartTime()),
+    m_endMarkerTime(segment.getEndMarkerTime())
+{
+    const size_t count = segment.size();
+
+    m_times.reserve(count);
+    m_durations.reserve(count);
+    m_types.reserve(count);
+    m_pitches.reserve(count);
+    m_velocities.reserve(count);
+
+    for (const PropertyName &name : properties)
+        m_properties.push_back(std::make_pair(name, SparseColumn()));
+
+    // Runs of the same type are the norm, so check the last one first.
+    TypeId lastType = NoType;
+
+    for (Segment::const_iterator i = segment.begin();
+         i != segment.end();
+         ++i) {
+
+        const Event *event = *i;
+        const size_t index = m_times.size();
+
+        m_times.push_back(event->getAbsoluteTime());
+        m_durations.push_back(event->getDuration());
+
+        const EventTypeName type = event->getType();
+        if (lastType == NoType  ||  m_typeNames[lastType] != type) {
+            lastType = findType(type);
+            if (lastType == NoType) {
+                lastType = TypeId(m_typeNames.size());
+                m_typeNames.push_back(type);
+            }
+        }
+        m_types.push_back(lastType);
+
+        long value = NoValue;
+        if (!event->get<Int>(BaseProperties::PITCH, value))
+            value = NoValue;
+        m_pitches.push_back(value);
+
+        value = NoValue;
+        if (!event->get<Int>(BaseProperties::VELOCITY, value))
+            value = NoValue;
+        m_velocities.push_back(value);
+
+        for (std::pair<PropertyName, SparseColumn> &column : m_properties) {
+            if (event->get<Int>(column.first, value))
+                column.second.push_back(std::make_pair(index, value));
+        }
+    }
+}
+
+SegmentSnapshot::TypeId
+SegmentSnapshot::findType(const EventTypeName &type) const
+{
+    const std::vector<EventTypeName>::const_iterator found =
+            std::find(m_typeNames.begin(), m_typeNames.end(), type);
+    if (found == m_typeNames.end())
+        return NoType;
+
+    return TypeId(found - m_typeNames.begin());
+}
+
+long
+SegmentSnapshot::getProperty(size_t i, const PropertyName &name) const
+{
+    for (const std::pair<PropertyName, SparseColumn> &column : m_properties) {
+        if (!(column.first == name))
+            continue;
+
+        const SparseColumn &values = column.second;
+        const SparseColumn::const_iterator found = std::lower_bound(
+                values.begin(), values.end(), std::make_pair(i, NoValue));
+        if (found != values.end()  &&  found->first == i)
+            return found->second;
+
+        return NoValue;
+    }
+
+    return NoValue;
+}
+
+
+}
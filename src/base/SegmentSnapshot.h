@@ -0,0 +1,128 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#ifndef RG_SEGMENT_SNAPSHOT_H
+#define RG_SEGMENT_SNAPSHOT_H
+
+#include "base/EventTypeName.h"
+#include "base/PropertyName.h"
+#include "base/TimeT.h"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <rosegardenprivate_export.h>
+
+namespace Rosegarden
+{
+
+class Segment;
+
+
+/// An immutable, column-oriented copy of a Segment's events.
+/**
+ * Walking a Segment means following multiset nodes to Events and
+ * looking up each property by name in the Event's property map.  Code
+ * that reads a few fields of every event over and over, or from another
+ * thread, can copy those fields out once into parallel arrays and scan
+ * those instead.  Building a snapshot costs more than one walk of the
+ * Segment, so a single pass on the GUI thread should use the Segment.
+ * CsoundExporter, for one, reads them from a CompositionSnapshot so that
+ * it can write the file on a worker thread.
+ *
+ * Event i of the segment (in Segment order) has its time at getTime(i),
+ * its pitch at getPitch(i), and so on.  Event types are interned: use
+ * findType() once, then compare getType(i) against the result.
+ *
+ * Pitch and velocity are always captured.  Any other Int properties
+ * needed can be asked for when the snapshot is made; they are stored
+ * sparsely, as most events don't have most properties.
+ *
+ * A snapshot holds no pointers into the Segment, so once made it can
+ * be read from any number of threads while the Segment itself goes on
+ * being edited.  Pass it around as a SegmentSnapshot::Ptr.
+ */
+class ROSEGARDENPRIVATE_EXPORT SegmentSnapshot
+{
+public:
+    typedef std::shared_ptr<const SegmentSnapshot> Ptr;
+    typedef uint16_t TypeId;
+
+    /// For getPitch() and friends when the event lacks the property.
+    static const long NoValue;
+    /// From findType() for a type that isn't in the snapshot.
+    static const TypeId NoType;
+
+    /// Copy segment, including the given extra Int properties.
+    explicit SegmentSnapshot(const Segment &segment,
+                             const std::vector<PropertyName> &properties =
+                                     std::vector<PropertyName>());
+
+    static Ptr create(const Segment &segment,
+                      const std::vector<PropertyName> &properties =
+                              std::vector<PropertyName>())
+        { return std::make_shared<SegmentSnapshot>(segment, properties); }
+
+    size_t size() const  { return m_times.size(); }
+    bool empty() const  { return m_times.empty(); }
+
+    timeT getStartTime() const  { return m_startTime; }
+    timeT getEndMarkerTime() const  { return m_endMarkerTime; }
+
+    timeT getTime(size_t i) const  { return m_times[i]; }
+    timeT getDuration(size_t i) const  { return m_durations[i]; }
+    TypeId getType(size_t i) const  { return m_types[i]; }
+    long getPitch(size_t i) const  { return m_pitches[i]; }
+    long getVelocity(size_t i) const  { return m_velocities[i]; }
+
+    /// The id for an event type, or NoType if no event has it.
+    TypeId findType(const EventTypeName &type) const;
+    const EventTypeName &getTypeName(TypeId type) const
+        { return m_typeNames[type]; }
+    bool isa(size_t i, TypeId type) const  { return m_types[i] == type; }
+
+    /// One of the extra properties asked for at construction.
+    /**
+     * Returns NoValue if event i doesn't have it, or if it wasn't
+     * asked for.
+     */
+    long getProperty(size_t i, const PropertyName &name) const;
+
+private:
+    timeT m_startTime;
+    timeT m_endMarkerTime;
+
+    // One entry per event.
+    std::vector<timeT> m_times;
+    std::vector<timeT> m_durations;
+    std::vector<TypeId> m_types;
+    std::vector<long> m_pitches;
+    std::vector<long> m_velocities;
+
+    std::vector<EventTypeName> m_typeNames;
+
+    /// (event index, value) pairs in index order, for events that have it.
+    typedef std::vector<std::pair<size_t, long> > SparseColumn;
+    std::vector<std::pair<PropertyName, SparseColumn> > m_properties;
+};
+
+
+}
+
+#endif
@@ -103,7 +103,7 @@ public:
      * Return true if there are any events of the given type in
      * this selection.  Slow.
      */
-    bool contains(const std::string &type) const;
+    bool contains(const EventTypeName &type) const;
 
     /**
      * Return the time at which the first Event in the selection
@@ -136,6 +136,13 @@ public:
     bool Expand(Segment *target, Queue& queue) const;
 
 private:
+    bool expandEvents(Segment *target, Queue& queue) const;
+    bool expandTemplate(Segment *target,
+                        const TriggerSegmentRec::ExpansionTemplate &
+                            expansion) const;
+    bool clipToIntervals(TimeIntervalVector::const_iterator &interval,
+                         timeT &t, timeT &d) const;
+
     static TimeIntervalVector
     getSoundingIntervals(Segment::iterator iTrigger,
                          const Segment *oversegment,
@@ -161,6 +168,43 @@ private:
     TimeIntervalVector        m_intervals;
 };
 
+// @class TriggerSegmentRec::ExpansionTemplate
+// The events of a trigger segment that Expand copies, with the
+// properties it adjusts already looked up, in the segment's own time
+// relative to its start.
+class TriggerSegmentRec::ExpansionTemplate
+{
+public:
+    struct Entry
+    {
+        explicit Entry(const Event &e);
+
+        // Shares the source event's data.
+        Event event;
+        timeT time;
+        bool  hasPitch;
+        long  pitch;
+        bool  hasVelocity;
+        long  velocity;
+        // Controller or pitchbend, to be made absolute when inserted.
+        bool  isController;
+    };
+
+    std::vector<Entry> m_entries;
+};
+
+TriggerSegmentRec::ExpansionTemplate::Entry::Entry(const Event &e) :
+    event(e),
+    time(0),
+    hasPitch(event.has(BaseProperties::PITCH)),
+    pitch(hasPitch ? event.get<Int>(BaseProperties::PITCH) : 0),
+    hasVelocity(event.has(BaseProperties::VELOCITY)),
+    velocity(hasVelocity ? event.get<Int>(BaseProperties::VELOCITY) : 0),
+    isController(event.isa(Controller::EventType) ||
+                 event.isa(PitchBend::EventType))
+{
+}
+
 /*** TriggerSegmentRec definitions ***/
 
 TriggerSegmentRec::~TriggerSegmentRec()
@@ -179,7 +223,10 @@ TriggerSegmentRec::TriggerSegmentRec(TriggerSegmentId id,
     m_basePitch(basePitch),
     m_baseVelocity(baseVelocity),
     m_defaultTimeAdjust(defaultTimeAdjust),
-    m_defaultRetune(defaultRetune)
+    m_defaultRetune(defaultRetune),
+    m_haveExpansionTemplate(false),
+    m_haveRefreshStatusId(false),
+    m_refreshStatusId(0)
 {
     if (m_defaultTimeAdjust == "") {
 	m_defaultTimeAdjust = BaseProperties::TRIGGER_SEGMENT_ADJUST_SQUISH;
@@ -196,7 +243,10 @@ TriggerSegmentRec::TriggerSegmentRec(const TriggerSegmentRec &rec) :
     m_baseVelocity(rec.m_baseVelocity),
     m_defaultTimeAdjust(rec.m_defaultTimeAdjust),
     m_defaultRetune(rec.m_defaultRetune),
-    m_references(rec.m_references)
+    m_references(rec.m_references),
+    m_haveExpansionTemplate(false),
+    m_haveRefreshStatusId(false),
+    m_refreshStatusId(0)
 {
     // nothing else
 }
@@ -212,6 +262,9 @@ TriggerSegmentRec::operator=(const TriggerSegmentRec &rec)
     m_defaultTimeAdjust = rec.m_defaultTimeAdjust;
     m_defaultRetune = rec.m_defaultRetune;
     m_references = rec.m_references;
+    m_expansionTemplate.reset();
+    m_haveExpansionTemplate = false;
+    m_haveRefreshStatusId = false;
     return *this;
 }
 
@@ -297,6 +350,55 @@ getVelocityDiff(const Event *trigger) const
     return evVelocity - getBaseVelocity();
 }
 
+const TriggerSegmentRec::ExpansionTemplate *
+TriggerSegmentRec::getExpansionTemplate() const
+{
+    if (!m_segment) { return nullptr; }
+
+    // Throw it away whenever the trigger segment changes.
+    if (!m_haveRefreshStatusId) {
+        m_refreshStatusId = m_segment->getNewRefreshStatusId();
+        m_haveRefreshStatusId = true;
+    }
+    SegmentRefreshStatus &status =
+        m_segment->getRefreshStatus(m_refreshStatusId);
+    if (status.needsRefresh()) {
+        m_haveExpansionTemplate = false;
+        status.setNeedsRefresh(false);
+    }
+
+    if (m_haveExpansionTemplate)
+        { return m_expansionTemplate.get(); }
+
+    // Make it.  This picks out the events that
+    // TriggerExpansionContext::expandEvents would.
+    std::shared_ptr<ExpansionTemplate> expansion(new ExpansionTemplate);
+    const timeT baseTime = m_segment->getStartTime();
+
+    for (Segment::iterator i = m_segment->begin();
+         i != m_segment->getEndMarker();
+         ++i) {
+
+        // Nested ornaments can't be done from a template.  Remember
+        // that so we don't look again.
+        if ((*i)->has(BaseProperties::TRIGGER_SEGMENT_ID)) {
+            expansion.reset();
+            break;
+        }
+
+        if ((*i)->isa(Clef::EventType)) { continue; }
+        if ((*i)->isa(Key::EventType)) { continue; }
+
+        expansion->m_entries.push_back(ExpansionTemplate::Entry(**i));
+        expansion->m_entries.back().time =
+            (*i)->getAbsoluteTime() - baseTime;
+    }
+
+    m_expansionTemplate = expansion;
+    m_haveExpansionTemplate = true;
+    return m_expansionTemplate.get();
+}
+
 // @return
 // A segment linked to the trigger segment, adjusted in pitch and time
 // to match the ornament as performed by trigger.  Caller owns this.
@@ -696,16 +798,29 @@ makeNestedContext(Segment::iterator     iTrigger,
 bool
 TriggerExpansionContext::
 Expand(Segment *target, Queue& queue) const
+{
+    // Most ornaments contain no triggers of their own, so their
+    // events can come from a template shared by every trigger.
+    const TriggerSegmentRec::ExpansionTemplate *expansion =
+        m_rec->getExpansionTemplate();
+    if (expansion)
+        { return expandTemplate(target, *expansion); }
+
+    return expandEvents(target, queue);
+}
+
+// Expand the ornament from the trigger segment's own events.
+// @author Tom Breton (Tehom)
+bool
+TriggerExpansionContext::
+expandEvents(Segment *target, Queue& queue) const
 {
     const Segment *source = m_rec->getSegment();
     const timeT baseTime = source->getStartTime();
 
     bool insertedSomething = false;
 
-    /** Initial values **/
     TimeIntervalVector::const_iterator interval = m_intervals.begin();
-    timeT startT = interval->first;
-    timeT endT = interval->second;
 
     for (Segment::iterator i = source->begin();
          i != source->getEndMarker();
@@ -740,54 +855,21 @@ Expand(Segment *target, Queue& queue) const
         // !!! it.
         if ((*i)->isa(Key::EventType)) { continue; }
 
-        // Find performance time
+        // Find performance time and duration
         timeT t =
             m_timeScale.toPerformance((*i)->getAbsoluteTime() - baseTime);
+        timeT d =
+            m_timeScale.toPerformanceDuration((*i)->getDuration());
 
-        // Update the time interval and the clip times.
-        while (t >= endT) {
-            ++interval;
-
+        if (!clipToIntervals(interval, t, d)) {
             // We can end right now.  Everything past this event would
             // never have been inserted.  Even triggers would never
             // cause any insertions.
             if (interval == m_intervals.end())
                 { return insertedSomething; }
-            startT = interval->first;
-            endT = interval->second;
-        }
-
-        /** Now the time interval either contains the start of the
-           event or is the next time interval after it. **/
-
-        // Find performance duration.
-        timeT d =
-            m_timeScale.toPerformanceDuration((*i)->getDuration());
-
-        /** Clip to current time interval.  We may delay the start of
-            notes or end them early, but we don't try to make long
-            notes sound in multiple time intervals.  **/
-
-        // Clip to the start.
-        if (t < startT) {
-            if (t + d <= startT)
-                { continue; }
-            else {
-                d -= (startT - t);
-                t = startT;
-            }
-        }
-
-        // Clip to the end.
-        if (t + d > endT) {
-            if (t >= endT)
-                { continue; }
-            else {
-                d = endT - t;
-            }
+            continue;
         }
 
-
         // Make the event but don't insert it until we modify it.
         Event *newEvent = new Event(**i, t, d);
 
@@ -827,5 +909,113 @@ Expand(Segment *target, Queue& queue) const
     return insertedSomething;
 }
 
+// Expand the ornament from a template.  This does what expandEvents
+// does without looking anything up in the source events.
+bool
+TriggerExpansionContext::
+expandTemplate(Segment *target,
+               const TriggerSegmentRec::ExpansionTemplate &expansion) const
+{
+    typedef TriggerSegmentRec::ExpansionTemplate::Entry Entry;
+
+    bool insertedSomething = false;
+
+    TimeIntervalVector::const_iterator interval = m_intervals.begin();
+
+    for (const Entry &entry : expansion.m_entries) {
+        timeT t = m_timeScale.toPerformance(entry.time);
+        timeT d = m_timeScale.toPerformanceDuration(
+                entry.event.getDuration());
+
+        if (!clipToIntervals(interval, t, d)) {
+            if (interval == m_intervals.end())
+                { return insertedSomething; }
+            continue;
+        }
+
+        Event *newEvent = new Event(entry.event, t, d);
+
+        // Only set what actually changes.
+        if (m_retune && entry.hasPitch) {
+            long pitch = entry.pitch + m_pitchDiff;
+            if (pitch > 127)
+                pitch = 127;
+            if (pitch < 0)
+                pitch = 0;
+            if (pitch != entry.pitch)
+                { newEvent->set<Int>(BaseProperties::PITCH, pitch); }
+        }
+
+        if (entry.hasVelocity) {
+            long velocity = entry.velocity + m_velocityDiff;
+            if (velocity > 127)
+                velocity = 127;
+            if (velocity < 0)
+                velocity = 0;
+            if (velocity != entry.velocity)
+                { newEvent->set<Int>(BaseProperties::VELOCITY, velocity); }
+        }
+
+        if (entry.isController && m_controllerContextParams)
+            { m_controllerContextParams->makeControlValueAbsolute(newEvent); }
+
+        target->insert(newEvent);
+        insertedSomething = true;
+    }
+
+    return insertedSomething;
+}
+
+// Clip an event to the sounding intervals.  We may delay the start of
+// notes or end them early, but we don't try to make long notes sound
+// in multiple time intervals.
+// @return
+// False if the event doesn't sound at all.  If interval is then
+// m_intervals.end(), no later event can sound either.
+// @param interval
+// The interval the previous event was clipped to.  Stepped to the one
+// containing t, or the next after it.
+// @param t, d
+// Performance time and duration, clipped in place.
+bool
+TriggerExpansionContext::
+clipToIntervals(TimeIntervalVector::const_iterator &interval,
+                timeT &t, timeT &d) const
+{
+    // Update the time interval.
+    while (t >= interval->second) {
+        ++interval;
+        if (interval == m_intervals.end())
+            { return false; }
+    }
+
+    /** Now the time interval either contains the start of the
+       event or is the next time interval after it. **/
+
+    const timeT startT = interval->first;
+    const timeT endT = interval->second;
+
+    // Clip to the start.
+    if (t < startT) {
+        if (t + d <= startT)
+            { return false; }
+        else {
+            d -= (startT - t);
+            t = startT;
+        }
+    }
+
+    // Clip to the end.
+    if (t + d > endT) {
+        if (t >= endT)
+            { return false; }
+        else {
+            d = endT - t;
+        }
+    }
+
+    return true;
+}
+
 
 }
@@ -17,6 +17,7 @@
 #define RG_TRIGGER_SEGMENT_H
 
 #include <base/Segment.h>
+#include <memory>
 #include <set>
 #include <string>
 
@@ -80,6 +81,22 @@ public:
     int getTranspose(const Event *trigger) const;
     int getVelocityDiff(const Event *trigger) const;
 
+    /// The trigger segment's events as ExpandInto() uses them.  See
+    /// getExpansionTemplate().
+    class ExpansionTemplate;
+
+    /// The events ExpandInto() makes every expansion from.
+    /**
+     * Every trigger of this segment expands to the same events, only
+     * timed, clipped, retuned and re-velocitied differently, so the
+     * events are picked out once and kept until the trigger segment
+     * changes.
+     *
+     * Returns nullptr if the trigger segment itself contains triggers,
+     * as those nested expansions are more than that.
+     */
+    const ExpansionTemplate *getExpansionTemplate() const;
+
 protected:
     friend class Composition;
     TriggerSegmentRec(TriggerSegmentId id, Segment *segment,
@@ -100,6 +117,13 @@ protected:
     std::string          m_defaultTimeAdjust;
     bool                 m_defaultRetune;
     SegmentRuntimeIdSet  m_references;
+
+    // Expansion cache.  Not copied with the rest, as the refresh status
+    // ID is ours alone.
+    mutable std::shared_ptr<const ExpansionTemplate> m_expansionTemplate;
+    mutable bool                 m_haveExpansionTemplate;
+    mutable bool                 m_haveRefreshStatusId;
+    mutable unsigned int         m_refreshStatusId;
 };
 
 struct TriggerSegmentCmp
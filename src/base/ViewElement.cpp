@@ -105,7 +105,7 @@ ViewElementList::eraseSingle(ViewElement *el)
 }
 
 ViewElementList::iterator
-ViewElementList::findPrevious(const std::string &type, iterator i)
+ViewElementList::findPrevious(const EventTypeName &type, iterator i)
 
 {
     // what to return on failure? I think probably
@@ -120,7 +120,7 @@ ViewElementList::findPrevious(const std::string &type, iterator i)
 }
 
 ViewElementList::iterator
-ViewElementList::findNext(const std::string &type, iterator i)
+ViewElementList::findNext(const EventTypeName &type, iterator i)
 {
     if (i == end()) return i;
     for (++i; i != end() && !(*i)->event()->isa(type); ++i){ };
@@ -118,8 +118,8 @@ public:
     void erase(iterator from, iterator to);
     void eraseSingle(ViewElement *);
 
-    iterator findPrevious(const std::string &type, iterator i);
-    iterator findNext(const std::string &type, iterator i);
+    iterator findPrevious(const EventTypeName &type, iterator i);
+    iterator findNext(const EventTypeName &type, iterator i);
 
     /**
      * Returns an iterator pointing to that specific element,
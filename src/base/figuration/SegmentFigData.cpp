@@ -214,11 +214,13 @@ update(ChordSegmentMap& chordSources,
         lastEnd = endRegion;
 
         // Copy selected other contents of that region
+        std::vector<Event *> passed;
         Segment::iterator end = s->findTime(endRegion);
         for (Segment::iterator j = s->findTime(startRegion); j != end; ++j) {
             if (SegmentFigData::eventShouldPass(*j))
-                { target->insert(new Event(**j)); }
+                { passed.push_back(new Event(**j)); }
         }
+        target->insertEvents(passed);
     }
 
     // Finally, save the last contiguous region.  Safe even if we did
@@ -581,14 +583,18 @@ SegmentFigData::expand(SourcedFiguration& sourcedFiguration,
     const Key key =
         chordSource.m_s->getKeyAtTime(startTime);
 
+    // Everything we generate is collected here and inserted into
+    // target in one batch.
+    std::vector<Event *> newEvents;
+    newEvents.reserve(figuration->m_events.size() + 1);
+
     // Write an indication for the whole thing.
     {
         GeneratedRegion
             generatedRegion(chordSource.m_ID,
                             sourcedFiguration.first,
                             figuration->m_duration);
-        Event * e = generatedRegion.getAsEvent(startTime);
-        (void)target->insert(e);
+        newEvents.push_back(generatedRegion.getAsEvent(startTime));
     }
     // Write the respective notes into target
     RelativeEventVec & events = figuration->m_events;
@@ -618,9 +624,11 @@ SegmentFigData::expand(SourcedFiguration& sourcedFiguration,
             (*k)->getAsEvent(startTime,
                              key,
                              pBlockChord);
-        target->insert(newNote);
+        newEvents.push_back(newNote);
     }
 
+    target->insertEvents(newEvents);
+
     // We're done with chordSequence.
     for (ChordSequence::iterator j =
              chordSequence.begin();
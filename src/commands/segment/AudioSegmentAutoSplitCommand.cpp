@@ -49,13 +49,15 @@ struct AutoSplitPoint
 AudioSegmentAutoSplitCommand::AudioSegmentAutoSplitCommand(
     RosegardenDocument *doc,
     Segment *segment,
-    int threshold) :
+    int threshold,
+    SplitMode mode) :
         NamedCommand(getGlobalName()),
         m_segment(segment),
         m_composition(segment->getComposition()),
         m_audioFileManager(&(doc->getAudioFileManager())),
         m_detached(false),
-        m_threshold(threshold)
+        m_threshold(threshold),
+        m_mode(mode)
 {}
 
 AudioSegmentAutoSplitCommand::~AudioSegmentAutoSplitCommand()
@@ -84,13 +86,25 @@ AudioSegmentAutoSplitCommand::execute()
         std::vector<SplitPointPair> rtSplitPoints;
 
         try {
-            rtSplitPoints =
-                m_audioFileManager->
-                getSplitPoints(m_segment->getAudioFileId(),
-                               m_segment->getAudioStartTime(),
-                               m_segment->getAudioEndTime(),
-                               m_threshold,
-                               RealTime(0, 200000000));
+            if (m_mode == SplitOnTransients) {
+                // Slices are usually short (single drum hits), so
+                // allow anything down to 50ms.
+                rtSplitPoints =
+                    m_audioFileManager->
+                    getOnsetSplitPoints(m_segment->getAudioFileId(),
+                                        m_segment->getAudioStartTime(),
+                                        m_segment->getAudioEndTime(),
+                                        m_threshold,
+                                        RealTime(0, 50000000));
+            } else {
+                rtSplitPoints =
+                    m_audioFileManager->
+                    getSplitPoints(m_segment->getAudioFileId(),
+                                   m_segment->getAudioStartTime(),
+                                   m_segment->getAudioEndTime(),
+                                   m_threshold,
+                                   RealTime(0, 200000000));
+            }
         } catch (const AudioFileManager::BadAudioPathException &e) {
             RG_WARNING << "ERROR: AudioSegmentAutoSplitCommand: Bad audio path: " << e.getMessage();
         } catch (const PeakFileManager::BadPeakFileException &e) {
@@ -41,9 +41,17 @@ class AudioSegmentAutoSplitCommand : public NamedCommand
     Q_DECLARE_TR_FUNCTIONS(Rosegarden::AudioSegmentAutoSplitCommand)
 
 public:
+    enum SplitMode {
+        /// Split where the peak level drops below the threshold.
+        SplitOnSilence,
+        /// Split at each transient.  The threshold is the sensitivity.
+        SplitOnTransients
+    };
+
     AudioSegmentAutoSplitCommand(RosegardenDocument *doc,
                                  Segment *segment,
-                                 int threshold);
+                                 int threshold,
+                                 SplitMode mode = SplitOnSilence);
     ~AudioSegmentAutoSplitCommand() override;
 
     void execute() override;
@@ -58,6 +66,7 @@ private:
     std::vector<Segment *>  m_newSegments;
     bool                                m_detached;
     int                                 m_threshold;
+    SplitMode                           m_mode;
 };
 
 
@@ -36,6 +36,16 @@ CreateTempoMapFromSegmentCommand::CreateTempoMapFromSegmentCommand(Segment *groo
     initialise(grooveSegment);
 }
 
+CreateTempoMapFromSegmentCommand::CreateTempoMapFromSegmentCommand(
+        Composition *composition,
+        timeT startTime,
+        const std::vector<RealTime> &beatRealTimes) :
+    NamedCommand(tr("Set Tempos from Beat Segment")),
+    m_composition(composition)
+{
+    initialise(m_composition->getBarNumber(startTime), beatRealTimes);
+}
+
 CreateTempoMapFromSegmentCommand::~CreateTempoMapFromSegmentCommand()
 {
     // nothing
@@ -73,6 +83,22 @@ CreateTempoMapFromSegmentCommand::unexecute()
 
 void
 CreateTempoMapFromSegmentCommand::initialise(Segment *s)
+{
+    std::vector<RealTime> beatRealTimes;
+
+    for (Segment::iterator i = s->begin(); s->isBeforeEndMarker(i); ++i) {
+        if ((*i)->isa(Note::EventType)) {
+            beatRealTimes.push_back(s->getComposition()->getElapsedRealTime
+                                    ((*i)->getAbsoluteTime()));
+        }
+    }
+
+    initialise(m_composition->getBarNumber(s->getStartTime()), beatRealTimes);
+}
+
+void
+CreateTempoMapFromSegmentCommand::initialise(
+        int startBar, const std::vector<RealTime> &beatRealTimes)
 {
     m_oldTempi.clear();
     m_newTempi.clear();
@@ -82,29 +108,23 @@ CreateTempoMapFromSegmentCommand::initialise(Segment *s)
     // probably use TimeSignature.getDivisions()
 
     std::vector<timeT> beatTimeTs;
-    std::vector<RealTime> beatRealTimes;
+    beatTimeTs.reserve(beatRealTimes.size());
 
-    int startBar = m_composition->getBarNumber(s->getStartTime());
     int barNo = startBar;
     int beat = 0;
 
-    for (Segment::iterator i = s->begin(); s->isBeforeEndMarker(i); ++i) {
-        if ((*i)->isa(Note::EventType)) {
-
-            bool isNew;
-            TimeSignature sig =
-                m_composition->getTimeSignatureInBar(barNo, isNew);
+    for (size_t i = 0; i < beatRealTimes.size(); ++i) {
 
-            beatTimeTs.push_back(m_composition->getBarStart(barNo) +
-                                 beat * sig.getBeatDuration());
+        bool isNew;
+        TimeSignature sig =
+            m_composition->getTimeSignatureInBar(barNo, isNew);
 
-            if (++beat >= sig.getBeatsPerBar()) {
-                ++barNo;
-                beat = 0;
-            }
+        beatTimeTs.push_back(m_composition->getBarStart(barNo) +
+                             beat * sig.getBeatDuration());
 
-            beatRealTimes.push_back(s->getComposition()->getElapsedRealTime
-                                    ((*i)->getAbsoluteTime()));
+        if (++beat >= sig.getBeatsPerBar()) {
+            ++barNo;
+            beat = 0;
         }
     }
 
@@ -19,9 +19,11 @@
 #define RG_CREATETEMPOMAPFROMSEGMENTCOMMAND_H
 
 #include <map>
+#include <vector>
 #include "document/Command.h"
 #include "base/Event.h"
 #include "base/Composition.h" // for tempoT
+#include "base/RealTime.h"
 
 #include <QCoreApplication>
 
@@ -41,6 +43,15 @@ class CreateTempoMapFromSegmentCommand : public NamedCommand
 
 public:
     explicit CreateTempoMapFromSegmentCommand(Segment *grooveSegment);
+
+    /// Use beat times found elsewhere, e.g. by BeatTracker.
+    /**
+     * beatRealTimes are composition real times.  The first beat is
+     * taken to be the start of the bar containing startTime.
+     */
+    CreateTempoMapFromSegmentCommand(Composition *composition,
+                                     timeT startTime,
+                                     const std::vector<RealTime> &beatRealTimes);
     ~CreateTempoMapFromSegmentCommand() override;
 
     void execute() override;
@@ -48,6 +59,7 @@ public:
 
 private:
     void initialise(Segment *s);
+    void initialise(int startBar, const std::vector<RealTime> &beatRealTimes);
 
     Composition *m_composition;
 
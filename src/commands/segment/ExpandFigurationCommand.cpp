@@ -30,6 +30,8 @@
 
 #include <QtGlobal>
 
+#include <vector>
+
 namespace Rosegarden
 {
 
@@ -131,6 +133,7 @@ ExpandFigurationCommand::initialise(SegmentSelection selection)
         m_newSegments.insert(target);
 
         /** Add notes to target segment **/
+        std::vector<Event *> nonNotes;
         for (Segment::iterator e = s->begin();
              e != s->end();
              ++e) {
@@ -141,9 +144,10 @@ ExpandFigurationCommand::initialise(SegmentSelection selection)
                 continue;
             }
             if (!(*e)->isa(Note::EventType)) {
-                target->insert(new Event(**e));
+                nonNotes.push_back(new Event(**e));
             }
         }
+        target->insertEvents(nonNotes);
 
 
         // rawStartTime is the apparent start time before we take bars
@@ -43,7 +43,8 @@ CommandHistory::CommandHistory() :
     m_redoLimit(50),
     m_menuLimit(15),
     m_savedAt(0),
-    m_enableUndo(true)
+    m_enableUndo(true),
+    m_version(0)
 {
     // All Edit > Undo menu items share this QAction object.
     m_undoAction = new QAction(QIcon(":/icons/undo.png"), tr("&Undo"), this);
@@ -91,6 +92,7 @@ CommandHistory::clear()
     m_savedAt = -1;
     clearStack(m_undoStack);
     clearStack(m_redoStack);
+    ++m_version;
     updateActions();
 }
 
@@ -125,6 +127,7 @@ CommandHistory::addCommand(Command *command, timeT startPointerPosition)
 
     // Execute the command
     command->execute();
+    ++m_version;
 
     emit updateLinkedSegments(command);
     emit commandExecuted();
@@ -145,6 +148,7 @@ CommandHistory::undo()
 
     CommandInfo commInfo = m_undoStack.top();
     commInfo.command->unexecute();
+    ++m_version;
     emit updateLinkedSegments(commInfo.command);
     emit commandExecuted();
     emit commandUnexecuted(commInfo.command);
@@ -167,6 +171,7 @@ CommandHistory::redo()
 
     CommandInfo commInfo = m_redoStack.top();
     commInfo.command->execute();
+    ++m_version;
     emit updateLinkedSegments(commInfo.command);
     emit commandExecuted();
     //emit commandExecuted2(commInfo.command);
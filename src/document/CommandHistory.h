@@ -109,6 +109,14 @@ public:
     /// set pointer position
     void setPointerPositionForRedo(timeT pos);
 
+    /// Changes whenever a command is executed, undone or redone.
+    /**
+     * Unlike the depth of the undo stack this never repeats, so equal
+     * versions mean the document hasn't been changed by a command in
+     * between.  See CompositionSnapshot.
+     */
+    unsigned getVersion() const  { return m_version; }
+
     /// get pointer position
     timeT getPointerPosition() const;
 
@@ -223,6 +231,9 @@ protected:
     /// Enable/Disable undo (during playback).
     bool m_enableUndo;
 
+    /// See getVersion().
+    unsigned m_version;
+
     // pointer position
     timeT m_pointerPosition;
 
@@ -137,6 +137,7 @@ RosegardenDocument::RosegardenDocument(
     m_modified(false),
     m_autoSaved(false),
     m_lockFile(nullptr),
+    m_snapshotter(m_composition),
     m_audioFileManager(this),
     m_audioPeaksThread(&m_audioFileManager),
     m_seqManager(nullptr),
@@ -305,6 +306,13 @@ void RosegardenDocument::slotDocumentRestored()
     emit documentModified(false);
 }
 
+CompositionSnapshot::Ptr
+RosegardenDocument::takeSnapshot()
+{
+    return m_snapshotter.takeSnapshot(
+            CommandHistory::getInstance()->getVersion());
+}
+
 void
 RosegardenDocument::setQuickMarker()
 {
@@ -19,6 +19,7 @@
 #define RG_ROSEGARDENDOCUMENT_H
 
 #include "base/Composition.h"
+#include "base/CompositionSnapshot.h"
 #include "base/Configuration.h"
 #include "base/Device.h"
 #include "base/MidiProgram.h"
@@ -286,6 +287,13 @@ public:
     Composition &getComposition()  { return m_composition; }
     const Composition &getComposition() const  { return m_composition; }
 
+    /// A read-only copy of the composition for use on other threads.
+    /**
+     * See CompositionSnapshot.  The version is
+     * CommandHistory::getVersion().
+     */
+    CompositionSnapshot::Ptr takeSnapshot();
+
     /*
      * return the Studio
      */
@@ -730,6 +738,9 @@ private:
      */
     Composition m_composition;
 
+    /// For takeSnapshot().
+    CompositionSnapshotter m_snapshotter;
+
     /**
      * stores AudioFile mappings
      */
@@ -17,15 +17,12 @@
 
 #include "CsoundExporter.h"
 
-#include "base/Event.h"
-#include "base/BaseProperties.h"
 #include "base/Composition.h"
 #include "base/NotationTypes.h"
-#include "base/Segment.h"
-#include "base/Track.h"
-#include "gui/application/RosegardenApplication.h"
 
+#include <QCoreApplication>
 #include <QObject>
+#include <QThread>
 
 #include <fstream>
 
@@ -33,10 +30,34 @@
 namespace Rosegarden
 {
 
+namespace
+{
+    /// Runs CsoundExporter::write(std::ostream &) for write().
+    class WriterThread : public QThread
+    {
+    public:
+        WriterThread(const CsoundExporter &exporter, std::ostream &str) :
+            m_exporter(exporter),
+            m_str(str)
+        {
+        }
+
+    protected:
+        void run() override
+        {
+            m_exporter.write(m_str);
+        }
+
+    private:
+        const CsoundExporter &m_exporter;
+        std::ostream &m_str;
+    };
+}
+
 CsoundExporter::CsoundExporter(QObject * /*parent*/,
-                               Composition *composition,
+                               CompositionSnapshot::Ptr snapshot,
                                const std::string& fileName) :
-        m_composition(composition),
+        m_snapshot(snapshot),
         m_fileName(fileName)
 {
     // nothing else
@@ -62,55 +83,75 @@ CsoundExporter::write()
         return false;
     }
 
+    WriterThread thread(*this, str);
+    thread.start();
+    while (!thread.wait(50))
+        QCoreApplication::processEvents();
+
+    str.close();
+    return true;
+}
+
+void
+CsoundExporter::write(std::ostream &str) const
+{
     str << ";; Csound score file written by Rosegarden\n\n";
-    if (m_composition->getCopyrightNote() != "") {
+    if (m_snapshot->getCopyrightNote() != "") {
         str << ";; Copyright note:\n;; "
         //!!! really need to remove newlines from copyright note
-        << m_composition->getCopyrightNote() << "\n";
+        << m_snapshot->getCopyrightNote() << "\n";
     }
 
-    //int trackNo = 0;
+    const std::map<TrackId, CompositionSnapshot::TrackInfo> &tracks =
+            m_snapshot->getTracks();
 
-    for (Composition::iterator i = m_composition->begin();
-            i != m_composition->end(); ++i) {
+    for (const CompositionSnapshot::SegmentInfo &segment :
+             m_snapshot->getSegments()) {
 
-        // ??? The Csound export process is so fast, this is unnecessary.
-        //emit setValue(int(double(trackNo++) / double(m_composition->getNbTracks()) * 100.0));
+        const std::map<TrackId, CompositionSnapshot::TrackInfo>::const_iterator
+                track = tracks.find(segment.track);
 
-        str << "\n;; Segment: \"" << (*i)->getLabel() << "\"\n";
+        str << "\n;; Segment: \"" << segment.label << "\"\n";
         str << ";; on Track: \""
-        << m_composition->getTrackById((*i)->getTrack())->getLabel()
+        << (track != tracks.end() ? track->second.label : std::string())
         << "\"\n";
         str << ";;\n;; Inst\tStart\tDur\tAmp\tPch\n"
         << ";; ----\t----\t---\t-----\t----\n";
 
-        for (Segment::iterator j = (*i)->begin(); j != (*i)->end(); ++j) {
+        const SegmentSnapshot &events = *segment.events;
+        const SegmentSnapshot::TypeId noteType =
+                events.findType(Note::EventType);
+
+        for (size_t j = 0; j < events.size(); ++j) {
 
-            if ((*j)->isa(Note::EventType)) {
+            if (events.isa(j, noteType)) {
 
-                long pitch = 0;
-                (*j)->get
-                <Int>(BaseProperties::PITCH, pitch);
+                long pitch = events.getPitch(j);
+                if (pitch == SegmentSnapshot::NoValue)
+                    pitch = 0;
 
-                long velocity = 127;
-                (*j)->get
-                <Int>(BaseProperties::VELOCITY, velocity);
+                long velocity = events.getVelocity(j);
+                if (velocity == SegmentSnapshot::NoValue)
+                    velocity = 127;
 
                 str << "   i"
-                << ((*i)->getTrack() + 1)<< "\t"
-                << convertTime((*j)->getAbsoluteTime()) << "\t"
-                << convertTime((*j)->getDuration()) << "\t"
+                << (segment.track + 1)<< "\t"
+                << convertTime(events.getTime(j)) << "\t"
+                << convertTime(events.getDuration(j)) << "\t"
                 << velocity << "\t"
                 << 3 + (pitch / 12) << ((pitch % 12) < 10 ? ".0" : ".")
                 << pitch % 12 << "\t\n";
 
             } else {
-                str << ";; Event type: " << (*j)->getType() << std::endl;
+                str << ";; Event type: "
+                    << events.getTypeName(events.getType(j)) << std::endl;
             }
         }
     }
 
-    int tempoCount = m_composition->getTempoChangeCount();
+    const std::vector<std::pair<timeT, tempoT> > &tempoChanges =
+            m_snapshot->getTempoChanges();
+    const int tempoCount = int(tempoChanges.size());
 
     if (tempoCount > 0) {
 
@@ -118,13 +159,12 @@ CsoundExporter::write()
 
         for (int i = 0; i < tempoCount - 1; ++i) {
 
-            std::pair<timeT, tempoT> tempoChange =
-                m_composition->getTempoChange(i);
+            const std::pair<timeT, tempoT> &tempoChange = tempoChanges[i];
 
             timeT myTime = tempoChange.first;
             timeT nextTime = myTime;
-            if (i < m_composition->getTempoChangeCount() - 1) {
-                nextTime = m_composition->getTempoChange(i + 1).first;
+            if (i < tempoCount - 1) {
+                nextTime = tempoChanges[i + 1].first;
             }
 
             int tempo = int(Composition::getTempoQpm(tempoChange.second));
@@ -133,15 +173,13 @@ CsoundExporter::write()
             << convertTime(nextTime) << " " << tempo << " ";
         }
 
-        str << convertTime(m_composition->getTempoChange(tempoCount - 1).first)
+        str << convertTime(tempoChanges[tempoCount - 1].first)
         << " "
-        << int(Composition::getTempoQpm(m_composition->getTempoChange(tempoCount - 1).second))
+        << int(Composition::getTempoQpm(tempoChanges[tempoCount - 1].second))
         << std::endl;
     }
 
     str << "\ne" << std::endl;
-    str.close();
-    return true;
 }
 
 }
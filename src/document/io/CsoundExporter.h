@@ -19,8 +19,13 @@
 #ifndef RG_CSOUNDEXPORTER_H
 #define RG_CSOUNDEXPORTER_H
 
+#include "base/CompositionSnapshot.h"
+
+#include <iosfwd>
 #include <string>
 
+#include <rosegardenprivate_export.h>
+
 
 class QObject;
 
@@ -28,23 +33,30 @@ class QObject;
 namespace Rosegarden
 {
 
-class Composition;
-
 
 /**
  * Csound scorefile export
+ *
+ * Everything is read from a CompositionSnapshot, so the score can be
+ * written on a worker thread while the GUI carries on.
  */
 
-class CsoundExporter
+class ROSEGARDENPRIVATE_EXPORT CsoundExporter
 {
 public:
-    CsoundExporter(QObject *parent, Composition *, const std::string& fileName);
+    CsoundExporter(QObject *parent,
+                   CompositionSnapshot::Ptr snapshot,
+                   const std::string& fileName);
     ~CsoundExporter();
 
+    /// Write the file on a worker thread, keeping the UI alive meanwhile.
     bool write();
 
+    /// Write the score to str.  Safe to call from any thread.
+    void write(std::ostream &str) const;
+
 protected:
-    Composition *m_composition;
+    CompositionSnapshot::Ptr m_snapshot;
     std::string m_fileName;
 };
 
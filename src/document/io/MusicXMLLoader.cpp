@@ -22,7 +22,7 @@
 #include "base/Studio.h"
 #include "document/RosegardenDocument.h"
 #include "document/io/MusicXMLXMLHandler.h"
-#include "document/io/XMLReader.h"
+#include "document/io/MusicXMLPartReader.h"
 
 #include <QFile>
 #include <QObject>
@@ -51,7 +51,8 @@ MusicXMLLoader::load(
 
     MusicXMLXMLHandler handler(doc);
 
-    XMLReader reader;
+    // Parts are read in parallel, then built in order.
+    MusicXMLPartReader reader;
     reader.setHandler(&handler);
 
     bool ok = reader.parse(file);
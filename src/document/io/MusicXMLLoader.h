@@ -18,6 +18,7 @@
 #ifndef RG_MUSICXMLLOADER_H
 #define RG_MUSICXMLLOADER_H
 
+#include <rosegardenprivate_export.h>
 
 class QString;
 
@@ -30,7 +31,7 @@ class RosegardenDocument;
 
 
 /// Load a MusicXML file into a RosegardenDocument.
-class MusicXMLLoader
+class ROSEGARDENPRIVATE_EXPORT MusicXMLLoader
 {
 public:
 
@@ -0,0 +1,630 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A MIDI and audio sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+
+    Other copyrights also apply to some parts of this work.  Please
+    see the AUTHORS file and individual file headers for details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#define RG_MODULE_STRING "[MusicXMLPartReader]"
+#define RG_NO_DEBUG_PRINT 1
+
+#include "MusicXMLPartReader.h"
+
+#include "document/io/XMLHandler.h"
+#include "document/io/XMLReader.h"
+#include "misc/Debug.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QWaitCondition>
+#include <QXmlStreamReader>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <memory>
+
+
+namespace Rosegarden
+{
+
+
+namespace
+{
+    /// One call to make on the XMLHandler.
+    struct Token
+    {
+        QXmlStreamReader::TokenType type;
+        QString namespaceUri;
+        QString name;
+        /// Or the text, for Characters.
+        QString qualifiedName;
+        QXmlStreamAttributes attributes;
+    };
+
+    /// A piece of the file and, once tokenized, its tokens.
+    struct Piece
+    {
+        enum Kind { Header, Part, Trailer };
+
+        Piece(Kind kind, int begin, int end) :
+            kind(kind),
+            begin(begin),
+            end(end)
+        {
+        }
+
+        Kind kind;
+        /// [begin, end) in the file.
+        int begin;
+        int end;
+        /// Whitespace between the previous part and this one.
+        QString gap;
+
+        std::vector<Token> tokens;
+        bool hasError{false};
+        qint64 errorLine{0};
+        qint64 errorColumn{0};
+        QString errorString;
+    };
+
+    bool isSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    bool isNameEnd(char c)
+    {
+        return isSpace(c) || c == '/' || c == '>';
+    }
+
+    /// Offset of the '>' closing the tag starting at from, skipping
+    /// quoted attribute values, or -1.
+    int findTagEnd(const QByteArray &data, int from)
+    {
+        const char *p = data.constData();
+        const int size = data.size();
+        char quote = 0;
+        for (int i = from; i < size; ++i) {
+            if (quote) {
+                if (p[i] == quote) quote = 0;
+            } else if (p[i] == '"' || p[i] == '\'') {
+                quote = p[i];
+            } else if (p[i] == '>') {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    /// Does the XML declaration in [begin, end) name an encoding other
+    /// than UTF-8?
+    bool isForeignEncoding(const QByteArray &data, int begin, int end)
+    {
+        const QByteArray declaration = data.mid(begin, end - begin);
+        int i = declaration.indexOf("encoding");
+        if (i < 0) return false;
+        i += int(strlen("encoding"));
+        while (i < declaration.size() &&
+               (isSpace(declaration[i]) || declaration[i] == '='))
+            ++i;
+        if (i >= declaration.size()) return true;
+        const char quote = declaration[i];
+        const int valueEnd = declaration.indexOf(quote, i + 1);
+        if (valueEnd < 0) return true;
+        const QByteArray encoding =
+            declaration.mid(i + 1, valueEnd - i - 1).toLower();
+        return encoding != "utf-8"  &&  encoding != "utf8";
+    }
+
+    /// Line (from 1) and column (from 0) of offset, the way
+    /// QXmlStreamReader counts them.
+    void position(const QByteArray &data, int offset,
+                  qint64 &line, qint64 &column)
+    {
+        line = 1 + std::count(data.constData(), data.constData() + offset,
+                              '\n');
+        const int lastNewline =
+            (offset > 0) ? data.lastIndexOf('\n', offset - 1) : -1;
+        column = offset - (lastNewline + 1);
+    }
+
+    /// Read one piece of the file into its tokens.
+    /**
+     * Parts and the trailer are read after everything in front of the root
+     * element's start tag (and the tag itself), and the header and parts
+     * before a matching end tag, so each is a document of its own.  The
+     * tokens those add are dropped again.
+     */
+    void tokenize(const QByteArray &data,
+                  const MusicXMLPartReader::Layout &layout,
+                  Piece &piece)
+    {
+        QByteArray document;
+        const QByteArray endTag = "</" + layout.rootName + ">";
+        if (piece.kind == Piece::Header) {
+            document.reserve(piece.end + endTag.size());
+        } else {
+            document.reserve(layout.rootEnd + piece.end - piece.begin +
+                             endTag.size());
+            document.append(data.constData(), layout.rootEnd);
+        }
+        document.append(data.constData() + piece.begin,
+                        piece.end - piece.begin);
+        if (piece.kind != Piece::Trailer)
+            document.append(endTag);
+
+        QXmlStreamReader reader(document);
+
+        // Skip the prolog and the root element we put in front.
+        bool skipping = (piece.kind != Piece::Header);
+
+        if (!piece.gap.isEmpty()) {
+            piece.tokens.push_back(Token{QXmlStreamReader::Characters,
+                                         QString(), QString(), piece.gap,
+                                         QXmlStreamAttributes()});
+        }
+
+        while (!reader.atEnd()) {
+            const QXmlStreamReader::TokenType type = reader.readNext();
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wswitch-enum"
+            switch (type) {
+            case QXmlStreamReader::StartDocument:
+            case QXmlStreamReader::EndDocument:
+                if (!skipping)
+                    piece.tokens.push_back(Token{type, QString(), QString(),
+                                                 QString(),
+                                                 QXmlStreamAttributes()});
+                break;
+            case QXmlStreamReader::StartElement:
+                if (skipping) {
+                    skipping = false;
+                    break;
+                }
+                piece.tokens.push_back(Token{type,
+                                             reader.namespaceUri().toString(),
+                                             reader.name().toString(),
+                                             reader.qualifiedName().toString(),
+                                             reader.attributes()});
+                break;
+            case QXmlStreamReader::EndElement:
+                if (!skipping)
+                    piece.tokens.push_back(Token{type,
+                                             reader.namespaceUri().toString(),
+                                             reader.name().toString(),
+                                             reader.qualifiedName().toString(),
+                                             QXmlStreamAttributes()});
+                break;
+            case QXmlStreamReader::Characters:
+                if (!skipping)
+                    piece.tokens.push_back(Token{type, QString(), QString(),
+                                                 reader.text().toString(),
+                                                 QXmlStreamAttributes()});
+                break;
+            default:
+                break;
+            }
+#pragma GCC diagnostic pop
+        }
+
+        if (reader.hasError()) {
+            piece.hasError = true;
+            piece.errorString = reader.errorString();
+
+            // Back to where that is in the file.
+            if (piece.kind == Piece::Header) {
+                piece.errorLine = reader.lineNumber();
+                piece.errorColumn = reader.columnNumber();
+            } else {
+                qint64 prefixLine, prefixColumn;
+                position(data, layout.rootEnd, prefixLine, prefixColumn);
+                qint64 beginLine, beginColumn;
+                position(data, piece.begin, beginLine, beginColumn);
+                if (reader.lineNumber() == prefixLine) {
+                    piece.errorLine = beginLine;
+                    piece.errorColumn = beginColumn +
+                        std::max<qint64>(0, reader.columnNumber() -
+                                            prefixColumn);
+                } else {
+                    piece.errorLine =
+                        beginLine + reader.lineNumber() - prefixLine;
+                    piece.errorColumn = reader.columnNumber();
+                }
+            }
+            return;
+        }
+
+        // Drop the end tag we added, and the end of that document.
+        if (piece.kind != Piece::Trailer) {
+            while (!piece.tokens.empty()  &&
+                   piece.tokens.back().type != QXmlStreamReader::EndElement)
+                piece.tokens.pop_back();
+            if (!piece.tokens.empty())
+                piece.tokens.pop_back();
+        }
+    }
+
+    /// Pieces that are ready to be handed over, shared with the threads.
+    struct Progress
+    {
+        QMutex mutex;
+        QWaitCondition condition;
+        std::vector<bool> done;
+        /// Pieces handed over and freed so far.
+        size_t replayed{0};
+        /// How many pieces past those may be tokenized.
+        size_t window{1};
+        bool stop{false};
+    };
+
+    class TokenizerThread : public QThread
+    {
+    public:
+        TokenizerThread(const QByteArray &data,
+                        const MusicXMLPartReader::Layout &layout,
+                        std::vector<Piece> &pieces,
+                        std::atomic<size_t> &nextPiece,
+                        Progress &progress) :
+            m_data(data),
+            m_layout(layout),
+            m_pieces(pieces),
+            m_nextPiece(nextPiece),
+            m_progress(progress)
+        {
+        }
+
+    protected:
+        void run() override
+        {
+            while (true) {
+                const size_t index = m_nextPiece.fetch_add(1);
+                if (index >= m_pieces.size())
+                    break;
+
+                {
+                    // Don't get more than the window ahead of the replay.
+                    QMutexLocker locker(&m_progress.mutex);
+                    while (!m_progress.stop  &&
+                           index >= m_progress.replayed + m_progress.window)
+                        m_progress.condition.wait(&m_progress.mutex);
+                    if (m_progress.stop)
+                        break;
+                }
+
+                tokenize(m_data, m_layout, m_pieces[index]);
+
+                QMutexLocker locker(&m_progress.mutex);
+                m_progress.done[index] = true;
+                m_progress.condition.wakeAll();
+            }
+        }
+
+    private:
+        const QByteArray &m_data;
+        const MusicXMLPartReader::Layout &m_layout;
+        std::vector<Piece> &m_pieces;
+        std::atomic<size_t> &m_nextPiece;
+        Progress &m_progress;
+    };
+}
+
+
+MusicXMLPartReader::MusicXMLPartReader() :
+    m_handler(nullptr),
+    m_threadCount(std::max(1, QThread::idealThreadCount()))
+{
+}
+
+void
+MusicXMLPartReader::setHandler(XMLHandler *handler)
+{
+    m_handler = handler;
+}
+
+void
+MusicXMLPartReader::setThreadCount(int threads)
+{
+    m_threadCount = std::max(1, threads);
+}
+
+bool
+MusicXMLPartReader::parse(QFile &file)
+{
+    if (!m_handler) return false;
+
+    // No Text mode: the bytes are cut up as they are on disk, and
+    // QXmlStreamReader normalizes the line ends in each piece.
+    if (!file.open(QFile::ReadOnly)) {
+        qWarning() << "MusicXMLPartReader could not open file"
+                   << file.fileName();
+        return false;
+    }
+
+    // Map the file rather than reading it in, so the pages are only
+    // brought in as the threads get to them and are never copied whole.
+    QByteArray data;
+    uchar *mapped = nullptr;
+    if (file.size() <= std::numeric_limits<int>::max()) {
+        mapped = file.map(0, file.size());
+        if (mapped) {
+            data = QByteArray::fromRawData(
+                    reinterpret_cast<const char *>(mapped),
+                    int(file.size()));
+        } else {
+            // Not something that can be mapped, a pipe, say.
+            data = file.readAll();
+        }
+    }
+
+    Layout layout;
+    const bool partwise = !data.isEmpty()  &&  split(data, layout);
+    bool ok = false;
+    if (partwise)
+        ok = parse(data, layout);
+
+    // data must not outlive the mapping.
+    data.clear();
+    if (mapped)
+        file.unmap(mapped);
+    file.close();
+
+    if (partwise)
+        return ok;
+
+    RG_DEBUG << "parse(): reading" << file.fileName() << "in one piece";
+    XMLReader reader;
+    reader.setHandler(m_handler);
+    return reader.parse(file);
+}
+
+bool
+MusicXMLPartReader::split(const QByteArray &data, Layout &layout)
+{
+    layout = Layout();
+
+    const char *p = data.constData();
+    const int size = data.size();
+    int i = 0;
+
+    // Only UTF-8 can be cut up as bytes.
+    if (size >= 2  &&
+        ((uchar(p[0]) == 0xfe  &&  uchar(p[1]) == 0xff)  ||
+         (uchar(p[0]) == 0xff  &&  uchar(p[1]) == 0xfe)))
+        return false;
+    if (data.startsWith("\xef\xbb\xbf"))
+        i = 3;
+    const int start = i;
+
+    int depth = 0;
+    bool rootSeen = false;
+    int partBegin = -1;
+    // Whether anything but whitespace has come since the last part.
+    bool dirty = false;
+
+    while (i < size) {
+        const bool betweenParts =
+            (depth == 1  &&  partBegin < 0  &&  !layout.parts.empty());
+
+        if (p[i] != '<') {
+            const char *next = static_cast<const char *>(
+                    memchr(p + i, '<', size - i));
+            const int textEnd = next ? int(next - p) : size;
+            if (betweenParts) {
+                for (int j = i; j < textEnd; ++j) {
+                    if (!isSpace(p[j])) dirty = true;
+                }
+            }
+            i = textEnd;
+            continue;
+        }
+
+        if (data.mid(i, 4) == "<!--") {
+            const int end = data.indexOf("-->", i + 4);
+            if (end < 0) return false;
+            if (betweenParts) dirty = true;
+            i = end + 3;
+        } else if (data.mid(i, 9) == "<![CDATA[") {
+            const int end = data.indexOf("]]>", i + 9);
+            if (end < 0) return false;
+            if (betweenParts) dirty = true;
+            i = end + 3;
+        } else if (data.mid(i, 2) == "<!") {
+            // DOCTYPE.  An internal subset could declare entities or
+            // default attributes that each part would need.
+            if (depth != 0) return false;
+            int end = i + 2;
+            while (end < size  &&  p[end] != '>') {
+                if (p[end] == '[') return false;
+                ++end;
+            }
+            if (end >= size) return false;
+            i = end + 1;
+        } else if (data.mid(i, 2) == "<?") {
+            const int end = data.indexOf("?>", i + 2);
+            if (end < 0) return false;
+            if (i == start  &&  data.mid(i, 6) == "<?xml "  &&
+                isForeignEncoding(data, i, end))
+                return false;
+            if (betweenParts) dirty = true;
+            i = end + 2;
+        } else if (data.mid(i, 2) == "</") {
+            const int end = findTagEnd(data, i + 2);
+            if (end < 0) return false;
+            int nameEnd = i + 2;
+            while (nameEnd < end  &&  !isNameEnd(p[nameEnd])) ++nameEnd;
+            const QByteArray name = data.mid(i + 2, nameEnd - i - 2);
+
+            --depth;
+            if (depth < 0) return false;
+            if (depth == 1  &&  partBegin >= 0) {
+                if (name != "part") return false;
+                layout.parts.push_back(std::make_pair(partBegin, end + 1));
+                partBegin = -1;
+                dirty = false;
+            }
+            if (depth == 0  &&  name != layout.rootName) return false;
+            i = end + 1;
+        } else {
+            const int end = findTagEnd(data, i + 1);
+            if (end < 0) return false;
+            int nameEnd = i + 1;
+            while (nameEnd < end  &&  !isNameEnd(p[nameEnd])) ++nameEnd;
+            const QByteArray name = data.mid(i + 1, nameEnd - i - 1);
+            const bool empty = (p[end - 1] == '/');
+
+            if (depth == 0) {
+                if (rootSeen  ||  empty) return false;
+                if (name != "score-partwise") return false;
+                rootSeen = true;
+                layout.rootName = name;
+                layout.rootEnd = end + 1;
+            } else if (depth == 1) {
+                if (name == "part") {
+                    if (dirty) return false;
+                    if (empty)
+                        layout.parts.push_back(std::make_pair(i, end + 1));
+                    else
+                        partBegin = i;
+                } else if (!layout.parts.empty()) {
+                    dirty = true;
+                }
+            }
+
+            if (!empty) ++depth;
+            i = end + 1;
+        }
+    }
+
+    return rootSeen  &&  depth == 0  &&  !layout.parts.empty();
+}
+
+bool
+MusicXMLPartReader::parse(const QByteArray &data, const Layout &layout)
+{
+    // The header, each part, and whatever follows the last one.
+    std::vector<Piece> pieces;
+    pieces.reserve(layout.parts.size() + 2);
+    pieces.push_back(Piece(Piece::Header, 0, layout.parts.front().first));
+    int previousEnd = -1;
+    for (const std::pair<int, int> &part : layout.parts) {
+        pieces.push_back(Piece(Piece::Part, part.first, part.second));
+        if (previousEnd >= 0  &&  part.first > previousEnd) {
+            // As QXmlStreamReader would normalize the line ends.
+            QString gap = QString::fromLatin1(data.constData() + previousEnd,
+                                              part.first - previousEnd);
+            gap.replace(QLatin1String("\r\n"), QLatin1String("\n"));
+            gap.replace(QLatin1Char('\r'), QLatin1Char('\n'));
+            pieces.back().gap = gap;
+        }
+        previousEnd = part.second;
+    }
+    pieces.push_back(Piece(Piece::Trailer, previousEnd, int(data.size())));
+
+    const size_t threadCount =
+        std::min(size_t(m_threadCount), pieces.size());
+
+    Progress progress;
+    progress.done.resize(pieces.size(), false);
+    // The piece being handed over, and one for each thread.
+    progress.window = threadCount + 1;
+    std::atomic<size_t> nextPiece(0);
+    std::vector<std::unique_ptr<TokenizerThread>> threads;
+    for (size_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back(new TokenizerThread(
+                data, layout, pieces, nextPiece, progress));
+        threads.back()->start();
+    }
+
+    // Hand each piece over in order as soon as it is ready.
+    bool ok = true;
+    bool stop = false;
+    for (size_t index = 0; index < pieces.size()  &&  !stop; ++index) {
+        while (true) {
+            QMutexLocker locker(&progress.mutex);
+            if (progress.done[index])
+                break;
+            if (!progress.condition.wait(&progress.mutex, 50)) {
+                // Keep the UI alive while the parts are read.
+                locker.unlock();
+                QCoreApplication::processEvents();
+            }
+        }
+
+        Piece &piece = pieces[index];
+        for (const Token &token : piece.tokens) {
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wswitch-enum"
+            switch (token.type) {
+            case QXmlStreamReader::StartDocument:
+                ok = m_handler->startDocument();
+                break;
+            case QXmlStreamReader::EndDocument:
+                ok = m_handler->endDocument();
+                break;
+            case QXmlStreamReader::StartElement:
+                ok = m_handler->startElement(token.namespaceUri, token.name,
+                                             token.qualifiedName,
+                                             token.attributes);
+                break;
+            case QXmlStreamReader::EndElement:
+                ok = m_handler->endElement(token.namespaceUri, token.name,
+                                           token.qualifiedName);
+                break;
+            case QXmlStreamReader::Characters:
+                ok = m_handler->characters(token.qualifiedName);
+                break;
+            default:
+                break;
+            }
+#pragma GCC diagnostic pop
+            if (!ok) break;
+        }
+        std::vector<Token>().swap(piece.tokens);
+
+        {
+            QMutexLocker locker(&progress.mutex);
+            ++progress.replayed;
+            progress.condition.wakeAll();
+        }
+
+        if (!ok) {
+            qDebug() << m_handler->errorString();
+            stop = true;
+        } else if (piece.hasError) {
+            RG_DEBUG << "error";
+            m_handler->fatalError(piece.errorLine, piece.errorColumn,
+                                  piece.errorString);
+            stop = true;
+        }
+    }
+
+    // Nothing new gets started, and nothing waits for the replay.
+    if (stop) {
+        nextPiece.store(pieces.size());
+        QMutexLocker locker(&progress.mutex);
+        progress.stop = true;
+        progress.condition.wakeAll();
+    }
+    for (std::unique_ptr<TokenizerThread> &thread : threads)
+        thread->wait();
+
+    return ok;
+}
+
+
+}
@@ -0,0 +1,103 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A MIDI and audio sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+
+    Other copyrights also apply to some parts of this work.  Please
+    see the AUTHORS file and individual file headers for details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#ifndef RG_MUSICXMLPARTREADER_H
+#define RG_MUSICXMLPARTREADER_H
+
+#include <QByteArray>
+
+#include <rosegardenprivate_export.h>
+
+#include <utility>
+#include <vector>
+
+class QFile;
+
+
+namespace Rosegarden
+{
+
+
+class XMLHandler;
+
+
+/// Reads a partwise MusicXML file, tokenizing its parts in parallel.
+/**
+ * A partwise file is a header (identification, part-list, ...) followed
+ * by one <part> element per part.  MusicXMLPartReader cuts the file at
+ * those elements and runs each through its own QXmlStreamReader on a pool
+ * of threads.  The tokens are handed to the XMLHandler on the calling
+ * thread, in document order, as each part becomes ready, so the handler
+ * sees exactly the calls XMLReader would have made.
+ *
+ * The handler itself still runs on one thread.  It builds Tracks and
+ * Segments in the document's Composition, and neither that nor the
+ * PropertyName table behind every Event is safe to share between threads.
+ *
+ * The file is mapped rather than read in.  A part's tokens take about
+ * twenty times the bytes of the part (three QStrings and an attribute list
+ * for every tag and run of text), so the threads only get one part each
+ * ahead of the part being handed over, and each part's tokens are freed
+ * once the handler has seen them.  With a 7MB, 24 part score and eight
+ * threads that is about 60MB at most, where holding every part until its
+ * turn came could take 160MB.
+ *
+ * Files that split() can't cut up safely are read by XMLReader instead.
+ */
+class ROSEGARDENPRIVATE_EXPORT MusicXMLPartReader
+{
+public:
+    MusicXMLPartReader();
+
+    void setHandler(XMLHandler *handler);
+
+    /// Defaults to QThread::idealThreadCount().
+    void setThreadCount(int threads);
+
+    /// Same as XMLReader::parse(QFile &).
+    bool parse(QFile &file);
+
+    /// Where the parts are in a partwise file.
+    struct Layout
+    {
+        /// End of the root element's start tag.  Everything before this
+        /// is put in front of each part so it is read in the same context.
+        int rootEnd{0};
+        QByteArray rootName;
+        /// [begin, end) of each top level <part> element, in order.
+        std::vector<std::pair<int, int> > parts;
+    };
+
+    /**
+     * Find the parts in data.  Returns false if the file should be read in
+     * one piece: it is not score-partwise, not UTF-8, has an internal DTD
+     * subset, has anything but whitespace between two parts, has no parts,
+     * or is not well-formed enough to tell.
+     */
+    static bool split(const QByteArray &data, Layout &layout);
+
+private:
+    bool parse(const QByteArray &data, const Layout &layout);
+
+    XMLHandler *m_handler;
+    int m_threadCount;
+};
+
+
+}
+
+#endif
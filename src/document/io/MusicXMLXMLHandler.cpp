@@ -80,7 +80,9 @@ MusicXMLXMLHandler::MusicXMLXMLHandler(RosegardenDocument *doc) :
         m_clefoctavechange(0),
         m_midiChannel(0),
         m_midiProgram(0)
-{}
+{
+    m_processEventsTimer.start();
+}
 
 MusicXMLXMLHandler::~MusicXMLXMLHandler()
 {
@@ -120,7 +122,11 @@ MusicXMLXMLHandler::startElement(const QString& /*namespaceURI*/,
                                  const QString& qName,
                                  const QXmlStreamAttributes& atts)
 {
-    qApp->processEvents();
+    // Keep the UI alive, without an event loop pass for every element.
+    if (m_processEventsTimer.elapsed() >= 50) {
+        qApp->processEvents();
+        m_processEventsTimer.restart();
+    }
 
     // If m_ignored is not an empty string it contains the name of an element
     // which will be ignored, including all it children.
@@ -28,8 +28,11 @@
 #include "document/io/XMLHandler.h"
 
 #include <QCoreApplication>
+#include <QElapsedTimer>
 #include <QString>
 
+#include <rosegardenprivate_export.h>
+
 #include <string>
 #include <vector>
 #include <queue>
@@ -43,7 +46,7 @@ class RosegardenDocument;
 class Segment;
 
 
-class MusicXMLXMLHandler : public XMLHandler
+class ROSEGARDENPRIVATE_EXPORT MusicXMLXMLHandler : public XMLHandler
 {
     Q_DECLARE_TR_FUNCTIONS(Rosegarden::MusicXMLXMLHandler)
 
@@ -159,6 +162,9 @@ protected:
 
     QString         m_errormessage;
 
+    /// Since the UI last got a look in.
+    QElapsedTimer   m_processEventsTimer;
+
     PartMap         m_parts;
 
     int             m_number;
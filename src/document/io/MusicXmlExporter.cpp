@@ -28,6 +28,7 @@
 
 #include "misc/ConfigGroups.h"
 #include "misc/Debug.h"
+#include "misc/Preferences.h"
 #include "base/StaffExportTypes.h"
 #include "gui/application/RosegardenMainWindow.h"
 #include "gui/application/RosegardenMainViewWidget.h"
@@ -77,19 +78,17 @@ MusicXmlExporter::readConfigVariables()
     // grab settings info
     QSettings settings;
 
-    settings.beginGroup(NotationOptionsConfigGroup);
-    int accOctaveMode = settings.value("accidentaloctavemode", 1).toInt() ;
+    int accOctaveMode = Preferences::getAccidentalOctaveMode();
     m_octaveType =
         (accOctaveMode == 0 ? AccidentalTable::OctavesIndependent :
          accOctaveMode == 1 ? AccidentalTable::OctavesCautionary :
          AccidentalTable::OctavesEquivalent);
 
-    int accBarMode = settings.value("accidentalbarmode", 0).toInt() ;
+    int accBarMode = Preferences::getAccidentalBarMode();
     m_barResetType =
         (accBarMode == 0 ? AccidentalTable::BarResetNone :
          accBarMode == 1 ? AccidentalTable::BarResetCautionary :
          AccidentalTable::BarResetExplicit);
-    settings.endGroup();
 
     settings.beginGroup(MusicXMLExportConfigGroup);
     m_exportSelection = settings.value("mxmlexportselection",
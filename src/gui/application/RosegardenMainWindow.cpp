@@ -2641,7 +2641,38 @@ RosegardenMainWindow::slotGrooveQuantize()
     }
 
     Segment *s = *selection.begin();
-    m_view->slotAddCommandToHistory(new CreateTempoMapFromSegmentCommand(s));
+
+    if (s->getType() != Segment::Audio) {
+        m_view->slotAddCommandToHistory(new CreateTempoMapFromSegmentCommand(s));
+        return;
+    }
+
+    // For audio, find the beats in the audio itself.
+
+    Composition &comp = RosegardenDocument::currentDocument->getComposition();
+
+    std::vector<RealTime> beats;
+    {
+        SetWaitCursor waitCursor;
+        beats = RosegardenDocument::currentDocument->getAudioFileManager().
+                getBeatTimes(s->getAudioFileId(),
+                             s->getAudioStartTime(),
+                             s->getAudioEndTime());
+    }
+
+    if (beats.size() < 2) {
+        QMessageBox::warning(this, tr("Rosegarden"), tr("No beats could be found in the selected audio segment."));
+        return;
+    }
+
+    // Beat times are relative to the start of the audio file.
+    const RealTime offset =
+            comp.getElapsedRealTime(s->getStartTime()) - s->getAudioStartTime();
+    for (size_t i = 0; i < beats.size(); ++i)
+        beats[i] = beats[i] + offset;
+
+    m_view->slotAddCommandToHistory(new CreateTempoMapFromSegmentCommand(
+            &comp, comp.getElapsedTimeForRealTime(beats[0]), beats));
 }
 
 void
@@ -2899,7 +2930,10 @@ RosegardenMainWindow::slotAutoSplitSelection()
                 command->addCommand(
                     new AudioSegmentAutoSplitCommand(RosegardenDocument::currentDocument,
                                                      *i,
-                                                     aSD.getThreshold()));
+                                                     aSD.getThreshold(),
+                                                     aSD.getSplitOnTransients() ?
+                                                         AudioSegmentAutoSplitCommand::SplitOnTransients :
+                                                         AudioSegmentAutoSplitCommand::SplitOnSilence));
             }
         } else {
             command->addCommand(new SegmentAutoSplitCommand(*i));
@@ -5327,7 +5361,7 @@ RosegardenMainWindow::exportCsoundFile(QString file)
 
     CsoundExporter csoundExporter(
             this,  // parent
-            &RosegardenDocument::currentDocument->getComposition(),  // composition
+            RosegardenDocument::currentDocument->takeSnapshot(),  // snapshot
             std::string(file.toLocal8Bit()));  // fileName
 
     if (!csoundExporter.write()) {
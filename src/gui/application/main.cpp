@@ -18,6 +18,7 @@
 #include "misc/ConfigGroups.h"
 #include "misc/Strings.h"
 #include "misc/Debug.h"
+#include "misc/RealtimeDebug.h"
 #include "gui/application/RosegardenMainWindow.h"
 #include "document/RosegardenDocument.h"
 #include "gui/widgets/StartupLogo.h"
@@ -29,6 +30,7 @@
 #include "misc/Preferences.h"
 
 #include "sound/MidiFile.h"
+#include "sound/audiostream/MappedWavFileReadStream.h"
 #include "sound/audiostream/WavFileReadStream.h"
 #include "sound/audiostream/WavFileWriteStream.h"
 #include "sound/audiostream/OggVorbisReadStream.h"
@@ -390,6 +392,9 @@ int main(int argc, char *argv[])
     // This fixes bug #1503 (Audio files can't be read when RG is built in
     // release mode).
 
+    // Before WavFileReadStream, so that it gets first go at WAV files.
+    MappedWavFileReadStream::initStaticObjects();
+
 #ifdef HAVE_LIBSNDFILE
     WavFileReadStream::initStaticObjects();
     WavFileWriteStream::initStaticObjects();
@@ -790,6 +795,9 @@ int main(int argc, char *argv[])
     }
     settings.endGroup();
 
+    // Debug output from the audio and MIDI threads goes through this.
+    RTDebug::start();
+
     RG_INFO << "Launching the sequencer...";
 
     try {
@@ -822,6 +830,8 @@ int main(int argc, char *argv[])
 
     int returnCode = theApp.exec();
 
+    RTDebug::stop();
+
     // Announce end of run so that we can tell if we have crashed on
     // the way down.
     RG_INFO << "Rosegarden main() exiting with rc:" << returnCode;
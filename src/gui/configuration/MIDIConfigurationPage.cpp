@@ -75,8 +75,7 @@ MIDIConfigurationPage::MIDIConfigurationPage(QWidget *parent):
     m_baseOctaveNumber = new QSpinBox;
     m_baseOctaveNumber->setMinimum(-10);
     m_baseOctaveNumber->setMaximum(10);
-    m_baseOctaveNumber->setValue(
-            settings.value("midipitchoctave", -2).toInt());
+    m_baseOctaveNumber->setValue(Preferences::getMIDIPitchOctave());
     connect(m_baseOctaveNumber,
                 static_cast<void(QSpinBox::*)(int)>(&QSpinBox::valueChanged),
             this, &MIDIConfigurationPage::slotModified);
@@ -187,9 +186,8 @@ MIDIConfigurationPage::MIDIConfigurationPage(QWidget *parent):
 
     m_allowResetAllControllers = new QCheckBox;
     m_allowResetAllControllers->setToolTip(toolTip);
-    const bool allowResetAllControllers =
-            settings.value("allowresetallcontrollers", true).toBool();
-    m_allowResetAllControllers->setChecked(allowResetAllControllers);
+    m_allowResetAllControllers->setChecked(
+            Preferences::getAllowResetAllControllers());
     connect(m_allowResetAllControllers, &QCheckBox::stateChanged,
             this, &MIDIConfigurationPage::slotModified);
     layout->addWidget(m_allowResetAllControllers, row, 2);
@@ -347,7 +345,7 @@ MIDIConfigurationPage::MIDIConfigurationPage(QWidget *parent):
     m_midiClock->addItem(tr("Send MIDI Clock, Start and Stop"));
     m_midiClock->addItem(tr("Accept Start, Stop and Continue"));
 
-    int midiClock = settings.value("midiclock", 0).toInt();
+    int midiClock = Preferences::getMIDIClock();
     if (midiClock < 0  ||  midiClock > 2)
         midiClock = 0;
     m_midiClock->setCurrentIndex(midiClock);
@@ -489,7 +487,7 @@ MIDIConfigurationPage::apply()
     QSettings settings;
     settings.beginGroup(GeneralOptionsConfigGroup);
 
-    settings.setValue("midipitchoctave", m_baseOctaveNumber->value());
+    Preferences::setMIDIPitchOctave(m_baseOctaveNumber->value());
     settings.setValue("alwaysusedefaultstudio",
                       m_useDefaultStudio->isChecked());
 
@@ -513,8 +511,8 @@ MIDIConfigurationPage::apply()
 
     settings.beginGroup(SequencerOptionsConfigGroup);
 
-    settings.setValue("allowresetallcontrollers",
-                      m_allowResetAllControllers->isChecked());
+    Preferences::setAllowResetAllControllers(
+            m_allowResetAllControllers->isChecked());
 
     Preferences::setSendProgramChangesWhenLooping(
             m_sendProgramChangesWhenLooping->isChecked());
@@ -541,7 +539,7 @@ MIDIConfigurationPage::apply()
 
     // MIDI Clock and System messages
     const int midiClock = m_midiClock->currentIndex();
-    settings.setValue("midiclock", midiClock);
+    Preferences::setMIDIClock(midiClock);
 
     // Now send it (OLD METHOD - to be removed)
     // !!! No, don't remove -- this controls SPP as well doesn't it?
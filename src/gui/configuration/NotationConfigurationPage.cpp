@@ -20,6 +20,7 @@
 
 #include "misc/Strings.h"
 #include "misc/ConfigGroups.h"
+#include "misc/Preferences.h"
 #include "base/Exception.h"
 #include "base/NotationTypes.h"
 #include "commands/edit/PasteEventsCommand.h"
@@ -152,8 +153,7 @@ NotationConfigurationPage::NotationConfigurationPage(QWidget *parent) :
          row, 0, 1, 2);
     m_showInvisibles = new QCheckBox(frame);
     connect(m_showInvisibles, &QCheckBox::stateChanged, this, &NotationConfigurationPage::slotModified);
-    bool defaultShowInvisibles = qStrToBool(settings.value("showinvisibles", "true")) ;
-    m_showInvisibles->setChecked(defaultShowInvisibles);
+    m_showInvisibles->setChecked(Preferences::getShowInvisibles());
     layout->addWidget(m_showInvisibles, row, 2);
     ++row;
 
@@ -395,7 +395,7 @@ NotationConfigurationPage::NotationConfigurationPage(QWidget *parent) :
     m_accOctavePolicy->addItem(tr("Affect only that octave"));
     m_accOctavePolicy->addItem(tr("Require cautionaries in other octaves"));
     m_accOctavePolicy->addItem(tr("Affect all subsequent octaves"));
-    int accOctaveMode = settings.value("accidentaloctavemode", 1).toInt() ;
+    int accOctaveMode = Preferences::getAccidentalOctaveMode();
     if (accOctaveMode >= 0 && accOctaveMode < 3) {
         m_accOctavePolicy->setCurrentIndex(accOctaveMode);
     }
@@ -411,7 +411,7 @@ NotationConfigurationPage::NotationConfigurationPage(QWidget *parent) :
     m_accBarPolicy->addItem(tr("Affect only that bar"));
     m_accBarPolicy->addItem(tr("Require cautionary resets in following bar"));
     m_accBarPolicy->addItem(tr("Require explicit resets in following bar"));
-    int accBarMode = settings.value("accidentalbarmode", 0).toInt() ;
+    int accBarMode = Preferences::getAccidentalBarMode();
     if (accBarMode >= 0 && accBarMode < 3) {
         m_accBarPolicy->setCurrentIndex(accBarMode);
     }
@@ -539,8 +539,8 @@ NotationConfigurationPage::NotationConfigurationPage(QWidget *parent) :
     m_textFont = new FontRequester(frame);
     connect(m_textFont, &FontRequester::fontChanged, this, &NotationConfigurationPage::slotModified);
     QFont textFont = defaultTextFont;
-    QVariant fv = settings.value("textfont", textFont);
-    if (fv.canConvert<QFont>()) textFont = fv.value<QFont>();
+    textFont.fromString(Preferences::getNotationTextFont(
+            NotePixmapFactory::defaultSerifFontFamily));
     m_textFont->setFont(textFont);
     layout->addWidget(m_textFont, row, 1, 1, 3);
     ++row;
@@ -550,8 +550,8 @@ NotationConfigurationPage::NotationConfigurationPage(QWidget *parent) :
     m_sansFont = new FontRequester(frame);
     connect(m_sansFont, &FontRequester::fontChanged, this, &NotationConfigurationPage::slotModified);
     QFont sansFont = defaultTextFont;
-    fv = settings.value("sansfont", sansFont);
-    if (fv.canConvert<QFont>()) sansFont = fv.value<QFont>();
+    sansFont.fromString(Preferences::getNotationSansFont(
+            NotePixmapFactory::defaultSerifFontFamily));
     m_sansFont->setFont(sansFont);
     layout->addWidget(m_sansFont, row, 1, 1, 3);
 
@@ -737,13 +737,13 @@ NotationConfigurationPage::apply()
                       m_singleStaffSize->currentText().toUInt());
     settings.setValue("multistaffnotesize",
                       m_multiStaffSize->currentText().toUInt());
-    settings.setValue("textfont", m_textFont->getFont());
-    settings.setValue("sansfont", m_sansFont->getFont());
+    Preferences::setNotationTextFont(m_textFont->getFont());
+    Preferences::setNotationSansFont(m_sansFont->getFont());
 
     settings.setValue("layoutmode", m_layoutMode->currentIndex());
     settings.setValue("colourquantize", m_colourQuantize->isChecked());
     settings.setValue("showunknowns", m_showUnknowns->isChecked());
-    settings.setValue("showinvisibles", m_showInvisibles->isChecked());
+    Preferences::setShowInvisibles(m_showInvisibles->isChecked());
     settings.setValue("showranges", m_showRanges->isChecked());
     settings.setValue("showcollisions", m_showCollisions->isChecked());
     settings.setValue("shownotationheader",
@@ -757,8 +757,8 @@ NotationConfigurationPage::apply()
     settings.setValue("alwayspreview", m_preview->isChecked());
     settings.setValue("quickedit", m_quickEdit->isChecked());
 
-    settings.setValue("accidentaloctavemode", m_accOctavePolicy->currentIndex());
-    settings.setValue("accidentalbarmode", m_accBarPolicy->currentIndex());
+    Preferences::setAccidentalOctaveMode(m_accOctavePolicy->currentIndex());
+    Preferences::setAccidentalBarMode(m_accBarPolicy->currentIndex());
     settings.setValue("keysigcancelmode", m_keySigCancelMode->currentIndex());
 
     settings.setValue("quantizemakeviable", m_splitAndTie->isChecked());
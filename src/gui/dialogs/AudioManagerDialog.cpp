@@ -742,10 +742,12 @@ AudioManagerDialog::slotAdd()
     const QStringList fileList = FileDialog::getOpenFileNames(this, tr("Select one or more audio files"), directory, extensionList);
 
     QDir d;
+    QList<QUrl> urls;
     for (int i = 0 ; i < fileList.size(); i++) {
-        addFile(QUrl::fromLocalFile(fileList.at(i)));
+        urls << QUrl::fromLocalFile(fileList.at(i));
         d = QFileInfo(fileList.at(i)).dir();
     }
+    addFiles(urls);
 
     // pick the directory from the last URL encountered to save for future
     // reference, but don't store anything if no URLs were encountered (ie. the
@@ -1147,9 +1149,10 @@ AudioManagerDialog::closePlayingDialog(AudioFileId id)
 }
 
 bool
-AudioManagerDialog::addFile(const QUrl& kurl)
+AudioManagerDialog::addFiles(const QList<QUrl> &urls)
 {
-    AudioFileId id = 0;
+    if (urls.empty())
+        return true;
 
     AudioFileManager &aFM = m_doc->getAudioFileManager();
 
@@ -1157,13 +1160,8 @@ AudioManagerDialog::addFile(const QUrl& kurl)
         return false;
     }
 
-    // If multiple audio files are added concurrently, this implementation
-    // looks funny to the user, but it is functional for now.  NO time for
-    // a more robust solution.
-    // ??? By "looks funny" I assume this means that it pops up a new
-    //     progress dialog for each file being added.  Moving the
-    //     QProgressDialog up the call stack shouldn't be too hard.
-    //     That might cover one of the cases anyway.
+    // One progress dialog for the lot.  AudioFileManager::importURLs()
+    // converts the files in parallel.
 
     // Progress Dialog
     // Note: The label text and range will be set later as needed.
@@ -1189,32 +1187,43 @@ AudioManagerDialog::addFile(const QUrl& kurl)
     // Flush the event queue.
     qApp->processEvents(QEventLoop::AllEvents);
 
-    try {
-        id = aFM.importURL(kurl, m_sampleRate);
-    } catch (const AudioFileManager::BadAudioPathException &e) {
-        QString errorString = tr("Failed to add audio file. ") + strtoqstr(e.getMessage());
-        QMessageBox::warning(this, tr("Rosegarden"), errorString);
-        return false;
-    } catch (const SoundFile::BadSoundFileException &e) {
-        QString errorString = tr("Failed to add audio file. ") + strtoqstr(e.getMessage());
+    QStringList errors;
+    const std::vector<AudioFileId> ids =
+            aFM.importURLs(urls, m_sampleRate, errors);
+
+    if (!errors.isEmpty()) {
+        QString errorString = tr("Failed to add audio file. ") +
+                errors.join("\n");
         QMessageBox::warning(this, tr("Rosegarden"), errorString);
-        return false;
     }
 
-    try {
-        aFM.generatePreview(id);
-    } catch (const Exception &e) {
-        QString message = strtoqstr(e.getMessage()) + "\n\n" +
-                          tr("Try copying this file to a directory where you have write permission and re-add it");
-        QMessageBox::information(this, tr("Rosegarden"), message);
+    bool added = false;
+
+    for (AudioFileId id : ids) {
+        if (id == 0)
+            continue;
+
+        try {
+            aFM.generatePreview(id);
+        } catch (const Exception &e) {
+            QString message = strtoqstr(e.getMessage()) + "\n\n" +
+                              tr("Try copying this file to a directory where you have write permission and re-add it");
+            QMessageBox::information(this, tr("Rosegarden"), message);
+        }
+
+        added = true;
     }
 
-    slotPopulateFileList();
+    if (added)
+        slotPopulateFileList();
 
     // tell the sequencer
-    emit addAudioFile(id);
+    for (AudioFileId id : ids) {
+        if (id != 0)
+            emit addAudioFile(id);
+    }
 
-    return true;
+    return errors.isEmpty();
 }
 
 
@@ -1223,11 +1232,7 @@ AudioManagerDialog::slotDropped(QDropEvent* /* event */, QTreeWidget*, const QLi
     /// signaled from AudioListView on dropEvent, sl = list of items (URLs)
     if( sl.empty() ) return;
 
-    // iterate over dropped URIs
-    for( int i=0; i<sl.count(); i++ ) {
-        //RG_DEBUG << "slotDropped() - Adding DroppedFile " << sl.at(i);
-        addFile( sl.at(i) );
-    }
+    addFiles(sl);
 }
 
 //void
@@ -1248,7 +1253,7 @@ AudioManagerDialog::slotDropped(QDropEvent* /* event */, QTreeWidget*, const QLi
 
             RG_DEBUG << "AudioManagerDialog::dropEvent() : got " << url;
 
-            addFile(QUrl(url));
+            addFiles(QList<QUrl>() << QUrl(url));
         }
 //    }// end if QUriDrag
 */
@@ -1284,7 +1289,7 @@ AudioManagerDialog::addAudioFile(const QString &filePath)
 {
     QString fp = QFileInfo(filePath).absoluteFilePath();
     //RG_DEBUG << "addAudioFile(): fp =" << fp;
-    return addFile(QUrl::fromLocalFile(fp));
+    return addFiles(QList<QUrl>() << QUrl::fromLocalFile(fp));
 }
 
 bool
@@ -172,7 +172,11 @@ protected slots:
     void slotCancelPlayingAudio();
 
 protected:
-    bool addFile(const QUrl& kurl);
+    /// Import the files, converting them in parallel.
+    /**
+     * Returns true if all of them were added.
+     */
+    bool addFiles(const QList<QUrl> &urls);
     bool isSelectedTrackAudio();
     void selectFileListItemNoSignal(QTreeWidgetItem*);
     void updateActionState(bool haveSelection);
@@ -26,6 +26,7 @@
 #include "base/Segment.h"
 #include "document/RosegardenDocument.h"
 #include "gui/application/RosegardenApplication.h"
+#include "gui/application/SetWaitCursor.h"
 #include "sound/AudioFileManager.h"
 
 #include <QDialog>
@@ -36,6 +37,7 @@
 #include <QPalette>
 #include <QScrollArea>
 #include <QSpinBox>
+#include <QComboBox>
 #include <QString>
 #include <QWidget>
 #include <QVBoxLayout>
@@ -61,7 +63,8 @@ AudioSplitDialog::AudioSplitDialog(QWidget *parent,
         m_sceneWidth(500),
         m_sceneHeight(200),
         m_previewWidth(400),
-        m_previewHeight(100)
+        m_previewHeight(100),
+        m_haveOnsetAnalysis(false)
 {
     if (!segment || segment->getType() != Segment::Audio)
         reject();
@@ -96,6 +99,16 @@ AudioSplitDialog::AudioSplitDialog(QWidget *parent,
     hbox->setLayout(hboxLayout);
     boxLayout->addWidget(hbox);
 
+    label = new QLabel(tr("Split on"));
+    hboxLayout->addWidget(label);
+    m_modeCombo = new QComboBox;
+    m_modeCombo->addItem(tr("Silence"));
+    m_modeCombo->addItem(tr("Transients"));
+    hboxLayout->addWidget(m_modeCombo);
+    connect(m_modeCombo,
+            static_cast<void(QComboBox::*)(int)>(&QComboBox::activated),
+            this, &AudioSplitDialog::slotModeChanged);
+
     label = new QLabel(tr("Threshold"));
     hboxLayout->addWidget(label);
     m_thresholdSpin = new QSpinBox;
@@ -286,11 +299,28 @@ AudioSplitDialog::drawSplits(int threshold)
     RealTime endTime = m_segment->getAudioEndTime();
 
     AudioFileManager &aFM = m_doc->getAudioFileManager();
-    std::vector<SplitPointPair> splitPoints =
-        aFM.getSplitPoints(m_segment->getAudioFileId(),
-                           startTime,
-                           endTime,
-                           threshold);
+    std::vector<SplitPointPair> splitPoints;
+    if (getSplitOnTransients()) {
+        if (!m_haveOnsetAnalysis) {
+            // If the file can't be read the analysis stays empty, and
+            // there's no point trying again.
+            SetWaitCursor waitCursor;
+            aFM.getOnsetAnalysis(m_segment->getAudioFileId(),
+                                 startTime,
+                                 endTime,
+                                 m_onsetAnalysis);
+            m_haveOnsetAnalysis = true;
+        }
+
+        // Matches AudioSegmentAutoSplitCommand.
+        splitPoints = AudioFileManager::getOnsetSplitPoints(
+                m_onsetAnalysis, endTime, threshold, RealTime(0, 50000000));
+    } else {
+        splitPoints = aFM.getSplitPoints(m_segment->getAudioFileId(),
+                                         startTime,
+                                         endTime,
+                                         threshold);
+    }
 
     std::vector<SplitPointPair>::iterator it;
     std::vector<QGraphicsRectItem*> tempRects;
@@ -350,4 +380,16 @@ AudioSplitDialog::slotThresholdChanged(int threshold)
     drawSplits(threshold);
 }
 
+void
+AudioSplitDialog::slotModeChanged(int)
+{
+    // Sensible starting points: a low level for silence, middling
+    // sensitivity for transients.
+    m_thresholdSpin->blockSignals(true);
+    m_thresholdSpin->setValue(getSplitOnTransients() ? 50 : 1);
+    m_thresholdSpin->blockSignals(false);
+
+    drawSplits(m_thresholdSpin->value());
+}
+
 }
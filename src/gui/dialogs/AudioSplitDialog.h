@@ -18,9 +18,12 @@
 #ifndef RG_AUDIOSPLITDIALOG_H
 #define RG_AUDIOSPLITDIALOG_H
 
+#include "sound/OnsetDetector.h"
+
 #include <QDialog>
 #include <vector>
 #include <QSpinBox>
+#include <QComboBox>
 
 
 class QWidget;
@@ -54,8 +57,14 @@ public:
     //
     int getThreshold() { return m_thresholdSpin->value(); }
 
+    // Split at transients rather than on silence?  The threshold is
+    // then the detection sensitivity.
+    //
+    bool getSplitOnTransients() { return m_modeCombo->currentIndex() == 1; }
+
 public slots:
     void slotThresholdChanged(int);
+    void slotModeChanged(int);
 
     void slotHelpRequested();
 
@@ -65,6 +74,7 @@ protected:
     QGraphicsScene                 *m_scene;
     QGraphicsView                  *m_view;
     QSpinBox                       *m_thresholdSpin;
+    QComboBox                      *m_modeCombo;
 
     int                             m_sceneWidth;
     int                             m_sceneHeight;
@@ -73,6 +83,13 @@ protected:
 
     std::vector<QGraphicsRectItem*> m_previewBoxes;
 
+    // The segment's audio, analysed for transients the first time
+    // they are asked for.  Changing the sensitivity only picks the
+    // onsets out of this again.
+    //
+    OnsetAnalysis                   m_onsetAnalysis;
+    bool                            m_haveOnsetAnalysis;
+
     void noPreviewMsg();
 };
 
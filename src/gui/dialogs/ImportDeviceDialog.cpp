@@ -43,12 +43,113 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QButtonGroup>
+#include <QProgressDialog>
+#include <QThread>
 
+#include <functional>
 #include <string>
 
 namespace Rosegarden
 {
 
+
+namespace
+{
+    /// Runs a function in a thread of its own.
+    class FunctionThread : public QThread
+    {
+    public:
+        explicit FunctionThread(std::function<void ()> function) :
+            m_function(function)
+        { }
+
+    protected:
+        void run() override  { m_function(); }
+
+    private:
+        std::function<void ()> m_function;
+    };
+
+    /// Banks and programs from a SoundFont.  Safe to call off the GUI thread.
+    bool readSF2(const QString &fileName,
+                 BankList &banks, ProgramList &programs)
+    {
+        SF2PatchExtractor::Device sf2device;
+        try {
+            sf2device = SF2PatchExtractor::read( qstrtostr(fileName) );
+
+            // These exceptions shouldn't happen -- the isSF2File call before
+            // this one should have weeded them out
+        } catch (SF2PatchExtractor::FileNotFoundException& e) {
+            return false;
+        } catch (SF2PatchExtractor::WrongFileFormatException& e) {
+            return false;
+        }
+
+        banks.reserve(sf2device.size());
+
+        for (SF2PatchExtractor::Device::const_iterator i = sf2device.begin();
+                i != sf2device.end(); ++i) {
+
+            int bankNumber = i->first;
+            const SF2PatchExtractor::Bank &sf2bank = i->second;
+
+            int msb = bankNumber / 128;
+            int lsb = bankNumber % 128;
+
+            MidiBank bank
+            (msb == 1, msb, lsb,
+             qstrtostr(ImportDeviceDialog::tr("Bank %1:%2").arg(msb).arg(lsb)));
+
+            banks.push_back(bank);
+
+            for (SF2PatchExtractor::Bank::const_iterator j = sf2bank.begin();
+                    j != sf2bank.end(); ++j) {
+
+                programs.push_back(MidiProgram(bank, j->first, j->second));
+            }
+        }
+
+        return true;
+    }
+
+    /// Banks and programs from an LSCP file.  Safe to call off the GUI thread.
+    bool readLSCP(const QString &fileName,
+                  BankList &banks, ProgramList &programs)
+    {
+        LSCPPatchExtractor::Device lscpDevice;
+
+        lscpDevice = LSCPPatchExtractor::extractContent(fileName);
+
+        programs.reserve(lscpDevice.size());
+
+        int comparableBankNumber = -1; //Make sure that first bank is read too by comparing to -1 first (invalid bank number)
+
+        for (LSCPPatchExtractor::Device::const_iterator i = lscpDevice.begin();
+        i != lscpDevice.end(); ++i) {
+
+            int bankNumber = (*i).bankNumber; //Local variable bankNumber gets value from struct's member bankNumber
+
+            std::string bankName = (*i).bankName; //Local variable bankName gets value from struct's member bankName
+            int msb = bankNumber / 128;
+            int lsb = bankNumber % 128;
+
+            MidiBank bank (msb == 1, msb, lsb, bankName);
+
+            if (comparableBankNumber != bankNumber) {
+                banks.push_back(bank);
+                comparableBankNumber = bankNumber;
+            }
+
+            MidiProgram program(bank, (*i).programNumber, (*i).programName);
+            programs.push_back(program);
+        }
+
+        return true;
+    }
+}
+
+
 ImportDeviceDialog::ImportDeviceDialog(QWidget *parent, QUrl url) :
     QDialog(parent),
     m_url(url),
@@ -396,92 +497,49 @@ ImportDeviceDialog::importFromRG(const QString& fileName)
 bool
 ImportDeviceDialog::importFromSF2(const QString& fileName)
 {
-    SF2PatchExtractor::Device sf2device;
-    try {
-        sf2device = SF2PatchExtractor::read( qstrtostr(fileName) );
-
-        // These exceptions shouldn't happen -- the isSF2File call before this
-        // one should have weeded them out
-    } catch (SF2PatchExtractor::FileNotFoundException& e) {
-        return false;
-    } catch (SF2PatchExtractor::WrongFileFormatException& e) {
-        return false;
-    }
-
-    std::vector<MidiBank> banks;
-    std::vector<MidiProgram> programs;
-
-    for (SF2PatchExtractor::Device::const_iterator i = sf2device.begin();
-            i != sf2device.end(); ++i) {
-
-        int bankNumber = i->first;
-        const SF2PatchExtractor::Bank &sf2bank = i->second;
-
-        int msb = bankNumber / 128;
-        int lsb = bankNumber % 128;
-
-        MidiBank bank
-        (msb == 1, msb, lsb,
-         qstrtostr(tr("Bank %1:%2").arg(msb).arg(lsb)));
-
-        banks.push_back(bank);
-
-        for (SF2PatchExtractor::Bank::const_iterator j = sf2bank.begin();
-                j != sf2bank.end(); ++j) {
-
-            MidiProgram program(bank, j->first, j->second);
-            programs.push_back(program);
-        }
-    }
-
-    // This is a temporary device, so we can use device and instrument
-    // IDs that other devices in the Studio may also be using without
-    // expecting any problems
-    MidiDevice *device = new MidiDevice
-        (0, MidiInstrumentBase, "", MidiDevice::Play);
-    device->replaceBankList(banks);
-    device->replaceProgramList(programs);
-    m_devices.push_back(device);
-
-    return true;
+    return importPatches(fileName, readSF2);
 }
 
 bool
 ImportDeviceDialog::importFromLSCP(const QString& filename)
 {
-    LSCPPatchExtractor::Device lscpDevice;
-
-    lscpDevice = LSCPPatchExtractor::extractContent(filename);
-    std::vector<MidiBank> banks;
-    std::vector<MidiProgram> programs;
-
-    int comparableBankNumber = -1; //Make sure that first bank is read too by comparing to -1 first (invalid bank number)
-
-    for (LSCPPatchExtractor::Device::const_iterator i = lscpDevice.begin();
-    i != lscpDevice.end(); ++i) {
-
-        int bankNumber = (*i).bankNumber; //Local variable bankNumber gets value from struct's member bankNumber
-
-        std::string bankName = (*i).bankName; //Local variable bankName gets value from struct's member bankName
-        int msb = bankNumber / 128;
-        int lsb = bankNumber % 128;
-
-        MidiBank bank (msb == 1, msb, lsb, bankName);
-
-        if (comparableBankNumber != bankNumber) {
-            banks.push_back(bank);
-            comparableBankNumber = bankNumber;
-        }
+    return importPatches(filename, readLSCP);
+}
 
-        MidiProgram program(bank, (*i).programNumber, (*i).programName);
-        programs.push_back(program);
-    }
+bool
+ImportDeviceDialog::importPatches(const QString &fileName, PatchReader reader)
+{
+    BankList banks;
+    ProgramList programs;
+    bool ok = false;
+
+    // Sample libraries can have tens of thousands of patches, so read
+    // them in the background and keep the UI painting meanwhile.
+    FunctionThread thread([&]() { ok = reader(fileName, banks, programs); });
+
+    QProgressDialog progressDialog(
+            tr("Reading patches..."),  // labelText
+            QString(),  // cancelButtonText
+            0, 0,  // min, max
+            this);  // parent
+    progressDialog.setWindowTitle(tr("Rosegarden"));
+    progressDialog.setWindowModality(Qt::WindowModal);
+    // Only bother the user if it takes a while.
+    progressDialog.setMinimumDuration(500);
+
+    thread.start();
+    while (!thread.wait(50))
+        qApp->processEvents(QEventLoop::ExcludeUserInputEvents);
+
+    if (!ok)
+        return false;
 
     // This is a temporary device, so we can use device and instrument
     // IDs that other devices in the Studio may also be using without
     // expecting any problems
     MidiDevice *device = new MidiDevice
         (0, MidiInstrumentBase, "", MidiDevice::Play);
+    // One bulk load each, so the device's indexes are built just once.
     device->replaceBankList(banks);
     device->replaceProgramList(programs);
     m_devices.push_back(device);
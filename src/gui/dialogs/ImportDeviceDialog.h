@@ -79,6 +79,11 @@ protected:
     bool importFromSF2(const QString& fileName);
     bool importFromLSCP(const QString& filename);
 
+    typedef bool (*PatchReader)(const QString &fileName,
+                                BankList &banks, ProgramList &programs);
+    /// Read a patch file in a background thread and add it as a device.
+    bool importPatches(const QString &fileName, PatchReader reader);
+
     QUrl               m_url;
 
     QComboBox          *m_deviceCombo;
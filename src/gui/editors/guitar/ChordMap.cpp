@@ -23,9 +23,14 @@
 
 #include "rosegarden-version.h"
 
+#include <QDataStream>
+#include <QDateTime>
 #include <QFile>
+#include <QFileInfo>
 #include <QTextStream>
 
+#include <algorithm>
+
 namespace Rosegarden
 {
 
@@ -36,6 +41,13 @@ int ChordMap::FILE_FORMAT_VERSION_MAJOR = 1;
 int ChordMap::FILE_FORMAT_VERSION_MINOR = 0;
 int ChordMap::FILE_FORMAT_VERSION_POINT = 0;
 
+namespace
+{
+    // Change CACHE_VERSION whenever the layout of the cache changes.
+    const quint32 CACHE_MAGIC = 0x52474348; // "RGCH"
+    const quint32 CACHE_VERSION = 1;
+}
+
 ChordMap::ChordMap()
     : m_needSave(false)
 {
@@ -43,35 +55,134 @@ ChordMap::ChordMap()
 
 void ChordMap::insert(const Chord& c)
 {
-    m_map.insert(c);
+    std::pair<iterator, bool> res = m_map.insert(c);
+    if (res.second)
+        addToIndex(res.first);
     m_needSave = true;
 }
 
+void
+ChordMap::clear()
+{
+    m_map.clear();
+    m_extensions.clear();
+    m_positions.clear();
+}
+
+void
+ChordMap::addToIndex(const_iterator i)
+{
+    // The address of a chord in m_map is stable.
+    const Chord *chord = &*i;
+
+    ++m_extensions[chord->getRoot()][chord->getExt()];
+
+    const Fingering fingering = chord->getFingering();
+    for (unsigned int j = 0; j < fingering.getNbStrings(); ++j) {
+        if (fingering[j] >= Fingering::OPEN)
+            m_positions[position(j, fingering[j])].push_back(chord);
+    }
+}
+
+void
+ChordMap::removeFromIndex(const Chord& c)
+{
+    std::map<QString, extcounts>::iterator root =
+        m_extensions.find(c.getRoot());
+    if (root != m_extensions.end()) {
+        extcounts::iterator ext = root->second.find(c.getExt());
+        if (ext != root->second.end() && --ext->second == 0) {
+            root->second.erase(ext);
+            if (root->second.empty())
+                m_extensions.erase(root);
+        }
+    }
+
+    const Fingering fingering = c.getFingering();
+    for (unsigned int i = 0; i < fingering.getNbStrings(); ++i) {
+        if (fingering[i] < Fingering::OPEN) continue;
+        std::map<position, chordptrarray>::iterator chords =
+            m_positions.find(position(i, fingering[i]));
+        if (chords == m_positions.end()) continue;
+        chordptrarray &array = chords->second;
+        array.erase(std::remove(array.begin(), array.end(), &c), array.end());
+        if (array.empty())
+            m_positions.erase(chords);
+    }
+}
+
 
 ChordMap::chordarray
 ChordMap::getChords(const QString& root, const QString& ext) const
 {
-    chordarray res;
+    std::pair<const_iterator, const_iterator> range = getChordRange(root, ext);
+    return chordarray(range.first, range.second);
+}
 
-    Chord tmp(root, ext);
+std::pair<ChordMap::const_iterator, ChordMap::const_iterator>
+ChordMap::getChordRange(const QString& root, const QString& ext) const
+{
+    // An all-muted fingering sorts before any other.
+    const_iterator begin = m_map.lower_bound(Chord(root, ext));
+    const_iterator end = begin;
+    while (end != m_map.end() &&
+           end->getRoot() == root && end->getExt() == ext)
+        ++end;
+
+    return std::make_pair(begin, end);
+}
 
-// RG_DEBUG << "ChordMap::getChords() : chord = " /*<< tmp*/ <<
-//   " - ext is empty : " << ext.isEmpty();
+ChordMap::chordarray
+ChordMap::getChordsContaining(const Fingering& positions,
+                              unsigned int maxFretSpan) const
+{
+    chordarray res;
 
-    for (chordset::const_iterator i = m_map.lower_bound(tmp); i != m_map.end(); ++i) {
+    // Walk the shortest list of chords playing one of the positions,
+    // and check the rest against each of those.
 
-// RG_DEBUG << "ChordMap::getChords() : checking chord "/* << *i*/;
+    const chordptrarray *candidates = nullptr;
+    std::vector<position> wanted;
 
-        if (i->getRoot() != root)
-            break;
+    for (unsigned int i = 0; i < positions.getNbStrings(); ++i) {
+        if (positions[i] < Fingering::OPEN) continue;
 
-        if (/* ext.isNull() || */ i->getExt() == ext) {
+        const position p(i, positions[i]);
+        std::map<position, chordptrarray>::const_iterator chords =
+            m_positions.find(p);
+        if (chords == m_positions.end())
+            return res;
 
-// RG_DEBUG << "ChordMap::getChords() : adding chord " << *i;
+        if (!candidates || chords->second.size() < candidates->size())
+            candidates = &chords->second;
+        wanted.push_back(p);
+    }
 
-            res.push_back(*i);
-        } else {
-            break;
+    const auto matches = [&](const Chord &chord) {
+        const Fingering fingering = chord.getFingering();
+        for (const position &p : wanted) {
+            if (p.first >= fingering.getNbStrings() ||
+                fingering[p.first] != p.second)
+                return false;
+        }
+        return maxFretSpan == 0 || fingering.getFretSpan() <= maxFretSpan;
+    };
+
+    if (candidates) {
+        chordptrarray found;
+        for (const Chord *chord : *candidates) {
+            if (matches(*chord))
+                found.push_back(chord);
+        }
+        // Return them in the same order as m_map.
+        std::sort(found.begin(), found.end(), Chord::ChordCmp());
+        res.reserve(found.size());
+        for (const Chord *chord : found)
+            res.push_back(*chord);
+    } else {
+        for (const Chord &chord : m_map) {
+            if (matches(chord))
+                res.push_back(chord);
         }
     }
 
@@ -112,27 +223,15 @@ QStringList
 ChordMap::getExtList(const QString& root) const
 {
     QStringList extList;
-    QString currentExt = "ZZ";
-
-    Chord tmp(root);
-
-    for (chordset::const_iterator i = m_map.lower_bound(tmp);
-         i != m_map.end(); ++i) {
-        const Chord& chord = *i;
-
-// RG_DEBUG << "ChordMap::getExtList() : chord = " << chord;
-
-        if (chord.getRoot() != root)
-            break;
-
-        if (chord.getExt() != currentExt) {
 
-// RG_DEBUG << "ChordMap::getExtList() : adding ext " << chord.getExt() <<
-//   " for root " << root;
+    std::map<QString, extcounts>::const_iterator exts =
+        m_extensions.find(root);
+    if (exts == m_extensions.end())
+        return extList;
 
-            extList.push_back(chord.getExt());
-            currentExt = chord.getExt();
-        }
+    for (extcounts::const_iterator i = exts->second.begin();
+         i != exts->second.end(); ++i) {
+        extList.push_back(i->first);
     }
 
     return extList;
@@ -148,7 +247,11 @@ ChordMap::substitute(const Chord& oldChord, const Chord& newChord)
 void
 ChordMap::remove(const Chord& c)
 {
-    m_map.erase(c);
+    chordset::iterator i = m_map.find(c);
+    if (i != m_map.end()) {
+        removeFromIndex(*i);
+        m_map.erase(i);
+    }
     m_needSave = true;
 }
 
@@ -248,6 +351,94 @@ bool ChordMap::saveDocument(
     return outStream.status() == QTextStream::Ok;
 }
 
+bool
+ChordMap::loadCache(const QString& cacheFile, const QString& sourceFile)
+{
+    QFile file(cacheFile);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+
+    quint32 magic = 0, version = 0;
+    qint64 sourceSize = 0, sourceModified = 0;
+    quint32 count = 0;
+    stream >> magic >> version >> sourceSize >> sourceModified >> count;
+
+    const QFileInfo source(sourceFile);
+    if (stream.status() != QDataStream::Ok ||
+        magic != CACHE_MAGIC ||
+        version != CACHE_VERSION ||
+        sourceSize != source.size() ||
+        sourceModified != source.lastModified().toMSecsSinceEpoch()) {
+        RG_DEBUG << "loadCache(): cache" << cacheFile << "is out of date";
+        return false;
+    }
+
+    clear();
+
+    for (quint32 n = 0; n < count; ++n) {
+        QString root, ext;
+        bool isUserChord = false;
+        quint8 nbStrings = 0;
+        stream >> root >> ext >> isUserChord >> nbStrings;
+
+        Fingering fingering(nbStrings);
+        for (unsigned int i = 0; i < nbStrings; ++i) {
+            qint8 status = 0;
+            stream >> status;
+            fingering[i] = status;
+        }
+
+        if (stream.status() != QDataStream::Ok) {
+            RG_WARNING << "loadCache(): cache" << cacheFile << "is truncated";
+            clear();
+            return false;
+        }
+
+        Chord chord(root, ext);
+        chord.setUserChord(isUserChord);
+        chord.setFingering(fingering);
+
+        // The cache was written in order, so each chord goes at the end.
+        const size_t size = m_map.size();
+        const_iterator i = m_map.insert(m_map.end(), chord);
+        if (m_map.size() != size)
+            addToIndex(i);
+    }
+
+    // Same as the source file, so no need to save.
+    m_needSave = false;
+
+    return true;
+}
+
+bool
+ChordMap::saveCache(const QString& cacheFile, const QString& sourceFile) const
+{
+    QFile file(cacheFile);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream stream(&file);
+
+    const QFileInfo source(sourceFile);
+    stream << CACHE_MAGIC << CACHE_VERSION
+           << qint64(source.size())
+           << qint64(source.lastModified().toMSecsSinceEpoch())
+           << quint32(m_map.size());
+
+    for (const_iterator i = begin(); i != end(); ++i) {
+        const Fingering fingering = i->getFingering();
+        stream << i->getRoot() << i->getExt() << i->isUserChord()
+               << quint8(fingering.getNbStrings());
+        for (unsigned int j = 0; j < fingering.getNbStrings(); ++j)
+            stream << qint8(fingering[j]);
+    }
+
+    return stream.status() == QDataStream::Ok;
+}
+
 void
 // cppcheck-suppress unusedFunction
 ChordMap::debugDump() const
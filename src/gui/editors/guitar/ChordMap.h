@@ -21,7 +21,10 @@
 #include "Chord.h"
 
 #include <QStringList>
+#include <map>
 #include <set>
+#include <utility>
+#include <vector>
 
 namespace Rosegarden
 {
@@ -51,6 +54,19 @@ public:
 
     chordarray getChords(const QString& root, const QString& ext) const;
 
+    /// The chords with the given root and extension, without copying them
+    std::pair<const_iterator, const_iterator>
+    getChordRange(const QString& root, const QString& ext) const;
+
+    /**
+     * Return the chords whose fingerings fret or leave open each string
+     * exactly as \a positions does.  Strings that are MUTED in
+     * \a positions may be anything.  If \a maxFretSpan is not 0, only
+     * fingerings spanning at most that many frets are returned.
+     */
+    chordarray getChordsContaining(const Fingering& positions,
+                                   unsigned int maxFretSpan = 0) const;
+
     static QStringList getRootList();
     QStringList getExtList(const QString& root) const;
 
@@ -61,6 +77,17 @@ public:
 
     bool saveDocument(const QString& filename, bool userChordsOnly, QString& errMsg);
 
+    /**
+     * Load the chords from a cache written by saveCache(), replacing
+     * any already in the map.  Fails if the cache is missing, from
+     * another version, or was not written from \a sourceFile as it is
+     * now.
+     */
+    bool loadCache(const QString& cacheFile, const QString& sourceFile);
+
+    /// Write all the chords to a binary cache of \a sourceFile
+    bool saveCache(const QString& cacheFile, const QString& sourceFile) const;
+
     iterator begin() { return m_map.begin(); }
     iterator end()   { return m_map.end();   }
     const_iterator begin() const { return m_map.begin(); }
@@ -68,8 +95,33 @@ public:
 
 protected:
 
+    void clear();
+
+    void addToIndex(const_iterator);
+    void removeFromIndex(const Chord&);
+
     chordset m_map;
 
+    /// Orders extensions as Chord's operator< does, with no extension first
+    struct ExtCmp
+    {
+        bool operator()(const QString &e1, const QString &e2) const {
+            if (e1.isEmpty()) return !e2.isEmpty();
+            if (e2.isEmpty()) return false;
+            return e1 < e2;
+        }
+    };
+
+    /// Number of fingerings for each extension of each root
+    typedef std::map<QString, int, ExtCmp> extcounts;
+    std::map<QString, extcounts> m_extensions;
+
+    /// Chords in m_map by the (string, fret) positions they play, 0
+    /// being an open string.  Not kept in order, to keep loading fast.
+    typedef std::vector<const Chord *> chordptrarray;
+    typedef std::pair<unsigned int, int> position;
+    std::map<position, chordptrarray> m_positions;
+
     bool m_needSave;
 };
 
@@ -58,6 +58,20 @@ Fingering::getStartFret() const
     return min == 999 ? 1 : min;
 }
 
+unsigned int
+Fingering::getFretSpan() const
+{
+    int min = 999, max = 0;
+    for(std::vector<int>::const_iterator i = m_strings.begin(); i != m_strings.end(); ++i) {
+        if (*i > OPEN) {
+            min = std::min(min, *i);
+            max = std::max(max, *i);
+        }
+    }
+
+    return max == 0 ? 0 : max - min + 1;
+}
+
 bool
 Fingering::hasBarre() const
 {
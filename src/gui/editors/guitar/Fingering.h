@@ -60,6 +60,8 @@ public:
     int  getStringStatus(int stringNb) const       { return m_strings[stringNb]; }
     void setStringStatus(int stringNb, int status) { m_strings[stringNb] = status; }
     unsigned int getStartFret() const;
+    /// Number of frets between the lowest and highest fretted strings, inclusive
+    unsigned int getFretSpan() const;
     unsigned int getNbStrings() const { return m_strings.size(); }
 
     bool hasBarre() const;
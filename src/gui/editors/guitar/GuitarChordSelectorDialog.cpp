@@ -145,8 +145,15 @@ GuitarChordSelectorDialog::init()
     // populate the listboxes
     //
     QString chordFile = getChordFile();
-    
-    parseChordFile(chordFile);
+    QString cacheFile = getChordCacheFile();
+
+    // Parsing a large dictionary is slow, so use the cache if it was
+    // made from the file as it is now.
+    if (!m_chordMap.loadCache(cacheFile, chordFile)) {
+        // Don't cache what we got from a file we couldn't read in full.
+        if (parseChordFile(chordFile))
+            m_chordMap.saveCache(cacheFile, chordFile);
+    }
 
 //    m_chordMap.debugDump();
     
@@ -164,8 +171,7 @@ GuitarChordSelectorDialog::populate()
         QStringList extList = m_chordMap.getExtList(rootList.first());
         populateExtensions(extList);
         
-        Guitar::ChordMap::chordarray chords = m_chordMap.getChords(rootList.first(), extList.first());
-        populateFingerings(chords);
+        populateFingerings(rootList.first(), extList.first());
 
         m_chord.setRoot(rootList.first());
         m_chord.setExt(extList.first());
@@ -217,8 +223,7 @@ GuitarChordSelectorDialog::slotChordExtHighlighted(int i)
 
     if (i < 0) return;
 
-    Guitar::ChordMap::chordarray chords = m_chordMap.getChords(m_chord.getRoot(), m_chordExtList->item(i)->text() );
-    populateFingerings(chords);
+    populateFingerings(m_chord.getRoot(), m_chordExtList->item(i)->text());
     
     //m_fingeringsList->setCurrentIndex(0);
     m_fingeringsList->setCurrentRow(0);
@@ -387,16 +392,18 @@ GuitarChordSelectorDialog::setChord(const Guitar::Chord& chord)
     
     // populate fingerings and pass the current chord's fingering so it is selected
     //
-    Guitar::ChordMap::chordarray similarChords = m_chordMap.getChords(chord.getRoot(), chord.getExt());
-    populateFingerings(similarChords, chord.getFingering());
+    populateFingerings(chord.getRoot(), chord.getExt(), chord.getFingering());
 }
 
 void
-GuitarChordSelectorDialog::populateFingerings(const Guitar::ChordMap::chordarray& chords, const Guitar::Fingering& refFingering)
+GuitarChordSelectorDialog::populateFingerings(const QString& root, const QString& ext, const Guitar::Fingering& refFingering)
 {
     m_fingeringsList->clear();
 
-    for(Guitar::ChordMap::chordarray::const_iterator i = chords.begin(); i != chords.end(); ++i) {
+    std::pair<Guitar::ChordMap::const_iterator, Guitar::ChordMap::const_iterator> chords =
+        m_chordMap.getChordRange(root, ext);
+
+    for(Guitar::ChordMap::const_iterator i = chords.first; i != chords.second; ++i) {
         const Guitar::Chord& chord = *i; 
         QString fingeringString = strtoqstr(chord.getFingering().toString() );
 
@@ -494,7 +501,7 @@ GuitarChordSelectorDialog::evaluateChordComplexity(const QString& ext)
      return COMPLEXITY_ALL; 
 }
 
-void
+bool
 GuitarChordSelectorDialog::parseChordFile(const QString& chordFileName)
 {
     ChordXmlHandler handler(m_chordMap);
@@ -510,13 +517,15 @@ GuitarChordSelectorDialog::parseChordFile(const QString& chordFileName)
 // RG_DEBUG << "GuitarChordSelectorDialog::parseChordFile() parsing " << 
 //   chordFileName;
 
-    reader.parse(chordFile);
+    if (!reader.parse(chordFile))
+        ok = false;
 
 // RG_DEBUG << "  parsed OK, without crashing!  W00t!";
 
     if (!ok)
         QMessageBox::critical(nullptr, tr("Rosegarden"), tr("couldn't parse chord dictionary : %1").arg(handler.errorString()));
-    
+
+    return ok;
 }
 
 void
@@ -545,6 +554,12 @@ GuitarChordSelectorDialog::getChordFile()
     return name;
 }
 
+QString
+GuitarChordSelectorDialog::getChordCacheFile()
+{
+    return ResourceFinder().getResourceSaveDir("chords") + "/chords.cache";
+}
+
 bool
 GuitarChordSelectorDialog::saveUserChordMap()
 {
@@ -565,8 +580,15 @@ GuitarChordSelectorDialog::saveUserChordMap()
     bool userChordsOnly = false;
 
     m_chordMap.saveDocument(userChordDictPath, userChordsOnly, errMsg);
-    
-    return errMsg.isEmpty();
+
+    // Keep the cache in step with the file we just wrote, but only if
+    // we wrote all of it, or the cache would not match what's there.
+    if (!errMsg.isEmpty())
+        return false;
+
+    m_chordMap.saveCache(getChordCacheFile(), userChordDictPath);
+
+    return true;
 }
 
 
@@ -78,8 +78,9 @@ protected slots:
 
 protected:
 
-    void parseChordFile(const QString& chordFileName);
-    void populateFingerings(const Guitar::ChordMap::chordarray&, const Guitar::Fingering& refFingering=Guitar::Fingering(0));
+    /// Returns false if the file couldn't be read or parsed.
+    bool parseChordFile(const QString& chordFileName);
+    void populateFingerings(const QString& root, const QString& ext, const Guitar::Fingering& refFingering=Guitar::Fingering(0));
     void populateExtensions(const QStringList& extList);
 
     /// set enabled state of edit/delete buttons
@@ -105,6 +106,9 @@ protected:
     // transparent to everyone, and if not, we'll hear about it!)
     QString getChordFile();
 
+    /// Path of the binary cache of the chord dictionary in userspace.
+    QString getChordCacheFile();
+
     Guitar::ChordMap m_chordMap;
 
     /// current selected chord
@@ -43,6 +43,7 @@
 #include "misc/Strings.h"
 #include "misc/Debug.h"
 #include "misc/ConfigGroups.h"
+#include "misc/Preferences.h"
 
 #include <QApplication>
 #include <QSettings>
@@ -279,23 +280,19 @@ NotationHLayout::scanViewSegment(ViewSegment &staff, timeT startTime,
 
     RG_DEBUG << "ottava shift at start:" << ottavaShift << ", ottavaEnd " << ottavaEnd;
 
-    QSettings settings;
-    settings.beginGroup(NotationOptionsConfigGroup);
-
-    int accOctaveMode = settings.value("accidentaloctavemode", 1).toInt() ;
+    int accOctaveMode = Preferences::getAccidentalOctaveMode();
     AccidentalTable::OctaveType octaveType =
         (accOctaveMode == 0 ? AccidentalTable::OctavesIndependent :
          accOctaveMode == 1 ? AccidentalTable::OctavesCautionary :
          AccidentalTable::OctavesEquivalent);
 
-    int accBarMode = settings.value("accidentalbarmode", 0).toInt() ;
+    int accBarMode = Preferences::getAccidentalBarMode();
     AccidentalTable::BarResetType barResetType =
         (accBarMode == 0 ? AccidentalTable::BarResetNone :
          accBarMode == 1 ? AccidentalTable::BarResetCautionary :
          AccidentalTable::BarResetExplicit);
 
-    bool showInvisibles = qStrToBool( settings.value("showinvisibles", "true" ) ) ;
-    settings.endGroup();
+    bool showInvisibles = Preferences::getShowInvisibles();
 
     if (barResetType != AccidentalTable::BarResetNone) {
         //!!! very crude and expensive way of making sure we see the
@@ -1363,11 +1360,7 @@ NotationHLayout::layout(BarDataMap::iterator i, timeT startTime, timeT endTime,
 
     int startBar = getComposition()->getBarNumber(startTime);
 
-    QSettings settings;
-    settings.beginGroup(NotationOptionsConfigGroup);
-
-    bool showInvisibles = qStrToBool( settings.value("showinvisibles", "true" ) ) ;
-    settings.endGroup();
+    bool showInvisibles = Preferences::getShowInvisibles();
 
     for (BarPositionList::iterator bpi = m_barPositions.begin();
             bpi != m_barPositions.end(); ++bpi) {
@@ -40,6 +40,7 @@
 #include "misc/Strings.h"
 
 #include "misc/ConfigGroups.h"
+#include "misc/Preferences.h"
 #include "document/CommandHistory.h"
 #include "document/RosegardenDocument.h"
 #include "base/Profiler.h"
@@ -1576,11 +1577,9 @@ NotationScene::positionStaffs()
         const Configuration &metadata =
             m_document->getComposition().getMetadata();
 
-        QFont defaultFont(NotePixmapFactory::defaultSerifFontFamily);
-
-        QVariant fv = settings.value("textfont", defaultFont);
-        QFont font(defaultFont);
-        if (fv.canConvert<QFont>()) font = fv.value<QFont>();
+        QFont font(NotePixmapFactory::defaultSerifFontFamily);
+        font.fromString(Preferences::getNotationTextFont(
+                NotePixmapFactory::defaultSerifFontFamily));
 
         font.setPixelSize(m_notePixmapFactory->getSize() * 5);
         QFontMetrics metrics(font);
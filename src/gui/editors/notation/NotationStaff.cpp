@@ -54,6 +54,7 @@
 #include "gui/general/PixmapFunctions.h"
 #include "misc/ConfigGroups.h"
 #include "misc/Debug.h"
+#include "misc/Preferences.h"
 #include "misc/Strings.h"
 
 #include <QApplication>
@@ -448,11 +449,7 @@ NotationStaff::getNoteNameAtSceneCoords(double x, int y,
     ::Rosegarden::Key key;
     getClefAndKeyAtSceneCoords(x, y, clef, key);
 
-    QSettings settings;
-    settings.beginGroup( GeneralOptionsConfigGroup );
-
-    int baseOctave = settings.value("midipitchoctave", -2).toInt() ;
-    settings.endGroup();
+    const int baseOctave = Preferences::getMIDIPitchOctave();
 
     Pitch p(getHeightAtSceneCoords(x, y), clef, key);
 
@@ -826,13 +823,7 @@ NotationStaff::renderSingleElement(ViewElementList::iterator &vli,
     if (elt->event()->get
             <Bool>(BaseProperties::INVISIBLE, invisible) && invisible) {
 //        if (m_printPainter) return ;
-        QSettings settings;
-        settings.beginGroup( NotationOptionsConfigGroup );
-
-        bool showInvisibles = qStrToBool( settings.value("showinvisibles", "true" ) ) ;
-        settings.endGroup();
-
-        if (!showInvisibles) return;
+        if (!Preferences::getShowInvisibles()) return;
     }
 
     // Don't display clef or key already in use
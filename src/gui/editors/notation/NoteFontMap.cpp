@@ -27,6 +27,9 @@
 #include "gui/general/ResourceFinder.h"
 #include "document/io/XMLReader.h"
 
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
@@ -38,6 +41,26 @@
 namespace Rosegarden
 {
 
+namespace
+{
+    // Change CACHE_VERSION whenever the layout of the cache changes.
+    const quint32 CACHE_MAGIC = 0x52474e46; // "RGNF"
+    const quint32 CACHE_VERSION = 1;
+
+    QByteArray hashFile(const QString &fileName)
+    {
+        QFile file(fileName);
+        if (!file.open(QIODevice::ReadOnly))
+            return QByteArray();
+
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+        if (!hash.addData(&file))
+            return QByteArray();
+
+        return hash.result();
+    }
+}
+
 NoteFontMap::NoteFontMap(QString name) :
     m_name(name),
     m_smooth(false),
@@ -84,15 +107,30 @@ NoteFontMap::NoteFontMap(QString name) :
         mapFileName = mapFileMixedName;
     }
 
-    QFile mapFile(mapFileName);
+    const QString cacheFile = getCacheFile(mapFileName);
+
+    // Every map is read at startup and again for each size of a font
+    // that is used, so only parse the XML when the cache is out of date.
+    if (!loadCache(cacheFile, mapFileName)) {
+
+        QFile mapFile(mapFileName);
 
-    XMLReader reader;
-    reader.setHandler(this);
-    bool ok = reader.parse(mapFile);
+        XMLReader reader;
+        reader.setHandler(this);
+        bool ok = reader.parse(mapFile);
 
-    if (!ok) {
-        throw MappingFileReadFailed(m_errorString);
+        if (!ok) {
+            throw MappingFileReadFailed(m_errorString);
+        }
+
+        if (!saveCache(cacheFile, mapFileName)) {
+            RG_WARNING << "NoteFontMap(): Unable to write cache" << cacheFile;
+        }
     }
+
+    // Which system fonts are installed can change without the mapping
+    // file changing, so this is never cached.
+    loadSystemFonts();
 }
 
 NoteFontMap::~NoteFontMap()
@@ -450,7 +488,7 @@ NoteFontMap::startElement(const QString &, const QString &,
             symbolData.setFontId(n);
         }
 
-        m_data[symbolName.toUpper()] = symbolData;
+        m_symbols[addSymbolId(symbolName.toUpper())] = symbolData;
 
     } else if (lcName == "font-hotspots") {
     } else if (lcName == "hotspot") {
@@ -481,13 +519,8 @@ NoteFontMap::startElement(const QString &, const QString &,
         }
         double y = qstrtodouble(s);
 
-        HotspotDataMap::iterator i = m_hotspots.find(m_hotspotCharName);
-        if (i == m_hotspots.end()) {
-            m_hotspots[m_hotspotCharName] = HotspotData();
-            i = m_hotspots.find(m_hotspotCharName);
-        }
-
-        i->second.setScaledHotspot(x, y);
+        HotspotData &hotspot = m_hotspots[addSymbolId(m_hotspotCharName)];
+        hotspot.setScaledHotspot(x, y);
 
     } else if (lcName == "fixed") {
 
@@ -506,13 +539,8 @@ NoteFontMap::startElement(const QString &, const QString &,
 		if ( ! s.isEmpty())
             y = s.toInt();
 
-        HotspotDataMap::iterator i = m_hotspots.find(m_hotspotCharName);
-        if (i == m_hotspots.end()) {
-            m_hotspots[m_hotspotCharName] = HotspotData();
-            i = m_hotspots.find(m_hotspotCharName);
-        }
-
-        i->second.addHotspot(0, x, y);
+        HotspotData &hotspot = m_hotspots[addSymbolId(m_hotspotCharName)];
+        hotspot.addHotspot(0, x, y);
 
     } else if (lcName == "when") {
 
@@ -540,13 +568,8 @@ NoteFontMap::startElement(const QString &, const QString &,
         }
         int y = s.toInt();
 
-        HotspotDataMap::iterator i = m_hotspots.find(m_hotspotCharName);
-        if (i == m_hotspots.end()) {
-            m_hotspots[m_hotspotCharName] = HotspotData();
-            i = m_hotspots.find(m_hotspotCharName);
-        }
-
-        i->second.addHotspot(noteHeight, x, y);
+        HotspotData &hotspot = m_hotspots[addSymbolId(m_hotspotCharName)];
+        hotspot.addHotspot(noteHeight, x, y);
 
     } else if (lcName == "font-requirements") {
     } else if (lcName == "font-requirement") {
@@ -576,40 +599,17 @@ NoteFontMap::startElement(const QString &, const QString &,
                 return false;
             }
 
-            SystemFont *font = SystemFont::loadSystemFont
-                (SystemFontSpec(name, 12));
-
-            if (font) {
-                m_systemFontNames[n] = name;
-                delete font;
-            } else {
-                RG_WARNING << "startElement(): WARNING: Unable to load font" << name;
-                m_ok = false;
-            }
+            m_systemFontRequirements[n] = QStringList(name);
 
         } else if (!names.isEmpty()) {
 
-            bool have = false;
 //            QStringList list = QStringList::split(",", names, false);
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 14, 0))
             QStringList list = names.split(",", Qt::SkipEmptyParts);
 #else
             QStringList list = names.split(",", QString::SkipEmptyParts);
 #endif
-            for (QStringList::Iterator i = list.begin(); i != list.end(); ++i) {
-                SystemFont *font = SystemFont::loadSystemFont
-                                   (SystemFontSpec(*i, 12));
-                if (font) {
-                    m_systemFontNames[n] = *i;
-                    have = true;
-                    delete font;
-                    break;
-                }
-            }
-            if (!have) {
-                RG_DEBUG << "startElement(): Unable to load any of the fonts in" << names;
-                m_ok = false;
-            }
+            m_systemFontRequirements[n] = list;
 
         } else {
             m_errorString = "font-requirement must have either name or names attribute";
@@ -675,14 +675,74 @@ NoteFontMap::getCharNames() const
 {
     std::set<CharName> names;
 
-    for (SymbolDataMap::const_iterator i = m_data.begin();
-         i != m_data.end(); ++i) {
-        names.insert(i->first);
+    for (SymbolIdMap::const_iterator i = m_symbolIds.begin();
+         i != m_symbolIds.end(); ++i) {
+        if (m_symbols[i->second].isDefined())
+            names.insert(i->first);
     }
 
     return names;
 }
 
+int
+NoteFontMap::findSymbolId(const CharName &charName) const
+{
+    SymbolIdMap::const_iterator i = m_symbolIds.find(charName);
+    if (i == m_symbolIds.end())
+        return -1;
+    return i->second;
+}
+
+int
+NoteFontMap::addSymbolId(const CharName &charName)
+{
+    std::pair<SymbolIdMap::iterator, bool> res =
+        m_symbolIds.insert(SymbolIdMap::value_type(charName,
+                                                   int(m_symbols.size())));
+    if (res.second) {
+        m_symbols.push_back(SymbolData());
+        m_hotspots.push_back(HotspotData());
+    }
+    return res.first->second;
+}
+
+const NoteFontMap::SymbolData *
+NoteFontMap::findSymbol(const CharName &charName) const
+{
+    const int id = findSymbolId(charName);
+    if (id < 0 || !m_symbols[id].isDefined())
+        return nullptr;
+    return &m_symbols[id];
+}
+
+void
+NoteFontMap::loadSystemFonts()
+{
+    m_systemFontNames.clear();
+
+    for (SystemFontRequirementMap::const_iterator i =
+             m_systemFontRequirements.begin();
+         i != m_systemFontRequirements.end(); ++i) {
+
+        bool have = false;
+        for (QStringList::const_iterator j = i->second.constBegin();
+             j != i->second.constEnd(); ++j) {
+            SystemFont *font = SystemFont::loadSystemFont
+                               (SystemFontSpec(*j, 12));
+            if (font) {
+                m_systemFontNames[i->first] = *j;
+                have = true;
+                delete font;
+                break;
+            }
+        }
+        if (!have) {
+            RG_DEBUG << "loadSystemFonts(): Unable to load any of the fonts in" << i->second;
+            m_ok = false;
+        }
+    }
+}
+
 bool
 NoteFontMap::checkFile(int size, QString &src) const
 {
@@ -730,18 +790,18 @@ NoteFontMap::checkFile(int size, QString &src) const
 bool
 NoteFontMap::hasInversion(int, CharName charName) const
 {
-    SymbolDataMap::const_iterator i = m_data.find(charName);
-    if (i == m_data.end()) return false;
-    return i->second.hasInversion();
+    const SymbolData *symbol = findSymbol(charName);
+    if (!symbol) return false;
+    return symbol->hasInversion();
 }
 
 bool
 NoteFontMap::getSrc(int size, CharName charName, QString &src) const
 {
-    SymbolDataMap::const_iterator i = m_data.find(charName);
-    if (i == m_data.end()) return false;
+    const SymbolData *symbol = findSymbol(charName);
+    if (!symbol) return false;
 
-    src = i->second.getSrc();
+    src = symbol->getSrc();
     if (src == "") return false;
     return checkFile(size, src);
 }
@@ -749,13 +809,13 @@ NoteFontMap::getSrc(int size, CharName charName, QString &src) const
 bool
 NoteFontMap::getInversionSrc(int size, CharName charName, QString &src) const
 {
-    SymbolDataMap::const_iterator i = m_data.find(charName);
-    if (i == m_data.end())
+    const SymbolData *symbol = findSymbol(charName);
+    if (!symbol)
         return false;
 
-    if (!i->second.hasInversion())
+    if (!symbol->hasInversion())
         return false;
-    src = i->second.getInversionSrc();
+    src = symbol->getInversionSrc();
     if (src == "")
         return false;
     return checkFile(size, src);
@@ -765,15 +825,15 @@ SystemFont *
 NoteFontMap::getSystemFont(int size, CharName charName, int &charBase)
 const
 {
-    SymbolDataMap::const_iterator i = m_data.find(charName);
-    if (i == m_data.end())
+    const SymbolData *symbol = findSymbol(charName);
+    if (!symbol)
         return nullptr;
 
     SizeDataMap::const_iterator si = m_sizes.find(size);
     if (si == m_sizes.end())
         return nullptr;
 
-    int fontId = i->second.getFontId();
+    int fontId = symbol->getFontId();
 
     unsigned int fontHeight = 0;
     if (!si->second.getFontHeight(fontId, fontHeight)) {
@@ -813,11 +873,11 @@ const
 SystemFont::Strategy
 NoteFontMap::getStrategy(int, CharName charName) const
 {
-    SymbolDataMap::const_iterator i = m_data.find(charName);
-    if (i == m_data.end())
+    const SymbolData *symbol = findSymbol(charName);
+    if (!symbol)
         return SystemFont::PreferGlyphs;
 
-    int fontId = i->second.getFontId();
+    int fontId = symbol->getFontId();
     SystemFontStrategyMap::const_iterator si =
         m_systemFontStrategies.find(fontId);
 
@@ -831,44 +891,44 @@ NoteFontMap::getStrategy(int, CharName charName) const
 bool
 NoteFontMap::getCode(int, CharName charName, int &code) const
 {
-    SymbolDataMap::const_iterator i = m_data.find(charName);
-    if (i == m_data.end())
+    const SymbolData *symbol = findSymbol(charName);
+    if (!symbol)
         return false;
 
-    code = i->second.getCode();
+    code = symbol->getCode();
     return (code >= 0);
 }
 
 bool
 NoteFontMap::getInversionCode(int, CharName charName, int &code) const
 {
-    SymbolDataMap::const_iterator i = m_data.find(charName);
-    if (i == m_data.end())
+    const SymbolData *symbol = findSymbol(charName);
+    if (!symbol)
         return false;
 
-    code = i->second.getInversionCode();
+    code = symbol->getInversionCode();
     return (code >= 0);
 }
 
 bool
 NoteFontMap::getGlyph(int, CharName charName, int &glyph) const
 {
-    SymbolDataMap::const_iterator i = m_data.find(charName);
-    if (i == m_data.end())
+    const SymbolData *symbol = findSymbol(charName);
+    if (!symbol)
         return false;
 
-    glyph = i->second.getGlyph();
+    glyph = symbol->getGlyph();
     return (glyph >= 0);
 }
 
 bool
 NoteFontMap::getInversionGlyph(int, CharName charName, int &glyph) const
 {
-    SymbolDataMap::const_iterator i = m_data.find(charName);
-    if (i == m_data.end())
+    const SymbolData *symbol = findSymbol(charName);
+    if (!symbol)
         return false;
 
-    glyph = i->second.getInversionGlyph();
+    glyph = symbol->getInversionGlyph();
     return (glyph >= 0);
 }
 
@@ -936,10 +996,10 @@ bool
 NoteFontMap::getHotspot(int size, CharName charName, int width, int height,
                         int &x, int &y) const
 {
-    HotspotDataMap::const_iterator i = m_hotspots.find(charName);
-    if (i == m_hotspots.end())
+    const int id = findSymbolId(charName);
+    if (id < 0 || m_hotspots[id].isEmpty())
         return false;
-    return i->second.getHotspot(size, width, height, x, y);
+    return m_hotspots[id].getHotspot(size, width, height, x, y);
 }
 
 bool
@@ -973,6 +1033,282 @@ NoteFontMap::HotspotData::getHotspot(int size, int width, int height,
     return true;
 }
 
+void
+NoteFontMap::SymbolData::write(QDataStream &stream) const
+{
+    stream << qint32(m_fontId) << m_src << m_inversionSrc
+           << qint32(m_code) << qint32(m_inversionCode)
+           << qint32(m_glyph) << qint32(m_inversionGlyph);
+}
+
+void
+NoteFontMap::SymbolData::read(QDataStream &stream)
+{
+    qint32 fontId = 0, code = -1, inversionCode = -1;
+    qint32 glyph = -1, inversionGlyph = -1;
+    stream >> fontId >> m_src >> m_inversionSrc
+           >> code >> inversionCode >> glyph >> inversionGlyph;
+    m_fontId = fontId;
+    m_code = code;
+    m_inversionCode = inversionCode;
+    m_glyph = glyph;
+    m_inversionGlyph = inversionGlyph;
+}
+
+void
+NoteFontMap::HotspotData::write(QDataStream &stream) const
+{
+    stream << m_scaled.first << m_scaled.second << quint32(m_data.size());
+    for (DataMap::const_iterator i = m_data.begin(); i != m_data.end(); ++i) {
+        stream << qint32(i->first)
+               << qint32(i->second.first) << qint32(i->second.second);
+    }
+}
+
+void
+NoteFontMap::HotspotData::read(QDataStream &stream)
+{
+    quint32 count = 0;
+    stream >> m_scaled.first >> m_scaled.second >> count;
+    m_data.clear();
+    for (quint32 n = 0; n < count && stream.status() == QDataStream::Ok; ++n) {
+        qint32 size = 0, x = 0, y = 0;
+        stream >> size >> x >> y;
+        m_data[size] = Point(x, y);
+    }
+}
+
+void
+NoteFontMap::SizeData::write(QDataStream &stream) const
+{
+    stream << qint32(m_stemThickness) << qint32(m_beamThickness)
+           << qint32(m_stemLength) << qint32(m_flagSpacing)
+           << qint32(m_staffLineThickness) << qint32(m_legerLineThickness)
+           << quint32(m_fontHeights.size());
+    for (std::map<int, int>::const_iterator i = m_fontHeights.begin();
+         i != m_fontHeights.end(); ++i) {
+        stream << qint32(i->first) << qint32(i->second);
+    }
+}
+
+void
+NoteFontMap::SizeData::read(QDataStream &stream)
+{
+    qint32 stemThickness = -1, beamThickness = -1;
+    qint32 stemLength = -1, flagSpacing = -1;
+    qint32 staffLineThickness = -1, legerLineThickness = -1;
+    quint32 count = 0;
+    stream >> stemThickness >> beamThickness >> stemLength >> flagSpacing
+           >> staffLineThickness >> legerLineThickness >> count;
+    m_stemThickness = stemThickness;
+    m_beamThickness = beamThickness;
+    m_stemLength = stemLength;
+    m_flagSpacing = flagSpacing;
+    m_staffLineThickness = staffLineThickness;
+    m_legerLineThickness = legerLineThickness;
+    m_fontHeights.clear();
+    for (quint32 n = 0; n < count && stream.status() == QDataStream::Ok; ++n) {
+        qint32 fontId = 0, height = 0;
+        stream >> fontId >> height;
+        m_fontHeights[fontId] = height;
+    }
+}
+
+QString
+NoteFontMap::getCacheFile(const QString &mapFileName)
+{
+    return ResourceFinder().getResourceSavePath
+        ("fonts/cache",
+         QString("%1.cache").arg(QFileInfo(mapFileName).completeBaseName()));
+}
+
+bool
+NoteFontMap::loadCache(const QString &cacheFile, const QString &mapFileName)
+{
+    if (cacheFile.isEmpty())
+        return false;
+
+    QFile file(cacheFile);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+
+    quint32 magic = 0, version = 0;
+    QString sourceFile;
+    qint64 sourceSize = 0, sourceModified = 0;
+    QByteArray sourceHash;
+    stream >> magic >> version >> sourceFile
+           >> sourceSize >> sourceModified >> sourceHash;
+
+    const QFileInfo source(mapFileName);
+    if (stream.status() != QDataStream::Ok ||
+        magic != CACHE_MAGIC ||
+        version != CACHE_VERSION ||
+        sourceFile != mapFileName ||
+        sourceSize != source.size()) {
+        RG_DEBUG << "loadCache(): cache" << cacheFile << "is out of date";
+        return false;
+    }
+
+    // A new timestamp alone, as when the same file is installed again,
+    // is not worth a parse.  Check the contents and restamp the cache.
+    const bool touched =
+        (sourceModified != source.lastModified().toMSecsSinceEpoch());
+    if (touched && sourceHash != hashFile(mapFileName)) {
+        RG_DEBUG << "loadCache(): cache" << cacheFile << "is out of date";
+        return false;
+    }
+
+    // Read into temporaries, so a truncated cache leaves us ready to
+    // parse the XML instead.
+
+    QString name, origin, copyright, mappedBy, type, srcDirectory;
+    bool smooth = false;
+    stream >> name >> origin >> copyright >> mappedBy >> type
+           >> smooth >> srcDirectory;
+
+    SizeDataMap sizes;
+    quint32 count = 0;
+    stream >> count;
+    for (quint32 n = 0; n < count && stream.status() == QDataStream::Ok; ++n) {
+        qint32 size = 0;
+        stream >> size;
+        sizes[size].read(stream);
+    }
+
+    SystemFontRequirementMap requirements;
+    stream >> count;
+    for (quint32 n = 0; n < count && stream.status() == QDataStream::Ok; ++n) {
+        qint32 fontId = 0;
+        stream >> fontId;
+        stream >> requirements[fontId];
+    }
+
+    SystemFontStrategyMap strategies;
+    stream >> count;
+    for (quint32 n = 0; n < count && stream.status() == QDataStream::Ok; ++n) {
+        qint32 fontId = 0, strategy = 0;
+        stream >> fontId >> strategy;
+        strategies[fontId] = SystemFont::Strategy(strategy);
+    }
+
+    CharBaseMap bases;
+    stream >> count;
+    for (quint32 n = 0; n < count && stream.status() == QDataStream::Ok; ++n) {
+        qint32 fontId = 0, base = 0;
+        stream >> fontId >> base;
+        bases[fontId] = base;
+    }
+
+    SymbolIdMap symbolIds;
+    std::vector<SymbolData> symbols;
+    std::vector<HotspotData> hotspots;
+    stream >> count;
+    for (quint32 n = 0; n < count && stream.status() == QDataStream::Ok; ++n) {
+        CharName charName;
+        stream >> charName;
+        symbolIds[charName] = int(n);
+        symbols.push_back(SymbolData());
+        symbols.back().read(stream);
+        hotspots.push_back(HotspotData());
+        hotspots.back().read(stream);
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        RG_WARNING << "loadCache(): cache" << cacheFile << "is truncated";
+        return false;
+    }
+
+    m_name = name;
+    m_origin = origin;
+    m_copyright = copyright;
+    m_mappedBy = mappedBy;
+    m_type = type;
+    m_smooth = smooth;
+    m_srcDirectory = srcDirectory;
+    m_sizes.swap(sizes);
+    m_systemFontRequirements.swap(requirements);
+    m_systemFontStrategies.swap(strategies);
+    m_bases.swap(bases);
+    m_symbolIds.swap(symbolIds);
+    m_symbols.swap(symbols);
+    m_hotspots.swap(hotspots);
+
+    if (touched) {
+        file.close();
+        saveCache(cacheFile, mapFileName);
+    }
+
+    return true;
+}
+
+bool
+NoteFontMap::saveCache(const QString &cacheFile,
+                       const QString &mapFileName) const
+{
+    if (cacheFile.isEmpty())
+        return false;
+
+    QFile file(cacheFile);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream stream(&file);
+
+    const QFileInfo source(mapFileName);
+    stream << CACHE_MAGIC << CACHE_VERSION << mapFileName
+           << qint64(source.size())
+           << qint64(source.lastModified().toMSecsSinceEpoch())
+           << hashFile(mapFileName);
+
+    stream << m_name << m_origin << m_copyright << m_mappedBy << m_type
+           << m_smooth << m_srcDirectory;
+
+    stream << quint32(m_sizes.size());
+    for (SizeDataMap::const_iterator i = m_sizes.begin();
+         i != m_sizes.end(); ++i) {
+        stream << qint32(i->first);
+        i->second.write(stream);
+    }
+
+    stream << quint32(m_systemFontRequirements.size());
+    for (SystemFontRequirementMap::const_iterator i =
+             m_systemFontRequirements.begin();
+         i != m_systemFontRequirements.end(); ++i) {
+        stream << qint32(i->first) << i->second;
+    }
+
+    stream << quint32(m_systemFontStrategies.size());
+    for (SystemFontStrategyMap::const_iterator i =
+             m_systemFontStrategies.begin();
+         i != m_systemFontStrategies.end(); ++i) {
+        stream << qint32(i->first) << qint32(i->second);
+    }
+
+    stream << quint32(m_bases.size());
+    for (CharBaseMap::const_iterator i = m_bases.begin();
+         i != m_bases.end(); ++i) {
+        stream << qint32(i->first) << qint32(i->second);
+    }
+
+    // In id order, so the ids are the same when read back.
+    std::vector<CharName> names(m_symbols.size());
+    for (SymbolIdMap::const_iterator i = m_symbolIds.begin();
+         i != m_symbolIds.end(); ++i) {
+        names[i->second] = i->first;
+    }
+
+    stream << quint32(m_symbols.size());
+    for (size_t id = 0; id < m_symbols.size(); ++id) {
+        stream << names[id];
+        m_symbols[id].write(stream);
+        m_hotspots[id].write(stream);
+    }
+
+    return stream.status() == QDataStream::Ok;
+}
+
 QStringList
 // cppcheck-suppress unusedFunction
 NoteFontMap::getSystemFontNames() const
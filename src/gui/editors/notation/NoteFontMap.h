@@ -29,7 +29,9 @@
 #include <map>
 #include <set>
 #include <utility>
+#include <vector>
 
+class QDataStream;
 class QXmlStreamAttributes;
 
 
@@ -42,7 +44,13 @@ class NoteFontMap : public XMLHandler
 public:
     typedef Exception MappingFileReadFailed;
 
-    explicit NoteFontMap(QString name); // load and parse the XML mapping file
+    /**
+     * Load the XML mapping file for the named font.  The parsed map is
+     * cached in binary in the user's resource directory, and the cache
+     * is used instead of the XML whenever it was made from the mapping
+     * file as it is now.
+     */
+    explicit NoteFontMap(QString name);
     ~NoteFontMap() override;
 
     /**
@@ -140,6 +148,16 @@ private:
                    m_inversionSrc   != "";
         }
 
+        /// False for a symbol that only has a hotspot.
+        bool isDefined() const {
+            return m_glyph >= 0 ||
+                   m_code  >= 0 ||
+                   m_src   != "";
+        }
+
+        void write(QDataStream &stream) const;
+        void read(QDataStream &stream);
+
     private:
         int m_fontId;
         QString m_src;
@@ -171,6 +189,14 @@ private:
 
         bool getHotspot(int size, int width, int height, int &x, int &y) const;
 
+        /// True for a symbol with no hotspot element.
+        bool isEmpty() const {
+            return m_data.empty() && m_scaled == ScaledPoint(-1.0, -1.0);
+        }
+
+        void write(QDataStream &stream) const;
+        void read(QDataStream &stream);
+
     private:
         DataMap m_data;
         ScaledPoint m_scaled;
@@ -260,6 +286,9 @@ private:
             return false;
         }
 
+        void write(QDataStream &stream) const;
+        void read(QDataStream &stream);
+
     private:
         int m_stemThickness;
         int m_beamThickness;
@@ -281,15 +310,21 @@ private:
 
     QString m_srcDirectory;
 
-    typedef std::map<CharName, SymbolData> SymbolDataMap;
-    SymbolDataMap m_data;
-
-    typedef std::map<CharName, HotspotData> HotspotDataMap;
-    HotspotDataMap m_hotspots;
+    // Symbols and their hotspots are kept in flat arrays indexed by
+    // symbol id.  Ids are given out in the order names are first seen.
+    typedef std::map<CharName, int> SymbolIdMap;
+    SymbolIdMap m_symbolIds;
+    std::vector<SymbolData> m_symbols;
+    std::vector<HotspotData> m_hotspots;
 
     typedef std::map<int, SizeData> SizeDataMap;
     SizeDataMap m_sizes;
 
+    // The system fonts each font id may use, in order of preference.
+    typedef std::map<int, QStringList> SystemFontRequirementMap;
+    SystemFontRequirementMap m_systemFontRequirements;
+
+    // The first of each font id's requirements that could be loaded.
     typedef std::map<int, QString> SystemFontNameMap;
     SystemFontNameMap m_systemFontNames;
 
@@ -309,6 +344,24 @@ private:
 
     bool checkFile(int size, QString &src) const;
 
+    /// Returns the symbol id for charName, or -1 if it has none.
+    int findSymbolId(const CharName &charName) const;
+
+    /// Returns the symbol id for charName, giving it one if necessary.
+    int addSymbolId(const CharName &charName);
+
+    /// Returns nullptr unless the mapping file defines charName.
+    const SymbolData *findSymbol(const CharName &charName) const;
+
+    /// Find the system fonts for m_systemFontRequirements, and clear
+    /// m_ok if any are missing.
+    void loadSystemFonts();
+
+    static QString getCacheFile(const QString &mapFileName);
+    bool loadCache(const QString &cacheFile, const QString &mapFileName);
+    bool saveCache(const QString &cacheFile,
+                   const QString &mapFileName) const;
+
     bool m_ok;
 };
 
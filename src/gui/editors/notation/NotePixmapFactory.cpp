@@ -28,6 +28,7 @@
 #include "base/NotationRules.h"
 #include "misc/Strings.h"
 #include "misc/ConfigGroups.h"
+#include "misc/Preferences.h"
 #include "base/Exception.h"
 #include "base/NotationTypes.h"
 #include "base/Profiler.h"
@@ -53,7 +54,6 @@
 #include "NoteStyle.h"
 
 #include <QApplication>
-#include <QSettings>
 #include <QMessageBox>
 #include <QBitmap>
 #include <QColor>
@@ -227,54 +227,52 @@ NotePixmapFactory::init(QString fontName, int size)
 
     // Resize the fonts, because the original constructor used point
     // sizes only and we want pixels
-    QFont timeSigFont(defaultTimeSigFontFamily),
-        textFont(defaultSerifFontFamily);
+    const QString timeSigFont =
+        Preferences::getNotationTimeSigFont(defaultTimeSigFontFamily);
+    const QString textFont =
+        Preferences::getNotationTextFont(defaultSerifFontFamily);
 
-    QSettings settings;
-    settings.beginGroup( NotationViewConfigGroup );
-
-    m_timeSigFont = settings.value("timesigfont", timeSigFont).toString();
+    m_timeSigFont = timeSigFont;
     m_timeSigFont.setBold(true);
     m_timeSigFont.setPixelSize(size * 5 / 2);
     m_timeSigFontMetrics = QFontMetrics(m_timeSigFont);
 
-    m_bigTimeSigFont = settings.value("timesigfont", timeSigFont).toString();
+    m_bigTimeSigFont = timeSigFont;
     m_bigTimeSigFont.setPixelSize(size * 4 + 2);
     m_bigTimeSigFontMetrics = QFontMetrics(m_bigTimeSigFont);
 
-    m_tupletCountFont = settings.value("textfont", textFont).toString();
+    m_tupletCountFont = textFont;
     m_tupletCountFont.setBold(true);
     m_tupletCountFont.setPixelSize(size * 2);
     m_tupletCountFontMetrics = QFontMetrics(m_tupletCountFont);
 
-    m_textMarkFont = settings.value("textfont", textFont).toString();
+    m_textMarkFont = textFont;
     m_textMarkFont.setBold(true);
     m_textMarkFont.setItalic(true);
     m_textMarkFont.setPixelSize(size * 2);
     m_textMarkFontMetrics = QFontMetrics(m_textMarkFont);
 
-    m_fingeringFont = settings.value("textfont", textFont).toString();
+    m_fingeringFont = textFont;
     m_fingeringFont.setBold(true);
     m_fingeringFont.setPixelSize(size * 5 / 3);
     m_fingeringFontMetrics = QFontMetrics(m_fingeringFont);
 
-    m_ottavaFont = settings.value("textfont", textFont).toString();
+    m_ottavaFont = textFont;
     m_ottavaFont.setPixelSize(size * 2);
     m_ottavaFontMetrics = QFontMetrics(m_ottavaFont);
 
-    m_clefOttavaFont = settings.value("textfont", textFont).toString();
+    m_clefOttavaFont = textFont;
     m_clefOttavaFont.setPixelSize(getLineSpacing() * 3 / 2);
     m_clefOttavaFontMetrics = QFontMetrics(m_clefOttavaFont);
 
-    m_trackHeaderFont = settings.value("sansfont", m_trackHeaderFont).toString();
+    m_trackHeaderFont =
+        Preferences::getNotationSansFont(defaultSansSerifFontFamily);
     m_trackHeaderFont.setPixelSize(9);
     m_trackHeaderFontMetrics = QFontMetrics(m_trackHeaderFont);
 
     m_trackHeaderBoldFont = m_trackHeaderFont;
     m_trackHeaderBoldFont.setBold(true);
     m_trackHeaderBoldFontMetrics = QFontMetrics(m_trackHeaderBoldFont);
-
-    settings.endGroup();
 }
 
 NotePixmapFactory::~NotePixmapFactory()
@@ -3336,20 +3334,15 @@ NotePixmapFactory::getTextFont(const Text &text) const
         tiny = true;
     }
 
-    QSettings settings;
-    //@@@ JAS Check here first for errors.  Added .beginGroup()
-    settings.beginGroup( NotationViewConfigGroup );
-
     QFont textFont;
 
     if (serif) {
-        textFont = QFont(defaultSerifFontFamily);
-        textFont = settings.value("textfont", textFont).toString();
+        textFont = QFont(Preferences::getNotationTextFont(
+                defaultSerifFontFamily));
     } else {
-        textFont = QFont(defaultSansSerifFontFamily);
-        textFont = settings.value("sansfont", textFont).toString();
+        textFont = QFont(Preferences::getNotationSansFont(
+                defaultSansSerifFontFamily));
     }
-    settings.endGroup();
 
     textFont.setStyleStrategy(QFont::StyleStrategy(QFont::PreferDefault |
                                                    QFont::PreferMatch));
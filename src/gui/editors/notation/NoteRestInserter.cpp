@@ -24,6 +24,7 @@
 #include "misc/Strings.h"
 #include "misc/Debug.h"
 #include "misc/ConfigGroups.h"
+#include "misc/Preferences.h"
 #include "base/Event.h"
 #include "base/NotationTypes.h"
 #include "base/Segment.h"
@@ -142,13 +143,13 @@ NoteRestInserter::NoteRestInserter(NotationWidget* widget) :
     m_alwaysPreview = qStrToBool(settings.value("alwayspreview", "false"));
     m_quickEdit = qStrToBool(settings.value("quickedit", "false"));
 
-    int accOctaveMode = settings.value("accidentaloctavemode", 1).toInt() ;
+    int accOctaveMode = Preferences::getAccidentalOctaveMode();
     m_octaveType =
         (accOctaveMode == 0 ? AccidentalTable::OctavesIndependent :
          accOctaveMode == 1 ? AccidentalTable::OctavesCautionary :
          AccidentalTable::OctavesEquivalent);
 
-    int accBarMode = settings.value("accidentalbarmode", 0).toInt() ;
+    int accBarMode = Preferences::getAccidentalBarMode();
     m_barResetType =
         (accBarMode == 0 ? AccidentalTable::BarResetNone :
          accBarMode == 1 ? AccidentalTable::BarResetCautionary :
@@ -28,8 +28,8 @@
 #include "gui/widgets/CollapsingFrame.h"
 #include "base/ColourMap.h"
 #include "base/Composition.h"
-#include "misc/ConfigGroups.h"
 #include "misc/Debug.h"
+#include "misc/Preferences.h"
 #include "base/Device.h"
 #include "base/Exception.h"
 #include "gui/general/GUIPalette.h"
@@ -63,7 +63,6 @@
 #include <QMessageBox>
 #include <QPixmap>
 #include <QPushButton>
-#include <QSettings>
 #include <QString>
 #include <QWidget>
 
@@ -1325,10 +1324,7 @@ TrackParameterBox::updateWidgets2()
 
     // Pitch Lowest
 
-    QSettings settings;
-    settings.beginGroup(GeneralOptionsConfigGroup);
-    const int octaveBase = settings.value("midipitchoctave", -2).toInt() ;
-    settings.endGroup();
+    const int octaveBase = Preferences::getMIDIPitchOctave();
 
     const bool includeOctave = false;
 
@@ -17,10 +17,9 @@
 
 
 #include "MidiPitchLabel.h"
-#include "misc/ConfigGroups.h"
+#include "misc/Preferences.h"
 
 #include <QApplication>
-#include <QSettings>
 #include <QString>
 
 
@@ -46,15 +45,10 @@ MidiPitchLabel::MidiPitchLabel(int pitch)
 
     } else {
 
-        QSettings settings;
-        settings.beginGroup( GeneralOptionsConfigGroup );
-
-        int baseOctave = settings.value("midipitchoctave", -2).toInt() ;
+        int baseOctave = Preferences::getMIDIPitchOctave();
 
         int octave = (int)(((float)pitch) / 12.0) + baseOctave;
         m_midiNote = QString("%1 %2").arg(notes[pitch % 12]).arg(octave);
-
-        settings.endGroup();
     }
 }
 
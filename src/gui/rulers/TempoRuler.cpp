@@ -54,6 +54,8 @@
 #include <QPaintEvent>
 #include <QMouseEvent>
 
+#include <algorithm>
+
 
 
 namespace Rosegarden
@@ -87,6 +89,10 @@ TempoRuler::TempoRuler(RulerScale *rulerScale,
         m_menu(nullptr),
         m_editTempoController(EditTempoController::self()),
         m_fontMetrics(m_boldFont),
+        m_timePointsValid(false),
+        m_timePointsDefaultTempo(0),
+        m_timePointXFirst(0),
+        m_timePointXLast(0),
         m_Thorn(Thorn)
 {
     m_font.setPixelSize(m_height / 3);
@@ -98,7 +104,9 @@ TempoRuler::TempoRuler(RulerScale *rulerScale,
 
     QObject::connect(
             CommandHistory::getInstance(), &CommandHistory::commandExecuted,
-            this, static_cast<void(TempoRuler::*)()>(&TempoRuler::update));
+            this, &TempoRuler::slotCommandExecuted);
+
+    m_composition->addObserver(this);
 
     createAction("insert_tempo_here", SLOT(slotInsertTempoHere()));
     createAction("insert_tempo_at_pointer", SLOT(slotInsertTempoAtPointer()));
@@ -114,6 +122,130 @@ TempoRuler::TempoRuler(RulerScale *rulerScale,
 
 TempoRuler::~TempoRuler()
 {
+    if (!isCompositionDeleted())
+        m_composition->removeObserver(this);
+}
+
+void
+TempoRuler::tempoChanged(const Composition *)
+{
+    invalidateTimePoints();
+}
+
+void
+TempoRuler::timeSignatureChanged(const Composition *)
+{
+    invalidateTimePoints();
+}
+
+void
+TempoRuler::slotCommandExecuted()
+{
+    // A command may change the ruler scale's layout (e.g. notation bar
+    // widths) without changing the first or last x coordinate.  It may
+    // also change the default tempo, which Composition doesn't tell its
+    // observers about (ModifyDefaultTempoCommand).  Start again.
+    invalidateTimePoints();
+}
+
+void
+TempoRuler::invalidateTimePoints()
+{
+    m_timePointsValid = false;
+    m_timePointX.clear();
+    update();
+}
+
+void
+TempoRuler::updateTimePoints()
+{
+    // SequenceManager sets the default tempo directly, without a command
+    // or a notification.
+    if (m_timePointsValid  &&
+        m_timePointsDefaultTempo == m_composition->getCompositionDefaultTempo())
+        return;
+
+    m_timePoints.clear();
+    m_timePointX.clear();
+
+    constexpr int tempoChangeHere = 1;
+    constexpr int timeSigChangeHere = 2;
+
+    const int tempoCount = m_composition->getTempoChangeCount();
+    const int sigCount = m_composition->getTimeSignatureCount();
+    m_timePoints.reserve(tempoCount + sigCount);
+
+    // Merge the two change lists, which are both in time order.
+    int tempoNo = 0;
+    int sigNo = 0;
+    while (tempoNo < tempoCount  ||  sigNo < sigCount) {
+        const timeT tempoTime = (tempoNo < tempoCount ?
+                m_composition->getTempoChange(tempoNo).first : 0);
+        const timeT sigTime = (sigNo < sigCount ?
+                m_composition->getTimeSignatureChange(sigNo).first : 0);
+
+        TimePoint point;
+        point.changeMask = 0;
+
+        if (tempoNo < tempoCount  &&
+            (sigNo >= sigCount  ||  tempoTime <= sigTime)) {
+            point.time = tempoTime;
+            point.changeMask |= tempoChangeHere;
+            ++tempoNo;
+        } else {
+            point.time = sigTime;
+        }
+
+        if (sigNo < sigCount  &&  sigTime == point.time) {
+            const TimeSignature sig =
+                    m_composition->getTimeSignatureChange(sigNo).second;
+            point.changeMask |= timeSigChangeHere;
+            point.timeSigLabel = QString("%1/%2")
+                    .arg(sig.getNumerator())
+                    .arg(sig.getDenominator());
+            ++sigNo;
+        }
+
+        point.tempoChangeNumber =
+                m_composition->getTempoChangeNumberAt(point.time);
+        point.tempo = m_composition->getTempoAtTime(point.time);
+        point.endTempo = point.tempo;
+        point.qpm = m_composition->getTempoQpm(point.tempo);
+        point.colour = TempoColour::getColour(point.qpm);
+
+        // Now that we know where this one starts, finish the previous.
+        if (!m_timePoints.empty()) {
+            m_timePoints.back().endTempo =
+                    m_composition->getTempoAtTime(point.time - 1);
+        }
+
+        m_timePoints.push_back(point);
+    }
+
+    m_timePointsValid = true;
+    m_timePointsDefaultTempo = m_composition->getCompositionDefaultTempo();
+}
+
+void
+TempoRuler::updateTimePointX()
+{
+    if (m_timePoints.empty())
+        return;
+
+    // Has the zoom level changed?
+    if (!m_timePointX.empty()  &&
+        m_rulerScale->getXForTime(m_timePoints.front().time) ==
+                m_timePointXFirst  &&
+        m_rulerScale->getXForTime(m_timePoints.back().time) ==
+                m_timePointXLast)
+        return;
+
+    m_timePointX.resize(m_timePoints.size());
+    for (size_t i = 0; i < m_timePoints.size(); ++i)
+        m_timePointX[i] = m_rulerScale->getXForTime(m_timePoints[i].time);
+
+    m_timePointXFirst = m_timePointX.front();
+    m_timePointXLast = m_timePointX.back();
 }
 
 void
@@ -583,98 +715,105 @@ TempoRuler::paintEvent(QPaintEvent* e)
     // bmp text aligns better in temporuler now - is this font dependent?
     int textY = fontHeight - 3;
 
-    // Assemble a map of timePoints.
+    updateTimePoints();
+    updateTimePointX();
 
-    typedef std::map<timeT, int /*changeMask*/> TimePoints;
-    // changeMask values.
     constexpr int tempoChangeHere = 1;
     constexpr int timeSigChangeHere = 2;
-    TimePoints timePoints;
-
-    for (int tempoNo = m_composition->getTempoChangeNumberAt(from);
-            tempoNo <= m_composition->getTempoChangeNumberAt(to) + 1; ++tempoNo) {
-
-        if (tempoNo >= 0 && tempoNo < m_composition->getTempoChangeCount()) {
-            timePoints.insert
-            (TimePoints::value_type
-             (m_composition->getTempoChange(tempoNo).first,
-              tempoChangeHere));
-        }
-    }
-
-    for (int sigNo = m_composition->getTimeSignatureNumberAt(from);
-            sigNo <= m_composition->getTimeSignatureNumberAt(to) + 1; ++sigNo) {
 
-        if (sigNo >= 0 && sigNo < m_composition->getTimeSignatureCount()) {
-            timeT time(m_composition->getTimeSignatureChange(sigNo).first);
-            if (timePoints.find(time) != timePoints.end()) {
-                timePoints[time] |= timeSigChangeHere;
-            } else {
-                timePoints.insert(TimePoints::value_type(time, timeSigChangeHere));
-            }
-        }
-    }
+    // Find the points to draw: the change in force at "from" through
+    // the first change after "to".
+    struct TimeLess {
+        bool operator()(timeT t, const TimePoint &point) const
+            { return t < point.time; }
+    };
+    size_t firstIndex = std::upper_bound(
+            m_timePoints.begin(), m_timePoints.end(), from, TimeLess()) -
+            m_timePoints.begin();
+    if (firstIndex > 0)
+        --firstIndex;
+    size_t endIndex = std::upper_bound(
+            m_timePoints.begin(), m_timePoints.end(), to, TimeLess()) -
+            m_timePoints.begin();
+    if (endIndex < m_timePoints.size())
+        ++endIndex;
 
     // Draw the points, lines, and colored backgrounds.
 
     // Keep track of whether we actually have any points.
     bool haveSome = false;
-    //    tempoT minTempo = m_composition->getMinTempo();
-    //    tempoT maxTempo = m_composition->getMaxTempo();
-
-    //if (m_illuminate >= 0) {
-    //    int tcn = m_composition->getTempoChangeNumberAt(from);
-    //  illuminate = (m_illuminate == tcn);
-    //}
 
     RG_DEBUG << "paintEvent" << from << to;
 
-    for (TimePoints::iterator i = timePoints.begin(); ; ++i) {
+    for (size_t k = firstIndex; ; ++k) {
+
+        const bool atEnd = (k >= endIndex);
 
         // Compute the time of the previous point (t0).
 
         timeT t0;
 
-        if (i == timePoints.begin()) {
+        if (k == firstIndex) {
             t0 = from;
         } else {
-            TimePoints::iterator j(i);
-            --j;
-            t0 = j->first;
+            t0 = m_timePoints[k - 1].time;
         }
 
         // Compute the time of the current point (t1).
 
         timeT t1;
 
-        if (i == timePoints.end()) {
+        if (atEnd) {
             t1 = to;
         } else {
-            t1 = i->first;
+            t1 = m_timePoints[k].time;
         }
 
         if (t1 <= t0)
             t1 = to;
 
-        const int tcn = m_composition->getTempoChangeNumberAt(t0);
+        // Use the cached values where we can.  The first and last
+        // spans start or end mid-way, so ask the Composition.
+        int tcn;
+        tempoT tempo0;
+        QColor colour;
+        double x0;
+        if (k == firstIndex) {
+            tcn = m_composition->getTempoChangeNumberAt(t0);
+            tempo0 = m_composition->getTempoAtTime(t0);
+            colour = TempoColour::getColour(
+                    m_composition->getTempoQpm(tempo0));
+            x0 = m_rulerScale->getXForTime(t0) + m_currentXOffset;
+        } else {
+            const TimePoint &point = m_timePoints[k - 1];
+            tcn = point.tempoChangeNumber;
+            tempo0 = point.tempo;
+            colour = point.colour;
+            x0 = m_timePointX[k - 1] + m_currentXOffset;
+        }
+
+        tempoT tempo1;
+        double x1;
+        if (!atEnd  &&  t1 == m_timePoints[k].time) {
+            tempo1 = (k == firstIndex ?
+                      m_composition->getTempoAtTime(t1 - 1) :
+                      m_timePoints[k - 1].endTempo);
+            x1 = m_timePointX[k] + m_currentXOffset;
+        } else {
+            tempo1 = m_composition->getTempoAtTime(t1 - 1);
+            x1 = m_rulerScale->getXForTime(t1) + m_currentXOffset;
+        }
+
+        // At coarse zoom levels several changes can share a pixel.
+        // Only draw the last of them.
+        if (haveSome  &&  !atEnd  &&  x1 - x0 < 1.0)
+            continue;
+
         bool illuminate = (m_illuminate == tcn);
-        const tempoT tempo0 = m_composition->getTempoAtTime(t0);
-        const tempoT tempo1 = m_composition->getTempoAtTime(t1 - 1);
 
         RG_DEBUG << "time point" << t0 << t1 << tempo0 << tempo1 <<
             tcn << m_illuminate;
 
-        double x0, x1;
-        x0 = m_rulerScale->getXForTime(t0) + m_currentXOffset;
-        x1 = m_rulerScale->getXForTime(t1) + m_currentXOffset;
-        /*!!!
-            if (x0 > e->rect().x()) {
-                paint.fillRect(e->rect().x(), 0, x0 - e->rect().x(), height(),
-                       paletteBackgroundColor());
-            }
-        */
-        QColor colour =
-            TempoColour::getColour(m_composition->getTempoQpm(tempo0));
         paint.setPen(colour);
         paint.setBrush(colour);
 
@@ -714,7 +853,7 @@ TempoRuler::paintEvent(QPaintEvent* e)
         }
 
         // We want to go through this loop at least once.  Check for end here.
-        if (i == timePoints.end())
+        if (atEnd)
             break;
 
         // We have more than zero points to plot.  Go ahead and start
@@ -744,28 +883,26 @@ TempoRuler::paintEvent(QPaintEvent* e)
     double prevTempo = 0.0;
     long prevBpm = 0;
 
-    for (TimePoints::iterator i = timePoints.begin();
-            i != timePoints.end(); ++i) {
-
-        timeT time = i->first;
-        double x = m_rulerScale->getXForTime(time) + m_currentXOffset;
+    for (size_t k = firstIndex; k < endIndex; ++k) {
 
-        if ((i->second & timeSigChangeHere)) {
+        const TimePoint &point = m_timePoints[k];
 
-            TimeSignature sig =
-                m_composition->getTimeSignatureAt(time);
+        timeT time = point.time;
+        double x = m_timePointX[k] + m_currentXOffset;
 
-            QString str = QString("%1/%2")
-                          .arg(sig.getNumerator())
-                          .arg(sig.getDenominator());
+        // Skip the labels of changes that were merged when drawing.
+        if (k + 1 < endIndex  &&  m_timePointX[k + 1] - m_timePointX[k] < 1.0)
+            continue;
 
+        if ((point.changeMask & timeSigChangeHere)) {
             paint.setFont(m_boldFont);
-            paint.drawText(static_cast<int>(x) + 2, m_height - 2, str);
+            paint.drawText(static_cast<int>(x) + 2, m_height - 2,
+                           point.timeSigLabel);
         }
 
-        if ((i->second & tempoChangeHere)) {
+        if ((point.changeMask & tempoChangeHere)) {
 
-            double tempo = m_composition->getTempoQpm(m_composition->getTempoAtTime(time));
+            double tempo = point.qpm;
             long bpm = long(tempo);
             //        long frac = long(tempo * 100 + 0.001) - 100 * bpm;
 
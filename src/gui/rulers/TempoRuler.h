@@ -21,14 +21,18 @@
 #include "gui/dialogs/TempoDialog.h"
 #include "gui/general/ActionFileClient.h"
 
+#include "base/Composition.h"
 #include "base/Event.h"
 
+#include <QColor>
 #include <QFont>
 #include <QFontMetrics>
 #include <QPixmap>
 #include <QSize>
 #include <QWidget>
 
+#include <vector>
+
 
 class QWheelEvent;
 class QMenu;
@@ -42,7 +46,6 @@ namespace Rosegarden
 class EditTempoController;
 class RulerScale;
 class RosegardenDocument;
-class Composition;
 
 
 /**
@@ -50,7 +53,8 @@ class Composition;
  * x-coordinates corresponding to tempo changes in a Composition.
  */
 
-class TempoRuler : public QWidget, public ActionFileClient
+class TempoRuler : public QWidget, public ActionFileClient,
+                   public CompositionObserver
 {
     Q_OBJECT
 
@@ -75,6 +79,10 @@ public:
 
     void setMinimumWidth(int width) { m_width = width; }
 
+    // CompositionObserver overrides
+    void tempoChanged(const Composition *) override;
+    void timeSignatureChanged(const Composition *) override;
+
 signals:
     void mousePress();
     void mouseRelease();
@@ -91,6 +99,7 @@ protected slots:
     void slotEditTempo();
     void slotEditTimeSignature();
     void slotEditTempos();
+    void slotCommandExecuted();
 
 protected:
     void paintEvent(QPaintEvent *) override;
@@ -147,6 +156,49 @@ private:
     QFontMetrics m_fontMetrics;
     QPixmap      m_buffer;
 
+    /// A tempo and/or time signature change, as drawn by paintEvent().
+    /**
+     * Everything paintEvent() needs from the Composition is gathered
+     * here once so that painting doesn't have to query the tempo map
+     * for each change every time.
+     */
+    struct TimePoint
+    {
+        timeT time;
+        int changeMask;
+        /// getTempoChangeNumberAt(time)
+        int tempoChangeNumber;
+        /// getTempoAtTime(time)
+        tempoT tempo;
+        /// getTempoAtTime(next point's time - 1)
+        tempoT endTempo;
+        double qpm;
+        QColor colour;
+        /// "n/d" if there is a time signature change here.
+        QString timeSigLabel;
+    };
+    typedef std::vector<TimePoint> TimePointVector;
+
+    /// All the tempo and time signature changes in the Composition.
+    TimePointVector m_timePoints;
+    bool m_timePointsValid;
+    /// The default tempo m_timePoints was computed with.
+    tempoT m_timePointsDefaultTempo;
+    void updateTimePoints();
+
+    /// Ruler scale x coordinate of each of m_timePoints.
+    /**
+     * Only valid for the zoom level and layout of the ruler scale at the
+     * time it was computed.  Checked against the x coordinates of the
+     * first and last points.
+     */
+    std::vector<double> m_timePointX;
+    double m_timePointXFirst;
+    double m_timePointXLast;
+    void updateTimePointX();
+
+    void invalidateTimePoints();
+
     bool m_Thorn;
 };
 
@@ -103,6 +103,13 @@ void InternalSegmentMapper::fillBuffer()
     m_controllerCache.clear();
     m_noteOffs = NoteoffContainer();
 
+    // Sounding times of the segment's own events.  These take ties and
+    // grace notes into account, which means looking at neighbouring
+    // events, so work them all out once rather than for every event
+    // on every repeat.
+    SegmentPerformanceHelper::SoundingTimeMap soundingTimes;
+    SegmentPerformanceHelper(*m_segment).getSoundingTimes(soundingTimes);
+
     for (int repeatNo = 0; repeatNo <= repeatCount; ++repeatNo) {
 
         // For triggered segments.  We write their notes into
@@ -161,6 +168,14 @@ void InternalSegmentMapper::fillBuffer()
                 long triggerId = -1;
                 (**k)->get<Int>(BaseProperties::TRIGGER_SEGMENT_ID, triggerId);
 
+                // m_triggeredEvents holds one time thru, so ornaments
+                // are expanded on the first and just played again on
+                // the repeats.
+                if (triggerId >= 0  &&  repeatNo > 0) {
+                    ++j;
+                    continue;
+                }
+
                 if (triggerId >= 0) {
 
                     TriggerSegmentRec *rec =
@@ -186,11 +201,10 @@ void InternalSegmentMapper::fillBuffer()
                             (m_triggeredEvents->findTime(refTime));
 
                         // Recalculate how much buffer space to
-                        // reserve.  !!! Probably should calculate the
-                        // extra from m_triggeredEvents rather than
-                        // rec->getSegment()
+                        // reserve, counting everything triggered so
+                        // far.
                         int spaceNeeded =
-                            addSize(calculateSize(), rec->getSegment());
+                            addSize(calculateSize(), m_triggeredEvents);
                         // Reserve more space if we will need it.
                         if (spaceNeeded > capacity()) {
                             reserve(spaceNeeded);
@@ -210,15 +224,23 @@ void InternalSegmentMapper::fillBuffer()
             //
             if (!(**k)->isa(Note::EventRestType)) {
 
-                SegmentPerformanceHelper helper
-                (usingImplied ? *m_triggeredEvents : *m_segment);
+                timeT playTime;
+                timeT playDuration;
+
+                if (usingImplied) {
+                    SegmentPerformanceHelper helper(*m_triggeredEvents);
+                    playTime = helper.getSoundingAbsoluteTime(*k);
+                    playDuration = helper.getSoundingDuration(*k);
+                } else {
+                    const SegmentPerformanceHelper::SoundingTime &sounding =
+                        soundingTimes[**k];
+                    playTime = sounding.absoluteTime;
+                    playDuration = sounding.duration;
+                }
 
-                timeT playTime =
-                    helper.getSoundingAbsoluteTime(*k) + timeForRepeats;
+                playTime += timeForRepeats;
                 if (playTime >= repeatEndTime) break;
 
-                timeT playDuration = helper.getSoundingDuration(*k);
-
                 // Ignore notes without duration -- they're probably in a tied
                 // series but not as first note
                 //
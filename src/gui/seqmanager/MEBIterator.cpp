@@ -28,6 +28,7 @@ MEBIterator::MEBIterator(
         QSharedPointer<MappedEventBuffer> mappedEventBuffer) :
     m_mappedEventBuffer(mappedEventBuffer),
     m_index(0),
+    m_generatedEvent(),
     m_ready(false),
     m_active(false),
     m_currentTime()
@@ -51,6 +52,33 @@ MEBIterator::moveTo(const RealTime &time)
     // iteration, we leave the lock on until we're done.
     QReadLocker locker(getLock());
 
+    // Generated buffers can be very long, so rather than make every
+    // event on the way, find the first event starting at or after time,
+    // then back up over any still sounding at time.
+    if (m_mappedEventBuffer->isGenerated()) {
+        int low = m_index;
+        int high = m_mappedEventBuffer->size();
+        while (low < high) {
+            const int middle = low + (high - low) / 2;
+            if (peekAt(middle)->getEventTime() < time)
+                low = middle + 1;
+            else
+                high = middle;
+        }
+        while (low > m_index) {
+            const MappedEvent *event = peekAt(low - 1);
+            if (event->getEventTime() + event->getDuration() < time)
+                break;
+            --low;
+        }
+        m_index = low;
+
+        // Since we moved, we need to send a channel setup again.
+        m_ready = false;
+
+        return;
+    }
+
     // For each event from the current iterator position
     while (1) {
         if (atEnd())
@@ -92,8 +120,21 @@ MEBIterator::peek() const
     if (m_index >= m_mappedEventBuffer->size())
         return nullptr;
 
+    return peekAt(m_index);
+}
+
+MappedEvent *
+MEBIterator::peekAt(int index) const
+{
+    // Generated buffers make the event on the spot.  It stays good
+    // until the next peek().
+    if (m_mappedEventBuffer->isGenerated()) {
+        m_mappedEventBuffer->generateEvent(index, m_generatedEvent);
+        return &m_generatedEvent;
+    }
+
     // Otherwise return a pointer into the buffer.
-    return &m_mappedEventBuffer->m_buffer[m_index];
+    return &m_mappedEventBuffer->m_buffer[index];
 }
 
 void
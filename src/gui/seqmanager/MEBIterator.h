@@ -19,9 +19,12 @@
 #define RG_MEBITERATOR_H
 
 #include "MappedEventBuffer.h"
+#include "sound/MappedEvent.h"
 
 #include <QSharedPointer>
 
+#include <rosegardenprivate_export.h>
+
 namespace Rosegarden {
 
 
@@ -30,7 +33,7 @@ namespace Rosegarden {
  * MappedBufMetaIterator creates and manages these.
  * MappedBufMetaIterator::m_iterators is a std::vector of these.
  */
-class MEBIterator
+class ROSEGARDENPRIVATE_EXPORT MEBIterator
 {
 public:
     explicit MEBIterator(QSharedPointer<MappedEventBuffer> mappedEventBuffer);
@@ -157,12 +160,21 @@ public:
         { return &m_mappedEventBuffer->m_lock; }
 
 private:
+    /// peek() without the range check.
+    MappedEvent *peekAt(int index) const;
+
     /// The buffer this iterator points into.
     QSharedPointer<MappedEventBuffer> m_mappedEventBuffer;
 
     /// Position of the iterator in the buffer.
     int m_index;
 
+    /// Where peek() makes the event for a generated buffer.
+    /**
+     * @see MappedEventBuffer::generateEvent()
+     */
+    mutable MappedEvent m_generatedEvent;
+
     // Additional non-iterator information.
 
     /// Whether we are ready with regard to performance time.
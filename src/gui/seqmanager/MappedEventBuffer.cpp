@@ -33,6 +33,7 @@ namespace Rosegarden
 
 MappedEventBuffer::MappedEventBuffer(RosegardenDocument *doc) :
     m_doc(doc),
+    m_generated(false),
     m_end(std::numeric_limits<int>::max(), 0),  // 68 years
     m_buffer(nullptr),
     m_capacity(0),
@@ -181,6 +182,14 @@ doInsert(MappedInserterBase &inserter, MappedEvent &evt,
     inserter.insertCopy(evt);
 }
 
+void
+MappedEventBuffer::
+generateEvent(int /*index*/, MappedEvent &event) const
+{
+    // Only called if m_generated, by derivers that override this.
+    event = MappedEvent();
+}
+
 // The default doesn't have to do anything to get ready.
 void
 MappedEventBuffer::
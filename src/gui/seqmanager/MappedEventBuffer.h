@@ -24,6 +24,8 @@
 #include <QReadWriteLock>
 #include <QAtomicInt>
 
+#include <rosegardenprivate_export.h>
+
 namespace Rosegarden
 {
 
@@ -63,7 +65,7 @@ class RosegardenDocument;
  * metaiterators (MappedBufMetaIterator?) and by ChannelManager and deletes
  * itself when the last owner is removed.  See addOwner() and removeOwner().
  */
-class MappedEventBuffer
+class ROSEGARDENPRIVATE_EXPORT MappedEventBuffer
 {
 
 public:
@@ -134,6 +136,12 @@ public:
         end   = m_end;
     }
 
+    /// Whether the events are made as they are read.
+    /**
+     * @see generateEvent()
+     */
+    bool isGenerated() const  { return m_generated; }
+
     virtual TrackId getTrackID() const  { return NoTrack; }
     virtual void insertChannelSetup(MappedInserterBase &)  { }
 
@@ -203,6 +211,21 @@ protected:
      */
     virtual bool shouldPlay(MappedEvent *evt, RealTime startTime)=0;
 
+    /// Make event number index of a generated buffer.
+    /**
+     * Mappers whose events follow a simple rule, like MetronomeMapper's
+     * ticks, would otherwise need a buffer the length of the whole
+     * composition.  Instead they can set m_generated, leave the buffer
+     * empty and just resize() it to the number of events.  MEBIterator
+     * then calls this to make each event as it is read, on the
+     * sequencer thread, so it must not touch the document.
+     *
+     * The events must be in time order, as always.
+     *
+     * @see m_generated
+     */
+    virtual void generateEvent(int index, MappedEvent &event) const;
+
 
     /// Not used here.  Convenience for derivers.
     /**
@@ -211,6 +234,9 @@ protected:
      */
     RosegardenDocument *m_doc;
 
+    /// The events are made by generateEvent() rather than kept in m_buffer.
+    bool m_generated;
+
     /// Earliest sounding time.
     /**
      * It is the responsibility of "fillBuffer()" to keep this field
@@ -232,6 +258,13 @@ protected:
     /// Add an event to the buffer.
     void mapAnEvent(MappedEvent *e);
 
+    /// The lock readers hold while they use an event.  See m_lock.
+    /**
+     * Derivers that set m_generated lock this for write while they
+     * change what generateEvent() reads.
+     */
+    QReadWriteLock *getLock()  { return &m_lock; }
+
     /// Set the sounding times (m_start, m_end).
     /**
      * InternalSegmentMapper::fillBuffer() keeps this updated.
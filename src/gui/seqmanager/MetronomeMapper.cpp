@@ -21,6 +21,7 @@
 
 #include "misc/Debug.h"
 #include "misc/ConfigGroups.h"
+#include "misc/Preferences.h"
 #include "base/MidiProgram.h"  // For InstrumentId
 #include "base/RealTime.h"
 #include "base/Studio.h"
@@ -35,7 +36,7 @@
 
 #include <QSettings>
 
-#include <algorithm>  // For std::sort().
+#include <algorithm>  // For std::sort(), std::upper_bound()
 
 namespace Rosegarden
 {
@@ -43,12 +44,20 @@ namespace Rosegarden
 
 MetronomeMapper::MetronomeMapper(RosegardenDocument *doc) :
     MappedEventBuffer(doc),
+    m_metronomeTicks(0),
+    m_clockStart(0),
+    m_clockInterval(Note(Note::Crotchet).getDuration() / 24),
+    m_clockTicks(0),
+    m_defaultTempo(0),
     m_metronome(nullptr),
     m_channelManager(nullptr), // We will set this below after we find instrument.
     m_metronomeDuring(GeneralConfigurationPage::DuringBoth)
 {
     //RG_DEBUG << "ctor: " << this;
 
+    // The ticks are made as they are read.  See generateEvent().
+    m_generated = true;
+
     Studio &studio = m_doc->getStudio();
 
     const DeviceId metronomeDeviceId = studio.getMetronomeDevice();
@@ -70,33 +79,86 @@ MetronomeMapper::MetronomeMapper(RosegardenDocument *doc) :
     m_channelManager.setInstrument(m_instrument);
     m_channelManager.setEternalInterval();
 
-    Composition &composition = m_doc->getComposition();
-
-    int depth = m_metronome->getDepth();
+    // Work out the ticks and copy the tempo map.
+    fillBuffer();
 
-    // If the metronome has bars at the very least, generate the metronome
-    // ticks.
-    if (depth > 0) {
+    if (m_metronomeTicks == 0  &&  m_clockTicks == 0) {
+        RG_WARNING << "ctor: WARNING no ticks generated";
+    }
+}
 
-        // Start at a somewhat arbitrary time (-20) prior to the beginning
-        // of the composition.
-        timeT barStart = composition.getBarStart(-20);
-        m_start = composition.getElapsedRealTime(barStart);
+MetronomeMapper::~MetronomeMapper()
+{
+    //RG_DEBUG << "dtor: " << this;
 
-        // For each bar
-        for (timeT barTime = barStart;
-             barTime < composition.getEndMarker();
-             barTime = composition.getBarEndForTime(barTime)) {
+    delete m_metronome;
+    m_metronome = nullptr;
+}
 
-            // Add the bar tick
-            m_ticks.push_back(Tick(barTime, BarTick));
+InstrumentId MetronomeMapper::getMetronomeInstrument() const
+{
+    return m_metronome->getInstrument();
+}
 
-            // If all they want is bars, move to the next bar.
-            if (depth == 1)
-                continue;
+int
+MetronomeMapper::makeBarRuns(const Composition &composition, timeT barStart,
+                             int depth, BarRunContainer &barRuns)
+{
+    int metronomeTicks = 0;
+
+    const timeT endMarker = composition.getEndMarker();
+
+    // Whether a bar of the given duration starts at barTime.
+    auto isBar = [&composition](timeT barTime, timeT barDuration) {
+        return composition.getBarStartForTime(barTime) == barTime  &&
+               composition.getBarEndForTime(barTime) ==
+                       barTime + barDuration;
+    };
+
+    timeT barTime = barStart;
+
+    // For each run of bars
+    while (barTime < endMarker) {
+        const timeT barEnd = composition.getBarEndForTime(barTime);
+        // Just in case.
+        if (barEnd <= barTime)
+            break;
+
+        BarRun run;
+        run.start = barTime;
+        run.barDuration = barEnd - barTime;
+        run.firstTick = metronomeTicks;
+
+        // The bars that follow are the same up to the next time
+        // signature.
+        timeT runEnd = endMarker;
+        const int timeSigNumber =
+                composition.getTimeSignatureNumberAt(barTime);
+        if (timeSigNumber + 1 < composition.getTimeSignatureCount()) {
+            runEnd = std::min(runEnd, composition.getTimeSignatureChange(
+                    timeSigNumber + 1).first);
+        }
+        run.bars = std::max(1, static_cast<int>(
+                (runEnd - barTime + run.barDuration - 1) / run.barDuration));
+
+        // Unless the last is cut short by that time signature, or we
+        // are somewhere odd, like before the first time signature in an
+        // anacrusis.  Then just take the one bar.
+        if (run.bars > 1  &&
+            !isBar(barTime + (run.bars - 1) * run.barDuration,
+                   run.barDuration)) {
+            --run.bars;
+            if (run.bars > 1  &&
+                !isBar(barTime + (run.bars - 1) * run.barDuration,
+                       run.barDuration))
+                run.bars = 1;
+        }
 
-            // Handle beats and subbeats.
+        // Add the bar tick
+        run.ticks.push_back(Tick(0, BarTick));
 
+        // Handle beats and subbeats.
+        if (depth > 1) {
             TimeSignature timeSig = composition.getTimeSignatureAt(barTime);
             timeT barDuration = timeSig.getBarDuration();
 
@@ -116,130 +178,310 @@ MetronomeMapper::MetronomeMapper(RosegardenDocument *doc) :
                     if (tick % divisions[i] == 0)
                         continue;
 
-                    timeT tickTime = barTime + (tick * barDuration) / ticks;
-                    m_ticks.push_back(Tick(tickTime, static_cast<TickType>(i + 1)));
+                    timeT tickTime = (tick * barDuration) / ticks;
+                    // Drop any past the end of a bar that was cut short
+                    // by a time signature change.  They would sound in
+                    // the next bar, usually on top of its own ticks.
+                    if (tickTime >= run.barDuration)
+                        continue;
+                    run.ticks.push_back(Tick(tickTime, static_cast<TickType>(i + 1)));
                 }
             }
+
+            std::sort(run.ticks.begin(), run.ticks.end());
         }
+
+        metronomeTicks += run.bars * static_cast<int>(run.ticks.size());
+        barTime += run.bars * run.barDuration;
+
+        barRuns.push_back(run);
     }
 
-    QSettings settings;
-    settings.beginGroup(SequencerOptionsConfigGroup);
-    int midiClock = settings.value("midiclock", 0).toInt();
-    //int mtcMode = settings.value("mtcmode", 0).toInt() ;
-    settings.endGroup();
+    return metronomeTicks;
+}
 
-    // Send
-    if (midiClock == 1) {
-        // 24 MIDI timing clocks per quarter note
-        timeT midiClockTime = Note(Note::Crotchet).getDuration() / 24;
-
-        // For each MIDI timing clock
-        for (timeT t = composition.getStartMarker();
-             t < composition.getEndMarker();
-             t += midiClockTime) {
-            m_ticks.push_back(Tick(t, MidiTimingClockTick));
+void
+MetronomeMapper::makeTempoChanges(const Composition &composition,
+                                  std::vector<TempoChange> &tempoChanges)
+{
+    const int tempoChangeCount = composition.getTempoChangeCount();
+
+    for (int i = 0; i < tempoChangeCount; ++i) {
+        const std::pair<timeT, tempoT> change = composition.getTempoChange(i);
+
+        TempoChange tempoChange;
+        tempoChange.time = change.first;
+        tempoChange.realTime = composition.getElapsedRealTime(change.first);
+        tempoChange.tempo = change.second;
+        tempoChange.target = -1;
+        tempoChange.targetTime = 0;
+
+        // Work out the ramp as Composition::getTempoTarget() does.
+        const std::pair<bool, tempoT> ramping =
+                composition.getTempoRamping(i, false);
+        if (ramping.first) {
+            tempoT target = ramping.second;
+            timeT targetTime;
+            if (i + 1 < tempoChangeCount) {
+                const std::pair<timeT, tempoT> next =
+                        composition.getTempoChange(i + 1);
+                if (target == 0)
+                    target = next.second;
+                targetTime = next.first;
+            } else {
+                targetTime = composition.getEndMarker();
+                if (targetTime < change.first)
+                    target = -1;
+            }
+            if (target > 0) {
+                tempoChange.target = target;
+                tempoChange.targetTime = targetTime;
+            }
         }
-    }
 
-    //if (mtcMode > 0) {
-    //    // do something
-    //}
+        tempoChanges.push_back(tempoChange);
+    }
+}
 
-    std::sort(m_ticks.begin(), m_ticks.end());
+RealTime
+MetronomeMapper::getElapsedRealTime(timeT t) const
+{
+    // The last tempo change at or before t.
+    std::vector<TempoChange>::const_iterator change = std::upper_bound(
+            m_tempoChanges.begin(), m_tempoChanges.end(), t,
+            [](timeT t, const TempoChange &change)
+                { return t < change.time; });
+
+    if (change == m_tempoChanges.begin()) {
+        // Same as Composition::getElapsedRealTime(), which in negative
+        // time uses the first tempo change if it is no later than zero.
+        if (t >= 0  ||  m_tempoChanges.empty()  ||  change->time > 0)
+            return Composition::time2RealTime(t, m_defaultTempo);
+    } else {
+        --change;
+    }
 
-    if (m_ticks.empty()) {
-        RG_WARNING << "ctor: WARNING no ticks generated";
+    if (change->target > 0) {
+        return change->realTime +
+                Composition::time2RealTime(t - change->time,
+                                           change->tempo,
+                                           change->targetTime - change->time,
+                                           change->target);
     }
 
-    // This eventually calls fillBuffer() which will convert (map) the
-    // ticks in m_ticks to events in m_buffer.
-    init();
+    return change->realTime +
+            Composition::time2RealTime(t - change->time, change->tempo);
 }
 
-MetronomeMapper::~MetronomeMapper()
+int
+MetronomeMapper::metronomeTicksBefore(timeT t) const
 {
-    //RG_DEBUG << "dtor: " << this;
+    // The last run starting before t.
+    BarRunContainer::const_iterator run = std::lower_bound(
+            m_barRuns.begin(), m_barRuns.end(), t,
+            [](const BarRun &run, timeT t) { return run.start < t; });
+    if (run == m_barRuns.begin())
+        return 0;
+    --run;
+
+    const int ticksPerBar = static_cast<int>(run->ticks.size());
+    const timeT bar = (t - run->start) / run->barDuration;
+    if (bar >= run->bars)
+        return run->firstTick + run->bars * ticksPerBar;
+
+    // The ticks in the bar before t.
+    const timeT offset = t - run->start - bar * run->barDuration;
+    const int before = static_cast<int>(std::lower_bound(
+            run->ticks.begin(), run->ticks.end(), Tick(offset, BarTick)) -
+                    run->ticks.begin());
+
+    return run->firstTick + static_cast<int>(bar) * ticksPerBar + before;
+}
 
-    delete m_metronome;
-    m_metronome = nullptr;
+int
+MetronomeMapper::clockTicksBefore(timeT t) const
+{
+    if (t <= m_clockStart)
+        return 0;
+
+    const timeT ticks =
+            (t - m_clockStart + m_clockInterval - 1) / m_clockInterval;
+
+    return static_cast<int>(std::min(ticks, timeT(m_clockTicks)));
 }
 
-InstrumentId MetronomeMapper::getMetronomeInstrument() const
+MetronomeMapper::Tick
+MetronomeMapper::getMetronomeTick(int index) const
 {
-    return m_metronome->getInstrument();
+    // The last run starting at or before index.
+    BarRunContainer::const_iterator run = std::upper_bound(
+            m_barRuns.begin(), m_barRuns.end(), index,
+            [](int index, const BarRun &run)
+                { return index < run.firstTick; });
+    --run;
+
+    const int ticksPerBar = static_cast<int>(run->ticks.size());
+    const int tick = index - run->firstTick;
+    const Tick &inBar = run->ticks[tick % ticksPerBar];
+
+    return Tick(run->start + (tick / ticksPerBar) * run->barDuration +
+                        inBar.first,
+                inBar.second);
+}
+
+MetronomeMapper::Tick
+MetronomeMapper::getTick(int index) const
+{
+    if (m_clockTicks == 0)
+        return getMetronomeTick(index);
+
+    if (m_metronomeTicks == 0)
+        return Tick(m_clockStart + index * m_clockInterval,
+                    MidiTimingClockTick);
+
+    // Both, merged in time order with the metronome ticks first at the
+    // same time, as if sorted.  Find the time of the tick, the last
+    // time with no more than index ticks before it.
+    timeT low = std::min(m_barRuns.front().start, m_clockStart);
+    timeT high = std::max(getMetronomeTick(m_metronomeTicks - 1).first,
+                          m_clockStart + (m_clockTicks - 1) * m_clockInterval);
+
+    while (low < high) {
+        const timeT middle = low + (high - low + 1) / 2;
+        if (metronomeTicksBefore(middle) + clockTicksBefore(middle) <= index)
+            low = middle;
+        else
+            high = middle - 1;
+    }
+
+    const int metronomeBefore = metronomeTicksBefore(low);
+    const int metronomeAt = metronomeTicksBefore(low + 1) - metronomeBefore;
+    const int atTime = index - metronomeBefore - clockTicksBefore(low);
+
+    if (atTime < metronomeAt)
+        return getMetronomeTick(metronomeBefore + atTime);
+
+    return Tick(low, MidiTimingClockTick);
+}
+
+void
+MetronomeMapper::generateEvent(int index, MappedEvent &event) const
+{
+    const Tick tick = getTick(index);
+
+    const RealTime tickDuration(0, 100000000);
+
+    RealTime eventTime = getElapsedRealTime(tick.first);
+
+    event = MappedEvent();
+
+    if (tick.second == MidiTimingClockTick) {
+        event.setType(MappedEvent::MidiSystemMessage);
+        event.setData1(MIDI_TIMING_CLOCK);
+        event.setEventTime(eventTime);
+        return;
+    }
+
+    MidiByte velocity = 0;
+    MidiByte pitch = 0;
+
+    switch (tick.second) {
+    case BarTick:
+        velocity = m_metronome->getBarVelocity();
+        pitch = m_metronome->getBarPitch();
+        break;
+    case BeatTick:
+        velocity = m_metronome->getBeatVelocity();
+        pitch = m_metronome->getBeatPitch();
+        break;
+    case SubBeatTick:
+        velocity = m_metronome->getSubBeatVelocity();
+        pitch = m_metronome->getSubBeatPitch();
+        break;
+    case MidiTimingClockTick:
+    default:
+        RG_WARNING << "generateEvent(): Unexpected tick type";
+    }
+
+    event.setInstrumentId(m_metronome->getInstrument());
+    event.setType(MappedEvent::MidiNoteOneShot);
+    event.setData1(pitch);
+    event.setData2(velocity);
+    event.setEventTime(eventTime);
+    event.setDuration(tickDuration);
 }
 
 void MetronomeMapper::fillBuffer()
 {
     //RG_DEBUG << "fillBuffer(): instrument is " << m_metronome->getInstrument();
 
-    Q_ASSERT_X(capacity() >= static_cast<int>(m_ticks.size()),
-               "MetronomeMapper::fillBuffer()",
-               "Buffer capacity is too small.");
+    // Work everything out again from the Composition, so that refresh()
+    // picks up tempo, time signature and end marker changes.
 
     Composition &composition = m_doc->getComposition();
 
-    const RealTime tickDuration(0, 100000000);
+    RealTime start = m_start;
+    BarRunContainer barRuns;
+    int metronomeTicks = 0;
 
-    int index = 0;
-
-    // For each tick
-    for (TickContainer::iterator tick = m_ticks.begin();
-         tick != m_ticks.end();
-         ++tick) {
-
-        //RG_DEBUG << "fillBuffer(): velocity = " << int(velocity);
-
-        RealTime eventTime = composition.getElapsedRealTime(tick->first);
-
-        MappedEvent e;
-
-        if (tick->second == MidiTimingClockTick) {
-            e.setType(MappedEvent::MidiSystemMessage);
-            e.setData1(MIDI_TIMING_CLOCK);
-            e.setEventTime(eventTime);
-        } else {
-            MidiByte velocity = 0;
-            MidiByte pitch = 0;
-
-            switch (tick->second) {
-            case BarTick:
-                velocity = m_metronome->getBarVelocity();
-                pitch = m_metronome->getBarPitch();
-                break;
-            case BeatTick:
-                velocity = m_metronome->getBeatVelocity();
-                pitch = m_metronome->getBeatPitch();
-                break;
-            case SubBeatTick:
-                velocity = m_metronome->getSubBeatVelocity();
-                pitch = m_metronome->getSubBeatPitch();
-                break;
-            case MidiTimingClockTick:
-            default:
-                RG_WARNING << "fillBuffer(): Unexpected tick type";
-            }
+    const int depth = m_metronome->getDepth();
 
-            e = MappedEvent();
-            e.setInstrumentId(m_metronome->getInstrument());
-            e.setType(MappedEvent::MidiNoteOneShot);
-            e.setData1(pitch);
-            e.setData2(velocity);
-            e.setEventTime(eventTime);
-            e.setDuration(tickDuration);
-        }
+    // If the metronome has bars at the very least, work out the
+    // metronome ticks.
+    if (depth > 0) {
+
+        // Start at a somewhat arbitrary time (-20) prior to the beginning
+        // of the composition.
+        timeT barStart = composition.getBarStart(-20);
+        start = composition.getElapsedRealTime(barStart);
+
+        metronomeTicks = makeBarRuns(composition, barStart, depth, barRuns);
+    }
+
+    timeT clockStart = 0;
+    int clockTicks = 0;
 
-        // Add the event to the buffer.
-        getBuffer()[index] = e;
+    const int midiClock = Preferences::getMIDIClock();
 
-        ++index;
+    // Send
+    if (midiClock == 1) {
+        // 24 MIDI timing clocks per quarter note, from the start marker
+        // to the end marker.
+        clockStart = composition.getStartMarker();
+        const timeT clockEnd = composition.getEndMarker();
+        if (clockEnd > clockStart) {
+            clockTicks = static_cast<int>(
+                    (clockEnd - clockStart + m_clockInterval - 1) /
+                            m_clockInterval);
+        }
     }
 
-    //RG_DEBUG << "fillBuffer(): capacity: " << capacity();
-    //RG_DEBUG << "  Total events written: " << index;
+    //if (mtcMode > 0) {
+    //    // do something
+    //}
 
-    resize(index);
+    // Copy the tempo map so that the ticks' real times can be worked
+    // out on the sequencer thread.
+    std::vector<TempoChange> tempoChanges;
+    makeTempoChanges(composition, tempoChanges);
+
+    {
+        // generateEvent() reads all of this on the sequencer thread,
+        // under the read lock.
+        QWriteLocker locker(getLock());
+
+        m_start = start;
+        m_barRuns.swap(barRuns);
+        m_metronomeTicks = metronomeTicks;
+        m_clockStart = clockStart;
+        m_clockTicks = clockTicks;
+        m_tempoChanges.swap(tempoChanges);
+        m_defaultTempo = composition.getCompositionDefaultTempo();
+
+        // Nothing goes in the buffer.  It just needs to know how many
+        // ticks there are.
+        resize(m_metronomeTicks + m_clockTicks);
+    }
 
     m_channelManager.allocateChannelInterval(false);
     m_channelManager.setDirty();
@@ -248,7 +490,8 @@ void MetronomeMapper::fillBuffer()
 int
 MetronomeMapper::calculateSize()
 {
-    return static_cast<int>(m_ticks.size());
+    // The ticks are made as they are read, so no buffer is needed.
+    return 0;
 }
 
 void
@@ -18,6 +18,7 @@
 #ifndef RG_METRONOMEMAPPER_H
 #define RG_METRONOMEMAPPER_H
 
+#include "base/Composition.h"  // For tempoT
 #include "base/MidiProgram.h"  // For InstrumentId
 #include "base/RealTime.h"
 #include "base/TimeT.h"
@@ -30,6 +31,8 @@
 #include <utility>
 #include <vector>
 
+#include <rosegardenprivate_export.h>
+
 namespace Rosegarden
 {
 
@@ -38,7 +41,17 @@ class RosegardenDocument;
 class MidiMetronome;
 
 
-class MetronomeMapper : public MappedEventBuffer
+/// Metronome and MIDI clock ticks for the sequencer.
+/**
+ * Rather than keep a tick for every bar, beat and sub-beat of the
+ * composition (and 24 MIDI clocks per crotchet), this keeps the pattern
+ * of ticks for each run of identical bars and a copy of the tempo map,
+ * and makes each tick as the sequencer reads it.  See
+ * MappedEventBuffer::generateEvent().  So memory and construction time
+ * depend on the number of time signature and tempo changes, not on the
+ * length of the composition.
+ */
+class ROSEGARDENPRIVATE_EXPORT MetronomeMapper : public MappedEventBuffer
 {
 public:
     explicit MetronomeMapper(RosegardenDocument *doc);
@@ -55,9 +68,12 @@ public:
     void makeReady(MappedInserterBase &inserter, RealTime time) override;
     /// Should the event be played?
     bool shouldPlay(MappedEvent *evt, RealTime startTime) override;
+    /// No buffer is needed.  See generateEvent().
     int calculateSize() override;
-    /// Convert m_ticks to events in m_buffer.
+    /// Work out the ticks and copy the tempo map again.
     void fillBuffer() override;
+    /// Make tick number index.
+    void generateEvent(int index, MappedEvent &event) const override;
 
 private:
     Instrument *m_instrument;
@@ -70,8 +86,66 @@ private:
     };
     typedef std::pair<timeT, TickType> Tick;
     typedef std::vector<Tick> TickContainer;
-    /// The ticks of the metronome.
-    TickContainer m_ticks;
+
+    /// Bars with the same time signature and length, one after another.
+    struct BarRun
+    {
+        timeT start;
+        timeT barDuration;
+        int bars;
+        /// Metronome ticks before this run.
+        int firstTick;
+        /// The ticks in each bar, relative to the start of the bar.
+        TickContainer ticks;
+    };
+    typedef std::vector<BarRun> BarRunContainer;
+    /// The metronome ticks, in time order.
+    BarRunContainer m_barRuns;
+    int m_metronomeTicks;
+
+    /// Append the BarRuns for the bars from barStart to the end marker.
+    /**
+     * Returns the number of ticks in them.
+     */
+    static int makeBarRuns(const Composition &composition, timeT barStart,
+                           int depth, BarRunContainer &barRuns);
+
+    /// MIDI clock ticks, every m_clockInterval from m_clockStart.
+    timeT m_clockStart;
+    timeT m_clockInterval;
+    int m_clockTicks;
+
+    /// Copy of the Composition's tempo changes.
+    struct TempoChange
+    {
+        timeT time;
+        RealTime realTime;
+        tempoT tempo;
+        /// For a ramp, the tempo at targetTime.  Otherwise -1.
+        tempoT target;
+        timeT targetTime;
+    };
+    std::vector<TempoChange> m_tempoChanges;
+    tempoT m_defaultTempo;
+
+    /// Append a TempoChange for each of the Composition's tempo changes.
+    static void makeTempoChanges(const Composition &composition,
+                                 std::vector<TempoChange> &tempoChanges);
+
+    /// Composition::getElapsedRealTime() from m_tempoChanges.
+    /**
+     * Safe on the sequencer thread.
+     */
+    RealTime getElapsedRealTime(timeT t) const;
+
+    /// Number of metronome ticks before time t.
+    int metronomeTicksBefore(timeT t) const;
+    /// Number of MIDI clock ticks before time t.
+    int clockTicksBefore(timeT t) const;
+    /// Metronome tick number index.
+    Tick getMetronomeTick(int index) const;
+    /// Tick number index, metronome and MIDI clock ticks merged.
+    Tick getTick(int index) const;
 
     const MidiMetronome *m_metronome;
 
@@ -81,7 +155,6 @@ private:
 
 };
 
-
 }
 
 #endif
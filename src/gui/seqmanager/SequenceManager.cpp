@@ -1800,7 +1800,7 @@ SequenceManager::sendTransportControlStatuses()
     int mmcMode = settings.value("mmcmode", 0).toInt() ;
     int mtcMode = settings.value("mtcmode", 0).toInt() ;
 
-    int midiClock = settings.value("midiclock", 0).toInt() ;
+    int midiClock = Preferences::getMIDIClock();
     bool midiSyncAuto = qStrToBool( settings.value("midisyncautoconnect", "false" ) ) ;
 
     // Send JACK transport
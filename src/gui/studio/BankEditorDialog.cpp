@@ -59,6 +59,7 @@
 #include <QGridLayout>
 #include <QHBoxLayout>
 #include <QStackedLayout>
+#include <QtAlgorithms>
 #include <QDesktopServices>
 #include <QSettings>
 #if QT_VERSION >= 0x050000
@@ -70,6 +71,14 @@ namespace Rosegarden
 {
 
 
+namespace
+{
+    // Devices with more banks and key maps than this start out collapsed
+    // and only get their child items when expanded.
+    const size_t lazyItemCount = 256;
+}
+
+
 BankEditorDialog::BankEditorDialog(QWidget *parent,
                                    RosegardenDocument *doc,
                                    DeviceId defaultDevice) :
@@ -108,6 +117,8 @@ BankEditorDialog::BankEditorDialog(QWidget *parent,
     m_treeWidget->setRootIsDecorated(true);
     m_treeWidget->setSelectionBehavior(QAbstractItemView::SelectRows);
     m_treeWidget->setSelectionMode(QAbstractItemView::SingleSelection);
+    // All rows are one line of text, so the view can skip measuring them.
+    m_treeWidget->setUniformRowHeights(true);
     m_treeWidget->sortItems(0, Qt::AscendingOrder);
     m_treeWidget->setSortingEnabled(true);
     connect(m_treeWidget, &QTreeWidget::itemDoubleClicked,
@@ -116,6 +127,10 @@ BankEditorDialog::BankEditorDialog(QWidget *parent,
             this, &BankEditorDialog::slotUpdateEditor);
     connect(m_treeWidget, &QTreeWidget::itemChanged,
             this, &BankEditorDialog::slotItemChanged);
+    connect(m_treeWidget, &QTreeWidget::itemExpanded,
+            this, &BankEditorDialog::slotItemExpanded);
+    connect(m_treeWidget, &QTreeWidget::itemCollapsed,
+            this, &BankEditorDialog::slotItemCollapsed);
 
     // Editor Right Side.  The Bank and Key Map editors.
 
@@ -320,6 +335,9 @@ BankEditorDialog::updateDialog()
     //       cleared it.  That's very helpful.
     m_treeWidget->clear();
 
+    // Sort once at the end rather than on every insert.
+    m_treeWidget->setSortingEnabled(false);
+
     MidiDeviceTreeWidgetItem *selectDeviceItem{nullptr};
 
     DeviceList *devices = m_studio->getDevices();
@@ -350,17 +368,37 @@ BankEditorDialog::updateDialog()
         MidiDeviceTreeWidgetItem *deviceItem = new MidiDeviceTreeWidgetItem(
                 m_treeWidget, midiDevice, itemName);
 
-        deviceItem->setExpanded(true);
-
-        // Add the banks and key maps for this device to the tree.
-        populateDeviceItem(deviceItem, midiDevice);
-
         // Is this the parent Device item of the selected item?
         // Save it if so.
         if (deviceItem->getDevice() == parentDevice)
             selectDeviceItem = deviceItem;
+
+        // Large devices start out collapsed.  After that, go with
+        // whatever the user last did.
+        bool expand = (midiDevice->getBanks().size() +
+                       midiDevice->getKeyMappings().size() <= lazyItemCount);
+        std::map<DeviceId, bool>::const_iterator expandedIter =
+                m_deviceExpanded.find(midiDevice->getId());
+        if (expandedIter != m_deviceExpanded.end())
+            expand = expandedIter->second;
+        // The selected bank or key map must be visible.
+        if (deviceItem == selectDeviceItem  &&
+            selectedType != SelectedType::DEVICE)
+            expand = true;
+
+        // Add the banks and key maps for this device to the tree.
+        // Collapsed devices wait until slotItemExpanded().
+        if (expand  ||  deviceItem == selectDeviceItem)
+            populateDeviceItem(deviceItem, midiDevice);
+        else
+            deviceItem->setChildIndicatorPolicy(
+                    QTreeWidgetItem::ShowIndicator);
+
+        deviceItem->setExpanded(expand);
     }
 
+    m_treeWidget->setSortingEnabled(true);
+
     m_treeWidget->blockSignals(false);
 
     // Restore the item selection.
@@ -446,14 +484,22 @@ void
 BankEditorDialog::populateDeviceItem(
         QTreeWidgetItem *deviceItem, MidiDevice *midiDevice)
 {
+    // Inserting into a sorted tree sorts each time, so hold off until
+    // everything is in.
+    const bool sorting = m_treeWidget->isSortingEnabled();
+    m_treeWidget->setSortingEnabled(false);
+
+    deviceItem->setChildIndicatorPolicy(
+            QTreeWidgetItem::DontShowIndicatorWhenChildless);
+
     // Remove children from deviceItem.
-    // While there are items to remove...
-    while (deviceItem->childCount() > 0)
-        delete deviceItem->child(0);
+    // takeChildren() detaches them all at once, which is much quicker than
+    // deleting them one at a time when there are thousands.
+    qDeleteAll(deviceItem->takeChildren());
 
     // Add Banks
 
-    BankList banks = midiDevice->getBanks();
+    const BankList &banks = midiDevice->getBanks();
     // add banks for this device
     for (size_t i = 0; i < banks.size(); ++i) {
         RG_DEBUG << "populateDeviceItem() - adding bank " << strtoqstr(midiDevice->getName()) << " - " << strtoqstr(banks[i].getName());
@@ -477,6 +523,57 @@ BankEditorDialog::populateDeviceItem(
                 deviceItem,  // parent
                 strtoqstr(keyMapList[i].getName()));  // name
     }
+
+    m_treeWidget->setSortingEnabled(sorting);
+}
+
+void
+BankEditorDialog::ensurePopulated(MidiDeviceTreeWidgetItem *deviceItem)
+{
+    if (!deviceItem  ||  deviceItem->childCount() > 0)
+        return;
+
+    MidiDevice *device = deviceItem->getDevice();
+    if (!device)
+        return;
+
+    // See updateDialog().
+    m_treeWidget->blockSignals(true);
+    populateDeviceItem(deviceItem, device);
+    m_treeWidget->blockSignals(false);
+}
+
+void
+BankEditorDialog::slotItemExpanded(QTreeWidgetItem *item)
+{
+    MidiDeviceTreeWidgetItem *deviceItem =
+            dynamic_cast<MidiDeviceTreeWidgetItem *>(item);
+    // Bank and key map items derive from MidiDeviceTreeWidgetItem.
+    if (!deviceItem  ||  item->parent())
+        return;
+
+    MidiDevice *device = deviceItem->getDevice();
+    if (!device)
+        return;
+
+    m_deviceExpanded[device->getId()] = true;
+
+    ensurePopulated(deviceItem);
+}
+
+void
+BankEditorDialog::slotItemCollapsed(QTreeWidgetItem *item)
+{
+    MidiDeviceTreeWidgetItem *deviceItem =
+            dynamic_cast<MidiDeviceTreeWidgetItem *>(item);
+    if (!deviceItem  ||  item->parent())
+        return;
+
+    MidiDevice *device = deviceItem->getDevice();
+    if (!device)
+        return;
+
+    m_deviceExpanded[device->getId()] = false;
 }
 
 void BankEditorDialog::slotUpdateEditor(QTreeWidgetItem *currentItem, QTreeWidgetItem * /*previousItem*/)
@@ -607,6 +704,8 @@ BankEditorDialog::selectItem(MidiDeviceTreeWidgetItem *deviceItem, const QString
     if (!deviceItem)
         return;
 
+    ensurePopulated(deviceItem);
+
     // Only one can be selected.
     deviceItem->setSelected(false);
 
@@ -25,6 +25,7 @@
 
 #include <QMainWindow>
 
+#include <map>
 #include <set>
 #include <utility>
 
@@ -108,6 +109,9 @@ private slots:
     void slotEdit(QTreeWidgetItem *item, int column);
     /// Handles name changes in the tree.
     void slotItemChanged(QTreeWidgetItem *item, int column);
+    /// Fills in a collapsed device's banks and key maps when expanded.
+    void slotItemExpanded(QTreeWidgetItem *item);
+    void slotItemCollapsed(QTreeWidgetItem *item);
 
     /// Show and update the program editor or the key map editor.
     /**
@@ -155,6 +159,14 @@ private:
     /// Add Banks and Key Maps to the tree for a MidiDevice.
     void populateDeviceItem(QTreeWidgetItem *deviceItem,
                             MidiDevice *midiDevice);
+    /// populateDeviceItem() if it hasn't been done yet.
+    void ensurePopulated(MidiDeviceTreeWidgetItem *deviceItem);
+    /// Expanded state of each device item, as last set by the user.
+    /**
+     * The tree is rebuilt whenever a device changes, so this keeps
+     * devices from collapsing or expanding under the user.
+     */
+    std::map<DeviceId, bool> m_deviceExpanded;
     /// Checks type of item and calls item->parent().
     MidiDeviceTreeWidgetItem *getParentDeviceItem(QTreeWidgetItem *item);
     /// Select a device in the tree.  Used after adding or importing banks.
@@ -20,6 +20,7 @@
 #include "PreferenceInt.h"
 #include "PreferenceString.h"
 
+#include <QFont>
 #include <QSettings>
 
 namespace Rosegarden
@@ -69,6 +70,56 @@ bool Preferences::getSendControlChangesWhenLooping()
     return sendControlChangesWhenLooping.get();
 }
 
+PreferenceBool allowResetAllControllers(
+        SequencerOptionsConfigGroup, "allowresetallcontrollers", true);
+
+void Preferences::setAllowResetAllControllers(bool value)
+{
+    allowResetAllControllers.set(value);
+}
+
+bool Preferences::getAllowResetAllControllers()
+{
+    return allowResetAllControllers.get();
+}
+
+PreferenceBool forceChannelSetups(
+        SequencerOptionsConfigGroup, "forceChannelSetups", false);
+
+void Preferences::setForceChannelSetups(bool value)
+{
+    forceChannelSetups.set(value);
+}
+
+bool Preferences::getForceChannelSetups()
+{
+    return forceChannelSetups.get();
+}
+
+PreferenceInt midiClock(SequencerOptionsConfigGroup, "midiclock", 0);
+
+void Preferences::setMIDIClock(int value)
+{
+    midiClock.set(value);
+}
+
+int Preferences::getMIDIClock()
+{
+    return midiClock.get();
+}
+
+PreferenceInt midiPitchOctave(GeneralOptionsConfigGroup, "midipitchoctave", -2);
+
+void Preferences::setMIDIPitchOctave(int value)
+{
+    midiPitchOctave.set(value);
+}
+
+int Preferences::getMIDIPitchOctave()
+{
+    return midiPitchOctave.get();
+}
+
 PreferenceBool useNativeFileDialogs("FileDialog", "useNativeFileDialogs", true);
 
 void Preferences::setUseNativeFileDialogs(bool value)
@@ -230,6 +281,130 @@ bool Preferences::getShowNoteNames()
     return showNoteNames.get();
 }
 
+PreferenceBool showInvisibles(
+        NotationOptionsConfigGroup, "showinvisibles", true);
+
+void Preferences::setShowInvisibles(bool value)
+{
+    showInvisibles.set(value);
+}
+
+bool Preferences::getShowInvisibles()
+{
+    return showInvisibles.get();
+}
+
+PreferenceInt accidentalOctaveMode(
+        NotationOptionsConfigGroup, "accidentaloctavemode", 1);
+
+void Preferences::setAccidentalOctaveMode(int value)
+{
+    accidentalOctaveMode.set(value);
+}
+
+int Preferences::getAccidentalOctaveMode()
+{
+    return accidentalOctaveMode.get();
+}
+
+PreferenceInt accidentalBarMode(
+        NotationOptionsConfigGroup, "accidentalbarmode", 0);
+
+void Preferences::setAccidentalBarMode(int value)
+{
+    accidentalBarMode.set(value);
+}
+
+int Preferences::getAccidentalBarMode()
+{
+    return accidentalBarMode.get();
+}
+
+namespace
+{
+    // The notation fonts are stored as QFonts.  A PreferenceString would
+    // write them back as plain strings, so they are cached here.
+    struct FontPreference
+    {
+        const char *key;
+        bool cacheValid;
+        // Whether there is a stored value, and if so, the value.
+        bool isSet;
+        QString cache;
+        // The last default asked for, and the font it makes.  Callers
+        // don't all agree on the default.
+        QString defaultFamily;
+        QString defaultCache;
+    };
+
+    FontPreference notationTextFont{
+            "textfont", false, false, QString(), QString(), QString()};
+    FontPreference notationSansFont{
+            "sansfont", false, false, QString(), QString(), QString()};
+    FontPreference notationTimeSigFont{
+            "timesigfont", false, false, QString(), QString(), QString()};
+
+    void setFont(FontPreference &preference, const QFont &font)
+    {
+        QSettings settings;
+        settings.beginGroup(NotationViewConfigGroup);
+        settings.setValue(preference.key, font);
+        preference.cache = font.toString();
+        preference.isSet = true;
+        preference.cacheValid = true;
+    }
+
+    QString getFont(FontPreference &preference, const QString &defaultFamily)
+    {
+        if (!preference.cacheValid) {
+            preference.cacheValid = true;
+
+            QSettings settings;
+            settings.beginGroup(NotationViewConfigGroup);
+            preference.isSet = settings.contains(preference.key);
+            if (preference.isSet)
+                preference.cache = settings.value(preference.key).toString();
+        }
+
+        if (preference.isSet)
+            return preference.cache;
+
+        // As settings.value(key, QFont(defaultFamily)).toString() would.
+        if (preference.defaultCache.isEmpty()  ||
+            defaultFamily != preference.defaultFamily) {
+            preference.defaultFamily = defaultFamily;
+            preference.defaultCache = QFont(defaultFamily).toString();
+        }
+
+        return preference.defaultCache;
+    }
+}
+
+void Preferences::setNotationTextFont(const QFont &font)
+{
+    setFont(notationTextFont, font);
+}
+
+QString Preferences::getNotationTextFont(const QString &defaultFamily)
+{
+    return getFont(notationTextFont, defaultFamily);
+}
+
+void Preferences::setNotationSansFont(const QFont &font)
+{
+    setFont(notationSansFont, font);
+}
+
+QString Preferences::getNotationSansFont(const QString &defaultFamily)
+{
+    return getFont(notationSansFont, defaultFamily);
+}
+
+QString Preferences::getNotationTimeSigFont(const QString &defaultFamily)
+{
+    return getFont(notationTimeSigFont, defaultFamily);
+}
+
 PreferenceInt smfExportPPQN(GeneralOptionsConfigGroup, "smfExportPPQN", 480);
 
 void Preferences::setSMFExportPPQN(int value)
@@ -17,6 +17,8 @@
 
 #include <QString>
 
+class QFont;
+
 // Need this to be seen within main.cpp.
 #include <rosegardenprivate_export.h>
 
@@ -56,7 +58,22 @@ namespace Preferences
     void setSendControlChangesWhenLooping(bool value);
     bool getSendControlChangesWhenLooping();
 
-    // ??? Move ChannelManager.cpp:allowReset() and forceChannelSetups() here.
+    // Edit > Preferences... > MIDI > General > Allow Reset All Controllers
+    void setAllowResetAllControllers(bool value);
+    bool getAllowResetAllControllers();
+
+    // Related to Bug #1560.  Send channel setups at the start of each
+    // fixed channel Segment.
+    void setForceChannelSetups(bool value);
+    bool getForceChannelSetups();
+
+    // MIDI clock mode: 0 off, 1 send, 2 accept.
+    void setMIDIClock(int value);
+    int getMIDIClock();
+
+    // Octave number of MIDI pitch 0, usually -2 or -1.
+    void setMIDIPitchOctave(int value);
+    int getMIDIPitchOctave();
 
     void setUseNativeFileDialogs(bool value);
     bool getUseNativeFileDialogs();
@@ -88,6 +105,29 @@ namespace Preferences
     void setShowNoteNames(bool value);
     bool getShowNoteNames();
 
+    // Notation.  These are read during layout and rendering.
+
+    void setShowInvisibles(bool value);
+    bool getShowInvisibles();
+
+    // See AccidentalTable::OctaveType.
+    void setAccidentalOctaveMode(int value);
+    int getAccidentalOctaveMode();
+
+    // See AccidentalTable::BarResetType.
+    void setAccidentalBarMode(int value);
+    int getAccidentalBarMode();
+
+    // Text and sans-serif fonts for notation text, as the strings
+    // NotePixmapFactory makes its fonts from.  defaultFamily is used if
+    // nothing has been set.
+    void setNotationTextFont(const QFont &font);
+    QString getNotationTextFont(const QString &defaultFamily);
+    void setNotationSansFont(const QFont &font);
+    QString getNotationSansFont(const QString &defaultFamily);
+    // Only ever set by hand in the config file.
+    QString getNotationTimeSigFont(const QString &defaultFamily);
+
     // Experimental
 
     bool getBug1623();
@@ -0,0 +1,361 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#define RG_MODULE_STRING "[RTDebug]"
+
+#include "RealtimeDebug.h"
+
+#include "base/RealTime.h"
+
+#include <QThread>
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+
+namespace Rosegarden
+{
+
+
+namespace
+{
+    // Must be a power of two.
+    const size_t queueSize = 1024;
+
+    // Bounded multi-producer queue after Dmitry Vyukov.  Each slot has
+    // a sequence number that tells producers and the consumer whose
+    // turn it is, so a producer never waits for another one.
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        size_t length;
+        bool warning;
+        char text[RTDebugMessage::MaxLength + 1];
+    };
+
+    class MessageQueue
+    {
+    public:
+        MessageQueue() :
+            m_enqueue(0),
+            m_dequeue(0),
+            m_dropped(0)
+        {
+            for (size_t i = 0; i < queueSize; ++i)
+                m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        bool push(const char *text, size_t length, bool warning)
+        {
+            size_t position = m_enqueue.load(std::memory_order_relaxed);
+            Slot *slot;
+
+            for (;;) {
+                slot = &m_slots[position & (queueSize - 1)];
+                const size_t sequence =
+                        slot->sequence.load(std::memory_order_acquire);
+                const ptrdiff_t difference =
+                        ptrdiff_t(sequence) - ptrdiff_t(position);
+
+                if (difference == 0) {
+                    if (m_enqueue.compare_exchange_weak(
+                            position, position + 1,
+                            std::memory_order_relaxed))
+                        break;
+                } else if (difference < 0) {
+                    // Full.
+                    m_dropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                } else {
+                    position = m_enqueue.load(std::memory_order_relaxed);
+                }
+            }
+
+            memcpy(slot->text, text, length);
+            slot->text[length] = '\0';
+            slot->length = length;
+            slot->warning = warning;
+            slot->sequence.store(position + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        /// Single consumer.
+        bool pop(char *text, bool &warning)
+        {
+            const size_t position = m_dequeue.load(std::memory_order_relaxed);
+            Slot &slot = m_slots[position & (queueSize - 1)];
+
+            if (slot.sequence.load(std::memory_order_acquire) != position + 1)
+                return false;
+
+            memcpy(text, slot.text, slot.length + 1);
+            warning = slot.warning;
+
+            slot.sequence.store(position + queueSize,
+                                std::memory_order_release);
+            m_dequeue.store(position + 1, std::memory_order_relaxed);
+
+            return true;
+        }
+
+        size_t getDropped() const
+            { return m_dropped.load(std::memory_order_relaxed); }
+
+    private:
+        Slot m_slots[queueSize];
+        std::atomic<size_t> m_enqueue;
+        std::atomic<size_t> m_dequeue;
+        std::atomic<size_t> m_dropped;
+    };
+
+    MessageQueue &queue()
+    {
+        // Constructed on first use, i.e. from start() or the first
+        // message, never in the middle of an audio callback in practice.
+        static MessageQueue instance;
+        return instance;
+    }
+
+    class FlushThread : public QThread
+    {
+    public:
+        FlushThread() : m_exiting(false)  { }
+
+        void exit()  { m_exiting.store(true); }
+
+    protected:
+        void run() override
+        {
+            while (!m_exiting.load()) {
+                RTDebug::flush();
+                msleep(50);
+            }
+        }
+
+    private:
+        std::atomic<bool> m_exiting;
+    };
+
+    FlushThread *flushThread = nullptr;
+    size_t reportedDropped = 0;
+}
+
+
+std::atomic<unsigned> RTDebug::m_categories(RTDebug::All);
+
+void
+RTDebug::start()
+{
+    if (flushThread)
+        return;
+
+    queue();
+
+    flushThread = new FlushThread;
+    flushThread->start(QThread::LowPriority);
+}
+
+void
+RTDebug::stop()
+{
+    if (flushThread) {
+        flushThread->exit();
+        flushThread->wait();
+        delete flushThread;
+        flushThread = nullptr;
+    }
+
+    flush();
+}
+
+void
+RTDebug::flush()
+{
+    char text[RTDebugMessage::MaxLength + 1];
+    bool warning;
+
+    while (queue().pop(text, warning)) {
+        if (warning)
+            QDebug(QtWarningMsg).noquote() << text;
+        else
+            QDebug(QtDebugMsg).noquote() << text;
+    }
+
+    const size_t dropped = queue().getDropped();
+    if (dropped != reportedDropped) {
+        RG_WARNING << "flush(): dropped" << (dropped - reportedDropped)
+                   << "messages";
+        reportedDropped = dropped;
+    }
+}
+
+size_t
+RTDebug::getDroppedCount()
+{
+    return queue().getDropped();
+}
+
+bool
+RTDebug::post(const char *text, size_t length, bool warning)
+{
+    return queue().push(text, length, warning);
+}
+
+
+RTDebugMessage::RTDebugMessage(const char *module, bool warning) :
+    m_length(0),
+    m_warning(warning)
+{
+    m_text[0] = '\0';
+    append(module, strlen(module));
+}
+
+RTDebugMessage::~RTDebugMessage()
+{
+    RTDebug::post(m_text, m_length, m_warning);
+}
+
+void
+RTDebugMessage::append(const char *s, size_t length)
+{
+    // Space separated, like QDebug.
+    if (m_length > 0  &&  m_length < MaxLength)
+        m_text[m_length++] = ' ';
+
+    if (length > MaxLength - m_length)
+        length = MaxLength - m_length;
+
+    memcpy(m_text + m_length, s, length);
+    m_length += length;
+    m_text[m_length] = '\0';
+}
+
+void
+RTDebugMessage::appendFormatted(const char *format, ...)
+{
+    char buffer[64];
+
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+
+    if (length < 0)
+        return;
+    if (size_t(length) >= sizeof(buffer))
+        length = sizeof(buffer) - 1;
+
+    append(buffer, length);
+}
+
+RTDebugMessage &
+RTDebugMessage::operator<<(const char *s)
+{
+    if (!s)
+        s = "(null)";
+    append(s, strlen(s));
+    return *this;
+}
+
+RTDebugMessage &
+RTDebugMessage::operator<<(const std::string &s)
+{
+    append(s.data(), s.size());
+    return *this;
+}
+
+RTDebugMessage &
+RTDebugMessage::operator<<(bool b)
+{
+    return *this << (b ? "true" : "false");
+}
+
+RTDebugMessage &
+RTDebugMessage::operator<<(char c)
+{
+    append(&c, 1);
+    return *this;
+}
+
+RTDebugMessage &
+RTDebugMessage::operator<<(int i)
+{
+    appendFormatted("%d", i);
+    return *this;
+}
+
+RTDebugMessage &
+RTDebugMessage::operator<<(unsigned int i)
+{
+    appendFormatted("%u", i);
+    return *this;
+}
+
+RTDebugMessage &
+RTDebugMessage::operator<<(long i)
+{
+    appendFormatted("%ld", i);
+    return *this;
+}
+
+RTDebugMessage &
+RTDebugMessage::operator<<(unsigned long i)
+{
+    appendFormatted("%lu", i);
+    return *this;
+}
+
+RTDebugMessage &
+RTDebugMessage::operator<<(long long i)
+{
+    appendFormatted("%lld", i);
+    return *this;
+}
+
+RTDebugMessage &
+RTDebugMessage::operator<<(unsigned long long i)
+{
+    appendFormatted("%llu", i);
+    return *this;
+}
+
+RTDebugMessage &
+RTDebugMessage::operator<<(double d)
+{
+    appendFormatted("%g", d);
+    return *this;
+}
+
+RTDebugMessage &
+RTDebugMessage::operator<<(const void *p)
+{
+    appendFormatted("%p", p);
+    return *this;
+}
+
+RTDebugMessage &
+RTDebugMessage::operator<<(const RealTime &rt)
+{
+    const bool negative = (rt < RealTime::zero());
+    appendFormatted("%s%d.%09d", negative ? "-" : "",
+                    negative ? -rt.sec : rt.sec,
+                    negative ? -rt.nsec : rt.nsec);
+    return *this;
+}
+
+
+}
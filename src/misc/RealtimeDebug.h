@@ -0,0 +1,160 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#ifndef RG_REALTIMEDEBUG_H
+#define RG_REALTIMEDEBUG_H
+
+#include "Debug.h"
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+
+#include <rosegardenprivate_export.h>
+
+namespace Rosegarden
+{
+
+
+struct RealTime;
+
+
+/// Debug output that is safe to use in the audio and MIDI threads.
+/**
+ * RG_DEBUG goes straight to QDebug, which allocates and may block on
+ * the output device.  That is fine in the GUI thread, but in the JACK
+ * process callback or the ALSA MIDI thread it causes xruns.
+ *
+ * RG_RT_DEBUG and RG_RT_WARNING are used just like RG_DEBUG and
+ * RG_WARNING.  Each message is formatted into a fixed size buffer
+ * (RTDebugMessage) and handed to a preallocated lock-free queue.  A
+ * background thread, started by start(), writes the queued messages
+ * out through QDebug.  If the queue is full, the message is dropped and
+ * counted.  Nothing on the calling side allocates or locks.
+ *
+ * Messages can be turned off at compile time like RG_DEBUG (define
+ * RG_NO_DEBUG_PRINT at the top of the .cpp) or at runtime by category
+ * (setCategories()).  Define RG_RT_CATEGORY before including this
+ * header to set the category for a file.  The default is General.
+ */
+class ROSEGARDENPRIVATE_EXPORT RTDebug
+{
+public:
+    enum Category {
+        General = 0x01,
+        Audio   = 0x02,
+        MIDI    = 0x04,
+        Plugins = 0x08,
+        All     = 0xff
+    };
+
+    /// Start the thread that writes out queued messages.
+    static void start();
+    /// Write out anything still queued and stop the thread.
+    static void stop();
+
+    /// Write out the queued messages now.
+    /**
+     * Called periodically by the background thread.  Must only be
+     * called from one thread at a time.
+     */
+    static void flush();
+
+    /// Turn categories on or off at runtime.  All are on by default.
+    static void setCategories(unsigned categories)
+        { m_categories.store(categories, std::memory_order_relaxed); }
+    static unsigned getCategories()
+        { return m_categories.load(std::memory_order_relaxed); }
+    static bool isEnabled(unsigned category)
+        { return (getCategories() & category) != 0; }
+
+    /// Number of messages lost because the queue was full.
+    static size_t getDroppedCount();
+
+private:
+    friend class RTDebugMessage;
+
+    /// Queue a message.  Returns false if the queue is full.
+    static bool post(const char *text, size_t length, bool warning);
+
+    static std::atomic<unsigned> m_categories;
+};
+
+
+/// One message for RTDebug.
+/**
+ * Formats into a buffer on the stack, adding a space between items as
+ * QDebug does, and queues the result when destroyed.  Anything past
+ * MaxLength characters is cut off.
+ */
+class ROSEGARDENPRIVATE_EXPORT RTDebugMessage
+{
+public:
+    static const size_t MaxLength = 255;
+
+    RTDebugMessage(const char *module, bool warning);
+    ~RTDebugMessage();
+
+    RTDebugMessage &operator<<(const char *s);
+    RTDebugMessage &operator<<(const std::string &s);
+    RTDebugMessage &operator<<(bool b);
+    RTDebugMessage &operator<<(char c);
+    RTDebugMessage &operator<<(int i);
+    RTDebugMessage &operator<<(unsigned int i);
+    RTDebugMessage &operator<<(long i);
+    RTDebugMessage &operator<<(unsigned long i);
+    RTDebugMessage &operator<<(long long i);
+    RTDebugMessage &operator<<(unsigned long long i);
+    RTDebugMessage &operator<<(double d);
+    RTDebugMessage &operator<<(const void *p);
+    RTDebugMessage &operator<<(const RealTime &rt);
+
+private:
+    char m_text[MaxLength + 1];
+    size_t m_length;
+    bool m_warning;
+
+    void append(const char *s, size_t length);
+    /// printf-style append for numbers.
+    void appendFormatted(const char *format, ...);
+
+    RTDebugMessage(const RTDebugMessage &); // not provided
+    RTDebugMessage &operator=(const RTDebugMessage &); // not provided
+};
+
+
+}
+
+#if !defined RG_RT_CATEGORY
+    #define RG_RT_CATEGORY Rosegarden::RTDebug::General
+#endif
+
+#if !defined NDEBUG && !defined RG_NO_DEBUG_PRINT
+    // The loop body runs once if the category is enabled and not at all
+    // otherwise, so disabled messages are never formatted.  Unlike an
+    // if/else, it has no else to capture when used in an unbraced if.
+    #define RG_RT_DEBUG \
+        for (bool rgRtDebugOnce = \
+                 Rosegarden::RTDebug::isEnabled(RG_RT_CATEGORY); \
+             rgRtDebugOnce; rgRtDebugOnce = false) \
+            Rosegarden::RTDebugMessage(RG_MODULE_STRING, false)
+#else
+    #define RG_RT_DEBUG Rosegarden::RGNoDebug()
+#endif
+
+// Always enabled, like RG_WARNING.
+#define RG_RT_WARNING Rosegarden::RTDebugMessage(RG_MODULE_STRING, true)
+
+#endif // RG_REALTIMEDEBUG_H
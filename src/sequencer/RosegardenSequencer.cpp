@@ -17,10 +17,12 @@
 
 #define RG_MODULE_STRING "[RosegardenSequencer]"
 #define RG_NO_DEBUG_PRINT
+#define RG_RT_CATEGORY Rosegarden::RTDebug::MIDI
 
 #include "RosegardenSequencer.h"
 
 #include "misc/Debug.h"
+#include "misc/RealtimeDebug.h"
 #include "misc/Strings.h"
 #include "sound/ControlBlock.h"
 #include "sound/SoundDriver.h"
@@ -1182,7 +1184,7 @@ RosegardenSequencer::getSlice(MappedEventList &mappedEventList,
 
     if (firstFetch || (start < m_lastStartTime)) {
 #ifdef DEBUG_ROSEGARDEN_SEQUENCER
-        SEQUENCER_DEBUG << "[calling jumpToTime on start]";
+        RG_RT_DEBUG << "getSlice(): calling jumpToTime on start";
 #endif
         m_metaIterator.jumpToTime(start);
     }
@@ -1360,7 +1362,7 @@ void
 RosegardenSequencer::processRecordedMidi()
 {
 #ifdef DEBUG_ROSEGARDEN_SEQUENCER
-    SEQUENCER_DEBUG << "RosegardenSequencer::processRecordedMidi";
+    RG_RT_DEBUG << "processRecordedMidi()";
 #endif
 
     MappedEventList recordList;
@@ -1383,7 +1385,7 @@ RosegardenSequencer::processRecordedMidi()
     routeEvents(&thruList, true);
 
 #ifdef DEBUG_ROSEGARDEN_SEQUENCER
-    SEQUENCER_DEBUG << "RosegardenSequencer::processRecordedMidi: have " << mC.size() << " events";
+    RG_RT_DEBUG << "processRecordedMidi(): have " << recordList.size() << " events";
 #endif
 
     // Remove events that match the record filter
@@ -1560,7 +1562,7 @@ RosegardenSequencer::transportChange(TransportRequest request)
     m_transportRequests.push_back(pair);
 
 #ifdef DEBUG_ROSEGARDEN_SEQUENCER
-    SEQUENCER_DEBUG << "RosegardenSequencer::transportChange: " << request;
+    RG_RT_DEBUG << "transportChange(): " << request;
 #endif
     if (request == TransportNoChange)
         return m_transportToken;
@@ -1578,7 +1580,7 @@ RosegardenSequencer::transportJump(TransportRequest request,
     m_transportRequests.push_back(pair);
 
 #ifdef DEBUG_ROSEGARDEN_SEQUENCER
-    SEQUENCER_DEBUG << "RosegardenSequencer::transportJump: " << request << ", " << rt;
+    RG_RT_DEBUG << "transportJump(): " << request << ", " << rt;
 #endif
     if (request == TransportNoChange)
         return m_transportToken + 1;
@@ -1592,7 +1594,7 @@ RosegardenSequencer::isTransportSyncComplete(TransportToken token)
     QMutexLocker locker(&m_transportRequestMutex);
 
 #ifdef DEBUG_ROSEGARDEN_SEQUENCER
-    SEQUENCER_DEBUG << "RosegardenSequencer::isTransportSyncComplete: token " << token << ", current token " << m_transportToken;
+    RG_RT_DEBUG << "isTransportSyncComplete(): token " << token << ", current token " << m_transportToken;
 #endif
     return m_transportToken >= token;
 }
@@ -1602,7 +1604,7 @@ RosegardenSequencer::incrementTransportToken()
 {
     ++m_transportToken;
 #ifdef DEBUG_ROSEGARDEN_SEQUENCER
-    SEQUENCER_DEBUG << "RosegardenSequencer::incrementTransportToken: incrementing to " << m_transportToken;
+    RG_RT_DEBUG << "incrementTransportToken(): incrementing to " << m_transportToken;
 #endif
 }
 
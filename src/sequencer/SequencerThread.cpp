@@ -13,10 +13,12 @@
 */
 
 #define RG_MODULE_STRING "[SequencerThread]"
+#define RG_RT_CATEGORY Rosegarden::RTDebug::MIDI
 
 #include "SequencerThread.h"
 
 #include "misc/Debug.h"
+#include "misc/RealtimeDebug.h"
 #include "base/RealTime.h"
 #include "RosegardenSequencer.h"
 #include "gui/application/TransportStatus.h"
@@ -124,11 +126,11 @@ SequencerThread::run()
             // direct to RosegardenSequencer to start with
             seq.setStatus(STOPPED);
 
-            RG_DEBUG << "run() - Stopped";
+            RG_RT_DEBUG << "run() - Stopped";
             break;
 
         case RECORDING_ARMED:
-            RG_DEBUG << "run() - Sequencer can't enter \"RECORDING_ARMED\" state - internal error";
+            RG_RT_DEBUG << "run() - Sequencer can't enter \"RECORDING_ARMED\" state - internal error";
             break;
 
         case STOPPED:
@@ -148,7 +150,7 @@ SequencerThread::run()
 
         // If the sequencer status has changed...
         if (lastSeqStatus != seq.getStatus()) {
-            RG_DEBUG << "run(): Sequencer status changed from " << lastSeqStatus << " to " << seq.getStatus();
+            RG_RT_DEBUG << "run(): Sequencer status changed from " << lastSeqStatus << " to " << seq.getStatus();
             lastSeqStatus = seq.getStatus();
 
             // Immediately check for another change.
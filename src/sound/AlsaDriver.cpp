@@ -19,8 +19,10 @@
 
 #define RG_MODULE_STRING "[AlsaDriver]"
 #define RG_NO_DEBUG_PRINT 1
+#define RG_RT_CATEGORY Rosegarden::RTDebug::MIDI
 
 #include "misc/Debug.h"
+#include "misc/RealtimeDebug.h"
 #include <cstdlib>
 #include <cstdio>
 #include <algorithm>
@@ -2382,7 +2384,7 @@ void
 AlsaDriver::pushRecentNoteOffs()
 {
 #ifdef DEBUG_PROCESS_MIDI_OUT
-    RG_DEBUG << "pushRecentNoteOffs(): have " << m_recentNoteOffs.size() << " in queue";
+    RG_RT_DEBUG << "pushRecentNoteOffs(): have " << m_recentNoteOffs.size() << " in queue";
 #endif
 
     // Move all to m_noteOffQueue.
@@ -2403,7 +2405,7 @@ AlsaDriver::cropRecentNoteOffs(const RealTime &t)
         NoteOffQueue::const_iterator noteOffIter = m_recentNoteOffs.begin();
         const NoteOffEvent *noteOff = *noteOffIter;
 #ifdef DEBUG_PROCESS_MIDI_OUT
-        RG_DEBUG << "cropRecentNoteOffs(): " << noteOff->getRealTime() << " vs " << t;
+        RG_RT_DEBUG << "cropRecentNoteOffs(): " << noteOff->getRealTime() << " vs " << t;
 #endif
         if (noteOff->realTime >= t)
             break;
@@ -2423,7 +2425,7 @@ AlsaDriver::weedRecentNoteOffs(unsigned int pitch, MidiByte channel,
             (*i)->channel == channel &&
             (*i)->instrumentId == instrument) {
 #ifdef DEBUG_PROCESS_MIDI_OUT
-            RG_DEBUG << "weedRecentNoteOffs(): deleting one";
+            RG_RT_DEBUG << "weedRecentNoteOffs(): deleting one";
 #endif
             delete *i;
             m_recentNoteOffs.erase(i);
@@ -2513,7 +2515,7 @@ AlsaDriver::processNotesOff(const RealTime &time, bool now, bool everything)
     RealTime alsaTime = getAlsaTime();
 
 #ifdef DEBUG_PROCESS_MIDI_OUT
-    RG_DEBUG << "processNotesOff(" << time << "): alsaTime = " << alsaTime << ", now = " << now;
+    RG_RT_DEBUG << "processNotesOff(" << time << "): alsaTime = " << alsaTime << ", now = " << now;
 #endif
 
     // For each note-off event in the note-off queue.
@@ -2527,13 +2529,13 @@ AlsaDriver::processNotesOff(const RealTime &time, bool now, bool everything)
 
         if (noteOff->realTime > time) {
 #ifdef DEBUG_PROCESS_MIDI_OUT
-            RG_DEBUG << "processNotesOff(): Note off time " << noteOff->getRealTime() << " is beyond current time " << time;
+            RG_RT_DEBUG << "processNotesOff(): Note off time " << noteOff->getRealTime() << " is beyond current time " << time;
 #endif
             if (!everything) break;
         }
 
 #ifdef DEBUG_PROCESS_MIDI_OUT
-        RG_DEBUG << "processNotesOff(" << time << "): found event at " << noteOff->getRealTime() << ", instr " << noteOff->getInstrument() << ", channel " << int(noteOff->getChannel()) << ", pitch " << int(noteOff->getPitch());
+        RG_RT_DEBUG << "processNotesOff(" << time << "): found event at " << noteOff->getRealTime() << ", instr " << noteOff->getInstrument() << ", channel " << int(noteOff->getChannel()) << ", pitch " << int(noteOff->getPitch());
 #endif
 
         RealTime offTime = noteOff->realTime;
@@ -2561,7 +2563,7 @@ AlsaDriver::processNotesOff(const RealTime &time, bool now, bool everything)
             //
             int src = getOutputPortForMappedInstrument(noteOff->instrumentId);
             if (src < 0) {
-                RG_WARNING << "processNotesOff(): WARNING: Note off has no output port (instr = " << noteOff->instrumentId << ")";
+                RG_RT_WARNING << "processNotesOff(): WARNING: Note off has no output port (instr = " << noteOff->instrumentId << ")";
                 delete noteOff;
                 m_noteOffQueue.erase(noteOffIter);
                 continue;
@@ -2598,7 +2600,7 @@ AlsaDriver::processNotesOff(const RealTime &time, bool now, bool everything)
     // processMidiOut, which does the flushing
 
 #ifdef DEBUG_PROCESS_MIDI_OUT
-    RG_DEBUG << "processNotesOff() - queue size now: " << m_noteOffQueue.size();
+    RG_RT_DEBUG << "processNotesOff() - queue size now: " << m_noteOffQueue.size();
 #endif
 }
 
@@ -2648,7 +2650,7 @@ AlsaDriver::getMappedEventList(MappedEventList &mappedEventList)
 {
     while (failureReportReadIndex != failureReportWriteIndex) {
         MappedEvent::FailureCode code = failureReports[failureReportReadIndex];
-        //RG_DEBUG << "getMappedEventList(): failure code: " << code;
+        //RG_RT_DEBUG << "getMappedEventList(): failure code: " << code;
 
         MappedEvent *mE = new MappedEvent;
         mE->setType(MappedEvent::SystemFailure);
@@ -2675,7 +2677,7 @@ AlsaDriver::getMappedEventList(MappedEventList &mappedEventList)
 
     RealTime eventTime(0, 0);
 
-    //RG_DEBUG << "getMappedEventList(): looking for events";
+    //RG_RT_DEBUG << "getMappedEventList(): looking for events";
 
     snd_seq_event_t *event;
 
@@ -2688,13 +2690,13 @@ AlsaDriver::getMappedEventList(MappedEventList &mappedEventList)
 
     // While there's an event available...
     while (snd_seq_event_input(m_midiHandle, &event) > 0) {
-        //RG_DEBUG << "getMappedEventList(): found something";
+        //RG_RT_DEBUG << "getMappedEventList(): found something";
 
         unsigned int channel = (unsigned int)event->data.note.channel;
         unsigned int chanNoteKey = ( channel << 8 ) +
             (unsigned int) event->data.note.note;
 #ifdef DEBUG_ALSA
-        RG_DEBUG << "getMappedEventList(): Got note " << chanNoteKey
+        RG_RT_DEBUG << "getMappedEventList(): Got note " << chanNoteKey
                  << " on channel " << channel;
 #endif
 
@@ -2725,14 +2727,14 @@ AlsaDriver::getMappedEventList(MappedEventList &mappedEventList)
 
 #ifdef DEBUG_ALSA
         if (!fromExternalController) {
-            RG_DEBUG << "getMappedEventList(): Received normal event: type " << int(event->type) << ", chan " << channel << ", note " << int(event->data.note.note) << ", time " << eventTime;
+            RG_RT_DEBUG << "getMappedEventList(): Received normal event: type " << int(event->type) << ", chan " << channel << ", note " << int(event->data.note.note) << ", time " << eventTime;
         }
 #endif
 
         switch (event->type) {
         case SND_SEQ_EVENT_NOTE:
         case SND_SEQ_EVENT_NOTEON:
-            //RG_DEBUG << "AD::gMEL()  NOTEON channel:" << channel << " pitch:" << event->data.note.note << " velocity:" << event->data.note.velocity;
+            //RG_RT_DEBUG << "AD::gMEL()  NOTEON channel:" << channel << " pitch:" << event->data.note.note << " velocity:" << event->data.note.velocity;
 
             if (fromExternalController)
                 continue;
@@ -2768,7 +2770,7 @@ AlsaDriver::getMappedEventList(MappedEventList &mappedEventList)
             // NOTEON with velocity 0 is treated as a NOTEOFF
 
         case SND_SEQ_EVENT_NOTEOFF: {
-            //RG_DEBUG << "AD::gMEL()  NOTEOFF channel:" << channel << " pitch:" << event->data.note.note;
+            //RG_RT_DEBUG << "AD::gMEL()  NOTEOFF channel:" << channel << " pitch:" << event->data.note.note;
 
             if (fromExternalController)
                 continue;
@@ -2792,7 +2794,7 @@ AlsaDriver::getMappedEventList(MappedEventList &mappedEventList)
                 RealTime duration = eventTime - mE->getEventTime();
 
 #ifdef DEBUG_ALSA
-                RG_DEBUG << "getMappedEventList(): NOTE OFF: found NOTE ON at " << mE->getEventTime();
+                RG_RT_DEBUG << "getMappedEventList(): NOTE OFF: found NOTE ON at " << mE->getEventTime();
 #endif
 
                 // Fix zero duration record bug.
@@ -2935,12 +2937,12 @@ AlsaDriver::getMappedEventList(MappedEventList &mappedEventList)
 #ifdef DEBUG_ALSA
 
                 if ((MidiByte)(data[1]) == MIDI_SYSEX_RT) {
-                    RG_DEBUG << "getMappedEventList(): REALTIME SYSEX";
+                    RG_RT_DEBUG << "getMappedEventList(): REALTIME SYSEX";
                     for (unsigned int ii = 0; ii < event->data.ext.len; ++ii) {
                         printf("B %u = %02x\n", ii, ((char*)(event->data.ext.ptr))[ii]);
                     }
                 } else {
-                    RG_DEBUG << "getMappedEventList(): NON-REALTIME SYSEX";
+                    RG_RT_DEBUG << "getMappedEventList(): NON-REALTIME SYSEX";
                     for (unsigned int ii = 0; ii < event->data.ext.len; ++ii) {
                         printf("B %u = %02x\n", ii, ((char*)(event->data.ext.ptr))[ii]);
                     }
@@ -2991,8 +2993,8 @@ AlsaDriver::getMappedEventList(MappedEventList &mappedEventList)
                     createNewEvent = true;
 
                     if (!beginNewMessage) {
-                        RG_WARNING << "getMappedEventList(): WARNING: New ALSA message arrived with incorrect MIDI System Exclusive start byte.";
-                        RG_WARNING << "getMappedEventList():          This is probably a bad transmission.";
+                        RG_RT_WARNING << "getMappedEventList(): WARNING: New ALSA message arrived with incorrect MIDI System Exclusive start byte.";
+                        RG_RT_WARNING << "getMappedEventList():          This is probably a bad transmission.";
                     }
                 } else {
                     // We found a pending (unfinished) System Exclusive message.
@@ -3011,15 +3013,15 @@ AlsaDriver::getMappedEventList(MappedEventList &mappedEventList)
 
                         // Decide how to handle previous (incomplete) message
                         if (sysExcData.size() > 0) {
-                            RG_WARNING << "getMappedEventList(): WARNING: Sending an incomplete ALSA message to the composition.";
-                            RG_WARNING << "getMappedEventList():          This is probably a bad transmission.";
+                            RG_RT_WARNING << "getMappedEventList(): WARNING: Sending an incomplete ALSA message to the composition.";
+                            RG_RT_WARNING << "getMappedEventList():          This is probably a bad transmission.";
 
                             // Push previous (incomplete) message to mapped event list
                             DataBlockRepository::setDataBlockForEvent(sysExcEvent, sysExcData);
                             mappedEventList.insert(sysExcEvent);
                         } else {
                             // Previous message has no meaningful data.
-                            RG_WARNING << "getMappedEventList(): WARNING: Discarding meaningless incomplete ALSA message";
+                            RG_RT_WARNING << "getMappedEventList(): WARNING: Discarding meaningless incomplete ALSA message";
 
                             delete sysExcEvent;
                         }
@@ -3059,8 +3061,8 @@ AlsaDriver::getMappedEventList(MappedEventList &mappedEventList)
                     // in the pending map.  This will resolve itself elsewhere.
                     // But if we are here, this is probably and error.
 
-                    RG_WARNING << "getMappedEventList(): WARNING: ALSA message arrived with no useful System Exclusive data bytes";
-                    RG_WARNING << "getMappedEventList():          This is probably a bad transmission";
+                    RG_RT_WARNING << "getMappedEventList(): WARNING: ALSA message arrived with no useful System Exclusive data bytes";
+                    RG_RT_WARNING << "getMappedEventList():          This is probably a bad transmission";
 
                     pushOnMap = true;
                 }
@@ -3071,7 +3073,7 @@ AlsaDriver::getMappedEventList(MappedEventList &mappedEventList)
                                                            std::make_pair(sysExcEvent, data)));
 
                     if (beginNewMessage) {
-                        RG_DEBUG << "getMappedEventList(): Encountered long System Exclusive Message (pooling message until transmission complete)";
+                        RG_RT_DEBUG << "getMappedEventList(): Encountered long System Exclusive Message (pooling message until transmission complete)";
                     }
                 }
             }
@@ -3091,7 +3093,7 @@ AlsaDriver::getMappedEventList(MappedEventList &mappedEventList)
 
         case SND_SEQ_EVENT_CLOCK:
 #ifdef DEBUG_ALSA
-            RG_DEBUG << "getMappedEventList() - got realtime MIDI clock";
+            RG_RT_DEBUG << "getMappedEventList() - got realtime MIDI clock";
 #endif
             break;
 
@@ -3104,7 +3106,7 @@ AlsaDriver::getMappedEventList(MappedEventList &mappedEventList)
                         RosegardenSequencer::TransportStart);
             }
 #ifdef DEBUG_ALSA
-            RG_DEBUG << "getMappedEventList() - START";
+            RG_RT_DEBUG << "getMappedEventList() - START";
 #endif
             break;
 
@@ -3114,7 +3116,7 @@ AlsaDriver::getMappedEventList(MappedEventList &mappedEventList)
                         RosegardenSequencer::TransportPlay);
             }
 #ifdef DEBUG_ALSA
-            RG_DEBUG << "getMappedEventList() - CONTINUE";
+            RG_RT_DEBUG << "getMappedEventList() - CONTINUE";
 #endif
             break;
 
@@ -3124,13 +3126,13 @@ AlsaDriver::getMappedEventList(MappedEventList &mappedEventList)
                         RosegardenSequencer::TransportStop);
             }
 #ifdef DEBUG_ALSA
-            RG_DEBUG << "getMappedEventList() - STOP";
+            RG_RT_DEBUG << "getMappedEventList() - STOP";
 #endif
             break;
 
         case SND_SEQ_EVENT_SONGPOS:
 #ifdef DEBUG_ALSA
-            RG_DEBUG << "getMappedEventList() - SONG POSITION";
+            RG_RT_DEBUG << "getMappedEventList() - SONG POSITION";
 #endif
 
             break;
@@ -3146,14 +3148,14 @@ AlsaDriver::getMappedEventList(MappedEventList &mappedEventList)
             // These cases are handled by checkForNewClients().
             m_portCheckNeeded = true;
 #ifdef DEBUG_ALSA
-            RG_DEBUG << "getMappedEventList() - got announce event (" << int(event->type) << ")";
+            RG_RT_DEBUG << "getMappedEventList() - got announce event (" << int(event->type) << ")";
 #endif
 
             break;
         case SND_SEQ_EVENT_TICK:
         default:
 #ifdef DEBUG_ALSA
-            RG_DEBUG << "getMappedEventList() - got unhandled MIDI event type from ALSA sequencer" << "(" << int(event->type) << ")";
+            RG_RT_DEBUG << "getMappedEventList() - got unhandled MIDI event type from ALSA sequencer" << "(" << int(event->type) << ")";
 #endif
 
             break;
@@ -3164,7 +3166,7 @@ AlsaDriver::getMappedEventList(MappedEventList &mappedEventList)
 
     if (m_mtcStatus == TRANSPORT_FOLLOWER && isPlaying()) {
 #ifdef MTC_DEBUG
-        RG_DEBUG << "getMappedEventList(): seq time is " << getSequencerTime() << ", last MTC receive "
+        RG_RT_DEBUG << "getMappedEventList(): seq time is " << getSequencerTime() << ", last MTC receive "
                  << m_mtcLastReceive << ", first time " << m_mtcFirstTime;
 #endif
 
@@ -3293,14 +3295,14 @@ AlsaDriver::handleMTCQFrame(unsigned int data_byte, RealTime the_time)
          */
         if (m_playing) {
 #ifdef MTC_DEBUG
-            RG_DEBUG << "handleMTCQFrame(): RG MTC: Tstamp " << m_mtcEncodedTime << " Received @ " << m_mtcReceiveTime;
+            RG_RT_DEBUG << "handleMTCQFrame(): RG MTC: Tstamp " << m_mtcEncodedTime << " Received @ " << m_mtcReceiveTime;
 #endif
 
             calibrateMTC();
 
             RealTime t_diff = m_mtcEncodedTime - m_mtcReceiveTime;
 #ifdef MTC_DEBUG
-            RG_DEBUG << "handleMTCQFrame(): Diff: " << t_diff;
+            RG_RT_DEBUG << "handleMTCQFrame(): Diff: " << t_diff;
 #endif
 
             /* -ve diff means ALSA time ahead of MTC time */
@@ -3328,14 +3330,14 @@ AlsaDriver::handleMTCQFrame(unsigned int data_byte, RealTime the_time)
 
         } else if (m_eat_mtc > 0) {
 #ifdef MTC_DEBUG
-            RG_DEBUG << "handleMTCQFrame(): MTC: Received quarter frame just after issuing MMC stop - ignore it";
+            RG_RT_DEBUG << "handleMTCQFrame(): MTC: Received quarter frame just after issuing MMC stop - ignore it";
 #endif
 
             --m_eat_mtc;
         } else {
             /* If we're not playing, we should be. */
 #ifdef MTC_DEBUG
-            RG_DEBUG << "handleMTCQFrame(): MTC: Received quarter frame while not playing - starting now";
+            RG_RT_DEBUG << "handleMTCQFrame(): MTC: Received quarter frame while not playing - starting now";
 #endif
 
             tweakSkewForMTC(0);  /* JPM - reset it on start of playback, to be sure */
@@ -3410,7 +3412,7 @@ AlsaDriver::insertMTCQFrames(RealTime sliceStart, RealTime sliceEnd)
     int fps = 25;
 
 #ifdef MTC_DEBUG
-    RG_DEBUG << "insertMTCQFrames(" << sliceStart << ","
+    RG_RT_DEBUG << "insertMTCQFrames(" << sliceStart << ","
              << sliceEnd << "): first time " << m_mtcFirstTime;
 #endif
 
@@ -3441,7 +3443,7 @@ AlsaDriver::insertMTCQFrames(RealTime sliceStart, RealTime sliceEnd)
         snd_seq_ev_set_subs(&event);
 
 #ifdef MTC_DEBUG
-        RG_DEBUG << "insertMTCQFrames(): Sending MTC quarter frame at " << t;
+        RG_RT_DEBUG << "insertMTCQFrames(): Sending MTC quarter frame at " << t;
 #endif
 
         unsigned char c = (type << 4);
@@ -3517,9 +3519,9 @@ AlsaDriver::testForMTCSysex(const snd_seq_event_t *event)
     // sysex we're interested in is full-frame transport location
 
 #ifdef MTC_DEBUG
-    RG_DEBUG << "testForMTCSysex(): MTC: testing sysex of length " << event->data.ext.len << ":";
+    RG_RT_DEBUG << "testForMTCSysex(): MTC: testing sysex of length " << event->data.ext.len << ":";
     for (int i = 0; i < event->data.ext.len; ++i) {
-        RG_DEBUG << "testForMTCSysex():     " << (int)*((unsigned char *)event->data.ext.ptr + i);
+        RG_RT_DEBUG << "testForMTCSysex():     " << (int)*((unsigned char *)event->data.ext.ptr + i);
     }
 #endif
 
@@ -3584,7 +3586,7 @@ AlsaDriver::testForMTCSysex(const snd_seq_event_t *event)
     }
 
 #ifdef MTC_DEBUG
-    RG_DEBUG << "testForMTCSysex(): MTC: MTC sysex found (frame type " << type << "), jumping to " << m_mtcEncodedTime;
+    RG_RT_DEBUG << "testForMTCSysex(): MTC: MTC sysex found (frame type " << type << "), jumping to " << m_mtcEncodedTime;
 #endif
 
     RosegardenSequencer::getInstance()->transportJump(
@@ -3665,14 +3667,14 @@ restarted.  Reset it to a sane default when called with factor of 0
 
     unsigned int t_skew = snd_seq_queue_tempo_get_skew(q_ptr);
 #ifdef MTC_DEBUG
-    RG_DEBUG << "tweakSkewForMTC(): RG MTC: skew: " << t_skew;
+    RG_RT_DEBUG << "tweakSkewForMTC(): RG MTC: skew: " << t_skew;
 #endif
 
     // cppcheck-suppress redundantAssignment
     t_skew = 0x10000 + factor + bias_factor;
 
 #ifdef MTC_DEBUG
-    RG_DEBUG << "tweakSkewForMTC():     changed to " << factor << "+" << bias_factor;
+    RG_RT_DEBUG << "tweakSkewForMTC():     changed to " << factor << "+" << bias_factor;
 #endif
 
     snd_seq_queue_tempo_set_skew(q_ptr, t_skew);
@@ -3732,7 +3734,7 @@ AlsaDriver::processMidiOut(const MappedEventList &rgEventList,
     bool now = (sliceStart == RealTime::zero() && sliceEnd == RealTime::zero());
 
 #ifdef DEBUG_PROCESS_MIDI_OUT
-    RG_DEBUG << "processMidiOut(" << sliceStart << "," << sliceEnd << "), " << rgEventList.size() << " events, now is " << now;
+    RG_RT_DEBUG << "processMidiOut(" << sliceStart << "," << sliceEnd << "), " << rgEventList.size() << " events, now is " << now;
 #endif
 
     if (!now) {
@@ -3778,15 +3780,15 @@ AlsaDriver::processMidiOut(const MappedEventList &rgEventList,
 
         bool debug = throttledDebug();
         if (debug) {
-            RG_DEBUG << "processMidiOut(): for each event...";
-            QString eventType = "unknown";
+            RG_RT_DEBUG << "processMidiOut(): for each event...";
+            const char *eventType = "unknown";
             switch (rgEvent->getType()) {
                 case MappedEvent::MidiNote: eventType = "MidiNote"; break;
                 case MappedEvent::MidiNoteOneShot: eventType = "MidiNoteOneShot"; break;
                 case MappedEvent::MidiController: eventType = "MidiController"; break;
                 default: break;
             }
-            RG_DEBUG << "processMidiOut():   MappedEvent Event Type: " << rgEvent->getType() << " (" << eventType << ")";
+            RG_RT_DEBUG << "processMidiOut():   MappedEvent Event Type: " << rgEvent->getType() << " (" << eventType << ")";
         }
 
         snd_seq_event_t alsaEvent;
@@ -3805,7 +3807,7 @@ AlsaDriver::processMidiOut(const MappedEventList &rgEventList,
             // stop queue to ensure exact timing and make sure the
             // event gets through right now
 #ifdef DEBUG_PROCESS_MIDI_OUT
-            RG_DEBUG << "processMidiOut(): stopping queue for now-event";
+            RG_RT_DEBUG << "processMidiOut(): stopping queue for now-event";
 #endif
 
             checkAlsaError(snd_seq_stop_queue(m_midiHandle, m_queue, nullptr), "processMidiOut(): stop queue");
@@ -3826,7 +3828,7 @@ AlsaDriver::processMidiOut(const MappedEventList &rgEventList,
         }
 
 #ifdef DEBUG_PROCESS_MIDI_OUT
-        RG_DEBUG << "processMidiOut[" << now << "]: event is at " << outputTime << " (" << outputTime - alsaTimeNow << " ahead of queue time), type " << int(rgEvent->getType()) << ", duration " << rgEvent->getDuration();
+        RG_RT_DEBUG << "processMidiOut[" << now << "]: event is at " << outputTime << " (" << outputTime - alsaTimeNow << " ahead of queue time), type " << int(rgEvent->getType()) << ", duration " << rgEvent->getDuration();
 #endif
 
         if (!m_queueRunning && outputTime < alsaTimeNow) {
@@ -3834,20 +3836,20 @@ AlsaDriver::processMidiOut(const MappedEventList &rgEventList,
             if (rgEvent->getDuration() > RealTime::zero()) {
                 if (rgEvent->getDuration() <= adjust) {
 #ifdef DEBUG_PROCESS_MIDI_OUT
-                    RG_DEBUG << "processMidiOut[" << now << "]: too late for this event, abandoning it";
+                    RG_RT_DEBUG << "processMidiOut[" << now << "]: too late for this event, abandoning it";
 #endif
 
                     continue;
                 } else {
 #ifdef DEBUG_PROCESS_MIDI_OUT
-                    RG_DEBUG << "processMidiOut[" << now << "]: pushing event forward and reducing duration by " << adjust;
+                    RG_RT_DEBUG << "processMidiOut[" << now << "]: pushing event forward and reducing duration by " << adjust;
 #endif
 
                     rgEvent->setDuration(rgEvent->getDuration() - adjust);
                 }
             } else {
 #ifdef DEBUG_PROCESS_MIDI_OUT
-                RG_DEBUG << "processMidiOut[" << now << "]: pushing zero-duration event forward by " << adjust;
+                RG_RT_DEBUG << "processMidiOut[" << now << "]: pushing zero-duration event forward by " << adjust;
 #endif
 
             }
@@ -3862,7 +3864,7 @@ AlsaDriver::processMidiOut(const MappedEventList &rgEventList,
             size_t elapsed = frameCount - debug_jack_frame_count;
             RealTime rt = RealTime::frame2RealTime(elapsed, m_jackDriver->getSampleRate());
             rt = rt - getAlsaTime();
-            RG_DEBUG << "processMidiOut[" << now << "]: JACK time is " << rt << " ahead of ALSA time";
+            RG_RT_DEBUG << "processMidiOut[" << now << "]: JACK time is " << rt << " ahead of ALSA time";
         }
 #endif
 
@@ -3874,7 +3876,7 @@ AlsaDriver::processMidiOut(const MappedEventList &rgEventList,
         if (!isSoftSynth) {
 
 #ifdef DEBUG_PROCESS_MIDI_OUT
-            RG_DEBUG << "processMidiOut[" << now << "]: instrument" << rgEvent->getInstrument() << " pitch:" << (int)rgEvent->getPitch() << " velocity" << (int)rgEvent->getVelocity() << "duration " << rgEvent->getDuration();
+            RG_RT_DEBUG << "processMidiOut[" << now << "]: instrument" << rgEvent->getInstrument() << " pitch:" << (int)rgEvent->getPitch() << " velocity" << (int)rgEvent->getVelocity() << "duration " << rgEvent->getDuration();
 #endif
 
             snd_seq_ev_set_subs(&alsaEvent);
@@ -3915,16 +3917,16 @@ AlsaDriver::processMidiOut(const MappedEventList &rgEventList,
         if (isExternalController) {
             channel = rgEvent->getRecordedChannel();
 #ifdef DEBUG_ALSA
-            RG_DEBUG << "processMidiOut() - Event of type " << (int)(rgEvent->getType()) << " (data1 " << (int)rgEvent->getData1() << ", data2 " << (int)rgEvent->getData2() << ") for external controller channel " << (int)channel;
+            RG_RT_DEBUG << "processMidiOut() - Event of type " << (int)(rgEvent->getType()) << " (data1 " << (int)rgEvent->getData1() << ", data2 " << (int)rgEvent->getData2() << ") for external controller channel " << (int)channel;
 #endif
         } else if (instrument != nullptr) {
             channel = rgEvent->getRecordedChannel();
 #ifdef DEBUG_ALSA
-            RG_DEBUG << "processMidiOut() - Non-controller Event of type " << (int)(rgEvent->getType()) << " (data1 " << (int)rgEvent->getData1() << ", data2 " << (int)rgEvent->getData2() << ") for channel " << (int)rgEvent->getRecordedChannel();
+            RG_RT_DEBUG << "processMidiOut() - Non-controller Event of type " << (int)(rgEvent->getType()) << " (data1 " << (int)rgEvent->getData1() << ", data2 " << (int)rgEvent->getData2() << ") for channel " << (int)rgEvent->getRecordedChannel();
 #endif
         } else {
 #ifdef DEBUG_ALSA
-            RG_DEBUG << "processMidiOut() - No instrument for event of type "
+            RG_RT_DEBUG << "processMidiOut() - No instrument for event of type "
                       << (int)rgEvent->getType() << " at " << rgEvent->getEventTime();
 #endif
             channel = 0;
@@ -4037,7 +4039,7 @@ AlsaDriver::processMidiOut(const MappedEventList &rgEventList,
                 RealTime rt =
                     RealTime(time.tv_sec, time.tv_nsec);
 
-                //RG_DEBUG << "processMidiOut() - " << "send clock @ " << rt;
+                //RG_RT_DEBUG << "processMidiOut() - " << "send clock @ " << rt;
 
                 // Send out the sync port.
                 sendSystemQueued(SND_SEQ_EVENT_CLOCK, "", rt);
@@ -4054,7 +4056,7 @@ AlsaDriver::processMidiOut(const MappedEventList &rgEventList,
                 break;
 
             default:
-                RG_WARNING << "processMidiOut(): WARNING: unrecognised system message";
+                RG_RT_WARNING << "processMidiOut(): WARNING: unrecognised system message";
                 break;
             }
         }
@@ -4115,44 +4117,44 @@ AlsaDriver::processMidiOut(const MappedEventList &rgEventList,
         case MappedEvent::InvalidMappedEvent:
         default:
 #ifdef DEBUG_ALSA
-            RG_DEBUG << "processMidiOut() - skipping unrecognised or invalid MappedEvent type";
+            RG_RT_DEBUG << "processMidiOut() - skipping unrecognised or invalid MappedEvent type";
 #endif
 
             continue;
         }
 
         if (debug) {
-            QString eventType = "unknown";
+            const char *eventType = "unknown";
             switch (alsaEvent.type) {
                 case SND_SEQ_EVENT_NOTEON: eventType = "SND_SEQ_EVENT_NOTEON"; break;
                 case SND_SEQ_EVENT_NOTEOFF: eventType = "SND_SEQ_EVENT_NOTEOFF"; break;
                 case SND_SEQ_EVENT_CONTROLLER: eventType = "SND_SEQ_EVENT_CONTROLLER"; break;
                 default: break;
             }
-            RG_DEBUG << "  ALSA event type: " << alsaEvent.type << " (" << eventType << ")";
+            RG_RT_DEBUG << "  ALSA event type: " << alsaEvent.type << " (" << eventType << ")";
         }
 
         if (isSoftSynth) {
             if (debug)
-                RG_DEBUG << "  Calling processSoftSynthEventOut()...";
+                RG_RT_DEBUG << "  Calling processSoftSynthEventOut()...";
 
             processSoftSynthEventOut(rgEvent->getInstrumentId(), &alsaEvent, now);
 
         } else {
             if (debug)
-                RG_DEBUG << "  Calling snd_seq_event_output()...";
+                RG_RT_DEBUG << "  Calling snd_seq_event_output()...";
 
             int rc = snd_seq_event_output(m_midiHandle, &alsaEvent);
             checkAlsaError(rc, "processMidiOut(): output queued");
 
             if (debug)
-                RG_DEBUG << "  snd_seq_event_output() rc:" << rc;
+                RG_RT_DEBUG << "  snd_seq_event_output() rc:" << rc;
 
             if (now) {
                 if (m_queueRunning && !m_playing) {
                     // restart queue
 #ifdef DEBUG_PROCESS_MIDI_OUT
-                    RG_DEBUG << "processMidiOut(): restarting queue after now-event";
+                    RG_RT_DEBUG << "processMidiOut(): restarting queue after now-event";
 #endif
 
                     checkAlsaError(snd_seq_continue_queue(m_midiHandle, m_queue, nullptr), "processMidiOut(): continue queue");
@@ -4171,7 +4173,7 @@ AlsaDriver::processMidiOut(const MappedEventList &rgEventList,
                                  rgEvent->getInstrumentId());
 
 #ifdef DEBUG_ALSA
-            RG_DEBUG << "processMidiOut(): Adding NOTE OFF at " << outputStopTime;
+            RG_RT_DEBUG << "processMidiOut(): Adding NOTE OFF at " << outputStopTime;
 #endif
 
             m_noteOffQueue.insert(noteOffEvent);
@@ -4189,14 +4191,14 @@ AlsaDriver::processMidiOut(const MappedEventList &rgEventList,
         if (now && !m_playing) {
             // just to be sure
 #ifdef DEBUG_PROCESS_MIDI_OUT
-            RG_DEBUG << "processMidiOut(): restarting queue after all now-events";
+            RG_RT_DEBUG << "processMidiOut(): restarting queue after all now-events";
 #endif
 
             checkAlsaError(snd_seq_continue_queue(m_midiHandle, m_queue, nullptr), "processMidiOut(): continue queue");
         }
 
 #ifdef DEBUG_PROCESS_MIDI_OUT
-        //RG_DEBUG << "processMidiOut(): m_queueRunning " << m_queueRunning << ", now " << now;
+        //RG_RT_DEBUG << "processMidiOut(): m_queueRunning " << m_queueRunning << ", now " << now;
 #endif
         checkAlsaError(snd_seq_drain_output(m_midiHandle), "processMidiOut(): draining");
     }
@@ -4208,7 +4210,7 @@ AlsaDriver::processSoftSynthEventOut(InstrumentId id,
                                      bool now)
 {
 #ifdef DEBUG_PROCESS_SOFT_SYNTH_OUT
-    RG_DEBUG << "processSoftSynthEventOut(): instrument " << id << ", now " << now;
+    RG_RT_DEBUG << "processSoftSynthEventOut(): instrument " << id << ", now " << now;
 #endif
 
 #ifdef HAVE_LIBJACK
@@ -4227,14 +4229,14 @@ AlsaDriver::processSoftSynthEventOut(InstrumentId id,
             t = t + m_playStartPosition - m_alsaPlayStartTime;
 
 #ifdef DEBUG_PROCESS_SOFT_SYNTH_OUT
-        RG_DEBUG << "processSoftSynthEventOut(): event time " << t;
+        RG_RT_DEBUG << "processSoftSynthEventOut(): event time " << t;
 #endif
 
         synthPlugin->sendEvent(t, event);
 
         if (now) {
 #ifdef DEBUG_PROCESS_SOFT_SYNTH_OUT
-            RG_DEBUG << "processSoftSynthEventOut(): setting haveAsyncAudioEvent";
+            RG_RT_DEBUG << "processSoftSynthEventOut(): setting haveAsyncAudioEvent";
 #endif
 
             m_jackDriver->setHaveAsyncAudioEvent();
@@ -4464,7 +4466,7 @@ AlsaDriver::processEventsOut(const MappedEventList &rgEventList,
                     (m_studio->getAudioFader(mappedEvent->getInstrumentId()));
 
                 if (!fader) {
-                    RG_WARNING << "processEventsOut(): WARNING: No fader for audio instrument " << mappedEvent->getInstrumentId();
+                    RG_RT_WARNING << "processEventsOut(): WARNING: No fader for audio instrument " << mappedEvent->getInstrumentId();
                     continue;
                 }
 
@@ -4482,8 +4484,8 @@ AlsaDriver::processEventsOut(const MappedEventList &rgEventList,
 
                 //#define DEBUG_PLAYING_AUDIO
 #ifdef DEBUG_PLAYING_AUDIO
-                RG_DEBUG << "processEventsOut(): Creating playable audio file: id " << audioFile->getId() << ", event time " << mappedEvent->getEventTime() << ", time now " << getAlsaTime() << ", start marker " << mappedEvent->getAudioStartMarker() << ", duration " << mappedEvent->getDuration() << ", instrument " << mappedEvent->getInstrument() << " channels " << channels;
-                RG_DEBUG << "processEventsOut(): Read buffer length is " << bufferLength << " (" << bufferFrames << " frames)";
+                RG_RT_DEBUG << "processEventsOut(): Creating playable audio file: id " << audioFile->getId() << ", event time " << mappedEvent->getEventTime() << ", time now " << getAlsaTime() << ", start marker " << mappedEvent->getAudioStartMarker() << ", duration " << mappedEvent->getDuration() << ", instrument " << mappedEvent->getInstrument() << " channels " << channels;
+                RG_RT_DEBUG << "processEventsOut(): Read buffer length is " << bufferLength << " (" << bufferFrames << " frames)";
 #endif
 
                 PlayableAudioFile *paf = nullptr;
@@ -4511,7 +4513,7 @@ AlsaDriver::processEventsOut(const MappedEventList &rgEventList,
                     //#define DEBUG_AUTOFADING
 #ifdef DEBUG_AUTOFADING
 
-                    RG_DEBUG << "processEventsOut(): PlayableAudioFile is AUTOFADING - "
+                    RG_RT_DEBUG << "processEventsOut(): PlayableAudioFile is AUTOFADING - "
                              << "in = " << mappedEvent->getFadeInTime()
                              << ", out = " << mappedEvent->getFadeOutTime();
 #endif
@@ -4519,7 +4521,7 @@ AlsaDriver::processEventsOut(const MappedEventList &rgEventList,
                 }
 #ifdef DEBUG_AUTOFADING
                 else {
-                    RG_DEBUG << "processEventsOut(): PlayableAudioFile has no AUTOFADE";
+                    RG_RT_DEBUG << "processEventsOut(): PlayableAudioFile has no AUTOFADE";
                 }
 #endif
 
@@ -4532,8 +4534,8 @@ AlsaDriver::processEventsOut(const MappedEventList &rgEventList,
                 haveNewAudio = true;
             } else {
 #ifdef DEBUG_ALSA
-                RG_DEBUG << "processEventsOut(): Can't find audio file reference.";
-                RG_DEBUG << "processEventsOut(): Try reloading the current Rosegarden file.";
+                RG_RT_DEBUG << "processEventsOut(): Can't find audio file reference.";
+                RG_RT_DEBUG << "processEventsOut(): Try reloading the current Rosegarden file.";
 #else
                 ;
 #endif
@@ -4554,7 +4556,7 @@ AlsaDriver::processEventsOut(const MappedEventList &rgEventList,
             case 0:  // MIDI Clock and System messages: Off
                 m_midiClockEnabled = false;
 #ifdef DEBUG_ALSA
-                RG_DEBUG << "processEventsOut(): Rosegarden MIDI CLOCK, START and STOP DISABLED";
+                RG_RT_DEBUG << "processEventsOut(): Rosegarden MIDI CLOCK, START and STOP DISABLED";
 #endif
 
                 m_midiSyncStatus = TRANSPORT_OFF;
@@ -4563,7 +4565,7 @@ AlsaDriver::processEventsOut(const MappedEventList &rgEventList,
             case 1:  // MIDI Clock and System messages: Send MIDI Clock, Start and Stop
                 m_midiClockEnabled = true;
 #ifdef DEBUG_ALSA
-                RG_DEBUG << "processEventsOut(): Rosegarden send MIDI CLOCK, START and STOP ENABLED";
+                RG_RT_DEBUG << "processEventsOut(): Rosegarden send MIDI CLOCK, START and STOP ENABLED";
 #endif
 
                 m_midiSyncStatus = TRANSPORT_SOURCE;
@@ -4572,7 +4574,7 @@ AlsaDriver::processEventsOut(const MappedEventList &rgEventList,
             case 2:  // MIDI Clock and System messages: Accept Start, Stop and Continue
                 m_midiClockEnabled = false;
 #ifdef DEBUG_ALSA
-                RG_DEBUG << "processEventsOut(): Rosegarden accept START and STOP ENABLED";
+                RG_RT_DEBUG << "processEventsOut(): Rosegarden accept START and STOP ENABLED";
 #endif
 
                 m_midiSyncStatus = TRANSPORT_FOLLOWER;
@@ -4584,7 +4586,7 @@ AlsaDriver::processEventsOut(const MappedEventList &rgEventList,
             if (mappedEvent->getData1()) {
                 m_midiSyncAutoConnect = true;
 #ifdef DEBUG_ALSA
-                RG_DEBUG << "processEventsOut(): Rosegarden MIDI SYNC AUTO ENABLED";
+                RG_RT_DEBUG << "processEventsOut(): Rosegarden MIDI SYNC AUTO ENABLED";
 #endif
 
                 for (DevicePortMap::iterator dpmi = m_devicePortMap.begin();
@@ -4597,7 +4599,7 @@ AlsaDriver::processEventsOut(const MappedEventList &rgEventList,
             } else {
                 m_midiSyncAutoConnect = false;
 #ifdef DEBUG_ALSA
-                RG_DEBUG << "processEventsOut(): Rosegarden MIDI SYNC AUTO DISABLED";
+                RG_RT_DEBUG << "processEventsOut(): Rosegarden MIDI SYNC AUTO DISABLED";
 #endif
             }
         }
@@ -4613,21 +4615,21 @@ AlsaDriver::processEventsOut(const MappedEventList &rgEventList,
                 source = true;
                 enabled = true;
 #ifdef DEBUG_ALSA
-                RG_DEBUG << "processEventsOut(): Rosegarden to follow JACK transport and request JACK timebase master role (not yet implemented)";
+                RG_RT_DEBUG << "processEventsOut(): Rosegarden to follow JACK transport and request JACK timebase master role (not yet implemented)";
 #endif
                 break;
 
             case 1:
                 enabled = true;
 #ifdef DEBUG_ALSA
-                RG_DEBUG << "processEventsOut(): Rosegarden to follow JACK transport";
+                RG_RT_DEBUG << "processEventsOut(): Rosegarden to follow JACK transport";
 #endif
                 break;
 
             case 0:
             default:
 #ifdef DEBUG_ALSA
-                RG_DEBUG << "processEventsOut(): Rosegarden to ignore JACK transport";
+                RG_RT_DEBUG << "processEventsOut(): Rosegarden to ignore JACK transport";
 #endif
                 break;
             }
@@ -4644,7 +4646,7 @@ AlsaDriver::processEventsOut(const MappedEventList &rgEventList,
             switch ((int)mappedEvent->getData1()) {
             case 1:
 #ifdef DEBUG_ALSA
-                RG_DEBUG << "processEventsOut(): Rosegarden is MMC SOURCE";
+                RG_RT_DEBUG << "processEventsOut(): Rosegarden is MMC SOURCE";
 #endif
 
                 m_mmcStatus = TRANSPORT_SOURCE;
@@ -4652,7 +4654,7 @@ AlsaDriver::processEventsOut(const MappedEventList &rgEventList,
 
             case 2:
 #ifdef DEBUG_ALSA
-                RG_DEBUG << "processEventsOut(): Rosegarden is MMC FOLLOWER";
+                RG_RT_DEBUG << "processEventsOut(): Rosegarden is MMC FOLLOWER";
 #endif
                 m_mmcStatus = TRANSPORT_FOLLOWER;
                 break;
@@ -4660,7 +4662,7 @@ AlsaDriver::processEventsOut(const MappedEventList &rgEventList,
             case 0:
             default:
 #ifdef DEBUG_ALSA
-                RG_DEBUG << "processEventsOut(): Rosegarden MMC Transport DISABLED";
+                RG_RT_DEBUG << "processEventsOut(): Rosegarden MMC Transport DISABLED";
 #endif
 
                 m_mmcStatus = TRANSPORT_OFF;
@@ -4672,7 +4674,7 @@ AlsaDriver::processEventsOut(const MappedEventList &rgEventList,
             switch ((int)mappedEvent->getData1()) {
             case 1:
 #ifdef DEBUG_ALSA
-                RG_DEBUG << "processEventsOut(): Rosegarden is MTC SOURCE";
+                RG_RT_DEBUG << "processEventsOut(): Rosegarden is MTC SOURCE";
 #endif
 
                 m_mtcStatus = TRANSPORT_SOURCE;
@@ -4682,7 +4684,7 @@ AlsaDriver::processEventsOut(const MappedEventList &rgEventList,
 
             case 2:
 #ifdef DEBUG_ALSA
-                RG_DEBUG << "processEventsOut(): Rosegarden is MTC FOLLOWER";
+                RG_RT_DEBUG << "processEventsOut(): Rosegarden is MTC FOLLOWER";
 #endif
 
                 m_mtcStatus = TRANSPORT_FOLLOWER;
@@ -4692,7 +4694,7 @@ AlsaDriver::processEventsOut(const MappedEventList &rgEventList,
             case 0:
             default:
 #ifdef DEBUG_ALSA
-                RG_DEBUG << "processEventsOut(): Rosegarden MTC Transport DISABLED";
+                RG_RT_DEBUG << "processEventsOut(): Rosegarden MTC Transport DISABLED";
 #endif
 
                 m_mtcStatus = TRANSPORT_OFF;
@@ -4714,7 +4716,7 @@ AlsaDriver::processEventsOut(const MappedEventList &rgEventList,
             }
 #else
 #ifdef DEBUG_ALSA
-            RG_DEBUG << "processEventsOut(): MappedEvent::SystemAudioPorts - no audio subsystem";
+            RG_RT_DEBUG << "processEventsOut(): MappedEvent::SystemAudioPorts - no audio subsystem";
 #endif
 #endif
 
@@ -4732,14 +4734,14 @@ AlsaDriver::processEventsOut(const MappedEventList &rgEventList,
                 break;
             default:
 #ifdef DEBUG_ALSA
-                RG_DEBUG << "processEventsOut(): MappedEvent::SystemAudioFileFormat - unexpected format number " << format;
+                RG_RT_DEBUG << "processEventsOut(): MappedEvent::SystemAudioFileFormat - unexpected format number " << format;
 #endif
 
                 break;
             }
 #else
 #ifdef DEBUG_ALSA
-            RG_DEBUG << "processEventsOut(): MappedEvent::SystemAudioFileFormat - no audio subsystem";
+            RG_RT_DEBUG << "processEventsOut(): MappedEvent::SystemAudioFileFormat - no audio subsystem";
 #endif
 #endif
 
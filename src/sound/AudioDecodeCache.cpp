@@ -0,0 +1,146 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#define RG_MODULE_STRING "[AudioDecodeCache]"
+
+#include "AudioDecodeCache.h"
+
+#include "misc/Debug.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QThread>
+
+
+namespace Rosegarden
+{
+
+
+namespace
+{
+    // Beyond this, the least recently used entries are removed.
+    const qint64 maxCacheBytes = qint64(2) * 1024 * 1024 * 1024;
+}
+
+QString
+AudioDecodeCache::getDirectory()
+{
+    return QStandardPaths::writableLocation(
+            QStandardPaths::GenericCacheLocation) + "/rosegarden/decoded";
+}
+
+bool
+AudioDecodeCache::isCacheable(const QString &sourceFile)
+{
+    const QString extension = QFileInfo(sourceFile).suffix().toLower();
+    return (extension != "wav"  &&  extension != "bwf");
+}
+
+QString
+AudioDecodeCache::getKey(const QString &sourceFile, int sampleRate)
+{
+    QFile file(sourceFile);
+    if (!file.open(QIODevice::ReadOnly))
+        return QString();
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    if (!hash.addData(&file))
+        return QString();
+
+    return QString("%1-%2").
+            arg(QString::fromLatin1(hash.result().toHex())).
+            arg(sampleRate);
+}
+
+bool
+AudioDecodeCache::fetch(const QString &key, const QString &targetFile)
+{
+    if (key.isEmpty())
+        return false;
+
+    const QString cached = getDirectory() + "/" + key + ".wav";
+    if (!QFile::exists(cached))
+        return false;
+
+    if (!QFile::copy(cached, targetFile)) {
+        RG_WARNING << "fetch(): failed to copy" << cached << "to" << targetFile;
+        return false;
+    }
+
+    // Mark it as recently used for prune().
+    QFile entry(cached);
+    if (entry.open(QIODevice::ReadWrite))
+        entry.setFileTime(QDateTime::currentDateTime(),
+                          QFileDevice::FileModificationTime);
+
+    RG_DEBUG << "fetch(): using cached decode for" << targetFile;
+
+    return true;
+}
+
+void
+AudioDecodeCache::store(const QString &key, const QString &decodedFile)
+{
+    if (key.isEmpty())
+        return;
+
+    const QString directory = getDirectory();
+    if (!QDir().mkpath(directory)) {
+        RG_WARNING << "store(): can't create" << directory;
+        return;
+    }
+
+    // Copy under a name of our own and rename into place, so another
+    // thread (or process) never sees a partial entry.
+    const QString cached = directory + "/" + key + ".wav";
+    const QString temporary = cached + QString(".%1.tmp").
+            arg(quintptr(QThread::currentThreadId()));
+
+    QFile::remove(temporary);
+    if (!QFile::copy(decodedFile, temporary))
+        return;
+
+    // If the rename fails, someone else stored it first.
+    if (!QFile::rename(temporary, cached))
+        QFile::remove(temporary);
+}
+
+void
+AudioDecodeCache::prune()
+{
+    QDir directory(getDirectory());
+    if (!directory.exists())
+        return;
+
+    // Most recently used first.
+    const QFileInfoList entries = directory.entryInfoList(
+            QStringList() << "*.wav", QDir::Files, QDir::Time);
+
+    qint64 total = 0;
+    for (const QFileInfo &entry : entries) {
+        total += entry.size();
+        if (total > maxCacheBytes) {
+            RG_DEBUG << "prune(): removing" << entry.fileName();
+            QFile::remove(entry.absoluteFilePath());
+        }
+    }
+}
+
+
+}
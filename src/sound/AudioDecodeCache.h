@@ -0,0 +1,77 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#ifndef RG_AUDIODECODECACHE_H
+#define RG_AUDIODECODECACHE_H
+
+#include <QString>
+
+#include <rosegardenprivate_export.h>
+
+namespace Rosegarden
+{
+
+
+/// Persistent cache of decoded (converted to WAV) audio files.
+/**
+ * Importing a compressed file (Ogg, FLAC, ...) means decoding all of it
+ * to a WAV in the project's audio directory.  The decoded WAV is also
+ * kept here, under the user's cache directory, so that importing the
+ * same material again (into another project, or after deleting it) is
+ * just a file copy.
+ *
+ * Entries are keyed on a hash of the source file's contents and the
+ * sample rate it was converted to, so renamed or moved files still hit
+ * and edited ones don't.
+ *
+ * All functions are safe to call from several threads at once.
+ */
+class ROSEGARDENPRIVATE_EXPORT AudioDecodeCache
+{
+public:
+    /// Whether decodes of this file are worth caching.
+    /**
+     * WAV files are converted by little more than a copy, so caching
+     * them would just double the disk space.
+     */
+    static bool isCacheable(const QString &sourceFile);
+
+    /// The cache key for sourceFile decoded at sampleRate.
+    /**
+     * Reads the whole file.  Returns an empty string if the file can't
+     * be read.
+     */
+    static QString getKey(const QString &sourceFile, int sampleRate);
+
+    /// Copy the cached decode for key to targetFile.
+    /**
+     * Returns false if there is no such entry.
+     */
+    static bool fetch(const QString &key, const QString &targetFile);
+
+    /// Add a copy of decodedFile to the cache under key.
+    static void store(const QString &key, const QString &decodedFile);
+
+    /// Remove the least recently used entries until the cache fits.
+    static void prune();
+
+private:
+    static QString getDirectory();
+};
+
+
+}
+
+#endif
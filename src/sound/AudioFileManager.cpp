@@ -19,6 +19,9 @@
 
 #include <pthread.h>  // pthread_mutex_lock() and friends
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <string>
 #include <sstream>  // std::stringstream
 #include <unistd.h>
@@ -31,12 +34,16 @@
 #include <QFileInfo>
 #include <QDir>
 #include <QRegularExpression>
+#include <QThread>
 
 #include "gui/dialogs/AudioFileLocationDialog.h"
 #include "gui/general/FileSource.h"
+#include "AudioDecodeCache.h"
 #include "AudioFile.h"
 #include "WAVAudioFile.h"
 #include "BWFAudioFile.h"
+#include "BeatTracker.h"
+#include "OnsetDetector.h"
 #include "misc/Debug.h"
 #include "misc/Preferences.h"
 #include "misc/Strings.h"  // qstrtostr() and friends
@@ -621,148 +628,317 @@ AudioFileManager::importURL(const QUrl &url, int targetSampleRate)
     return importFile(source.getLocalFilename(), targetSampleRate);
 }
 
+std::vector<AudioFileId>
+AudioFileManager::importURLs(const QList<QUrl> &urls, int targetSampleRate,
+                             QStringList &errors)
+{
+    if (m_progressDialog) {
+        m_progressDialog->setLabelText(tr("Adding audio files..."));
+        m_progressDialog->setRange(0, 0);
+    }
+
+    // Keep the sources, and so any downloaded copies, until the
+    // conversions are done.
+    std::vector<std::unique_ptr<FileSource>> sources;
+    QStringList fileNames;
+    std::vector<int> fileIndex;
+
+    for (const QUrl &url : urls) {
+        std::unique_ptr<FileSource> source(new FileSource(url));
+
+        if (!source->isAvailable()) {
+            errors << tr("Cannot download file %1").arg(url.toString());
+            fileIndex.push_back(-1);
+            continue;
+        }
+
+        source->waitForData();
+
+        fileIndex.push_back(fileNames.size());
+        fileNames << source->getLocalFilename();
+        sources.push_back(std::move(source));
+    }
+
+    const std::vector<AudioFileId> imported =
+            importFiles(fileNames, targetSampleRate, errors);
+
+    std::vector<AudioFileId> ids;
+    ids.reserve(urls.size());
+    for (int index : fileIndex)
+        ids.push_back(index < 0 ? 0 : imported[index]);
+
+    return ids;
+}
+
 AudioFileId
 AudioFileManager::importFile(const QString &fileName, int targetSampleRate)
 {
-    if (m_progressDialog)
-        m_progressDialog->setLabelText(tr("Importing audio file..."));
+    QStringList errors;
+    const std::vector<AudioFileId> ids =
+            importFiles(QStringList() << fileName, targetSampleRate, errors);
+
+    if (ids[0] == 0) {
+        throw SoundFile::BadSoundFileException
+            (fileName, qstrtostr(tr("Failed to convert or resample audio file on import")) );
+    }
+
+    return ids[0];
+}
+
+QString
+AudioFileManager::getConversionFileName(const QString &fileName,
+                                        AudioFileId &id)
+{
+    id = getUniqueAudioFileID();
+
+    QString sourceBase = QFileInfo(fileName).baseName();
+    if (sourceBase.length() > 3 && sourceBase.startsWith("rg-")) {
+        sourceBase = sourceBase.right(sourceBase.length() - 3);
+    }
+    if (sourceBase.length() > 15) sourceBase = sourceBase.left(15);
 
     QString targetName = "";
-    AudioFileId newId = 0;
 
-    {
-        MutexLock lock (&audioFileManagerLock)
-            ;
+    while (targetName == "") {
 
-        newId = getUniqueAudioFileID();
+        targetName = QString("conv-%2-%3-%4.wav")
+            .arg(sourceBase)
+            .arg(QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss"))
+            .arg(id + 1);
 
-        QString sourceBase = QFileInfo(fileName).baseName();
-        if (sourceBase.length() > 3 && sourceBase.startsWith("rg-")) {
-            sourceBase = sourceBase.right(sourceBase.length() - 3);
+        if (QFile(getAbsoluteAudioPath() + targetName).exists()) {
+            targetName = "";
+            id = getUniqueAudioFileID();
         }
-        if (sourceBase.length() > 15) sourceBase = sourceBase.left(15);
+    }
 
-        while (targetName == "") {
+    return targetName;
+}
 
-            targetName = QString("conv-%2-%3-%4.wav")
-                .arg(sourceBase)
-                .arg(QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss"))
-                .arg(newId + 1);
+namespace
+{
+    /**
+     * Convert an audio file from arbitrary external format to a WAV
+     * file at the given sample rate, using the AudioReadStream and
+     * AudioWriteStream classes.  This replaces the Perl script
+     * previously used.  Returns 0 for OK.
+     *
+     * Safe to call from any thread.  Gives up, removing the partial
+     * output, if cancelled becomes true.
+     */
+    int convertAudioFile(const QString &inFile, const QString &outFile,
+                         int rate, const std::atomic<bool> &cancelled)
+    {
+        std::unique_ptr<AudioReadStream> rs(
+                AudioReadStreamFactory::createReadStream(inFile));
+        if (!rs || !rs->isOK()) {
+            RG_WARNING << "convertAudioFile(): ERROR: Failed to read audio file";
+            if (rs) RG_WARNING << "convertAudioFile(): Error: " << rs->getError();
+            return -1;
+        }
 
-            if (QFile(getAbsoluteAudioPath() + targetName).exists()) {
-                targetName = "";
-                ++newId;
-            }
+        int channels = rs->getChannelCount();
+        // Block size in number of sample frames.  A sample frame consists
+        // of all the channels for a particular sample.
+        int blockSize = 20480; // or anything
+
+        rs->setRetrievalSampleRate(rate);
+
+        std::unique_ptr<AudioWriteStream> ws(
+                AudioWriteStreamFactory::createWriteStream
+                        (outFile, channels, rate));
+
+        if (!ws || !ws->isOK()) {
+            RG_WARNING << "convertAudioFile(): ERROR: Failed to write audio file";
+            if (ws) RG_WARNING << "convertAudioFile(): Error: " << ws->getError();
+            return -1;
         }
-    }
 
-    // ??? We should probably switch to indeterminate mode here.  This
-    //     is closest to the place where we know that we don't support
-    //     actual progress.
-    if (m_progressDialog)
-        m_progressDialog->setLabelText(tr("Converting audio file..."));
+        std::vector<float> block(blockSize * channels);
 
-    QString outFileName = getAbsoluteAudioPath() + targetName;
-    int ec = convertAudioFile(fileName, outFileName);
+        while (1) {
+            int got = rs->getInterleavedFrames(blockSize, block.data());
+            ws->putInterleavedFrames(got, block.data());
+            if (got < blockSize) break;
 
-    if (ec) {
-        throw SoundFile::BadSoundFileException
-            (fileName, qstrtostr(tr("Failed to convert or resample audio file on import")) );
+            if (cancelled.load()) {
+                // Clean up the file that we were writing.
+                ws->remove();
+
+                // Failure.
+                return -1;
+            }
+        }
+
+        // Success.
+        return 0;
     }
 
+    struct ConversionJob
     {
-        MutexLock lock (&audioFileManagerLock)
-            ;
+        QString source;
+        QString target;
+        int result = -1;
+    };
+
+    /// One of the threads of the import pool.
+    /**
+     * Each takes the next job that no other thread has taken until
+     * they are all done.  That keeps every thread busy however the
+     * file sizes vary.
+     */
+    class ConversionThread : public QThread
+    {
+    public:
+        ConversionThread(std::vector<ConversionJob> &jobs,
+                         std::atomic<size_t> &nextJob,
+                         std::atomic<size_t> &finishedJobs,
+                         const std::atomic<bool> &cancelled,
+                         int sampleRate) :
+            m_jobs(jobs),
+            m_nextJob(nextJob),
+            m_finishedJobs(finishedJobs),
+            m_cancelled(cancelled),
+            m_sampleRate(sampleRate)
+        {
+        }
 
-        // insert file into vector
-        WAVAudioFile *aF =
-            new WAVAudioFile(newId,
-                             qstrtostr(targetName),
-                             getAbsoluteAudioPath() + targetName);
-        m_audioFiles.push_back(aF);
-        m_derivedAudioFiles.insert(aF);
-        // Don't catch SoundFile::BadSoundFileException
+    protected:
+        void run() override
+        {
+            while (!m_cancelled.load()) {
+                const size_t index = m_nextJob.fetch_add(1);
+                if (index >= m_jobs.size())
+                    break;
 
-        m_expectedSampleRate = targetSampleRate;
+                convert(m_jobs[index]);
+                m_finishedJobs.fetch_add(1);
+            }
+        }
 
-        return aF->getId();
-    }
+    private:
+        std::vector<ConversionJob> &m_jobs;
+        std::atomic<size_t> &m_nextJob;
+        std::atomic<size_t> &m_finishedJobs;
+        const std::atomic<bool> &m_cancelled;
+        int m_sampleRate;
+
+        void convert(ConversionJob &job)
+        {
+            QString key;
+
+            if (AudioDecodeCache::isCacheable(job.source)) {
+                key = AudioDecodeCache::getKey(job.source, m_sampleRate);
+                if (AudioDecodeCache::fetch(key, job.target)) {
+                    job.result = 0;
+                    return;
+                }
+            }
+
+            job.result = convertAudioFile(job.source, job.target,
+                                          m_sampleRate, m_cancelled);
+
+            if (job.result == 0)
+                AudioDecodeCache::store(key, job.target);
+        }
+    };
 }
 
-int AudioFileManager::convertAudioFile(const QString &inFile, const QString &outFile)
+std::vector<AudioFileId>
+AudioFileManager::importFiles(const QStringList &fileNames,
+                              int targetSampleRate,
+                              QStringList &errors)
 {
-    AudioReadStream *rs = AudioReadStreamFactory::createReadStream( inFile);
-    if (!rs || !rs->isOK()) {
-        RG_WARNING << "convertAudioFile(): ERROR: Failed to read audio file";
-        if (rs) RG_WARNING << "convertAudioFile(): Error: " << rs->getError();
+    if (m_progressDialog)
+        m_progressDialog->setLabelText(tr("Importing audio file..."));
 
-        // ??? LEAK!  rs.  Use a QScopedPointer.
-        return -1;
+    std::vector<ConversionJob> jobs(fileNames.size());
+    std::vector<AudioFileId> ids(fileNames.size(), 0);
+    std::vector<QString> targetNames(fileNames.size());
+
+    {
+        MutexLock lock (&audioFileManagerLock)
+            ;
+
+        for (int i = 0; i < fileNames.size(); ++i) {
+            targetNames[i] = getConversionFileName(fileNames[i], ids[i]);
+            jobs[i].source = fileNames[i];
+            jobs[i].target = getAbsoluteAudioPath() + targetNames[i];
+        }
     }
 
-    int channels = rs->getChannelCount();
-    int rate = RosegardenSequencer::getInstance()->getSampleRate();
-    // Block size in number of sample frames.  A sample frame consists of
-    // all the channels for a particular sample.
-    int blockSize = 20480; // or anything
+    if (m_progressDialog) {
+        m_progressDialog->setLabelText(tr("Converting audio file..."));
+        // We can only tell how many files are done, so a single file
+        // stays indeterminate.
+        if (jobs.size() > 1) {
+            m_progressDialog->setRange(0, int(jobs.size()));
+            m_progressDialog->setValue(0);
+        }
+    }
 
-    rs->setRetrievalSampleRate(rate);
+    const int sampleRate = RosegardenSequencer::getInstance()->getSampleRate();
 
-    AudioWriteStream *ws = AudioWriteStreamFactory::createWriteStream
-            (outFile, channels, rate);
+    std::atomic<size_t> nextJob(0);
+    std::atomic<size_t> finishedJobs(0);
+    std::atomic<bool> cancelled(false);
 
-    if (!ws || !ws->isOK()) {
-        RG_WARNING << "convertAudioFile(): ERROR: Failed to write audio file";
-        if (ws) RG_WARNING << "convertAudioFile(): Error: " << ws->getError();
+    // Decoding is CPU bound, so one thread per core.
+    const size_t threadCount = std::min(
+            size_t(std::max(1, QThread::idealThreadCount())), jobs.size());
 
-        // ??? LEAK!  rs and ws.  Use a QScopedPointer.
-        return -1;
+    std::vector<std::unique_ptr<ConversionThread>> threads;
+    for (size_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back(new ConversionThread(
+                jobs, nextJob, finishedJobs, cancelled, sampleRate));
+        threads.back()->start();
     }
 
-    // ??? Use a QScopedArrayPointer.
-    float *block = new float[blockSize * channels];
-
-    int i = 0;
-    while (1) {
-        int got = rs->getInterleavedFrames(blockSize, block);
-        qApp->processEvents();
-        ws->putInterleavedFrames(got, block);
-        qApp->processEvents();
-        if (got < blockSize) break;
+    // Keep the UI alive (and the Cancel button working) while they run.
+    for (std::unique_ptr<ConversionThread> &thread : threads) {
+        while (!thread->wait(50)) {
+            if (m_progressDialog) {
+                if (m_progressDialog->wasCanceled())
+                    cancelled.store(true);
+                if (jobs.size() > 1)
+                    m_progressDialog->setValue(int(finishedJobs.load()));
+            }
+            qApp->processEvents();
+        }
+    }
 
-        // ??? It would be nice if we could provide progress to the
-        //     progress dialog like this:
-        //
-        //       if (m_progressDialog)
-        //           m_progressDialog->setValue(
-        //               static_cast<double>(currentBytes)/totalBytes * 100);
-        //
-        //     However, we don't have any way to get the total bytes from
-        //     AudioReadStream, let alone the current bytes.
+    MutexLock lock (&audioFileManagerLock)
+        ;
 
-        if (m_progressDialog  &&  m_progressDialog->wasCanceled()) {
-            // Clean up the file that we were writing.
-            ws->remove();
+    for (size_t i = 0; i < jobs.size(); ++i) {
 
-            // ??? Cleanup not needed with smart pointers mentioned above.
-            delete[] block;
-            delete ws;
-            delete rs;
+        if (jobs[i].result != 0) {
+            ids[i] = 0;
+            errors << tr("Failed to convert or resample audio file %1").
+                    arg(fileNames[i]);
+            continue;
+        }
 
-            // Failure.
-            return -1;
+        try {
+            // insert file into vector
+            WAVAudioFile *aF =
+                new WAVAudioFile(ids[i],
+                                 qstrtostr(targetNames[i]),
+                                 jobs[i].target);
+            m_audioFiles.push_back(aF);
+            m_derivedAudioFiles.insert(aF);
+        } catch (const SoundFile::BadSoundFileException &e) {
+            ids[i] = 0;
+            errors << strtoqstr(e.getMessage());
+            continue;
         }
 
-        ++i;
+        m_expectedSampleRate = targetSampleRate;
     }
 
-    // ??? Cleanup not needed with smart pointers mentioned above.
-    delete[] block;
-    delete ws;
-    delete rs;
+    AudioDecodeCache::prune();
 
-    // Success.
-    return 0;
+    return ids;
 }
 
 std::string
@@ -1084,6 +1260,132 @@ AudioFileManager::getSplitPoints(AudioFileId id,
                                         minTime);
 }
 
+bool
+AudioFileManager::getOnsetAnalysis(AudioFileId id,
+                                   const RealTime &startTime,
+                                   const RealTime &endTime,
+                                   OnsetAnalysis &analysis)
+{
+    QString fileName;
+    unsigned int sampleRate = 0;
+
+    {
+        MutexLock lock (&audioFileManagerLock)
+            ;
+
+        AudioFile *audioFile = getAudioFile(id);
+
+        if (audioFile == nullptr)
+            return false;
+
+        fileName = audioFile->getAbsoluteFilePath();
+        sampleRate = audioFile->getSampleRate();
+    }
+
+    // Decoding and transforming a long file takes a while.  Don't keep
+    // the lock for it.
+    OnsetDetector detector(sampleRate, 1);
+    return detector.analyse(fileName, startTime, endTime, analysis);
+}
+
+std::vector<RealTime>
+AudioFileManager::getOnsetTimes(AudioFileId id,
+                                const RealTime &startTime,
+                                const RealTime &endTime,
+                                int sensitivity,
+                                const RealTime &minTime)
+{
+    OnsetAnalysis analysis;
+    if (!getOnsetAnalysis(id, startTime, endTime, analysis))
+        return std::vector<RealTime>();
+
+    return getOnsetTimes(analysis, sensitivity, minTime);
+}
+
+std::vector<RealTime>
+AudioFileManager::getOnsetTimes(const OnsetAnalysis &analysis,
+                                int sensitivity,
+                                const RealTime &minTime)
+{
+    OnsetDetector detector(analysis.sampleRate, sensitivity);
+    detector.setMinimumGap(minTime);
+
+    const std::vector<long> onsets = detector.findOnsets(analysis);
+
+    std::vector<RealTime> times;
+    times.reserve(onsets.size());
+    for (size_t i = 0; i < onsets.size(); ++i) {
+        times.push_back(RealTime::frame2RealTime(onsets[i],
+                                                 analysis.sampleRate));
+    }
+
+    return times;
+}
+
+std::vector<RealTime>
+AudioFileManager::getBeatTimes(AudioFileId id,
+                               const RealTime &startTime,
+                               const RealTime &endTime)
+{
+    MutexLock lock (&audioFileManagerLock)
+        ;
+
+    std::vector<RealTime> times;
+
+    AudioFile *audioFile = getAudioFile(id);
+
+    if (audioFile == nullptr)
+        return times;
+
+    const unsigned int sampleRate = audioFile->getSampleRate();
+
+    BeatTracker tracker(sampleRate);
+
+    const std::vector<long> beats =
+            tracker.findBeats(audioFile, startTime, endTime);
+
+    times.reserve(beats.size());
+    for (size_t i = 0; i < beats.size(); ++i)
+        times.push_back(RealTime::frame2RealTime(beats[i], sampleRate));
+
+    return times;
+}
+
+std::vector<SplitPointPair>
+AudioFileManager::getOnsetSplitPoints(AudioFileId id,
+                                      const RealTime &startTime,
+                                      const RealTime &endTime,
+                                      int sensitivity,
+                                      const RealTime &minTime)
+{
+    OnsetAnalysis analysis;
+    if (!getOnsetAnalysis(id, startTime, endTime, analysis))
+        return std::vector<SplitPointPair>();
+
+    return getOnsetSplitPoints(analysis, endTime, sensitivity, minTime);
+}
+
+std::vector<SplitPointPair>
+AudioFileManager::getOnsetSplitPoints(const OnsetAnalysis &analysis,
+                                      const RealTime &endTime,
+                                      int sensitivity,
+                                      const RealTime &minTime)
+{
+    const std::vector<RealTime> onsets =
+            getOnsetTimes(analysis, sensitivity, minTime);
+
+    std::vector<SplitPointPair> points;
+
+    for (size_t i = 0; i < onsets.size(); ++i) {
+        const RealTime &end =
+                (i + 1 < onsets.size() ? onsets[i + 1] : endTime);
+        if (end > onsets[i])
+            points.push_back(SplitPointPair(onsets[i], end));
+    }
+
+    return points;
+}
+
 std::set<int>
 AudioFileManager::getActualSampleRates() const
 {
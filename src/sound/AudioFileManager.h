@@ -26,6 +26,7 @@
 #include <QUrl>
 #include <QPointer>
 #include <QProgressDialog>
+#include <QStringList>
 
 class QPixmap;
 
@@ -41,6 +42,7 @@ namespace Rosegarden
 
 
 class RosegardenDocument;
+struct OnsetAnalysis;
 
 typedef std::vector<AudioFile *> AudioFileVector;
 
@@ -102,6 +104,20 @@ public:
     AudioFileId importURL(const QUrl &url,
                           int targetSampleRate);
 
+    /// Import several files at once, converting them in parallel.
+    /**
+     * As importURL() for each of urls, but the conversions are shared
+     * out over a pool of threads, and decodes of compressed files are
+     * kept in AudioDecodeCache so that importing the same material
+     * again is just a copy.
+     *
+     * Returns the new IDs in the same order as urls, with 0 for any
+     * that failed.  A message for each failure is added to errors.
+     */
+    std::vector<AudioFileId> importURLs(const QList<QUrl> &urls,
+                                        int targetSampleRate,
+                                        QStringList &errors);
+
     /// Used by RoseXmlHandler to add an audio file.
     /**
      * throws BadAudioPathException
@@ -260,6 +276,67 @@ public:
                        int threshold,
                        const RealTime &minTime = RealTime(0, 100000000));
 
+    /// Read a region and analyse it for getOnsetTimes().
+    /**
+     * This is the slow part of finding onsets.  Keep the result to find
+     * them at several sensitivities.  The lock is only held to look the
+     * file up, not while it is read.  Returns false if the file can't be
+     * found or read.
+     */
+    bool getOnsetAnalysis(AudioFileId id,
+                          const RealTime &startTime,
+                          const RealTime &endTime,
+                          OnsetAnalysis &analysis);
+
+    /// Get sample accurate transient (onset) times within a region.
+    /**
+     * sensitivity is 1 to 100.  See OnsetDetector.  Onsets closer
+     * together than minTime are merged.  The times are relative to the
+     * start of the audio file, as for getSplitPoints().
+     */
+    std::vector<RealTime>
+        getOnsetTimes(AudioFileId id,
+                      const RealTime &startTime,
+                      const RealTime &endTime,
+                      int sensitivity,
+                      const RealTime &minTime = RealTime(0, 30000000));
+
+    /// As above, for a region from getOnsetAnalysis().
+    static std::vector<RealTime>
+        getOnsetTimes(const OnsetAnalysis &analysis,
+                      int sensitivity,
+                      const RealTime &minTime = RealTime(0, 30000000));
+
+    /// Get a split point vector with one split per transient.
+    /**
+     * Each split runs from one onset to the next, the last one to
+     * endTime.  Anything before the first onset is dropped.
+     */
+    std::vector<SplitPointPair>
+        getOnsetSplitPoints(AudioFileId id,
+                            const RealTime &startTime,
+                            const RealTime &endTime,
+                            int sensitivity,
+                            const RealTime &minTime = RealTime(0, 100000000));
+
+    /// As above, for a region from getOnsetAnalysis().
+    static std::vector<SplitPointPair>
+        getOnsetSplitPoints(const OnsetAnalysis &analysis,
+                            const RealTime &endTime,
+                            int sensitivity,
+                            const RealTime &minTime = RealTime(0, 100000000));
+
+    /// Get the beat times within a region.
+    /**
+     * See BeatTracker.  The times are relative to the start of the
+     * audio file, as for getOnsetTimes().  Returns an empty vector if
+     * no beat could be found.
+     */
+    std::vector<RealTime>
+        getBeatTimes(AudioFileId id,
+                     const RealTime &startTime,
+                     const RealTime &endTime);
+
     int getExpectedSampleRate() const  { return m_expectedSampleRate; }
     void setExpectedSampleRate(int rate)  { m_expectedSampleRate = rate; }
 
@@ -333,14 +410,23 @@ private:
     AudioFileId importFile(const QString &fileName,
                            int targetSampleRate);
 
+    /// Convert and add several files.
+    /**
+     * The work behind importFile() and importURLs().  Converts each file
+     * to a WAV in the audio path on a pool of threads (see
+     * convertAudioFile() in the .cpp), then adds the results.  Returns
+     * the new IDs in order, 0 for failures, with a message for each
+     * failure in errors.
+     */
+    std::vector<AudioFileId> importFiles(const QStringList &fileNames,
+                                         int targetSampleRate,
+                                         QStringList &errors);
+
+    /// Pick an unused name in the audio path for a conversion of fileName.
     /**
-     * Convert an audio file from arbitrary external format to an
-     * internal format suitable for use by addFile, using packages in
-     * Rosegarden.  This replaces the Perl script previously used. It
-     * returns 0 for OK.  This is used by importFile and importURL
-     * which normally provide the more suitable interface for import.
+     * Also allocates the ID for it.  Call with audioFileManagerLock held.
      */
-    int convertAudioFile(const QString &inFile, const QString &outFile);
+    QString getConversionFileName(const QString &fileName, AudioFileId &id);
 
     /// Convert a relative path or file path to absolute.
     /**
@@ -15,6 +15,7 @@
 
 #define RG_MODULE_STRING "[AudioInstrumentMixer]"
 #define RG_NO_DEBUG_PRINT
+#define RG_RT_CATEGORY Rosegarden::RTDebug::Audio
 
 #include "AudioInstrumentMixer.h"
 
@@ -26,6 +27,7 @@
 #include "PluginFactory.h"
 #include "ControlBlock.h"
 #include "misc/Debug.h"
+#include "misc/RealtimeDebug.h"
 
 #include <sys/time.h>
 #include <pthread.h>
@@ -937,7 +939,7 @@ AudioInstrumentMixer::processBlocks(bool &readSomething)
 
 #ifdef DEBUG_MIXER
     if (m_driver->isPlaying())
-        std::cerr << "AudioInstrumentMixer::processBlocks" << std::endl;
+        RG_RT_DEBUG << "processBlocks";
 #endif
 
     const AudioPlayQueue *queue = m_driver->getAudioQueue();
@@ -1059,7 +1061,7 @@ AudioInstrumentMixer::processBlock(InstrumentId id,
 #ifdef DEBUG_MIXER
     //    if (m_driver->isPlaying()) {
     if ((id % 100) == 0)
-        std::cerr << "AudioInstrumentMixer::processBlock(" << id << "): buffer time is " << bufferTime << std::endl;
+        RG_RT_DEBUG << "processBlock(" << id << "): buffer time is " << bufferTime;
     //    }
 #endif
 
@@ -1071,7 +1073,7 @@ AudioInstrumentMixer::processBlock(InstrumentId id,
     if (channels == 0) {
 #ifdef DEBUG_MIXER
         if ((id % 100) == 0)
-            std::cerr << "AudioInstrumentMixer::processBlock(" << id << "): nominal channels " << rec.channels << ", ring buffers " << rec.buffers.size() << ", process buffers " << pBuf.size() << std::endl;
+            RG_RT_DEBUG << "processBlock(" << id << "): nominal channels " << rec.channels << ", ring buffers " << rec.buffers.size() << ", process buffers " << pBuf.size();
 #endif
 
         return false; // buffers just haven't been set up yet
@@ -1090,7 +1092,7 @@ AudioInstrumentMixer::processBlock(InstrumentId id,
 #ifdef DEBUG_MIXER
                 //		if (m_driver->isPlaying()) {
                 if ((id % 100) == 0)
-                    std::cerr << "AudioInstrumentMixer::processBlock(" << id << "): only " << minWriteSpace << " write space on channel " << ch << " for block size " << m_blockSize << std::endl;
+                    RG_RT_DEBUG << "processBlock(" << id << "): only " << minWriteSpace << " write space on channel " << ch << " for block size " << m_blockSize;
                 //		}
 #endif
 
@@ -1104,7 +1106,7 @@ AudioInstrumentMixer::processBlock(InstrumentId id,
 #ifdef DEBUG_MIXER
 
     if ((id % 100) == 0 && m_driver->isPlaying())
-        std::cerr << "AudioInstrumentMixer::processBlock(" << id << "): minWriteSpace is " << minWriteSpace << std::endl;
+        RG_RT_DEBUG << "processBlock(" << id << "): minWriteSpace is " << minWriteSpace;
 #else
 #ifdef DEBUG_MIXER_LIGHTWEIGHT
 
@@ -1116,7 +1118,7 @@ AudioInstrumentMixer::processBlock(InstrumentId id,
 #ifdef DEBUG_MIXER
 
     if ((id % 100) == 0 && playCount > 0)
-        std::cerr << "AudioInstrumentMixer::processBlock(" << id << "): " << playCount << " audio file(s) to consider" << std::endl;
+        RG_RT_DEBUG << "processBlock(" << id << "): " << playCount << " audio file(s) to consider";
 #endif
 
     bool haveBlock = true;
@@ -1135,7 +1137,7 @@ AudioInstrumentMixer::processBlock(InstrumentId id,
 
 #ifdef DEBUG_MIXER
             if ((id % 100) == 0)
-                std::cerr << "AudioInstrumentMixer::processBlock(" << id << "): will be asking for more" << std::endl;
+                RG_RT_DEBUG << "processBlock(" << id << "): will be asking for more";
 #endif
 
             haveMore = true;
@@ -1143,7 +1145,7 @@ AudioInstrumentMixer::processBlock(InstrumentId id,
 
 #ifdef DEBUG_MIXER
         if ((id % 100) == 0)
-            std::cerr << "AudioInstrumentMixer::processBlock(" << id << "): file has " << frames << " frames available" << std::endl;
+            RG_RT_DEBUG << "processBlock(" << id << "): file has " << frames << " frames available";
 #endif
 
         if (!acceptable) {
@@ -1181,7 +1183,7 @@ AudioInstrumentMixer::processBlock(InstrumentId id,
 #ifdef DEBUG_MIXER
     if (!haveMore) {
         if ((id % 100) == 0)
-            std::cerr << "AudioInstrumentMixer::processBlock(" << id << "): won't be asking for more" << std::endl;
+            RG_RT_DEBUG << "processBlock(" << id << "): won't be asking for more";
     }
 #endif
 
@@ -1227,7 +1229,7 @@ AudioInstrumentMixer::processBlock(InstrumentId id,
                     blockSize = 0;
 #ifdef DEBUG_MIXER
 
-                std::cerr << "AudioInstrumentMixer::processBlock: file starts at offset " << offset << ", block size now " << blockSize << std::endl;
+                RG_RT_DEBUG << "processBlock: file starts at offset " << offset << ", block size now " << blockSize;
 #endif
 
             }
@@ -1283,8 +1285,8 @@ AudioInstrumentMixer::processBlock(InstrumentId id,
         }
 
 #ifdef DEBUG_MIXER
-        std::cerr << "Running plugin with " << plugin->getAudioInputCount()
-        << " inputs, " << plugin->getAudioOutputCount() << " outputs" << std::endl;
+        RG_RT_DEBUG << "Running plugin with " << plugin->getAudioInputCount()
+        << " inputs, " << plugin->getAudioOutputCount() << " outputs";
 #endif
 
         plugin->run(bufferTime);
@@ -1371,7 +1373,7 @@ AudioInstrumentMixer::processBlock(InstrumentId id,
 
 #ifdef DEBUG_MIXER
     if ((id % 100) == 0 && m_driver->isPlaying())
-        std::cerr << "AudioInstrumentMixer::processBlock(" << id << "): setting dormant to " << dormant << std::endl;
+        RG_RT_DEBUG << "processBlock(" << id << "): setting dormant to " << dormant;
 #endif
 
     rec.dormant = dormant;
@@ -1383,7 +1385,7 @@ AudioInstrumentMixer::processBlock(InstrumentId id,
 #ifdef DEBUG_MIXER
 
     if ((id % 100) == 0)
-        std::cerr << "AudioInstrumentMixer::processBlock(" << id << "): done, returning " << haveMore << std::endl;
+        RG_RT_DEBUG << "processBlock(" << id << "): done, returning " << haveMore;
 #endif
 
     return haveMore;
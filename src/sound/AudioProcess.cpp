@@ -13,6 +13,9 @@
     COPYING included with this distribution for more information.
 */
 
+#define RG_MODULE_STRING "[AudioProcess]"
+#define RG_RT_CATEGORY Rosegarden::RTDebug::Audio
+
 #include "AudioProcess.h"
 
 #include "AudioInstrumentMixer.h"
@@ -24,6 +27,7 @@
 #include "base/AudioLevel.h"
 #include "AudioPlayQueue.h"
 
+#include "misc/RealtimeDebug.h"
 #include "misc/Strings.h"
 
 #include <sys/time.h>
@@ -559,7 +563,7 @@ AudioBussMixer::processBlocks()
 #ifdef DEBUG_BUSS_MIXER
 
     if (m_driver->isPlaying())
-        std::cerr << "AudioBussMixer::processBlocks" << std::endl;
+        RG_RT_DEBUG << "AudioBussMixer::processBlocks";
 #endif
 
     InstrumentId audioInstrumentBase;
@@ -602,7 +606,7 @@ AudioBussMixer::processBlocks()
 
 #ifdef DEBUG_BUSS_MIXER
 
-            std::cerr << "AudioBussMixer::processBlocks: buss " << buss << ": write space " << w << " on channel " << ch << std::endl;
+            RG_RT_DEBUG << "AudioBussMixer::processBlocks: buss " << buss << ": write space " << w << " on channel " << ch;
 #endif
 
             if (minSpace == 0)
@@ -634,7 +638,7 @@ AudioBussMixer::processBlocks()
 #ifdef DEBUG_BUSS_MIXER
 
                     if (id == 1000) {
-                        std::cerr << "AudioBussMixer::processBlocks: buss " << buss << ": read space " << r << " on instrument " << id << ", channel " << ch << std::endl;
+                        RG_RT_DEBUG << "AudioBussMixer::processBlocks: buss " << buss << ": read space " << r << " on instrument " << id << ", channel " << ch;
                     }
 #endif
 
@@ -655,7 +659,7 @@ AudioBussMixer::processBlocks()
 
 #ifdef DEBUG_BUSS_MIXER
         if (m_driver->isPlaying())
-            std::cerr << "AudioBussMixer::processBlocks: doing " << blocks << " blocks at block size " << m_blockSize << std::endl;
+            RG_RT_DEBUG << "AudioBussMixer::processBlocks: doing " << blocks << " blocks at block size " << m_blockSize;
 #endif
 
         for (size_t block = 0; block < blocks; ++block) {
@@ -744,8 +748,8 @@ AudioBussMixer::processBlocks()
                     }
 
 #ifdef DEBUG_BUSS_MIXER
-                    std::cerr << "Running buss plugin with " << plugin->getAudioInputCount()
-                    << " inputs, " << plugin->getAudioOutputCount() << " outputs" << std::endl;
+                    RG_RT_DEBUG << "Running buss plugin with " << plugin->getAudioInputCount()
+                                << " inputs, " << plugin->getAudioOutputCount() << " outputs";
 #endif
 
                     // We don't currently maintain a record of our
@@ -788,7 +792,7 @@ AudioBussMixer::processBlocks()
 #ifdef DEBUG_BUSS_MIXER
 
             if (m_driver->isPlaying())
-                std::cerr << "AudioBussMixer::processBlocks: buss " << buss << (dormant ? " dormant" : " not dormant") << std::endl;
+                RG_RT_DEBUG << "AudioBussMixer::processBlocks: buss " << buss << (dormant ? " dormant" : " not dormant");
 #endif
 
         }
@@ -822,7 +826,7 @@ AudioBussMixer::processBlocks()
 
 
 #ifdef DEBUG_BUSS_MIXER
-    std::cerr << "AudioBussMixer::processBlocks: done" << std::endl;
+    RG_RT_DEBUG << "AudioBussMixer::processBlocks: done";
 #endif
 }
 
@@ -883,7 +887,7 @@ AudioFileReader::fillBuffers(const RealTime &currentTime)
 
 #ifdef DEBUG_READER
 
-    std::cerr << "AudioFileReader::fillBuffers: have " << files.size() << " audio files total" << std::endl;
+    RG_RT_DEBUG << "AudioFileReader::fillBuffers: have " << files.size() << " audio files total";
 #endif
 
     for (AudioPlayQueue::FileSet::const_iterator fi = files.begin();
@@ -1190,7 +1194,7 @@ AudioFileWriter::kick(bool wantLock)
         if (raf->getStatus() == RecordableAudioFile::DEFUNCT) {
 
 #ifdef DEBUG_WRITER
-            std::cerr << "AudioFileWriter::kick: found defunct file on instrument " << id << std::endl;
+            RG_RT_DEBUG << "AudioFileWriter::kick: found defunct file on instrument " << id;
 #endif
 
             m_files[id].first = nullptr;
@@ -1199,7 +1203,7 @@ AudioFileWriter::kick(bool wantLock)
 
         } else {
 #ifdef DEBUG_WRITER
-            std::cerr << "AudioFileWriter::kick: writing file on instrument " << id << std::endl;
+            RG_RT_DEBUG << "AudioFileWriter::kick: writing file on instrument " << id;
 #endif
 
             raf->write();
@@ -0,0 +1,299 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A MIDI and audio sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+
+    Other copyrights also apply to some parts of this work.  Please
+    see the AUTHORS file and individual file headers for details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#define RG_MODULE_STRING "[BeatTracker]"
+
+#include "BeatTracker.h"
+
+#include "OnsetDetector.h"
+#include "misc/Debug.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+
+namespace Rosegarden
+{
+
+
+namespace
+{
+    // Number of multiples of the period summed when scoring a tempo.
+    const int harmonics = 4;
+
+    // Half-width, in steps, of the moving mean removed from the envelope.
+    const long meanWindow = 16;
+
+    // How strongly beat spacing is held to the period.
+    const double tightness = 100.0;
+
+    /// Remove the local mean and scale to unit standard deviation.
+    /**
+     * Returns false if there is nothing left, i.e. no onsets at all.
+     */
+    bool normalise(std::vector<float> &envelope)
+    {
+        const long n = long(envelope.size());
+        if (n == 0)
+            return false;
+
+        std::vector<double> cumulative(n + 1, 0.0);
+        for (long i = 0; i < n; ++i)
+            cumulative[i + 1] = cumulative[i] + envelope[i];
+
+        std::vector<float> result(n);
+        double sumSquares = 0.0;
+        for (long i = 0; i < n; ++i) {
+            const long from = std::max(0L, i - meanWindow);
+            const long to = std::min(n, i + meanWindow + 1);
+            const double mean =
+                    (cumulative[to] - cumulative[from]) / (to - from);
+            const double value = std::max(0.0, envelope[i] - mean);
+            result[i] = float(value);
+            sumSquares += value * value;
+        }
+
+        const double deviation = std::sqrt(sumSquares / n);
+        if (deviation <= 0.0)
+            return false;
+
+        for (long i = 0; i < n; ++i)
+            result[i] = float(result[i] / deviation);
+
+        envelope.swap(result);
+        return true;
+    }
+}
+
+BeatTracker::BeatTracker(unsigned int sampleRate) :
+    m_sampleRate(sampleRate),
+    m_minBpm(50.0),
+    m_maxBpm(220.0),
+    m_tempo(0.0)
+{
+}
+
+void
+BeatTracker::setTempoRange(double minBpm, double maxBpm)
+{
+    if (minBpm <= 0.0  ||  maxBpm <= minBpm)
+        return;
+
+    m_minBpm = minBpm;
+    m_maxBpm = maxBpm;
+}
+
+double
+BeatTracker::estimatePeriod(const std::vector<float> &envelope) const
+{
+    const double stepsPerMinute =
+            60.0 * m_sampleRate / OnsetDetector::stepSize;
+    const double minLag = stepsPerMinute / m_maxBpm;
+    const double maxLag = stepsPerMinute / m_minBpm;
+    const double preferredLag = stepsPerMinute / 120.0;
+
+    const long n = long(envelope.size());
+    const long maxAcLag =
+            std::min(n - 1, long(std::ceil(maxLag * harmonics)) + 1);
+    if (maxAcLag < long(std::ceil(maxLag)) + 1)
+        return 0.0;
+
+    // Autocorrelation, normalised by overlap.
+    std::vector<double> ac(maxAcLag + 1, 0.0);
+    const float *e = &envelope[0];
+    for (long lag = 1; lag <= maxAcLag; ++lag) {
+        double sum = 0.0;
+        for (long i = 0; i + lag < n; ++i)
+            sum += e[i] * e[i + lag];
+        ac[lag] = sum / double(n - lag);
+    }
+
+    double bestLag = 0.0;
+    double bestScore = 0.0;
+
+    // Try fractional periods so that the tempo is precise.
+    for (double lag = minLag; lag <= maxLag; lag += 0.02) {
+
+        double score = 0.0;
+        int used = 0;
+        for (int k = 1; k <= harmonics; ++k) {
+            const double x = lag * k;
+            const long i = long(x);
+            if (i + 1 > maxAcLag)
+                break;
+            const double fraction = x - i;
+            score += ac[i] * (1.0 - fraction) + ac[i + 1] * fraction;
+            ++used;
+        }
+        if (used == 0)
+            continue;
+        score /= used;
+
+        // Prefer tempi near 120bpm, by octave distance.
+        const double octaves = std::log2(lag / preferredLag);
+        score *= std::exp(-0.5 * octaves * octaves);
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestLag = lag;
+        }
+    }
+
+    return bestLag;
+}
+
+std::vector<long>
+BeatTracker::trackBeats(const std::vector<float> &envelope,
+                        double period) const
+{
+    std::vector<long> beats;
+
+    const long n = long(envelope.size());
+    const long shortest = std::max(1L, long(std::lround(period / 2)));
+    const long longest = std::max(shortest, long(std::lround(period * 2)));
+
+    // Penalty for each possible distance back to the previous beat.
+    std::vector<double> penalty(longest + 1, 0.0);
+    for (long d = shortest; d <= longest; ++d) {
+        const double deviation = std::log(d / period);
+        penalty[d] = -tightness * deviation * deviation;
+    }
+
+    std::vector<double> score(n, 0.0);
+    std::vector<long> previous(n, -1);
+
+    for (long t = 0; t < n; ++t) {
+        double best = 0.0;
+        long bestPrevious = -1;
+
+        for (long d = shortest; d <= longest  &&  d <= t; ++d) {
+            const double candidate = score[t - d] + penalty[d];
+            if (bestPrevious < 0  ||  candidate > best) {
+                best = candidate;
+                bestPrevious = t - d;
+            }
+        }
+
+        if (bestPrevious >= 0  &&  best > 0.0) {
+            score[t] = envelope[t] + best;
+            previous[t] = bestPrevious;
+        } else {
+            score[t] = envelope[t];
+        }
+    }
+
+    // The last beat is the best scoring step within the last period.
+    long last = n - 1;
+    for (long t = std::max(0L, n - long(std::lround(period))); t < n; ++t) {
+        if (score[t] > score[last])
+            last = t;
+    }
+
+    for (long t = last; t >= 0; t = previous[t])
+        beats.push_back(t);
+
+    std::reverse(beats.begin(), beats.end());
+
+    return beats;
+}
+
+std::vector<long>
+BeatTracker::findBeats(const float *samples, long count)
+{
+    m_tempo = 0.0;
+
+    std::vector<long> beats;
+    if (!samples  ||  count <= 0)
+        return beats;
+
+    OnsetDetector detector(m_sampleRate, 50);
+
+    std::vector<float> envelope;
+    detector.getOnsetEnvelope(samples, count, envelope);
+
+    // The onsets are for moving the beats to sample positions.
+    const std::vector<long> onsets =
+            detector.findOnsets(samples, count, envelope);
+
+    std::vector<float> normalised(envelope);
+    if (!normalise(normalised))
+        return beats;
+
+    const double period = estimatePeriod(normalised);
+    if (period <= 0.0)
+        return beats;
+
+    m_tempo = 60.0 * m_sampleRate / (period * OnsetDetector::stepSize);
+
+    RG_DEBUG << "findBeats(): tempo" << m_tempo << "bpm";
+
+    const std::vector<long> steps = trackBeats(normalised, period);
+
+    // Snap to the nearest onset within a quarter of a beat.
+    const long snapDistance =
+            long(period * OnsetDetector::stepSize / 4);
+    long previousBeat = -1;
+
+    for (size_t i = 0; i < steps.size(); ++i) {
+        long beat = steps[i] * OnsetDetector::stepSize;
+
+        std::vector<long>::const_iterator onset =
+                std::lower_bound(onsets.begin(), onsets.end(), beat);
+        long nearest = -1;
+        if (onset != onsets.end())
+            nearest = *onset;
+        if (onset != onsets.begin()  &&
+            (nearest < 0  ||  beat - *(onset - 1) < nearest - beat))
+            nearest = *(onset - 1);
+
+        if (nearest >= 0  &&  labs(nearest - beat) <= snapDistance)
+            beat = nearest;
+
+        if (beat <= previousBeat  ||  beat >= count)
+            continue;
+
+        beats.push_back(beat);
+        previousBeat = beat;
+    }
+
+    return beats;
+}
+
+std::vector<long>
+BeatTracker::findBeats(AudioFile *audioFile,
+                       const RealTime &startTime,
+                       const RealTime &endTime)
+{
+    m_tempo = 0.0;
+
+    std::vector<float> mono;
+    long startFrame = 0;
+    if (!OnsetDetector::readMono(audioFile, startTime, endTime,
+                                 mono, startFrame))
+        return std::vector<long>();
+
+    std::vector<long> beats = findBeats(mono.data(), long(mono.size()));
+
+    for (size_t i = 0; i < beats.size(); ++i)
+        beats[i] += startFrame;
+
+    return beats;
+}
+
+
+}
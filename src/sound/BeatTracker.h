@@ -0,0 +1,98 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A MIDI and audio sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+
+    Other copyrights also apply to some parts of this work.  Please
+    see the AUTHORS file and individual file headers for details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#ifndef RG_BEATTRACKER_H
+#define RG_BEATTRACKER_H
+
+#include "base/RealTime.h"
+
+#include <vector>
+
+#include <rosegardenprivate_export.h>
+
+namespace Rosegarden
+{
+
+
+class AudioFile;
+
+
+/// Offline beat tracking for audio material.
+/**
+ * Works from the onset strength envelope computed by OnsetDetector (one
+ * value per OnsetDetector::stepSize samples):
+ *
+ *   1. The tempo is estimated from the autocorrelation of the envelope,
+ *      summed over the first few multiples of each candidate period and
+ *      weighted towards 120bpm to settle octave ambiguity.
+ *   2. The beats are placed by dynamic programming (after Ellis,
+ *      "Beat Tracking by Dynamic Programming", 2007): each step scores
+ *      its onset strength plus the best score of a predecessor about one
+ *      period earlier, penalising deviation from the period.
+ *   3. Each beat is moved to the onset found by OnsetDetector nearby,
+ *      if there is one, so that beats are sample accurate.
+ *
+ * Used by RosegardenMainWindow to set the tempo map from an audio
+ * segment (see CreateTempoMapFromSegmentCommand).
+ */
+class ROSEGARDENPRIVATE_EXPORT BeatTracker
+{
+public:
+    explicit BeatTracker(unsigned int sampleRate);
+
+    /// Limit the tempo estimate.  Default is 50 to 220bpm.
+    void setTempoRange(double minBpm, double maxBpm);
+
+    /// Find the beats in a mono buffer.
+    /**
+     * Returns the sample offsets of the beats, in ascending order.
+     */
+    std::vector<long> findBeats(const float *samples, long count);
+
+    /// Find the beats in a region of an audio file.
+    /**
+     * Returns sample frame offsets from the start of the file, in
+     * ascending order.  Returns an empty vector if the file cannot be
+     * read.
+     */
+    std::vector<long> findBeats(AudioFile *audioFile,
+                                const RealTime &startTime,
+                                const RealTime &endTime);
+
+    /// The tempo found by the last call to findBeats(), in bpm.
+    /**
+     * 0 if no tempo could be found.
+     */
+    double getTempo() const  { return m_tempo; }
+
+private:
+    unsigned int m_sampleRate;
+    double m_minBpm;
+    double m_maxBpm;
+    double m_tempo;
+
+    /// The beat period, in envelope steps.  0 if none was found.
+    double estimatePeriod(const std::vector<float> &envelope) const;
+    /// The beat positions, in envelope steps.
+    std::vector<long> trackBeats(const std::vector<float> &envelope,
+                                 double period) const;
+};
+
+
+}
+
+#endif
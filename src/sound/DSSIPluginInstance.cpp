@@ -13,10 +13,14 @@
     COPYING included with this distribution for more information.
 */
 
+#define RG_MODULE_STRING "[DSSIPluginInstance]"
+#define RG_RT_CATEGORY Rosegarden::RTDebug::Plugins
+
 #include "DSSIPluginInstance.h"
 #include "PluginIdentifier.h"
 #include "LADSPAPluginFactory.h"
 
+#include "misc/RealtimeDebug.h"
 #include <misc/Strings.h>
 
 #include <QtGlobal>
@@ -827,7 +831,7 @@ DSSIPluginInstance::sendEvent(const RealTime &eventTime,
     snd_seq_event_t *seqEvent = (snd_seq_event_t *)event;
 #ifdef DEBUG_DSSI_PROCESS
 
-    std::cerr << "DSSIPluginInstance::sendEvent at " << eventTime << std::endl;
+    RG_RT_DEBUG << "DSSIPluginInstance::sendEvent at " << eventTime;
 #endif
 
     snd_seq_event_t ev(*seqEvent);
@@ -836,8 +840,8 @@ DSSIPluginInstance::sendEvent(const RealTime &eventTime,
     ev.time.time.tv_nsec = eventTime.nsec;
 
 #ifdef DEBUG_DSSI_PROCESS
-    std::cerr << "DSSIPluginInstance::sendEvent: type channel " <<
-        (int)ev.type << " " << (int)ev.data.note.channel << std::endl;
+    RG_RT_DEBUG << "DSSIPluginInstance::sendEvent: type channel " <<
+        (int)ev.type << " " << (int)ev.data.note.channel;
 #endif
 
     m_eventBuffer.write(&ev, 1);
@@ -850,7 +854,7 @@ DSSIPluginInstance::handleController(snd_seq_event_t *ev)
 
 #ifdef DEBUG_DSSI_PROCESS
 
-    std::cerr << "DSSIPluginInstance::handleController " << controller << std::endl;
+    RG_RT_DEBUG << "DSSIPluginInstance::handleController " << controller;
 #endif
 
     if (controller == 0) { // bank select MSB
@@ -918,14 +922,14 @@ DSSIPluginInstance::run(const RealTime &blockTime)
     }
 
 #ifdef DEBUG_DSSI_PROCESS
-    std::cerr << "DSSIPluginInstance::run(" << blockTime << ")" << std::endl;
+    RG_RT_DEBUG << "DSSIPluginInstance::run(" << blockTime << ")";
 #endif
 
 #ifdef DEBUG_DSSI_PROCESS
 
     if (m_eventBuffer.getReadSpace() > 0) {
-        std::cerr << "DSSIPluginInstance::run: event buffer has "
-        << m_eventBuffer.getReadSpace() << " event(s) in it" << std::endl;
+        RG_RT_DEBUG << "DSSIPluginInstance::run: event buffer has "
+        << m_eventBuffer.getReadSpace() << " event(s) in it";
     }
 #endif
 
@@ -943,9 +947,9 @@ DSSIPluginInstance::run(const RealTime &blockTime)
         }
 
 #ifdef DEBUG_DSSI_PROCESS
-        std::cerr << "DSSIPluginInstance::run: evTime " << evTime << ", blockTime " << blockTime << ", frameOffset " << frameOffset
-        << ", blockSize " << m_blockSize << std::endl;
-        std::cerr << "Type: " << int(ev->type) << ", pitch: " << int(ev->data.note.note) << ", velocity: " << int(ev->data.note.velocity) << std::endl;
+        RG_RT_DEBUG << "DSSIPluginInstance::run: evTime " << evTime << ", blockTime " << blockTime << ", frameOffset " << frameOffset
+        << ", blockSize " << m_blockSize;
+        RG_RT_DEBUG << "Type: " << int(ev->type) << ", pitch: " << int(ev->data.note.note) << ", velocity: " << int(ev->data.note.velocity);
 #endif
 
         if (frameOffset >= int(m_blockSize)) {
@@ -990,7 +994,7 @@ DSSIPluginInstance::run(const RealTime &blockTime)
 
 #ifdef DEBUG_DSSI
 
-        std::cerr << "DSSIPluginInstance::run: making select_program(" << bank << "," << program << " call" << std::endl;
+        RG_RT_DEBUG << "DSSIPluginInstance::run: making select_program(" << bank << "," << program << " call";
 #endif
 
         m_pending.lsb = m_pending.msb = m_pending.program = -1;
@@ -998,14 +1002,13 @@ DSSIPluginInstance::run(const RealTime &blockTime)
 
 #ifdef DEBUG_DSSI
 
-        std::cerr << "DSSIPluginInstance::run: made select_program(" << bank << "," << program << " call" << std::endl;
+        RG_RT_DEBUG << "DSSIPluginInstance::run: made select_program(" << bank << "," << program << " call";
 #endif
 
     }
 
 #ifdef DEBUG_DSSI_PROCESS
-    std::cerr << "DSSIPluginInstance::run: running with " << evCount << " events"
-    << std::endl;
+    RG_RT_DEBUG << "DSSIPluginInstance::run: running with " << evCount << " events";
 #endif
 
     m_descriptor->run_synth(m_instanceHandle, m_blockSize,
@@ -1069,7 +1072,7 @@ DSSIPluginInstance::runGrouped(const RealTime &blockTime)
 
 #ifdef DEBUG_DSSI_PROCESS
 
-    std::cerr << "DSSIPluginInstance::runGrouped(" << blockTime << "): this is " << this << "; " << s.size() << " elements in m_groupMap[" << m_identifier << "]" << std::endl;
+    RG_RT_DEBUG << "DSSIPluginInstance::runGrouped(" << blockTime << "): this is " << this << "; " << s.size() << " elements in group";
 #endif
 
     if (m_lastRunTime != blockTime) {
@@ -1077,7 +1080,7 @@ DSSIPluginInstance::runGrouped(const RealTime &blockTime)
             DSSIPluginInstance *instance = *i;
             if (instance != this && instance->m_lastRunTime == blockTime) {
 #ifdef DEBUG_DSSI_PROCESS
-                std::cerr << "DSSIPluginInstance::runGrouped(" << blockTime << "): plugin " << instance << " has already been run" << std::endl;
+                RG_RT_DEBUG << "DSSIPluginInstance::runGrouped(" << blockTime << "): plugin " << instance << " has already been run";
 #endif
 
                 needRun = false;
@@ -1087,14 +1090,14 @@ DSSIPluginInstance::runGrouped(const RealTime &blockTime)
 
     if (!needRun) {
 #ifdef DEBUG_DSSI_PROCESS
-        std::cerr << "DSSIPluginInstance::runGrouped(" << blockTime << "): already run, returning" << std::endl;
+        RG_RT_DEBUG << "DSSIPluginInstance::runGrouped(" << blockTime << "): already run, returning";
 #endif
 
         return ;
     }
 
 #ifdef DEBUG_DSSI_PROCESS
-    std::cerr << "DSSIPluginInstance::runGrouped(" << blockTime << "): I'm the first, running" << std::endl;
+    RG_RT_DEBUG << "DSSIPluginInstance::runGrouped(" << blockTime << "): I'm the first, running";
 #endif
 
     size_t index = 0;
@@ -1120,7 +1123,7 @@ DSSIPluginInstance::runGrouped(const RealTime &blockTime)
 
 #ifdef DEBUG_DSSI_PROCESS
 
-        std::cerr << "DSSIPluginInstance::runGrouped(" << blockTime << "): running " << instance << std::endl;
+        RG_RT_DEBUG << "DSSIPluginInstance::runGrouped(" << blockTime << "): running " << instance;
 #endif
 
         if (instance->m_pending.program >= 0 &&
@@ -1146,8 +1149,8 @@ DSSIPluginInstance::runGrouped(const RealTime &blockTime)
             }
 
 #ifdef DEBUG_DSSI_PROCESS
-            std::cerr << "DSSIPluginInstance::runGrouped: evTime " << evTime << ", frameOffset " << frameOffset
-            << ", block size " << m_blockSize << std::endl;
+            RG_RT_DEBUG << "DSSIPluginInstance::runGrouped: evTime " << evTime << ", frameOffset " << frameOffset
+            << ", block size " << m_blockSize;
 #endif
 
             if (frameOffset >= int(m_blockSize)) {
@@ -0,0 +1,141 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#ifndef RG_FRAMERINGBUFFER_H
+#define RG_FRAMERINGBUFFER_H
+
+#include "RingBuffer.h"
+
+#include <algorithm>
+
+namespace Rosegarden {
+
+/**
+ * FrameRingBuffer is a lock-free ring buffer for one writer and one
+ * reader that stores multi-channel audio as interleaved frames.
+ *
+ * Compared with one RingBuffer per channel, a block of frames costs a
+ * single position update, and the reader gets interleaved data that
+ * can be handed straight to e.g. AudioWriteStream::putInterleavedFrames()
+ * through getReadRegions() without any copying.
+ *
+ * The underlying storage is a whole number of frames, so a frame is
+ * never split across the end of the buffer.
+ */
+
+template <typename T>
+class FrameRingBuffer
+{
+public:
+    /**
+     * Create a ring buffer with room to write the given number of
+     * frames of channelCount samples each.
+     */
+    FrameRingBuffer(size_t channelCount, size_t frames) :
+        m_channels(std::max(size_t(1), channelCount)),
+        m_buffer(m_channels * (frames + 1) - 1)
+    {
+    }
+
+    size_t getChannelCount() const  { return m_channels; }
+
+    /// The number of frames available for reading.
+    size_t getReadSpace() const
+        { return m_buffer.getReadSpace() / m_channels; }
+
+    /// The number of frames that may be written.
+    size_t getWriteSpace() const
+        { return m_buffer.getWriteSpace() / m_channels; }
+
+    /**
+     * Write n frames taken from one buffer per channel, interleaving
+     * them.  If there is insufficient space, not all frames may be
+     * written.  Returns the number of frames actually written.
+     */
+    size_t write(const T *const *channels, size_t n)
+    {
+        T *first, *second;
+        size_t firstCount, secondCount;
+        m_buffer.getWriteRegions(first, firstCount, second, secondCount);
+
+        const size_t firstFrames = firstCount / m_channels;
+        const size_t secondFrames = secondCount / m_channels;
+
+        n = std::min(n, firstFrames + secondFrames);
+
+        const size_t here = std::min(n, firstFrames);
+        interleave(first, channels, 0, here);
+        interleave(second, channels, here, n - here);
+
+        m_buffer.commitWrite(n * m_channels);
+
+        return n;
+    }
+
+    /**
+     * Direct access to the interleaved frames available for reading.
+     * The second region is only non-empty if the data wraps around
+     * the end of the buffer.  Counts are in frames.  Returns the
+     * total number of frames.  Call skip() when done with them.
+     */
+    size_t getReadRegions(const T *&first, size_t &firstFrames,
+                          const T *&second, size_t &secondFrames) const
+    {
+        size_t firstCount, secondCount;
+        m_buffer.getReadRegions(first, firstCount, second, secondCount);
+
+        firstFrames = firstCount / m_channels;
+        secondFrames = secondCount / m_channels;
+
+        return firstFrames + secondFrames;
+    }
+
+    /**
+     * Discard the next n frames.  Returns the number of frames
+     * actually discarded.
+     */
+    size_t skip(size_t n)
+        { return m_buffer.skip(n * m_channels) / m_channels; }
+
+    /**
+     * Reset read and write positions, thus emptying the buffer.
+     * Should be called from the write thread.
+     */
+    void reset()  { m_buffer.reset(); }
+
+private:
+    size_t m_channels;
+    RingBuffer<T> m_buffer;
+
+    void interleave(T *destination, const T *const *channels,
+                    size_t from, size_t frames) const
+    {
+        for (size_t c = 0; c < m_channels; ++c) {
+            const T *source = channels[c] + from;
+            T *d = destination + c;
+            for (size_t i = 0; i < frames; ++i) {
+                *d = source[i];
+                d += m_channels;
+            }
+        }
+    }
+
+    FrameRingBuffer(const FrameRingBuffer &); // not provided
+    FrameRingBuffer &operator=(const FrameRingBuffer &); // not provided
+};
+
+}
+
+#endif // RG_FRAMERINGBUFFER_H
@@ -15,6 +15,7 @@
 
 #define RG_MODULE_STRING "[JackDriver]"
 #define RG_NO_DEBUG_PRINT 1
+#define RG_RT_CATEGORY Rosegarden::RTDebug::Audio
 
 #include "JackDriver.h"
 #include "AlsaDriver.h"
@@ -31,6 +32,7 @@
 #include "misc/ConfigGroups.h"
 #include "misc/Debug.h"
 #include "misc/Preferences.h"
+#include "misc/RealtimeDebug.h"
 
 #include <QSettings>
 #include <QtGlobal>
@@ -808,7 +810,7 @@ JackDriver::jackProcess(jack_nframes_t nframes)
 {
     if (!m_ok || !m_client) {
 #ifdef DEBUG_JACK_PROCESS
-        RG_DEBUG << "jackProcess(): not OK";
+        RG_RT_DEBUG << "jackProcess(): not OK";
 #endif
 
         return 0;
@@ -816,7 +818,7 @@ JackDriver::jackProcess(jack_nframes_t nframes)
 
     if (!m_bussMixer) {
 #ifdef DEBUG_JACK_PROCESS
-        RG_DEBUG << "jackProcess(): no buss mixer";
+        RG_RT_DEBUG << "jackProcess(): no buss mixer";
 #endif
 
         return jackProcessEmpty(nframes);
@@ -828,7 +830,7 @@ JackDriver::jackProcess(jack_nframes_t nframes)
     if (threadId != gettid())
     {
         threadId = gettid();
-        RG_WARNING << "jackProcess(): gettid(): " << gettid();
+        RG_RT_WARNING << "jackProcess(): gettid(): " << gettid();
     }
 #endif
 
@@ -841,7 +843,7 @@ JackDriver::jackProcess(jack_nframes_t nframes)
     m_alsaDriver->getSoftSynthInstrumentNumbers(synthInstrumentBase,
                                                 synthInstruments);
     int synthCount = m_instrumentMixer->getNumSoftSynths();
-    //RG_DEBUG << "process got" << synthCount << "synths";
+    //RG_RT_DEBUG << "process got" << synthCount << "synths";
 
     // synchronize MIDI and audio by adjusting MIDI playback rate
     if (m_alsaDriver->areClocksRunning()) {
@@ -860,12 +862,12 @@ JackDriver::jackProcess(jack_nframes_t nframes)
     if (m_exportManager) {
         // Transitioning to play.
         if (playing  &&  !m_playing) {
-            RG_DEBUG << "export start playing";
+            RG_RT_DEBUG << "export start playing";
             m_exportManager->start();
         }
         // Transitioning to stop.
         if (!playing  &&  m_playing) {
-            RG_DEBUG << "export stop playing";
+            RG_RT_DEBUG << "export stop playing";
             m_exportManager->stop();
             // finished with the exportManager - it is deleted elsewhere
             m_exportManager = nullptr;
@@ -889,7 +891,7 @@ JackDriver::jackProcess(jack_nframes_t nframes)
                     m_instrumentMixer->releaseLock();
                     //#ifdef DEBUG_JACK_PROCESS
                 } else {
-                    RG_WARNING << "jackProcess(): WARNING: no instrument mixer lock available";
+                    RG_RT_WARNING << "jackProcess(): WARNING: no instrument mixer lock available";
                     //#endif
                 }
                 if (m_bussMixer->getBussCount() > 0) {
@@ -898,7 +900,7 @@ JackDriver::jackProcess(jack_nframes_t nframes)
                         m_bussMixer->releaseLock();
                         //#ifdef DEBUG_JACK_PROCESS
                     } else {
-                        RG_WARNING << "jackProcess(): WARNING: no buss mixer lock available";
+                        RG_RT_WARNING << "jackProcess(): WARNING: no buss mixer lock available";
                         //#endif
                     }
                 }
@@ -941,7 +943,7 @@ JackDriver::jackProcess(jack_nframes_t nframes)
         state = jack_transport_query(m_client, &position);
 
 #ifdef DEBUG_JACK_PROCESS
-        RG_DEBUG << "jackProcess(): JACK transport state is " << state;
+        RG_RT_DEBUG << "jackProcess(): JACK transport state is " << state;
 #endif
 
         if (state == JackTransportStopped) {
@@ -950,7 +952,7 @@ JackDriver::jackProcess(jack_nframes_t nframes)
                         RosegardenSequencer::getInstance();
                 if (sequencer) {
 #ifdef DEBUG_JACK_TRANSPORT
-                    RG_DEBUG << "jackProcess(): JACK transport stopped externally at " << position.frame;
+                    RG_RT_DEBUG << "jackProcess(): JACK transport stopped externally at " << position.frame;
 #endif
 
                     m_waitingToken = sequencer->transportJump(
@@ -961,7 +963,7 @@ JackDriver::jackProcess(jack_nframes_t nframes)
             } else if (clocksRunning) {
                 if (!asyncAudio) {
 #ifdef DEBUG_JACK_PROCESS
-                    RG_DEBUG << "jackProcess(): no interesting async events";
+                    RG_RT_DEBUG << "jackProcess(): no interesting async events";
 #endif
                     // do this before record monitor, otherwise we lose monitor out
                     jackProcessEmpty(nframes);
@@ -987,7 +989,7 @@ JackDriver::jackProcess(jack_nframes_t nframes)
         } else if (state == JackTransportStarting) {
             return jackProcessEmpty(nframes);
         } else if (state != JackTransportRolling) {
-            RG_WARNING << "jackProcess(): WARNING: unexpected JACK transport state " << state;
+            RG_RT_WARNING << "jackProcess(): WARNING: unexpected JACK transport state " << state;
         }
     }
 
@@ -995,11 +997,11 @@ JackDriver::jackProcess(jack_nframes_t nframes)
         if (m_waiting) {
             if (ignoreCount > 0) {
 #ifdef DEBUG_JACK_TRANSPORT
-                RG_DEBUG << "jackProcess(): transport rolling, but we're ignoring it (count = " << ignoreCount << ")";
+                RG_RT_DEBUG << "jackProcess(): transport rolling, but we're ignoring it (count = " << ignoreCount << ")";
 #endif
             } else {
 #ifdef DEBUG_JACK_TRANSPORT
-                RG_DEBUG << "jackProcess(): transport rolling, telling ALSA driver to go!";
+                RG_RT_DEBUG << "jackProcess(): transport rolling, telling ALSA driver to go!";
 #endif
 
                 m_alsaDriver->startClocksApproved();
@@ -1008,24 +1010,24 @@ JackDriver::jackProcess(jack_nframes_t nframes)
         }
 
 #ifdef DEBUG_JACK_PROCESS
-        RG_DEBUG << "jackProcess(): (rolling or not on JACK transport)";
+        RG_RT_DEBUG << "jackProcess(): (rolling or not on JACK transport)";
 #endif
 
         if (!clocksRunning) {
 #ifdef DEBUG_JACK_PROCESS
-            RG_DEBUG << "jackProcess(): clocks stopped";
+            RG_RT_DEBUG << "jackProcess(): clocks stopped";
 #endif
 
             return jackProcessEmpty(nframes);
 
         } else if (!playing) {
 #ifdef DEBUG_JACK_PROCESS
-            RG_DEBUG << "jackProcess(): not playing";
+            RG_RT_DEBUG << "jackProcess(): not playing";
 #endif
 
             if (!asyncAudio) {
 #ifdef DEBUG_JACK_PROCESS
-                RG_DEBUG << "jackProcess(): no interesting async events";
+                RG_RT_DEBUG << "jackProcess(): no interesting async events";
 #endif
                 // do this before record monitor, otherwise we lose monitor out
                 jackProcessEmpty(nframes);
@@ -1145,7 +1147,7 @@ JackDriver::jackProcess(jack_nframes_t nframes)
     }
 
 #ifdef DEBUG_JACK_PROCESS
-    RG_DEBUG << "jackProcess(): have " << audioInstruments << " audio and " << synthInstruments << " synth instruments and " << bussCount << " busses";
+    RG_RT_DEBUG << "jackProcess(): have " << audioInstruments << " audio and " << synthInstruments << " synth instruments and " << bussCount << " busses";
 #endif
 
     bool allInstrumentsDormant = true;
@@ -1195,7 +1197,7 @@ JackDriver::jackProcess(jack_nframes_t nframes)
 
 #ifdef DEBUG_JACK_PROCESS
             if (id == 1000 || id == 10000) {
-                RG_DEBUG << "jackProcess(): instrument id " << id << ", base " << audioInstrumentBase << ", direct masters " << m_directMasterAudioInstruments << ": " << directToMaster;
+                RG_RT_DEBUG << "jackProcess(): instrument id " << id << ", base " << audioInstrumentBase << ", direct masters " << m_directMasterAudioInstruments << ": " << directToMaster;
             }
 #endif
 
@@ -1206,9 +1208,9 @@ JackDriver::jackProcess(jack_nframes_t nframes)
 #ifdef DEBUG_JACK_PROCESS
                 if (id == 1000 || id == 10000) {
                     if (rb) {
-                        RG_DEBUG << "jackProcess(): instrument " << id << " dormant";
+                        RG_RT_DEBUG << "jackProcess(): instrument " << id << " dormant";
                     } else {
-                        RG_DEBUG << "jackProcess(): instrument " << id << " has no ring buffer for channel " << ch;
+                        RG_RT_DEBUG << "jackProcess(): instrument " << id << " has no ring buffer for channel " << ch;
                     }
                 }
 #endif
@@ -1226,12 +1228,12 @@ JackDriver::jackProcess(jack_nframes_t nframes)
 #ifdef DEBUG_JACK_PROCESS
 
                 if (id == 1000) {
-                    RG_DEBUG << "jackProcess(): read " << actual << " of " << nframes << " frames for instrument " << id << " channel " << ch;
+                    RG_RT_DEBUG << "jackProcess(): read " << actual << " of " << nframes << " frames for instrument " << id << " channel " << ch;
                 }
 #endif
 
                 if (actual < nframes) {
-                    RG_WARNING << "jackProcess(): WARNING: read " << actual << " of " << nframes << " frames for " << id << " ch " << ch << " (pl " << playing << ", cl " << clocksRunning << ", aa " << asyncAudio << ")";
+                    RG_RT_WARNING << "jackProcess(): WARNING: read " << actual << " of " << nframes << " frames for " << id << " ch " << ch << " (pl " << playing << ", cl " << clocksRunning << ", aa " << asyncAudio << ")";
                     reportFailure(MappedEvent::FailureMixUnderrun);
                 }
 
@@ -1270,7 +1272,7 @@ JackDriver::jackProcess(jack_nframes_t nframes)
             dormantTime = dormantTime +
                           RealTime::frame2RealTime(m_bufferSize, m_sampleRate);
             if (dormantTime > RealTime(10, 0)) {
-                RG_WARNING << "jackProcess(): WARNING: dormantTime = " << dormantTime << ", resetting m_haveAsyncAudioEvent";
+                RG_RT_WARNING << "jackProcess(): WARNING: dormantTime = " << dormantTime << ", resetting m_haveAsyncAudioEvent";
                 m_haveAsyncAudioEvent = false;
             }
         }
@@ -1330,7 +1332,7 @@ JackDriver::jackProcess(jack_nframes_t nframes)
 #endif
 
 #ifdef DEBUG_JACK_PROCESS
-    RG_DEBUG << "jackProcess(): " << nframes << " frames, " << framesThisPlay << " this play, " << m_framesProcessed << " total";
+    RG_RT_DEBUG << "jackProcess(): " << nframes << " frames, " << framesThisPlay << " this play, " << m_framesProcessed << " total";
 #endif
 
     return 0;
@@ -1349,7 +1351,7 @@ JackDriver::jackProcessEmpty(jack_nframes_t nframes)
     sample_t *buffer;
 
 #ifdef DEBUG_JACK_PROCESS
-    RG_DEBUG << "jackProcessEmpty() begin";
+    RG_RT_DEBUG << "jackProcessEmpty() begin";
 #endif
 
     buffer = static_cast<sample_t *>
@@ -1393,7 +1395,7 @@ JackDriver::jackProcessEmpty(jack_nframes_t nframes)
     framesThisPlay += nframes;
 #endif
 #ifdef DEBUG_JACK_PROCESS
-    RG_DEBUG << "jackProcess(): " << nframes << " frames, " << framesThisPlay << " this play, " << m_framesProcessed << " total";
+    RG_RT_DEBUG << "jackProcess(): " << nframes << " frames, " << framesThisPlay << " this play, " << m_framesProcessed << " total";
 #endif
 
     return 0;
@@ -1419,7 +1421,7 @@ JackDriver::jackProcessRecord(InstrumentId id,
     sample_t peakLeft = 0.0, peakRight = 0.0;
 
 #ifdef DEBUG_JACK_PROCESS
-    RG_DEBUG << "jackProcessRecord(" << id << "): clocksRunning " << clocksRunning;
+    RG_RT_DEBUG << "jackProcessRecord(" << id << "): clocksRunning " << clocksRunning;
 #endif
 
     // Get input buffers
@@ -1438,7 +1440,7 @@ JackDriver::jackProcessRecord(InstrumentId id,
     if (sourceBufferLeft) {
 
 #ifdef DEBUG_JACK_PROCESS
-        RG_DEBUG << "jackProcessRecord(" << id << "): buss input provided";
+        RG_RT_DEBUG << "jackProcessRecord(" << id << "): buss input provided";
 #endif
 
         inputBufferLeft = sourceBufferLeft;
@@ -1448,7 +1450,7 @@ JackDriver::jackProcessRecord(InstrumentId id,
     } else if (recInput < 1000) {
 
 #ifdef DEBUG_JACK_PROCESS
-        RG_DEBUG << "jackProcessRecord(" << id << "): no known input";
+        RG_RT_DEBUG << "jackProcessRecord(" << id << "): no known input";
 #endif
 
         return 0;
@@ -1456,7 +1458,7 @@ JackDriver::jackProcessRecord(InstrumentId id,
     } else {
 
 #ifdef DEBUG_JACK_PROCESS
-        RG_DEBUG << "jackProcessRecord(" << id << "): record input " << recInput;
+        RG_RT_DEBUG << "jackProcessRecord(" << id << "): record input " << recInput;
 #endif
 
         int input = recInput - 1000;
@@ -1482,7 +1484,7 @@ JackDriver::jackProcessRecord(InstrumentId id,
         m_fileWriter->haveRecordFileOpen(id)) {
 
 #ifdef DEBUG_JACK_PROCESS
-        RG_DEBUG << "jackProcessRecord(" << id << "): recording";
+        RG_RT_DEBUG << "jackProcessRecord(" << id << "): recording";
 #endif
 
         memset(m_tempOutBuffer, 0, nframes * sizeof(sample_t));
@@ -1540,7 +1542,7 @@ JackDriver::jackProcessRecord(InstrumentId id,
         // want peak levels and monitors anyway, even if not recording
 
 #ifdef DEBUG_JACK_PROCESS
-        RG_DEBUG << "jackProcessRecord(" << id << "): monitoring only";
+        RG_RT_DEBUG << "jackProcessRecord(" << id << "): monitoring only";
 #endif
 
         if (inputBufferLeft) {
@@ -1617,9 +1619,9 @@ JackDriver::jackSyncCallback(jack_transport_state_t state,
 
 #ifdef DEBUG_JACK_TRANSPORT
 
-    RG_DEBUG << "jackSyncCallback(): state " << state << " [" << (state == 0 ? "stopped" : state == 1 ? "rolling" : state == 2 ? "looping" : state == 3 ? "starting" : "unknown") << "], frame " << position->frame << ", waiting " << inst->m_waiting << ", playing " << inst->m_alsaDriver->isPlaying();
-    RG_DEBUG << "jackSyncCallback(): m_waitingState " << inst->m_waitingState << ", unique_1 " << position->unique_1 << ", unique_2 " << position->unique_2;
-    RG_DEBUG << "jackSyncCallback(): rate " << position->frame_rate << ", bar " << position->bar << ", beat " << position->beat << ", tick " << position->tick << ", bpm " << position->beats_per_minute;
+    RG_RT_DEBUG << "jackSyncCallback(): state " << state << " [" << (state == 0 ? "stopped" : state == 1 ? "rolling" : state == 2 ? "looping" : state == 3 ? "starting" : "unknown") << "], frame " << position->frame << ", waiting " << inst->m_waiting << ", playing " << inst->m_alsaDriver->isPlaying();
+    RG_RT_DEBUG << "jackSyncCallback(): m_waitingState " << inst->m_waitingState << ", unique_1 " << position->unique_1 << ", unique_2 " << position->unique_2;
+    RG_RT_DEBUG << "jackSyncCallback(): rate " << position->frame_rate << ", bar " << position->bar << ", beat " << position->beat << ", tick " << position->tick << ", bpm " << position->beats_per_minute;
 
 #endif
 
@@ -1652,37 +1654,37 @@ JackDriver::jackSyncCallback(jack_transport_state_t state,
                                                    position->frame_rate);
 
 #ifdef DEBUG_JACK_TRANSPORT
-            RG_DEBUG << "jackSyncCallback(): Requesting jump to " << rt;
+            RG_RT_DEBUG << "jackSyncCallback(): Requesting jump to " << rt;
 #endif
 
             inst->m_waitingToken = sequencer->transportJump(request, rt);
 
 #ifdef DEBUG_JACK_TRANSPORT
-            RG_DEBUG << "jackSyncCallback(): My token is " << inst->m_waitingToken;
+            RG_RT_DEBUG << "jackSyncCallback(): My token is " << inst->m_waitingToken;
 #endif
 
         } else if (request == RosegardenSequencer::TransportStop) {
 
 #ifdef DEBUG_JACK_TRANSPORT
-            RG_DEBUG << "jackSyncCallback(): Requesting state change to " << request;
+            RG_RT_DEBUG << "jackSyncCallback(): Requesting state change to " << request;
 #endif
 
             inst->m_waitingToken = sequencer->transportChange(request);
 
 #ifdef DEBUG_JACK_TRANSPORT
-            RG_DEBUG << "jackSyncCallback(): My token is " << inst->m_waitingToken;
+            RG_RT_DEBUG << "jackSyncCallback(): My token is " << inst->m_waitingToken;
 #endif
 
         } else if (request == RosegardenSequencer::TransportNoChange) {
 
 #ifdef DEBUG_JACK_TRANSPORT
-            RG_DEBUG << "jackSyncCallback(): Requesting no state change!";
+            RG_RT_DEBUG << "jackSyncCallback(): Requesting no state change!";
 #endif
 
             inst->m_waitingToken = sequencer->transportChange(request);
 
 #ifdef DEBUG_JACK_TRANSPORT
-            RG_DEBUG << "jackSyncCallback(): My token is " << inst->m_waitingToken;
+            RG_RT_DEBUG << "jackSyncCallback(): My token is " << inst->m_waitingToken;
 #endif
 
         }
@@ -1691,7 +1693,7 @@ JackDriver::jackSyncCallback(jack_transport_state_t state,
         inst->m_waitingState = state;
 
 #ifdef DEBUG_JACK_TRANSPORT
-        RG_DEBUG << "jackSyncCallback(): Setting waiting to " << inst->m_waiting << " and waiting state to " << inst->m_waitingState << " (request was " << request << ")";
+        RG_RT_DEBUG << "jackSyncCallback(): Setting waiting to " << inst->m_waiting << " and waiting state to " << inst->m_waitingState << " (request was " << request << ")";
 #endif
 
         return 0;
@@ -1700,13 +1702,13 @@ JackDriver::jackSyncCallback(jack_transport_state_t state,
 
         if (sequencer->isTransportSyncComplete(inst->m_waitingToken)) {
 #ifdef DEBUG_JACK_TRANSPORT
-            RG_DEBUG << "jackSyncCallback(): Sync complete";
+            RG_RT_DEBUG << "jackSyncCallback(): Sync complete";
 #endif
 
             return 1;
         } else {
 #ifdef DEBUG_JACK_TRANSPORT
-            RG_DEBUG << "jackSyncCallback(): Sync not complete";
+            RG_RT_DEBUG << "jackSyncCallback(): Sync not complete";
 #endif
 
             return 0;
@@ -1937,11 +1939,11 @@ int
 JackDriver::jackXRun(void *arg)
 {
 #ifdef DEBUG_JACK_DRIVER
-    RG_DEBUG << "jackXRun()";
+    RG_RT_DEBUG << "jackXRun()";
 #endif
 
 #ifdef DEBUG_JACK_XRUN
-    RG_DEBUG << "jackXRun()";
+    RG_RT_DEBUG << "jackXRun()";
     Profiles::getInstance()->dump();
 #endif
 
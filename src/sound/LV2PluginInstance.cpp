@@ -14,6 +14,7 @@
 
 #define RG_MODULE_STRING "[LV2PluginInstance]"
 #define RG_NO_DEBUG_PRINT 1
+#define RG_RT_CATEGORY Rosegarden::RTDebug::Plugins
 
 //#define LV2RUN_PROFILE 1
 
@@ -27,6 +28,7 @@
 
 #include "base/Profiler.h"
 #include "misc/Debug.h"
+#include "misc/RealtimeDebug.h"
 #include "sound/Midi.h"
 #include "sound/AudioInstrumentMixer.h"  // For AudioInstrumentMixer
 #include "gui/application/RosegardenMainWindow.h"
@@ -1133,7 +1135,7 @@ LV2PluginInstance::run(const RealTime &rt)
     if (!m_instance->lv2_descriptor)
         return;
 
-    //RG_DEBUG << "run" << rt << m_eventsDiscarded;
+    //RG_RT_DEBUG << "run" << rt << m_eventsDiscarded;
     m_pluginHasRun = true;
 
     // Get connected buffers.
@@ -1144,7 +1146,7 @@ LV2PluginInstance::run(const RealTime &rt)
             c.isOutput == false) {
             auto ib = m_amixer->getAudioBuffer(c.instrumentId, c.channel);
             if (ib) {
-                //RG_DEBUG << "copy" << c.instrumentId << c.channel;
+                //RG_RT_DEBUG << "copy" << c.instrumentId << c.channel;
 
                 memcpy(m_inputBuffers[bufIndex],
                        ib,
@@ -1169,12 +1171,12 @@ LV2PluginInstance::run(const RealTime &rt)
                 (size_t)RealTime::realTime2Frame(evTime - bufferStart,
                                                  m_sampleRate);
             if (frameOffset >= m_blockSize) {
-                //RG_DEBUG << "event not in frame" << frameOffset;
+                //RG_RT_DEBUG << "event not in frame" << frameOffset;
                 it++;
                 continue;
             }
             // the event is in this block
-            RG_DEBUG << "send event to plugin" << evTime;
+            RG_RT_DEBUG << "send event to plugin" << evTime;
             auto iterToDelete = it;
             ++it;
             m_eventBuffer.erase(iterToDelete);
@@ -1182,7 +1184,7 @@ LV2PluginInstance::run(const RealTime &rt)
             // if we have just been reset with discardEvents make sure we
             // send this data after the "stop all notes"
             if (m_eventsDiscarded && frameOffset == 0) {
-                RG_DEBUG << "adjusting frameOffset to be after all notes off";
+                RG_RT_DEBUG << "adjusting frameOffset to be after all notes off";
                 frameOffset = 1;
             }
             sendMidiData(rawMidi, frameOffset);
@@ -1194,7 +1196,7 @@ LV2PluginInstance::run(const RealTime &rt)
         // mono plugin. If this is the case there are exactly 2 input
         // and output buffers. The first ones are connected to the
         // plugin
-        //RG_DEBUG << "distribute stereo -> mono";
+        //RG_RT_DEBUG << "distribute stereo -> mono";
         for (size_t i = 0; i < m_blockSize; ++i) {
                     m_inputBuffers[0][i] =
                         (m_inputBuffers[0][i] + m_inputBuffers[1][i]) / 2.0;
@@ -1231,7 +1233,7 @@ LV2PluginInstance::run(const RealTime &rt)
         if (ap.atomSeq->atom.size == 8 * ABUFSIZED - 8) {
             // if the plugin has not touched the output buffer it
             // should be reset
-            RG_DEBUG << "run resetting unused buffer" << ap.index;
+            RG_RT_DEBUG << "run resetting unused buffer" << ap.index;
             lv2_atom_sequence_clear(ap.atomSeq);
         }
     }
@@ -1248,7 +1250,7 @@ LV2PluginInstance::run(const RealTime &rt)
             if (val > vmax) vmax = val;
             vms += val * val;
         }
-        RG_DEBUG << "run - output:" << vmin << vmax << sqrt(vms);
+        RG_RT_DEBUG << "run - output:" << vmin << vmax << sqrt(vms);
     }
     */
 
@@ -1276,13 +1278,13 @@ LV2PluginInstance::run(const RealTime &rt)
 
     // get atom out data
     for (const AtomPort &ap : m_atomOutputPorts) {
-        //RG_DEBUG << "check atom out" << ap.index;
+        //RG_RT_DEBUG << "check atom out" << ap.index;
         LV2_Atom_Sequence* aseq = ap.atomSeq;
         LV2_ATOM_SEQUENCE_FOREACH(aseq, ev) {
             if (ev->body.type == m_midiEventUrid) {
                 // midi out not used
             } else {
-                //RG_DEBUG << "updatePortValue";
+                //RG_RT_DEBUG << "updatePortValue";
                 if (ev->body.type != 0) {
                     updatePortValue(ap.index, &(ev->body));
                 }
@@ -1313,7 +1315,7 @@ LV2PluginInstance::run(const RealTime &rt)
             //double ms = 0.0;
             //for (unsigned int si=0; si<m_blockSize; si++)
             //  ms += m_outputBuffers[outbuf][si] * m_outputBuffers[outbuf][si];
-            //RG_DEBUG << "send data to audio source for port" << portIndex <<
+            //RG_RT_DEBUG << "send data to audio source for port" << portIndex <<
             //    outbuf << ms;
             PluginAudioSource* pas = (*iter).second;
             if (pas) pas->setAudioData(m_outputBuffers[outbuf]);
@@ -1377,7 +1379,7 @@ LV2PluginInstance::run(const RealTime &rt)
     m_run = true;
     m_eventsDiscarded = false;
 
-    //RG_DEBUG << "run done";
+    //RG_RT_DEBUG << "run done";
 }
 
 void
@@ -15,11 +15,13 @@
 
 #define RG_MODULE_STRING "[LV2Worker]"
 #define RG_NO_DEBUG_PRINT 1
+#define RG_RT_CATEGORY Rosegarden::RTDebug::Plugins
 
 #include "LV2Worker.h"
 
 #include "sound/LV2Utils.h"
 #include "misc/Debug.h"
+#include "misc/RealtimeDebug.h"
 
 #include <QTimer>
 
@@ -111,7 +113,7 @@ LV2Worker::getResponse(const LV2Utils::PluginPosition& pp)
     if (responseQueue.empty())
         return nullptr;
 
-    RG_DEBUG << "getResponse" << pp.instrument << pp.position;
+    RG_RT_DEBUG << "getResponse" << pp.instrument << pp.position;
 
     // COPY response
     // Caller is responsible for delete.
@@ -130,7 +132,7 @@ LV2_Worker_Status LV2Worker::scheduleWork(uint32_t size,
 {
     // this is called by the plugin in the audio thread
 
-    RG_DEBUG << "scheduleWork called" << pp.instrument << pp.position << size;
+    RG_RT_DEBUG << "scheduleWork called" << pp.instrument << pp.position << size;
 
     // if we were doing direct rendering we could call work here. In
     // real time processing the work must be queued
@@ -151,7 +153,7 @@ LV2_Worker_Status LV2Worker::scheduleWork(uint32_t size,
     for (const WorkerQueues::value_type &pair : m_jobs) {
         const LV2Utils::PluginPosition& ppd = pair.first;
         const WorkerQueue &jqd = pair.second;
-        RG_DEBUG << "sched job queue" << ppd.instrument << ppd.position <<
+        RG_RT_DEBUG << "sched job queue" << ppd.instrument << ppd.position <<
             jqd.size();
     }
 #endif
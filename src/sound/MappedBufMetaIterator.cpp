@@ -426,6 +426,11 @@ MappedBufMetaIterator::getAudioEvents(std::vector<MappedEvent> &audioEvents)
         //     (MappedEventBuffer::m_lock which should probably be
         //     public) and get at it directly via
         //     MappedEventBuffer::getBuffer() (or just make m_buffer public).
+        // Generated buffers (the metronome) have no audio, and would
+        // have to make every event to find that out.
+        if ((*i)->isGenerated())
+            continue;
+
         MEBIterator iter(*i);
 
         QReadLocker locker(iter.getLock());
@@ -0,0 +1,213 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#define RG_MODULE_STRING "[MappedWavFile]"
+
+#include "MappedWavFile.h"
+
+#include "misc/Debug.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace Rosegarden
+{
+
+
+namespace
+{
+    const unsigned int WAVE_FORMAT_PCM = 0x0001;
+    const unsigned int WAVE_FORMAT_IEEE_FLOAT = 0x0003;
+    const unsigned int WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+
+    unsigned int readLE16(const unsigned char *p)
+    {
+        return p[0] | (p[1] << 8);
+    }
+
+    unsigned int readLE32(const unsigned char *p)
+    {
+        return p[0] | (p[1] << 8) | (p[2] << 16) | (unsigned(p[3]) << 24);
+    }
+}
+
+
+MappedWavFile::MappedWavFile(const QString &fileName) :
+    m_file(fileName),
+    m_map(nullptr),
+    m_data(nullptr),
+    m_channels(0),
+    m_sampleRate(0),
+    m_bitsPerSample(0),
+    m_format(SampleFormat::Unknown),
+    m_bytesPerFrame(0),
+    m_frames(0)
+{
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_error = QString("Failed to open audio file '%1'").arg(fileName);
+        return;
+    }
+
+    const qint64 size = m_file.size();
+    if (size <= 0) {
+        m_error = QString("Audio file '%1' is empty").arg(fileName);
+        return;
+    }
+
+    m_map = m_file.map(0, size);
+    if (!m_map) {
+        m_error = QString("Couldn't map audio file '%1'").arg(fileName);
+        return;
+    }
+
+    if (!parse(m_map, size_t(size))) {
+        RG_DEBUG << "ctor: can't read" << fileName << ":" << m_error;
+        m_file.unmap(m_map);
+        m_map = nullptr;
+        m_data = nullptr;
+    }
+}
+
+MappedWavFile::~MappedWavFile()
+{
+    if (m_map)
+        m_file.unmap(m_map);
+}
+
+bool
+MappedWavFile::parse(const unsigned char *map, size_t size)
+{
+    if (size < 12  ||
+        memcmp(map, "RIFF", 4) != 0  ||
+        memcmp(map + 8, "WAVE", 4) != 0) {
+        m_error = "Not a RIFF WAVE file";
+        return false;
+    }
+
+    bool haveFormat = false;
+    size_t position = 12;
+
+    while (position + 8 <= size) {
+        const unsigned char *chunk = map + position;
+        const size_t chunkSize = readLE32(chunk + 4);
+        const size_t bodyStart = position + 8;
+
+        if (memcmp(chunk, "fmt ", 4) == 0) {
+
+            if (chunkSize < 16  ||  bodyStart + 16 > size) {
+                m_error = "Truncated format chunk";
+                return false;
+            }
+
+            const unsigned char *fmt = map + bodyStart;
+            unsigned int formatTag = readLE16(fmt);
+            m_channels = readLE16(fmt + 2);
+            m_sampleRate = readLE32(fmt + 4);
+            const unsigned int blockAlign = readLE16(fmt + 12);
+            m_bitsPerSample = readLE16(fmt + 14);
+
+            // The real format tag is the first two bytes of the
+            // SubFormat GUID.
+            if (formatTag == WAVE_FORMAT_EXTENSIBLE  &&
+                chunkSize >= 40  &&  bodyStart + 40 <= size)
+                formatTag = readLE16(fmt + 24);
+
+            if (formatTag == WAVE_FORMAT_PCM)
+                m_format = Rosegarden::getSampleFormat(false, m_bitsPerSample);
+            else if (formatTag == WAVE_FORMAT_IEEE_FLOAT)
+                m_format = Rosegarden::getSampleFormat(true, m_bitsPerSample);
+
+            if (m_format == SampleFormat::Unknown  ||  m_channels == 0) {
+                m_error = QString("Unsupported format (tag %1, %2 bits)").
+                        arg(formatTag).arg(m_bitsPerSample);
+                return false;
+            }
+
+            // Samples padded out to a larger container aren't handled.
+            m_bytesPerFrame = m_channels * getSampleSize(m_format);
+            if (blockAlign != m_bytesPerFrame) {
+                m_error = QString("Unsupported block alignment %1").
+                        arg(blockAlign);
+                return false;
+            }
+
+            haveFormat = true;
+
+        } else if (memcmp(chunk, "data", 4) == 0) {
+
+            if (!haveFormat) {
+                m_error = "Data chunk before format chunk";
+                return false;
+            }
+
+            // Files that were still being recorded, or are over 4GB,
+            // can have a size that is too big (often 0xFFFFFFFF).
+            // Just use whatever is there.
+            const size_t available = size - bodyStart;
+            const size_t dataSize = std::min(chunkSize, available);
+
+            m_data = map + bodyStart;
+            m_frames = dataSize / m_bytesPerFrame;
+            return true;
+        }
+
+        // Chunks are padded to an even length.
+        position = bodyStart + chunkSize + (chunkSize & 1);
+    }
+
+    m_error = haveFormat ? "No data chunk" : "No format chunk";
+    return false;
+}
+
+size_t
+MappedWavFile::getInterleavedFrames(size_t start, size_t count,
+                                    float *frames) const
+{
+    if (!m_data  ||  start >= m_frames)
+        return 0;
+
+    count = std::min(count, m_frames - start);
+
+    // Interleaved in, interleaved out, so the whole block is one
+    // contiguous conversion.
+    convertToFloat(m_data + start * m_bytesPerFrame, m_format,
+                   getSampleSize(m_format), frames, count * m_channels);
+
+    return count;
+}
+
+size_t
+MappedWavFile::getChannelFrames(unsigned int channel, size_t start,
+                                size_t count, float *target, bool add) const
+{
+    if (!m_data  ||  channel >= m_channels  ||  start >= m_frames)
+        return 0;
+
+    count = std::min(count, m_frames - start);
+
+    const unsigned char *source = m_data + start * m_bytesPerFrame +
+            channel * getSampleSize(m_format);
+
+    if (add)
+        addToFloat(source, m_format, m_bytesPerFrame, target, count);
+    else
+        convertToFloat(source, m_format, m_bytesPerFrame, target, count);
+
+    return count;
+}
+
+
+}
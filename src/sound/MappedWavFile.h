@@ -0,0 +1,107 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#ifndef RG_MAPPEDWAVFILE_H
+#define RG_MAPPEDWAVFILE_H
+
+#include "SampleConversion.h"
+
+#include <QFile>
+#include <QString>
+
+#include <rosegardenprivate_export.h>
+
+namespace Rosegarden
+{
+
+
+/// Read-only, memory-mapped access to the samples in a WAV or BWF file.
+/**
+ * The whole file is mapped and the RIFF header parsed once.  After that,
+ * reading is just sample conversion straight out of the mapping, with no
+ * copying through a stream buffer and no seeking.  The kernel takes care
+ * of read-ahead and caching, which suits the mostly sequential access of
+ * playback, peak generation and export.
+ *
+ * Handles PCM (8, 16, 24 and 32-bit) and 32-bit IEEE float, in either
+ * the plain or the WAVE_FORMAT_EXTENSIBLE form.  isOK() is false for
+ * anything else, in which case the caller should fall back to a
+ * stream-based reader.
+ */
+class ROSEGARDENPRIVATE_EXPORT MappedWavFile
+{
+public:
+    explicit MappedWavFile(const QString &fileName);
+    ~MappedWavFile();
+
+    bool isOK() const  { return m_data != nullptr; }
+    QString getError() const  { return m_error; }
+
+    unsigned int getChannels() const  { return m_channels; }
+    unsigned int getSampleRate() const  { return m_sampleRate; }
+    unsigned int getBitsPerSample() const  { return m_bitsPerSample; }
+    SampleFormat getSampleFormat() const  { return m_format; }
+    /// Size of one frame (a sample for each channel) in bytes.
+    size_t getBytesPerFrame() const  { return m_bytesPerFrame; }
+    size_t getFrameCount() const  { return m_frames; }
+
+    /// The raw contents of the data chunk, getDataSize() bytes.
+    const unsigned char *getData() const  { return m_data; }
+    size_t getDataSize() const  { return m_frames * m_bytesPerFrame; }
+
+    /// Convert frames to interleaved floats.
+    /**
+     * Fills frames with count * getChannels() samples starting at
+     * frame start.  Returns the number of frames converted, which is
+     * less than count at the end of the file.
+     */
+    size_t getInterleavedFrames(size_t start, size_t count,
+                                float *frames) const;
+
+    /// Convert one channel's samples to floats.
+    /**
+     * If add is true the samples are added to what is in target, which
+     * is handy for mixing down to fewer channels.  Returns the number of
+     * frames converted.
+     */
+    size_t getChannelFrames(unsigned int channel, size_t start, size_t count,
+                            float *target, bool add = false) const;
+
+private:
+    QFile m_file;
+    QString m_error;
+
+    /// Start of the mapping.
+    unsigned char *m_map;
+    /// Start of the data chunk within the mapping.
+    const unsigned char *m_data;
+
+    unsigned int m_channels;
+    unsigned int m_sampleRate;
+    unsigned int m_bitsPerSample;
+    SampleFormat m_format;
+    size_t m_bytesPerFrame;
+    size_t m_frames;
+
+    bool parse(const unsigned char *map, size_t size);
+
+    MappedWavFile(const MappedWavFile &); // not provided
+    MappedWavFile &operator=(const MappedWavFile &); // not provided
+};
+
+
+}
+
+#endif
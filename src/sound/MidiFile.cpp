@@ -37,11 +37,16 @@
 #include "misc/Strings.h"
 #include "sound/MappedBufMetaIterator.h"
 #include "sound/MidiInserter.h"
+#include "sound/MidiTrackEncoder.h"
 #include "sound/SortingInserter.h"
 
 #include <QProgressDialog>
+#include <QThread>
 
+#include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <memory>
 #include <string>
 #include <sstream>
 
@@ -1383,37 +1388,6 @@ MidiFile::writeLong(std::ofstream *midiFile, unsigned long number)
     *midiFile << static_cast<MidiByte>(number & 0x000000FF);
 }
 
-std::string
-MidiFile::longToVarBuffer(unsigned long value)
-{
-    // See WriteVarLen() in the MIDI Spec section 4, page 11.
-
-    // Convert value into a "variable-length quantity" in buffer.
-
-    // Start with the lowest 7 bits of the number
-    long buffer = value & 0x7f;
-
-    while ((value >>= 7 ) > 0) {
-        buffer <<= 8;
-        buffer |= 0x80;
-        buffer += (value & 0x7f);
-    }
-
-    // Copy buffer to returnString and return it.
-
-    std::string returnString;
-
-    while (true) {
-        returnString += (MidiByte)(buffer & 0xff);
-        if (buffer & 0x80)
-            buffer >>= 8;
-        else
-            break;
-    }
-
-    return returnString;
-}
-
 void
 MidiFile::writeHeader(std::ofstream *midiFile)
 {
@@ -1431,126 +1405,48 @@ MidiFile::writeHeader(std::ofstream *midiFile)
     writeInt(midiFile, m_timingDivision);
 }
 
-void
-MidiFile::writeTrack(std::ofstream *midiFile, TrackId trackNumber)
+namespace
 {
-    // For running status.
-    MidiByte previousEventCode = 0;
-
-    // First we write into trackBuffer, then we write trackBuffer
-    // out to the file with its accompanying length.
-
-    std::string trackBuffer;
-
-    // Used to accumulate time deltas for skipped events.
-    timeT skippedTime = 0;
-
-    // For each event in the Track
-    for (MidiTrack::iterator i = m_midiComposition[trackNumber].begin();
-         i != m_midiComposition[trackNumber].end();
-         ++i) {
-        const MidiEvent &midiEvent = **i;
-
-        // Do not write controller reset events to the buffer/file.
-        // HACK for #1404.  I gave up trying to find where the events
-        // were originating, and decided to try just stripping them.  If
-        // you can't do it right, do it badly, and somebody will
-        // eventually freak out, then fix it the right way.
-        // ??? This is created in ChannelManager::insertControllers().
-        // ??? Since we now have the "Allow Reset All Controllers" config
-        //     option, we can probably get rid of this and tell people to
-        //     use the config option.  If someone complains that 121's
-        //     aren't appearing in MIDI files, that's probably the route
-        //     we'll have to go.
-
-        // 2023-09 Lorenzo: added a check that this is a control change
-        // otherwise any midi event with data1 == 121 would get caught
-        if (
-                midiEvent.getEventCode() == MIDI_CTRL_CHANGE &&
-                midiEvent.getData1() == MIDI_CONTROLLER_RESET
-            ) {
-            RG_WARNING << "writeTrack(): Found controller 121.  Skipping.  This is a HACK to address BUG #1404.";
-
-            // Keep track of the timestamps from skipped events so we can
-            // add them to the next event that makes it through.
-            skippedTime += midiEvent.getTime();
-
-            continue;
+    typedef std::vector<MidiEvent *> EncoderTrack;
+
+    /// Encodes tracks for MidiFile::write().
+    /**
+     * Each thread takes the next track nobody has started on until
+     * there are none left.
+     */
+    class EncoderThread : public QThread
+    {
+    public:
+        EncoderThread(const std::vector<const EncoderTrack *> &tracks,
+                      std::vector<std::string> &chunks,
+                      std::atomic<size_t> &nextTrack,
+                      std::atomic<size_t> &finishedTracks) :
+            m_tracks(tracks),
+            m_chunks(chunks),
+            m_nextTrack(nextTrack),
+            m_finishedTracks(finishedTracks)
+        {
         }
 
-        // Add the time to the buffer in MIDI format
-        trackBuffer += longToVarBuffer(midiEvent.getTime() + skippedTime);
-
-        skippedTime = 0;
-
-        RG_DEBUG << "MIDI event for channel "
-                  << static_cast<int>(midiEvent.getChannelNumber())
-                  << " (track " << trackNumber << ") "
-                  << " time" << midiEvent.getTime();
-        RG_DEBUG << midiEvent;
-
-        if (midiEvent.isMeta()) {
-            trackBuffer += MIDI_FILE_META_EVENT;
-            trackBuffer += midiEvent.getMetaEventCode();
-
-            trackBuffer += longToVarBuffer(midiEvent.
-                                           getMetaMessage().length());
-            trackBuffer += midiEvent.getMetaMessage();
-
-            // Meta events cannot use running status.
-            previousEventCode = 0;
-
-        } else {  // non-meta event
-            // If the event code has changed, or this is a SYSEX event, we
-            // can't use running status.
-            // Running status is "[f]or Voice and Mode messages only."
-            // Sysex is a system message.  See the MIDI spec, Section 2,
-            // page 5.
-            if ((midiEvent.getEventCode() != previousEventCode) ||
-                (midiEvent.getEventCode() == MIDI_SYSTEM_EXCLUSIVE)) {
-
-                // Send the normal event code (with encoded channel information)
-                trackBuffer += midiEvent.getEventCode();
-
-                previousEventCode = midiEvent.getEventCode();
-            }
+    protected:
+        void run() override
+        {
+            while (true) {
+                const size_t index = m_nextTrack.fetch_add(1);
+                if (index >= m_tracks.size())
+                    break;
 
-            switch (midiEvent.getMessageType()) {
-            case MIDI_NOTE_ON:  // These have two data bytes.
-            case MIDI_NOTE_OFF:
-            case MIDI_PITCH_BEND:
-            case MIDI_CTRL_CHANGE:
-            case MIDI_POLY_AFTERTOUCH:
-                trackBuffer += midiEvent.getData1();
-                trackBuffer += midiEvent.getData2();
-                break;
-
-            case MIDI_PROG_CHANGE:  // These have one data byte.
-            case MIDI_CHNL_AFTERTOUCH:
-                trackBuffer += midiEvent.getData1();
-                break;
-
-            case MIDI_SYSTEM_EXCLUSIVE:
-                trackBuffer +=
-                        longToVarBuffer(midiEvent.getMetaMessage().length());
-                trackBuffer += midiEvent.getMetaMessage();
-                break;
-
-            default:
-                RG_WARNING << "writeTrack() - cannot write unsupported MIDI event: " << QString("0x%1").arg(midiEvent.getMessageType(), 0, 16);
-                break;
+                MidiTrackEncoder::encode(*m_tracks[index], m_chunks[index]);
+                m_finishedTracks.fetch_add(1);
             }
         }
 
-        // Kick the event loop to keep the UI responsive.
-        qApp->processEvents();
-    }
-
-    // Now we write the track to the file.
-
-    *midiFile << MIDI_TRACK_HEADER;
-    writeLong(midiFile, trackBuffer.length());
-    *midiFile << trackBuffer;
+    private:
+        const std::vector<const EncoderTrack *> &m_tracks;
+        std::vector<std::string> &m_chunks;
+        std::atomic<size_t> &m_nextTrack;
+        std::atomic<size_t> &m_finishedTracks;
+    };
 }
 
 bool
@@ -1565,19 +1461,52 @@ MidiFile::write(const QString &filename)
         return false;
     }
 
-    writeHeader(&midiFile);
+    // Encode the tracks in parallel, each into its own buffer.
+
+    std::vector<const EncoderTrack *> tracks(m_numberOfTracks);
+    for (TrackId i = 0; i < m_numberOfTracks; ++i)
+        tracks[i] = &m_midiComposition[i];
 
-    // For each track, write it out.
-    for (TrackId i = 0; i < m_numberOfTracks; ++i) {
-        writeTrack(&midiFile, i);
+    std::vector<std::string> chunks(tracks.size());
+    std::atomic<size_t> nextTrack(0);
+    std::atomic<size_t> finishedTracks(0);
 
-        if (m_progressDialog  &&  m_progressDialog->wasCanceled())
-            return false;
+    const size_t threadCount = std::min<size_t>(
+            tracks.size(), std::max(1, QThread::idealThreadCount()));
 
-        if (m_progressDialog)
-            m_progressDialog->setValue(i * 100 / m_numberOfTracks);
+    std::vector<std::unique_ptr<EncoderThread>> threads;
+    for (size_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back(new EncoderThread(
+                tracks, chunks, nextTrack, finishedTracks));
+        threads.back()->start();
     }
 
+    // Keep the UI alive (and the Cancel button working) while they run.
+    bool cancelled = false;
+    for (std::unique_ptr<EncoderThread> &thread : threads) {
+        while (!thread->wait(50)) {
+            if (m_progressDialog) {
+                if (m_progressDialog->wasCanceled()) {
+                    // Nothing new gets started.
+                    nextTrack.store(tracks.size());
+                    cancelled = true;
+                }
+                m_progressDialog->setValue(
+                        int(finishedTracks.load() * 100 / tracks.size()));
+            }
+            qApp->processEvents();
+        }
+    }
+
+    if (cancelled)
+        return false;
+
+    writeHeader(&midiFile);
+
+    // One write per track.
+    for (const std::string &chunk : chunks)
+        midiFile.write(chunk.data(), chunk.size());
+
     midiFile.close();
 
     return true;
@@ -172,9 +172,12 @@ private:
     // *** Rosegarden to Standard MIDI File
 
     /// Write m_midiComposition to a MIDI file.
+    /**
+     * The tracks are encoded in parallel by MidiTrackEncoder, then each
+     * is written out in one go.
+     */
     bool write(const QString &filename);
     void writeHeader(std::ofstream *midiFile);
-    void writeTrack(std::ofstream *midiFile, TrackId trackNumber);
 
     // Write
     /// Write an int as 2 bytes.
@@ -182,10 +185,6 @@ private:
     /// Write a long as 4 bytes.
     void writeLong(std::ofstream *midiFile, unsigned long number);
 
-    // Conversion
-    /// Convert a value to a "variable-length quantity" in a std::string.
-    std::string longToVarBuffer(unsigned long value);
-
     // *** Misc
 
     QPointer<QProgressDialog> m_progressDialog;
@@ -0,0 +1,197 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#define RG_MODULE_STRING "[MidiTrackEncoder]"
+
+#include "MidiTrackEncoder.h"
+
+#include "Midi.h"
+#include "MidiEvent.h"
+
+#include "misc/Debug.h"
+
+#include <cstring>
+
+
+namespace Rosegarden
+{
+
+
+namespace
+{
+    /// Bytes in the "MTrk" header and length.
+    const size_t trackHeaderSize = 8;
+
+    /// Longest "variable-length quantity" for an unsigned long.
+    const size_t maxVarLength = (sizeof(unsigned long) * 8 + 6) / 7;
+
+    /// Write value as a "variable-length quantity".
+    /**
+     * See WriteVarLen() in the MIDI Spec section 4, page 11.
+     */
+    unsigned char *writeVar(unsigned char *out, unsigned long value)
+    {
+        // Seven bits at a time, least significant first, then
+        // reversed on the way out.
+        unsigned char buffer[maxVarLength];
+        size_t count = 0;
+
+        do {
+            buffer[count++] = value & 0x7f;
+            value >>= 7;
+        } while (value > 0);
+
+        while (count > 1)
+            *out++ = buffer[--count] | 0x80;
+        *out++ = buffer[0];
+
+        return out;
+    }
+
+    unsigned char *writeString(unsigned char *out, const std::string &s)
+    {
+        memcpy(out, s.data(), s.size());
+        return out + s.size();
+    }
+
+    bool isControllerReset(const MidiEvent &midiEvent)
+    {
+        return midiEvent.getEventCode() == MIDI_CTRL_CHANGE  &&
+               midiEvent.getData1() == MIDI_CONTROLLER_RESET;
+    }
+}
+
+
+size_t
+MidiTrackEncoder::getMaxSize(const std::vector<MidiEvent *> &events)
+{
+    size_t size = trackHeaderSize;
+
+    for (const MidiEvent *midiEvent : events) {
+        // Time, then status and two data bytes or meta code and length.
+        size += maxVarLength + 2 + maxVarLength;
+        if (midiEvent->isMeta()  ||
+            midiEvent->getEventCode() == MIDI_SYSTEM_EXCLUSIVE)
+            size += midiEvent->getMetaMessage().size();
+    }
+
+    return size;
+}
+
+void
+MidiTrackEncoder::encode(const std::vector<MidiEvent *> &events,
+                         std::string &chunk)
+{
+    chunk.resize(getMaxSize(events));
+
+    unsigned char * const begin =
+            reinterpret_cast<unsigned char *>(&chunk[0]);
+    unsigned char *out = begin + trackHeaderSize;
+
+    // For running status.
+    MidiByte previousEventCode = 0;
+
+    // Used to accumulate time deltas for skipped events.
+    timeT skippedTime = 0;
+    int skipped = 0;
+
+    for (const MidiEvent *event : events) {
+        const MidiEvent &midiEvent = *event;
+
+        // Do not write controller reset events.  HACK for #1404.
+        // ??? This is created in ChannelManager::insertControllers().
+        //     Since we now have the "Allow Reset All Controllers"
+        //     config option, we can probably get rid of this.
+        if (isControllerReset(midiEvent)) {
+            // Keep track of the timestamps from skipped events so we
+            // can add them to the next event that makes it through.
+            skippedTime += midiEvent.getTime();
+            ++skipped;
+            continue;
+        }
+
+        out = writeVar(out, midiEvent.getTime() + skippedTime);
+
+        skippedTime = 0;
+
+        if (midiEvent.isMeta()) {
+            const std::string message = midiEvent.getMetaMessage();
+
+            *out++ = MIDI_FILE_META_EVENT;
+            *out++ = midiEvent.getMetaEventCode();
+            out = writeVar(out, message.size());
+            out = writeString(out, message);
+
+            // Meta events cannot use running status.
+            previousEventCode = 0;
+
+            continue;
+        }
+
+        // If the event code has changed, or this is a SYSEX event, we
+        // can't use running status.
+        // Running status is "[f]or Voice and Mode messages only."
+        // Sysex is a system message.  See the MIDI spec, Section 2,
+        // page 5.
+        if (midiEvent.getEventCode() != previousEventCode  ||
+            midiEvent.getEventCode() == MIDI_SYSTEM_EXCLUSIVE) {
+            *out++ = midiEvent.getEventCode();
+            previousEventCode = midiEvent.getEventCode();
+        }
+
+        switch (midiEvent.getMessageType()) {
+        case MIDI_NOTE_ON:  // These have two data bytes.
+        case MIDI_NOTE_OFF:
+        case MIDI_PITCH_BEND:
+        case MIDI_CTRL_CHANGE:
+        case MIDI_POLY_AFTERTOUCH:
+            *out++ = midiEvent.getData1();
+            *out++ = midiEvent.getData2();
+            break;
+
+        case MIDI_PROG_CHANGE:  // These have one data byte.
+        case MIDI_CHNL_AFTERTOUCH:
+            *out++ = midiEvent.getData1();
+            break;
+
+        case MIDI_SYSTEM_EXCLUSIVE: {
+            const std::string message = midiEvent.getMetaMessage();
+            out = writeVar(out, message.size());
+            out = writeString(out, message);
+            break;
+        }
+
+        default:
+            RG_WARNING << "encode() - cannot write unsupported MIDI event: " << QString("0x%1").arg(midiEvent.getMessageType(), 0, 16);
+            break;
+        }
+    }
+
+    if (skipped)
+        RG_WARNING << "encode(): Skipped" << skipped << "controller 121 events.  This is a HACK to address BUG #1404.";
+
+    // Fill in the header now the length is known.
+    const size_t length = out - begin - trackHeaderSize;
+    memcpy(begin, "MTrk", 4);
+    begin[4] = (length >> 24) & 0xff;
+    begin[5] = (length >> 16) & 0xff;
+    begin[6] = (length >> 8) & 0xff;
+    begin[7] = length & 0xff;
+
+    chunk.resize(out - begin);
+}
+
+
+}
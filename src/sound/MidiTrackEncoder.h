@@ -0,0 +1,55 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#ifndef RG_MIDITRACKENCODER_H
+#define RG_MIDITRACKENCODER_H
+
+#include <string>
+#include <vector>
+
+#include <rosegardenprivate_export.h>
+
+namespace Rosegarden
+{
+
+
+class MidiEvent;
+
+/// Encodes a track of MidiEvents as a Standard MIDI File track chunk.
+/**
+ * The events are expected to be in order with delta times, as left by
+ * MidiInserter.  The whole chunk, "MTrk" header and length included,
+ * is built in one buffer sized up front, so MidiFile::write() can put
+ * it out with a single write.
+ *
+ * Touches nothing but the events it is given, so several tracks can be
+ * encoded at once on different threads.
+ */
+class ROSEGARDENPRIVATE_EXPORT MidiTrackEncoder
+{
+public:
+    /// Encode events into chunk, replacing whatever was there.
+    static void encode(const std::vector<MidiEvent *> &events,
+                       std::string &chunk);
+
+private:
+    /// Most bytes encode() could need for events.
+    static size_t getMaxSize(const std::vector<MidiEvent *> &events);
+};
+
+
+}
+
+#endif
@@ -0,0 +1,514 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A MIDI and audio sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+
+    Other copyrights also apply to some parts of this work.  Please
+    see the AUTHORS file and individual file headers for details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#define RG_MODULE_STRING "[OnsetDetector]"
+
+#include "OnsetDetector.h"
+
+#include "AudioFile.h"
+#include "audiostream/AudioReadStream.h"
+#include "audiostream/AudioReadStreamFactory.h"
+#include "misc/Debug.h"
+
+#include <QScopedArrayPointer>
+#include <QScopedPointer>
+#include <QThread>
+
+#include <fftw3.h>
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace Rosegarden
+{
+
+
+const int OnsetDetector::frameSize = 1024;
+const int OnsetDetector::stepSize = 256;
+
+namespace
+{
+    // Resolution of the fine pass envelope, in samples.
+    const long envelopeBlock = 16;
+
+    // Half-width, in steps, of the neighbourhood used for peak picking.
+    const long peakWindow = 3;
+    const long meanWindow = 8;
+
+    /// Computes the spectral flux for a contiguous range of steps.
+    /**
+     * The plan is created in the constructor, which always runs on the
+     * caller's thread, as the FFTW planner is not thread-safe.
+     * fftwf_execute() on distinct plans is.
+     */
+    class FluxWorker : public QThread
+    {
+    public:
+        FluxWorker(const float *samples, long count,
+                   const float *window,
+                   long firstStep, long endStep,
+                   float *flux);
+        ~FluxWorker() override;
+
+        /// Do the work on the current thread.
+        void process();
+
+    protected:
+        void run() override  { process(); }
+
+    private:
+        const float *m_samples;
+        long m_count;
+        const float *m_window;
+        long m_firstStep;
+        long m_endStep;
+        float *m_flux;
+
+        float *m_in;
+        fftwf_complex *m_out;
+        fftwf_plan m_plan;
+
+        std::vector<float> m_previous;
+        std::vector<float> m_current;
+
+        /// Window and transform the frame centred on step into m_current.
+        void magnitudes(long step);
+    };
+
+    FluxWorker::FluxWorker(const float *samples, long count,
+                           const float *window,
+                           long firstStep, long endStep,
+                           float *flux) :
+        m_samples(samples),
+        m_count(count),
+        m_window(window),
+        m_firstStep(firstStep),
+        m_endStep(endStep),
+        m_flux(flux),
+        m_previous(OnsetDetector::frameSize / 2 + 1, 0.0f),
+        m_current(OnsetDetector::frameSize / 2 + 1, 0.0f)
+    {
+        const int n = OnsetDetector::frameSize;
+        m_in = (float *)fftwf_malloc(sizeof(float) * n);
+        m_out = (fftwf_complex *)fftwf_malloc(
+                sizeof(fftwf_complex) * (n / 2 + 1));
+        m_plan = fftwf_plan_dft_r2c_1d(n, m_in, m_out, FFTW_ESTIMATE);
+    }
+
+    FluxWorker::~FluxWorker()
+    {
+        fftwf_destroy_plan(m_plan);
+        fftwf_free(m_in);
+        fftwf_free(m_out);
+    }
+
+    void
+    FluxWorker::magnitudes(long step)
+    {
+        const int n = OnsetDetector::frameSize;
+        const long start = step * OnsetDetector::stepSize - n / 2;
+
+        if (start >= 0  &&  start + n <= m_count) {
+            // Straight multiply so that the compiler can vectorise it.
+            const float *source = m_samples + start;
+            for (int i = 0; i < n; ++i)
+                m_in[i] = source[i] * m_window[i];
+        } else {
+            // Zero-pad at either end of the input.
+            for (int i = 0; i < n; ++i) {
+                const long s = start + i;
+                m_in[i] = (s >= 0  &&  s < m_count) ?
+                        m_samples[s] * m_window[i] : 0.0f;
+            }
+        }
+
+        fftwf_execute(m_plan);
+
+        const int bins = n / 2 + 1;
+        float *current = &m_current[0];
+        for (int i = 0; i < bins; ++i) {
+            const float re = m_out[i][0];
+            const float im = m_out[i][1];
+            current[i] = re * re + im * im;
+        }
+        // Log compression evens out the contribution of loud and quiet
+        // partials.
+        for (int i = 0; i < bins; ++i)
+            current[i] = std::log1p(std::sqrt(current[i]));
+    }
+
+    void
+    FluxWorker::process()
+    {
+        if (m_firstStep >= m_endStep)
+            return;
+
+        const int bins = OnsetDetector::frameSize / 2 + 1;
+
+        if (m_firstStep > 0) {
+            magnitudes(m_firstStep - 1);
+            m_previous.swap(m_current);
+        }
+
+        for (long step = m_firstStep; step < m_endStep; ++step) {
+            magnitudes(step);
+
+            // Half-wave rectified difference: only rising energy counts.
+            float sum = 0.0f;
+            const float *current = &m_current[0];
+            const float *previous = &m_previous[0];
+            for (int i = 0; i < bins; ++i) {
+                const float d = current[i] - previous[i];
+                sum += (d > 0.0f ? d : 0.0f);
+            }
+            m_flux[step] = sum;
+
+            m_previous.swap(m_current);
+        }
+    }
+}
+
+OnsetDetector::OnsetDetector(unsigned int sampleRate, int sensitivity) :
+    m_sampleRate(sampleRate),
+    m_sensitivity(std::max(1, std::min(100, sensitivity))),
+    m_minimumGap(long(sampleRate) * 30 / 1000),
+    m_threadCount(std::max(1, QThread::idealThreadCount()))
+{
+}
+
+void
+OnsetDetector::setMinimumGap(const RealTime &gap)
+{
+    m_minimumGap = std::max(1L, RealTime::realTime2Frame(gap, m_sampleRate));
+}
+
+void
+OnsetDetector::setThreadCount(int threads)
+{
+    m_threadCount = std::max(1, threads);
+}
+
+void
+OnsetDetector::getOnsetEnvelope(const float *samples, long count,
+                                std::vector<float> &flux) const
+{
+    const long steps = count / stepSize + 1;
+    flux.assign(steps, 0.0f);
+
+    std::vector<float> window(frameSize);
+    for (int i = 0; i < frameSize; ++i)
+        window[i] = float(0.5 - 0.5 * cos(2 * M_PI * i / frameSize));
+
+    // Don't bother spreading tiny inputs across threads.
+    const long minStepsPerWorker = 512;
+    long workers = std::min(long(m_threadCount),
+                            std::max(1L, steps / minStepsPerWorker));
+    const long stepsPerWorker = (steps + workers - 1) / workers;
+
+    std::vector<FluxWorker *> pool;
+    for (long w = 0; w < workers; ++w) {
+        const long first = w * stepsPerWorker;
+        const long end = std::min(steps, first + stepsPerWorker);
+        pool.push_back(new FluxWorker(samples, count, &window[0],
+                                      first, end, &flux[0]));
+    }
+
+    if (pool.size() == 1) {
+        pool[0]->process();
+    } else {
+        for (size_t i = 0; i < pool.size(); ++i)
+            pool[i]->start();
+        for (size_t i = 0; i < pool.size(); ++i)
+            pool[i]->wait();
+    }
+
+    for (size_t i = 0; i < pool.size(); ++i)
+        delete pool[i];
+}
+
+std::vector<long>
+OnsetDetector::pickPeaks(const std::vector<float> &flux) const
+{
+    std::vector<long> peaks;
+
+    const long steps = long(flux.size());
+    if (steps == 0)
+        return peaks;
+
+    const float maxFlux = *std::max_element(flux.begin(), flux.end());
+    if (maxFlux <= 0.0f)
+        return peaks;
+
+    // Sensitivity 100 gives the lowest margin above the local mean.
+    const float delta =
+            0.03f + 0.47f * float(100 - m_sensitivity) / 99.0f;
+
+    // Running sum for the local mean.
+    std::vector<double> cumulative(steps + 1, 0.0);
+    for (long i = 0; i < steps; ++i)
+        cumulative[i + 1] = cumulative[i] + flux[i] / maxFlux;
+
+    for (long i = 0; i < steps; ++i) {
+        const float value = flux[i] / maxFlux;
+
+        const long meanFrom = std::max(0L, i - meanWindow);
+        const long meanTo = std::min(steps, i + meanWindow + 1);
+        const float mean = float((cumulative[meanTo] - cumulative[meanFrom]) /
+                                 (meanTo - meanFrom));
+        if (value < mean + delta)
+            continue;
+
+        // Must be the first maximum within the neighbourhood.
+        bool isPeak = true;
+        const long from = std::max(0L, i - peakWindow);
+        const long to = std::min(steps, i + peakWindow + 1);
+        for (long j = from; j < to && isPeak; ++j) {
+            if (j < i  &&  flux[j] >= flux[i]) isPeak = false;
+            if (j > i  &&  flux[j] > flux[i]) isPeak = false;
+        }
+
+        if (isPeak)
+            peaks.push_back(i);
+    }
+
+    return peaks;
+}
+
+long
+OnsetDetector::refine(const float *samples, long count,
+                      long from, long to) const
+{
+    from = std::max(0L, from);
+    to = std::min(count, to);
+    if (to - from < envelopeBlock)
+        return from;
+
+    // Peak envelope at a fine resolution.
+    const long blocks = (to - from) / envelopeBlock;
+    std::vector<float> envelope(blocks, 0.0f);
+    for (long b = 0; b < blocks; ++b) {
+        const float *block = samples + from + b * envelopeBlock;
+        float peak = 0.0f;
+        for (long i = 0; i < envelopeBlock; ++i)
+            peak = std::max(peak, std::fabs(block[i]));
+        envelope[b] = peak;
+    }
+
+    // The attack is the block that rises furthest above the level of
+    // the few blocks before it.
+    const long history = 4;
+    long best = 0;
+    float bestRise = -1.0f;
+    float bestFloor = 0.0f;
+    for (long b = 0; b < blocks; ++b) {
+        float floor = 0.0f;
+        for (long h = std::max(0L, b - history); h < b; ++h)
+            floor = std::max(floor, envelope[h]);
+        const float rise = envelope[b] - floor;
+        if (rise > bestRise) {
+            bestRise = rise;
+            best = b;
+            bestFloor = floor;
+        }
+    }
+
+    // Now down to the sample: the first one that clears the floor by a
+    // tenth of the rise.
+    const float level = bestFloor + 0.1f * bestRise;
+    const long start = from + std::max(0L, best - 1) * envelopeBlock;
+    const long end = from + (best + 1) * envelopeBlock;
+    for (long i = start; i < end; ++i) {
+        if (std::fabs(samples[i]) > level)
+            return i;
+    }
+
+    return from + best * envelopeBlock;
+}
+
+std::vector<long>
+OnsetDetector::findOnsets(const float *samples, long count) const
+{
+    if (!samples  ||  count <= 0)
+        return std::vector<long>();
+
+    std::vector<float> flux;
+    getOnsetEnvelope(samples, count, flux);
+
+    return findOnsets(samples, count, flux);
+}
+
+std::vector<long>
+OnsetDetector::findOnsets(const float *samples, long count,
+                          const std::vector<float> &flux) const
+{
+    std::vector<long> onsets;
+    if (!samples  ||  count <= 0)
+        return onsets;
+
+    const std::vector<long> peaks = pickPeaks(flux);
+
+    long previous = -m_minimumGap;
+
+    for (size_t i = 0; i < peaks.size(); ++i) {
+        // The frame for this step is centred on it, so the attack lies
+        // somewhere within it.
+        const long centre = peaks[i] * stepSize;
+        const long from = std::max(previous + m_minimumGap,
+                                   centre - frameSize / 2);
+        const long to = centre + frameSize / 2;
+        if (from >= to  ||  from >= count)
+            continue;
+
+        const long onset = refine(samples, count, from, to);
+        if (onset - previous < m_minimumGap)
+            continue;
+
+        onsets.push_back(onset);
+        previous = onset;
+    }
+
+    return onsets;
+}
+
+bool
+OnsetDetector::readMono(AudioFile *audioFile,
+                        const RealTime &startTime,
+                        const RealTime &endTime,
+                        std::vector<float> &samples,
+                        long &startFrame)
+{
+    samples.clear();
+    startFrame = 0;
+
+    if (!audioFile)
+        return false;
+
+    unsigned int sampleRate = 0;
+    return readMono(audioFile->getAbsoluteFilePath(), startTime, endTime,
+                    samples, startFrame, sampleRate);
+}
+
+bool
+OnsetDetector::readMono(const QString &fileName,
+                        const RealTime &startTime,
+                        const RealTime &endTime,
+                        std::vector<float> &samples,
+                        long &startFrame,
+                        unsigned int &sampleRate)
+{
+    samples.clear();
+    startFrame = 0;
+    sampleRate = 0;
+
+    if (endTime <= startTime)
+        return false;
+
+    QScopedPointer<AudioReadStream> stream;
+    try {
+        stream.reset(AudioReadStreamFactory::createReadStream(fileName));
+    } catch (...) {
+    }
+
+    if (!stream  ||  !stream->isOK()) {
+        RG_WARNING << "readMono(): Failed to read" << fileName;
+        return false;
+    }
+
+    const size_t channels = stream->getChannelCount();
+    const unsigned int rate = stream->getSampleRate();
+    sampleRate = rate;
+    startFrame = RealTime::realTime2Frame(startTime, rate);
+    const long endFrame = RealTime::realTime2Frame(endTime, rate);
+
+    // Read in blocks, mixing down to mono as we go.
+    const long blockFrames = 65536;
+    QScopedArrayPointer<float> block(new float[blockFrames * channels]);
+
+    samples.reserve(endFrame - startFrame);
+
+    long position = 0;
+    while (position < endFrame) {
+        const long want = std::min(blockFrames, endFrame - position);
+        const long got = long(stream->getInterleavedFrames(want, block.data()));
+
+        const long skip = std::max(0L, std::min(got, startFrame - position));
+        const float scale = 1.0f / float(channels);
+        for (long i = skip; i < got; ++i) {
+            const float *frame = block.data() + i * channels;
+            float sum = 0.0f;
+            for (size_t c = 0; c < channels; ++c)
+                sum += frame[c];
+            samples.push_back(sum * scale);
+        }
+
+        position += got;
+        if (got < want)
+            break;
+    }
+
+    return true;
+}
+
+std::vector<long>
+OnsetDetector::findOnsets(AudioFile *audioFile,
+                          const RealTime &startTime,
+                          const RealTime &endTime) const
+{
+    if (!audioFile)
+        return std::vector<long>();
+
+    OnsetAnalysis analysis;
+    if (!analyse(audioFile->getAbsoluteFilePath(), startTime, endTime,
+                 analysis))
+        return std::vector<long>();
+
+    return findOnsets(analysis);
+}
+
+bool
+OnsetDetector::analyse(const QString &fileName,
+                       const RealTime &startTime,
+                       const RealTime &endTime,
+                       OnsetAnalysis &analysis) const
+{
+    analysis = OnsetAnalysis();
+
+    if (!readMono(fileName, startTime, endTime, analysis.samples,
+                  analysis.startFrame, analysis.sampleRate))
+        return false;
+
+    getOnsetEnvelope(analysis.samples.data(), long(analysis.samples.size()),
+                     analysis.envelope);
+
+    return true;
+}
+
+std::vector<long>
+OnsetDetector::findOnsets(const OnsetAnalysis &analysis) const
+{
+    std::vector<long> onsets = findOnsets(analysis.samples.data(),
+                                          long(analysis.samples.size()),
+                                          analysis.envelope);
+
+    for (size_t i = 0; i < onsets.size(); ++i)
+        onsets[i] += analysis.startFrame;
+
+    return onsets;
+}
+
+}
@@ -0,0 +1,168 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A MIDI and audio sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+
+    Other copyrights also apply to some parts of this work.  Please
+    see the AUTHORS file and individual file headers for details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#ifndef RG_ONSETDETECTOR_H
+#define RG_ONSETDETECTOR_H
+
+#include "base/RealTime.h"
+
+#include <QString>
+
+#include <vector>
+
+#include <rosegardenprivate_export.h>
+
+namespace Rosegarden
+{
+
+
+class AudioFile;
+
+
+/// A region of an audio file, read and analysed by OnsetDetector.
+/**
+ * Keep one of these to find the onsets at several sensitivities without
+ * reading and transforming the audio again each time.  It holds the whole
+ * region as mono samples, four bytes per frame.
+ */
+struct OnsetAnalysis
+{
+    unsigned int sampleRate{0};
+    /// Sample frame offset of samples[0] from the start of the file.
+    long startFrame{0};
+    std::vector<float> samples;
+    /// See OnsetDetector::getOnsetEnvelope().
+    std::vector<float> envelope;
+};
+
+
+/// Transient (onset) detection for audio material.
+/**
+ * Onsets are found in two passes.  The coarse pass computes the
+ * half-wave rectified spectral flux of overlapping FFT frames and picks
+ * peaks above an adaptive threshold.  The fine pass then looks at the
+ * samples around each peak to find the sample at which the attack
+ * actually starts, so the results are sample accurate and can be used
+ * directly as split points or slice positions.
+ *
+ * The coarse pass is split into contiguous blocks of frames which are
+ * analysed concurrently, one FFTW plan per worker.
+ *
+ * Used by AudioFileManager::getOnsetSplitPoints() for the "split on
+ * transients" mode of AudioSegmentAutoSplitCommand.  AudioSplitDialog
+ * keeps an OnsetAnalysis so it can show the splits for each sensitivity
+ * as it is changed.
+ */
+class ROSEGARDENPRIVATE_EXPORT OnsetDetector
+{
+public:
+    /**
+     * sensitivity is in the range 1 to 100.  Higher values find
+     * quieter onsets.
+     */
+    OnsetDetector(unsigned int sampleRate, int sensitivity);
+
+    /// Onsets closer together than this are merged.  Default 30msec.
+    void setMinimumGap(const RealTime &gap);
+
+    /// Number of concurrent analysis blocks.  Default is one per core.
+    void setThreadCount(int threads);
+
+    /// Find the onsets in a mono buffer.
+    /**
+     * Returns the sample offsets of the onsets, in ascending order.
+     */
+    std::vector<long> findOnsets(const float *samples, long count) const;
+
+    /// As above, but using an envelope from getOnsetEnvelope().
+    std::vector<long> findOnsets(const float *samples, long count,
+                                 const std::vector<float> &envelope) const;
+
+    /// Find the onsets in a region of an audio file.
+    /**
+     * The channels are mixed down before analysis.  Returns sample
+     * frame offsets from the start of the file, in ascending order.
+     * Returns an empty vector if the file cannot be read.
+     */
+    std::vector<long> findOnsets(AudioFile *audioFile,
+                                 const RealTime &startTime,
+                                 const RealTime &endTime) const;
+
+    /// As above, but for a region analysed already by analyse().
+    std::vector<long> findOnsets(const OnsetAnalysis &analysis) const;
+
+    /// Read a region of an audio file and compute its onset envelope.
+    /**
+     * This is the expensive part of findOnsets(), and doesn't depend on
+     * the sensitivity or the minimum gap.  Returns false if the file
+     * cannot be read.
+     */
+    bool analyse(const QString &fileName,
+                 const RealTime &startTime,
+                 const RealTime &endTime,
+                 OnsetAnalysis &analysis) const;
+
+    /// The onset strength (spectral flux) of a mono buffer.
+    /**
+     * There is one value per stepSize samples, each for the frame
+     * centred on that step.
+     */
+    void getOnsetEnvelope(const float *samples, long count,
+                          std::vector<float> &envelope) const;
+
+    /// Read a region of an audio file, mixed down to mono.
+    /**
+     * startFrame is set to the sample frame offset of the region from
+     * the start of the file.  Returns false if the file cannot be read.
+     */
+    static bool readMono(AudioFile *audioFile,
+                         const RealTime &startTime,
+                         const RealTime &endTime,
+                         std::vector<float> &samples,
+                         long &startFrame);
+
+    /// As above, given the file's absolute path.
+    /**
+     * sampleRate is set to the file's sample rate.
+     */
+    static bool readMono(const QString &fileName,
+                         const RealTime &startTime,
+                         const RealTime &endTime,
+                         std::vector<float> &samples,
+                         long &startFrame,
+                         unsigned int &sampleRate);
+
+    static const int frameSize;
+    static const int stepSize;
+
+private:
+    unsigned int m_sampleRate;
+    int m_sensitivity;
+    long m_minimumGap;
+    int m_threadCount;
+
+    /// Pick the steps whose flux stands out from its neighbourhood.
+    std::vector<long> pickPeaks(const std::vector<float> &flux) const;
+    /// Fine pass: find the first sample of the attack near a peak.
+    long refine(const float *samples, long count,
+                long from, long to) const;
+};
+
+
+}
+
+#endif
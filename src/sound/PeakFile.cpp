@@ -28,6 +28,8 @@
 
 #include "PeakFile.h"
 #include "AudioFile.h"
+#include "MappedWavFile.h"
+#include "SampleConversion.h"
 //#include "base/Profiler.h"
 #include "misc/Debug.h"
 #include "misc/Strings.h"
@@ -486,7 +488,7 @@ PeakFile::writePeaks(std::ofstream *file)
     //
     std::vector<std::pair<int, int> > channelPeaks;
     std::string samples;
-    unsigned char *samplePtr;
+    const unsigned char *samplePtr;
 
     int sampleValue;
     int sampleMax = 0 ;
@@ -499,6 +501,29 @@ PeakFile::writePeaks(std::ofstream *file)
     if (bytes == 3 || bytes == 4) // 24-bit PCM or 32-bit float
         m_format = 2; // write 16-bit PCM instead
 
+    // 32-bit is IEEE float (enforced by RIFFAudioFile)
+    const SampleFormat sampleFormat = getSampleFormat(bytes == 4, bytes * 8);
+
+    // Scale from the converted floats back to the integer peak values.
+    // Single byte format values range from 0-255 and are shifted down
+    // about the x-axis by the conversion.  24-bit is truncated to 16.
+    double sampleScale = 32768.0;
+    if (bytes == 1)
+        sampleScale = 128.0;
+    else if (bytes == 4)
+        sampleScale = 32767.0;
+
+    const size_t blockBytes = size_t(m_blockSize) * channels * bytes;
+    std::vector<float> blockSamples(size_t(m_blockSize) * channels);
+
+    // Read straight from a mapping of the file where we can, rather
+    // than copying every block through the stream.
+    MappedWavFile mappedFile(m_audioFile->getAbsoluteFilePath());
+    const bool useMapping = mappedFile.isOK()  &&
+            mappedFile.getSampleFormat() == sampleFormat  &&
+            int(mappedFile.getChannels()) == channels;
+    size_t mappedOffset = 0;
+
     // for the progress dialog
     size_t apprxTotalBytes = m_audioFile->getSize();
     size_t byteCount = 0;
@@ -516,24 +541,32 @@ PeakFile::writePeaks(std::ofstream *file)
 
     // ??? for each block...?
     while (true) {
-        try {
-            // Read a block
-            samples = m_audioFile->
-                      getBytes(m_blockSize * channels * bytes);
-        } catch (const BadSoundFileException &e) {
-            RG_WARNING << "writePeaks():" << e.getMessage();
-            break;
-        }
+        if (useMapping) {
+            // Stop at the first incomplete block, as below.
+            if (mappedOffset + blockBytes > mappedFile.getDataSize())
+                break;
 
-        // If no bytes or less than the total number of bytes are returned
-        // then break out
-        //
-        if (samples.length() == 0 ||
-            samples.length() < (m_blockSize * m_audioFile->getChannels()
-                                * bytes))
-            break;
+            samplePtr = mappedFile.getData() + mappedOffset;
+            mappedOffset += blockBytes;
+        } else {
+            try {
+                // Read a block
+                samples = m_audioFile->getBytes(blockBytes);
+            } catch (const BadSoundFileException &e) {
+                RG_WARNING << "writePeaks():" << e.getMessage();
+                break;
+            }
 
-        byteCount += samples.length();
+            // If no bytes or less than the total number of bytes are
+            // returned then break out
+            //
+            if (samples.length() == 0 || samples.length() < blockBytes)
+                break;
+
+            samplePtr = (const unsigned char *)samples.data();
+        }
+
+        byteCount += blockBytes;
 
 #if !TEST_PROGRESS_DIALOG
         // ??? Every 2000 blocks?  That's around 2Mbytes?
@@ -562,44 +595,19 @@ PeakFile::writePeaks(std::ofstream *file)
         }
         ++ct;
 
-        samplePtr = (unsigned char *)samples.c_str();
+        if (sampleFormat == SampleFormat::Unknown)
+            throw(BadSoundFileException(m_absoluteFilePath, "PeakFile::writePeaks - unsupported bit depth"));
+
+        // Convert the whole block in one go.
+        convertToFloat(samplePtr, sampleFormat, bytes,
+                       blockSamples.data(), blockSamples.size());
+        const float *blockPtr = blockSamples.data();
 
         for (int i = 0; i < m_blockSize; i++) {
-            for (unsigned int ch = 0; ch < m_audioFile->getChannels(); ch++) {
-                // Single byte format values range from 0-255 and then
-                // shifted down about the x-axis.  Double byte and above
-                // are already centred about x-axis.
-                //
-                if (bytes == 1) {
-                    // get value
-                    sampleValue = int(*samplePtr) - 128;
-                    samplePtr++;
-                } else if (bytes == 2) {
-                    unsigned char b2 = samplePtr[0];
-                    unsigned char b1 = samplePtr[1];
-                    unsigned int bits = (b1 << 8) + b2;
-                    sampleValue = (short)bits;
-                    samplePtr += 2;
-                } else if (bytes == 3) {
-                    unsigned char b3 = samplePtr[0];
-                    unsigned char b2 = samplePtr[1];
-                    unsigned char b1 = samplePtr[2];
-                    unsigned int bits = (b1 << 24) + (b2 << 16) + (b3 << 8);
-
-                    // write out as 16-bit (m_format == 2)
-                    sampleValue = int(bits) / 65536;
-
-                    samplePtr += 3;
-                } else if (bytes == 4)  // IEEE float (enforced by RIFFAudioFile)
-                {
-                    // write out as 16-bit (m_format == 2)
-                    // cppcheck-suppress invalidPointerCast
-                    float val = *(float *)samplePtr;
-                    sampleValue = (int)(32767.0 * val);
-                    samplePtr += 4;
-                } else {
-                    throw(BadSoundFileException(m_absoluteFilePath, "PeakFile::writePeaks - unsupported bit depth"));
-                }
+            for (int ch = 0; ch < channels; ch++) {
+                // Exact for the integer formats, and the same
+                // truncation as before for 24-bit and float.
+                sampleValue = int(sampleScale * *blockPtr++);
 
                 // First time for each channel
                 //
@@ -630,7 +638,7 @@ PeakFile::writePeaks(std::ofstream *file)
 
         // Write absolute peak data in channel order
         //
-        for (unsigned int i = 0; i < m_audioFile->getChannels(); i++) {
+        for (int i = 0; i < channels; i++) {
             putBytes(file, getLittleEndianFromInteger(channelPeaks[i].first,
                      m_format));
             putBytes(file, getLittleEndianFromInteger(channelPeaks[i].second,
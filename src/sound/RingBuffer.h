@@ -20,6 +20,9 @@
 #include <sys/mman.h>
 #include <string.h>
 
+#include <algorithm>
+#include <atomic>
+
 #include "Scavenger.h"
 
 //#define DEBUG_RINGBUFFER 1
@@ -46,6 +49,14 @@ namespace Rosegarden {
  * For efficiency, RingBuffer frequently initialises samples by
  * writing zeroes into their memory space, so T should normally be a
  * simple type that can safely be set to zero using memset.
+ *
+ * The writer publishes its position with a release store after the
+ * data is in place, and each reader does likewise after it has
+ * finished with the data, so the other side's acquire load sees the
+ * samples as well as the position.  Each position is on a cache line
+ * of its own so that the writer and readers don't contend for one.
+ *
+ * See FrameRingBuffer for interleaved multi-channel data.
  */
 
 template <typename T, int N = 1>
@@ -180,12 +191,56 @@ public:
      */
     size_t zero(size_t n);
 
+    /**
+     * Direct access to the samples available for reading by reader R,
+     * without copying them.  They are returned as two regions, the
+     * second of which is only non-empty if the data wraps around the
+     * end of the buffer.  Returns the total number of samples.  Call
+     * skip() when done with them.
+     */
+    size_t getReadRegions(const T *&first, size_t &firstCount,
+                          const T *&second, size_t &secondCount,
+                          int R = 0) const;
+
+    /**
+     * Direct access to the space available for writing, as for
+     * getReadRegions().  Returns the total number of samples that
+     * may be written.  Call commitWrite() to make them readable.
+     */
+    size_t getWriteRegions(T *&first, size_t &firstCount,
+                           T *&second, size_t &secondCount);
+
+    /**
+     * Make n samples written through getWriteRegions() available to
+     * the readers.  Returns the number of samples actually committed.
+     */
+    size_t commitWrite(size_t n);
+
 protected:
+    /// Keeps each position on its own cache line.
+    struct Position
+    {
+        std::atomic<size_t> value;
+        char padding[64 - sizeof(std::atomic<size_t>)];
+    };
+
     T               *m_buffer;
-    volatile size_t  m_writer;
-    volatile size_t  m_readers[N];
     size_t           m_size;
     bool             m_mlocked;
+    char             m_padding[64];
+    Position         m_writer;
+    Position         m_readers[N];
+
+    /// Position p moved on by n, where n < m_size.
+    size_t advance(size_t p, size_t n) const
+    {
+        p += n;
+        return (p >= m_size ? p - m_size : p);
+    }
+
+    /// Read space given the two positions.
+    size_t readSpace(size_t writer, size_t reader) const
+        { return (writer >= reader ? writer - reader : writer + m_size - reader); }
 
     static Scavenger<ScavengerArrayWrapper<T> > m_scavenger;
 
@@ -200,7 +255,6 @@ Scavenger<ScavengerArrayWrapper<T> > RingBuffer<T, N>::m_scavenger;
 template <typename T, int N>
 RingBuffer<T, N>::RingBuffer(size_t n) :
     m_buffer(new T[n + 1]),
-    m_writer(0),
     m_size(n + 1),
     m_mlocked(false)
 {
@@ -208,7 +262,8 @@ RingBuffer<T, N>::RingBuffer(size_t n) :
     std::cerr << "RingBuffer<T," << N << ">[" << this << "]::RingBuffer(" << n << ") [now have " << (++extant_ringbuffers) << "]" << std::endl;
 #endif
 
-    for (int i = 0; i < N; ++i) m_readers[i] = 0;
+    m_writer.value.store(0);
+    for (int i = 0; i < N; ++i) m_readers[i].value.store(0);
 
     m_scavenger.scavenge();
 }
@@ -287,14 +342,12 @@ RingBuffer<T, N>::resized(int newSize, int R) const
 {
     RingBuffer<T, N> *newBuffer = new RingBuffer<T, N>(newSize);
 
-    int w = m_writer;
-    int r = m_readers[R];
+    const T *first, *second;
+    size_t firstCount, secondCount;
+    getReadRegions(first, firstCount, second, secondCount, R);
 
-    while (r != w) {
-        T value = m_buffer[r];
-        newBuffer->write(&value, 1);
-        if (++r == (int)m_size) r = 0;
-    }
+    newBuffer->write(first, firstCount);
+    newBuffer->write(second, secondCount);
 
     return newBuffer;
 }
@@ -335,20 +388,18 @@ RingBuffer<T, N>::reset()
     std::cerr << "RingBuffer<T," << N << ">[" << this << "]::reset" << std::endl;
 #endif
 
-    m_writer = 0;
-    for (int i = 0; i < N; ++i) m_readers[i] = 0;
+    m_writer.value.store(0, std::memory_order_release);
+    for (int i = 0; i < N; ++i)
+        m_readers[i].value.store(0, std::memory_order_release);
 }
 
 template <typename T, int N>
 size_t
 RingBuffer<T, N>::getReadSpace(int R) const
 {
-    size_t writer = m_writer;
-    size_t reader = m_readers[R];
-    size_t space = 0;
-
-    if (writer > reader) space = writer - reader;
-    else space = ((writer + m_size) - reader) % m_size;
+    const size_t writer = m_writer.value.load(std::memory_order_acquire);
+    const size_t reader = m_readers[R].value.load(std::memory_order_relaxed);
+    const size_t space = readSpace(writer, reader);
 
 #ifdef DEBUG_RINGBUFFER
     std::cerr << "RingBuffer<T," << N << ">[" << this << "]::getReadSpace(" << R << "): " << space << std::endl;
@@ -361,18 +412,22 @@ template <typename T, int N>
 size_t
 RingBuffer<T, N>::getWriteSpace() const
 {
+    const size_t writer = m_writer.value.load(std::memory_order_relaxed);
+
     size_t space = 0;
     for (int i = 0; i < N; ++i) {
-        size_t here = (m_readers[i] + m_size - m_writer - 1) % m_size;
+        const size_t reader =
+                m_readers[i].value.load(std::memory_order_acquire);
+        const size_t here = m_size - 1 - readSpace(writer, reader);
         if (i == 0 || here < space) space = here;
     }
 
 #ifdef DEBUG_RINGBUFFER
-    size_t rs(getReadSpace()), rp(m_readers[0]);
+    size_t rs(getReadSpace()), rp(m_readers[0].value.load());
 
     std::cerr << "RingBuffer: write space " << space << ", read space "
               << rs << ", total " << (space + rs) << ", m_size " << m_size << std::endl;
-    std::cerr << "RingBuffer: reader " << rp << ", writer " << m_writer << std::endl;
+    std::cerr << "RingBuffer: reader " << rp << ", writer " << writer << std::endl;
 #endif
 
 #ifdef DEBUG_RINGBUFFER
@@ -401,18 +456,20 @@ RingBuffer<T, N>::read(T *destination, size_t n, int R)
     }
     if (n == 0) return n;
 
-    size_t here = m_size - m_readers[R];
+    const size_t reader = m_readers[R].value.load(std::memory_order_relaxed);
+
+    size_t here = m_size - reader;
     if (here >= n) {
-        memcpy(destination, m_buffer + m_readers[R], n * sizeof(T));
+        memcpy(destination, m_buffer + reader, n * sizeof(T));
     } else {
-        memcpy(destination, m_buffer + m_readers[R], here * sizeof(T));
+        memcpy(destination, m_buffer + reader, here * sizeof(T));
         memcpy(destination + here, m_buffer, (n - here) * sizeof(T));
     }
 
-    m_readers[R] = (m_readers[R] + n) % m_size;
+    m_readers[R].value.store(advance(reader, n), std::memory_order_release);
 
 #ifdef DEBUG_RINGBUFFER
-    std::cerr << "RingBuffer<T," << N << ">[" << this << "]::read: read " << n << ", reader now " << m_readers[R] << std::endl;
+    std::cerr << "RingBuffer<T," << N << ">[" << this << "]::read: read " << n << ", reader now " << advance(reader, n) << std::endl;
 #endif
 
     return n;
@@ -436,22 +493,24 @@ RingBuffer<T, N>::readAdding(T *destination, size_t n, int R)
     }
     if (n == 0) return n;
 
-    size_t here = m_size - m_readers[R];
+    const size_t reader = m_readers[R].value.load(std::memory_order_relaxed);
+
+    size_t here = m_size - reader;
 
     if (here >= n) {
         for (size_t i = 0; i < n; ++i) {
-            destination[i] += (m_buffer + m_readers[R])[i];
+            destination[i] += (m_buffer + reader)[i];
         }
     } else {
         for (size_t i = 0; i < here; ++i) {
-            destination[i] += (m_buffer + m_readers[R])[i];
+            destination[i] += (m_buffer + reader)[i];
         }
         for (size_t i = 0; i < (n - here); ++i) {
             destination[i + here] += m_buffer[i];
         }
     }
 
-    m_readers[R] = (m_readers[R] + n) % m_size;
+    m_readers[R].value.store(advance(reader, n), std::memory_order_release);
     return n;
 }
 
@@ -463,7 +522,7 @@ RingBuffer<T, N>::readOne(int R)
     std::cerr << "RingBuffer<T," << N << ">[" << this << "]::readOne(" << R << ")" << std::endl;
 #endif
 
-    if (m_writer == m_readers[R]) {
+    if (getReadSpace(R) == 0) {
 #ifdef DEBUG_RINGBUFFER
         std::cerr << "WARNING: No sample available"
                   << std::endl;
@@ -472,8 +531,10 @@ RingBuffer<T, N>::readOne(int R)
         memset(&t, 0, sizeof(T));
         return t;
     }
-    T value = m_buffer[m_readers[R]];
-    if (++m_readers[R] == m_size) m_readers[R] = 0;
+
+    const size_t reader = m_readers[R].value.load(std::memory_order_relaxed);
+    T value = m_buffer[reader];
+    m_readers[R].value.store(advance(reader, 1), std::memory_order_release);
     return value;
 }
 
@@ -488,20 +549,22 @@ RingBuffer<T, N>::peek(T *destination, size_t n, int R) const
     size_t available = getReadSpace(R);
     if (n > available) {
 #ifdef DEBUG_RINGBUFFER
-	std::cerr << "WARNING: Only " << available << " samples available"
-		  << std::endl;
+        std::cerr << "WARNING: Only " << available << " samples available"
+                  << std::endl;
 #endif
-	memset(destination + available, 0, (n - available) * sizeof(T));
-	n = available;
+        memset(destination + available, 0, (n - available) * sizeof(T));
+        n = available;
     }
     if (n == 0) return n;
 
-    size_t here = m_size - m_readers[R];
+    const size_t reader = m_readers[R].value.load(std::memory_order_relaxed);
+
+    size_t here = m_size - reader;
     if (here >= n) {
-	memcpy(destination, m_buffer + m_readers[R], n * sizeof(T));
+        memcpy(destination, m_buffer + reader, n * sizeof(T));
     } else {
-	memcpy(destination, m_buffer + m_readers[R], here * sizeof(T));
-	memcpy(destination + here, m_buffer, (n - here) * sizeof(T));
+        memcpy(destination, m_buffer + reader, here * sizeof(T));
+        memcpy(destination + here, m_buffer, (n - here) * sizeof(T));
     }
 
 #ifdef DEBUG_RINGBUFFER
@@ -519,7 +582,7 @@ RingBuffer<T, N>::peek(int R) const
     std::cerr << "RingBuffer<T," << N << ">[" << this << "]::peek(" << R << ")" << std::endl;
 #endif
 
-    if (m_writer == m_readers[R]) {
+    if (getReadSpace(R) == 0) {
 #ifdef DEBUG_RINGBUFFER
         std::cerr << "WARNING: No sample available"
                   << std::endl;
@@ -528,7 +591,7 @@ RingBuffer<T, N>::peek(int R) const
         memset(&t, 0, sizeof(T));
         return t;
     }
-    T value = m_buffer[m_readers[R]];
+    T value = m_buffer[m_readers[R].value.load(std::memory_order_relaxed)];
     return value;
 }
 
@@ -549,7 +612,9 @@ RingBuffer<T, N>::skip(size_t n, int R)
         n = available;
     }
     if (n == 0) return n;
-    m_readers[R] = (m_readers[R] + n) % m_size;
+
+    const size_t reader = m_readers[R].value.load(std::memory_order_relaxed);
+    m_readers[R].value.store(advance(reader, n), std::memory_order_release);
     return n;
 }
 
@@ -571,18 +636,20 @@ RingBuffer<T, N>::write(const T *source, size_t n)
     }
     if (n == 0) return n;
 
-    size_t here = m_size - m_writer;
+    const size_t writer = m_writer.value.load(std::memory_order_relaxed);
+
+    size_t here = m_size - writer;
     if (here >= n) {
-        memcpy(m_buffer + m_writer, source, n * sizeof(T));
+        memcpy(m_buffer + writer, source, n * sizeof(T));
     } else {
-        memcpy(m_buffer + m_writer, source, here * sizeof(T));
+        memcpy(m_buffer + writer, source, here * sizeof(T));
         memcpy(m_buffer, source + here, (n - here) * sizeof(T));
     }
 
-    m_writer = (m_writer + n) % m_size;
+    m_writer.value.store(advance(writer, n), std::memory_order_release);
 
 #ifdef DEBUG_RINGBUFFER
-    std::cerr << "RingBuffer<T," << N << ">[" << this << "]::write: wrote " << n << ", writer now " << m_writer << std::endl;
+    std::cerr << "RingBuffer<T," << N << ">[" << this << "]::write: wrote " << n << ", writer now " << advance(writer, n) << std::endl;
 #endif
 
     return n;
@@ -606,15 +673,63 @@ RingBuffer<T, N>::zero(size_t n)
     }
     if (n == 0) return n;
 
-    size_t here = m_size - m_writer;
+    const size_t writer = m_writer.value.load(std::memory_order_relaxed);
+
+    size_t here = m_size - writer;
     if (here >= n) {
-        memset(m_buffer + m_writer, 0, n * sizeof(T));
+        memset(m_buffer + writer, 0, n * sizeof(T));
     } else {
-        memset(m_buffer + m_writer, 0, here * sizeof(T));
+        memset(m_buffer + writer, 0, here * sizeof(T));
         memset(m_buffer, 0, (n - here) * sizeof(T));
     }
 
-    m_writer = (m_writer + n) % m_size;
+    m_writer.value.store(advance(writer, n), std::memory_order_release);
+    return n;
+}
+
+template <typename T, int N>
+size_t
+RingBuffer<T, N>::getReadRegions(const T *&first, size_t &firstCount,
+                                 const T *&second, size_t &secondCount,
+                                 int R) const
+{
+    const size_t n = getReadSpace(R);
+    const size_t reader = m_readers[R].value.load(std::memory_order_relaxed);
+
+    first = m_buffer + reader;
+    firstCount = std::min(n, m_size - reader);
+    second = m_buffer;
+    secondCount = n - firstCount;
+
+    return n;
+}
+
+template <typename T, int N>
+size_t
+RingBuffer<T, N>::getWriteRegions(T *&first, size_t &firstCount,
+                                  T *&second, size_t &secondCount)
+{
+    const size_t n = getWriteSpace();
+    const size_t writer = m_writer.value.load(std::memory_order_relaxed);
+
+    first = m_buffer + writer;
+    firstCount = std::min(n, m_size - writer);
+    second = m_buffer;
+    secondCount = n - firstCount;
+
+    return n;
+}
+
+template <typename T, int N>
+size_t
+RingBuffer<T, N>::commitWrite(size_t n)
+{
+    const size_t available = getWriteSpace();
+    if (n > available) n = available;
+    if (n == 0) return n;
+
+    const size_t writer = m_writer.value.load(std::memory_order_relaxed);
+    m_writer.value.store(advance(writer, n), std::memory_order_release);
     return n;
 }
 
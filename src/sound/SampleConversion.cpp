@@ -0,0 +1,251 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#include "SampleConversion.h"
+
+#include <cstdint>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+namespace Rosegarden
+{
+
+
+namespace
+{
+    // One loader per format.  Each reads a single little-endian sample.
+    // Byte-wise assembly keeps them independent of host endianness and
+    // alignment, and compilers turn the fixed-stride loops below into
+    // vector code.
+
+    struct Unsigned8
+    {
+        static const size_t size = 1;
+        static float load(const unsigned char *p)
+            { return (int(p[0]) - 128) * (1.0f / 128.0f); }
+    };
+
+    struct Signed16
+    {
+        static const size_t size = 2;
+        static float load(const unsigned char *p)
+        {
+            const int16_t value = int16_t(uint16_t(p[0] | (p[1] << 8)));
+            return value * (1.0f / 32768.0f);
+        }
+    };
+
+    struct Signed24
+    {
+        static const size_t size = 3;
+        static float load(const unsigned char *p)
+        {
+            // Into the top of an int so the sign comes out right.
+            const int32_t value = int32_t(uint32_t(p[0]) << 8 |
+                                          uint32_t(p[1]) << 16 |
+                                          uint32_t(p[2]) << 24);
+            return float(value) * (1.0f / 2147483648.0f);
+        }
+    };
+
+    struct Signed32
+    {
+        static const size_t size = 4;
+        static float load(const unsigned char *p)
+        {
+            const int32_t value = int32_t(uint32_t(p[0]) |
+                                          uint32_t(p[1]) << 8 |
+                                          uint32_t(p[2]) << 16 |
+                                          uint32_t(p[3]) << 24);
+            return float(value) * (1.0f / 2147483648.0f);
+        }
+    };
+
+    struct Float32
+    {
+        static const size_t size = 4;
+        static float load(const unsigned char *p)
+        {
+            float value;
+            memcpy(&value, p, sizeof(value));
+            return value;
+        }
+    };
+
+    template <typename Format, bool Add>
+    void convertPacked(const unsigned char *source, float *target,
+                       size_t count)
+    {
+        // Constant stride, so this vectorises.
+        for (size_t i = 0; i < count; ++i) {
+            const float value = Format::load(source + i * Format::size);
+            if (Add)
+                target[i] += value;
+            else
+                target[i] = value;
+        }
+    }
+
+#ifdef __SSE2__
+    // 16-bit is by far the most common format, so it gets a hand-written
+    // SSE2 version for the compilers that don't vectorise the above.
+    template <bool Add>
+    size_t convertPacked16SSE2(const unsigned char *source, float *target,
+                               size_t count)
+    {
+        const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            const __m128i packed = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i *>(source + i * 2));
+            // Duplicate each 16-bit value into a 32-bit lane, then an
+            // arithmetic shift leaves it sign extended.
+            const __m128i low =
+                    _mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16);
+            const __m128i high =
+                    _mm_srai_epi32(_mm_unpackhi_epi16(packed, packed), 16);
+
+            __m128 first = _mm_mul_ps(_mm_cvtepi32_ps(low), scale);
+            __m128 second = _mm_mul_ps(_mm_cvtepi32_ps(high), scale);
+
+            if (Add) {
+                first = _mm_add_ps(first, _mm_loadu_ps(target + i));
+                second = _mm_add_ps(second, _mm_loadu_ps(target + i + 4));
+            }
+
+            _mm_storeu_ps(target + i, first);
+            _mm_storeu_ps(target + i + 4, second);
+        }
+
+        return i;
+    }
+#endif
+
+    template <typename Format, bool Add>
+    void convertStrided(const unsigned char *source, size_t stride,
+                        float *target, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            const float value = Format::load(source + i * stride);
+            if (Add)
+                target[i] += value;
+            else
+                target[i] = value;
+        }
+    }
+
+    template <typename Format, bool Add>
+    void convert(const unsigned char *source, size_t stride,
+                 float *target, size_t count)
+    {
+        if (stride == Format::size)
+            convertPacked<Format, Add>(source, target, count);
+        else
+            convertStrided<Format, Add>(source, stride, target, count);
+    }
+
+    template <bool Add>
+    void convert(const unsigned char *source, SampleFormat format,
+                 size_t stride, float *target, size_t count)
+    {
+        switch (format) {
+        case SampleFormat::Unsigned8:
+            convert<Unsigned8, Add>(source, stride, target, count);
+            break;
+        case SampleFormat::Signed16:
+#ifdef __SSE2__
+            if (stride == Signed16::size) {
+                const size_t done =
+                        convertPacked16SSE2<Add>(source, target, count);
+                convertPacked<Signed16, Add>(source + done * 2,
+                                             target + done, count - done);
+                break;
+            }
+#endif
+            convert<Signed16, Add>(source, stride, target, count);
+            break;
+        case SampleFormat::Signed24:
+            convert<Signed24, Add>(source, stride, target, count);
+            break;
+        case SampleFormat::Signed32:
+            convert<Signed32, Add>(source, stride, target, count);
+            break;
+        case SampleFormat::Float32:
+            if (stride == Float32::size  &&  !Add) {
+                memcpy(target, source, count * sizeof(float));
+                break;
+            }
+            convert<Float32, Add>(source, stride, target, count);
+            break;
+        case SampleFormat::Unknown:
+        default:
+            if (!Add)
+                memset(target, 0, count * sizeof(float));
+            break;
+        }
+    }
+}
+
+SampleFormat
+getSampleFormat(bool isFloat, unsigned int bitsPerSample)
+{
+    if (isFloat)
+        return (bitsPerSample == 32) ? SampleFormat::Float32 :
+                                       SampleFormat::Unknown;
+
+    switch (bitsPerSample) {
+    case 8:  return SampleFormat::Unsigned8;
+    case 16: return SampleFormat::Signed16;
+    case 24: return SampleFormat::Signed24;
+    case 32: return SampleFormat::Signed32;
+    default: return SampleFormat::Unknown;
+    }
+}
+
+size_t
+getSampleSize(SampleFormat format)
+{
+    switch (format) {
+    case SampleFormat::Unsigned8: return 1;
+    case SampleFormat::Signed16:  return 2;
+    case SampleFormat::Signed24:  return 3;
+    case SampleFormat::Signed32:  return 4;
+    case SampleFormat::Float32:   return 4;
+    case SampleFormat::Unknown:
+    default:                      return 0;
+    }
+}
+
+void
+convertToFloat(const unsigned char *source, SampleFormat format,
+               size_t stride, float *target, size_t count)
+{
+    convert<false>(source, format, stride, target, count);
+}
+
+void
+addToFloat(const unsigned char *source, SampleFormat format,
+           size_t stride, float *target, size_t count)
+{
+    convert<true>(source, format, stride, target, count);
+}
+
+
+}
@@ -0,0 +1,71 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#ifndef RG_SAMPLECONVERSION_H
+#define RG_SAMPLECONVERSION_H
+
+#include <cstddef>
+
+#include <rosegardenprivate_export.h>
+
+namespace Rosegarden
+{
+
+
+/// The sample formats found in WAV and BWF files.
+/**
+ * All are little-endian.  8-bit samples are unsigned, the other integer
+ * formats are two's complement.
+ */
+enum class SampleFormat {
+    Unknown,
+    Unsigned8,
+    Signed16,
+    Signed24,
+    Signed32,
+    Float32
+};
+
+/// Work out the format from a WAV "fmt " chunk.
+ROSEGARDENPRIVATE_EXPORT SampleFormat
+getSampleFormat(bool isFloat, unsigned int bitsPerSample);
+
+/// Bytes per sample.  0 for SampleFormat::Unknown.
+ROSEGARDENPRIVATE_EXPORT size_t
+getSampleSize(SampleFormat format);
+
+/// Convert samples to float in the range [-1, 1).
+/**
+ * Reads count samples of the given format, the first at source and each
+ * following one stride bytes after the previous.  A stride equal to
+ * the sample size (i.e. all the samples of an interleaved buffer) is
+ * the fast case and is written so that the compiler can vectorise it.
+ * Pass the frame size to pull one channel out of interleaved data.
+ *
+ * Gives the same results as RIFFAudioFile::convertBytesToSample().
+ */
+ROSEGARDENPRIVATE_EXPORT void
+convertToFloat(const unsigned char *source, SampleFormat format,
+               size_t stride, float *target, size_t count);
+
+/// As convertToFloat() but adds to the contents of target.
+ROSEGARDENPRIVATE_EXPORT void
+addToFloat(const unsigned char *source, SampleFormat format,
+           size_t stride, float *target, size_t count);
+
+
+}
+
+#endif
@@ -16,8 +16,10 @@
 #define RG_MODULE_STRING "[WAVAudioFile]"
 
 #include "WAVAudioFile.h"
+#include "SampleConversion.h"
 #include "base/RealTime.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include "misc/Debug.h"
@@ -171,6 +173,10 @@ WAVAudioFile::decode(const unsigned char *sourceData,
         return false;
     }
 
+    // 32-bit is IEEE-float (enforced in RIFFAudioFile)
+    const SampleFormat sampleFormat =
+            getSampleFormat(bitsPerSample == 32, bitsPerSample);
+
 #ifdef DEBUG_DECODE
     RG_DEBUG << "WAVAudioFile::decode: " << sourceBytes << " bytes -> " << targetFrames << " frames, SSR " << getSampleRate() << ", TSR " << targetSampleRate << ", sch " << getChannels() << ", tch " << targetChannels;
 #endif
@@ -201,7 +207,19 @@ WAVAudioFile::decode(const unsigned char *sourceData,
             ratio = float(sourceSampleRate) / float(targetSampleRate);
         }
 
-        for (size_t i = 0; i < targetFrames; ++i) {
+        size_t i = 0;
+
+        if (sourceSampleRate == targetSampleRate) {
+            // One channel of interleaved data is a fixed stride, which
+            // the block converter handles much faster than going a
+            // sample at a time.
+            const size_t frames = std::min(targetFrames, fileFrames);
+            addToFloat(&sourceData[(bitsPerSample / 8) * ch], sampleFormat,
+                       getBytesPerFrame(), targetData[tch], frames);
+            i = frames;
+        }
+
+        for ( ; i < targetFrames; ++i) {
 
             size_t j = i;
             if (sourceSampleRate != targetSampleRate) {
@@ -56,9 +56,8 @@ WAVExporter::WAVExporter(const QString& fileName)
         return;
     }
 
-    // create the ring buffers
-    m_leftChannelBuffer.reset(new RingBuffer<sample_t>(sampleRate/2));
-    m_rightChannelBuffer.reset(new RingBuffer<sample_t>(sampleRate/2));
+    // create the ring buffer
+    m_buffer.reset(new FrameRingBuffer<sample_t>(2, sampleRate/2));
 }
 
 void WAVExporter::start()
@@ -83,9 +82,7 @@ void WAVExporter::addSamples(sample_t *left,
 {
     if (!m_audioWriteStream)
         return;
-    if (!m_leftChannelBuffer)
-        return;
-    if (!m_rightChannelBuffer)
+    if (!m_buffer)
         return;
 
     RG_DEBUG << "addSamples" << left << right << numSamples;
@@ -93,58 +90,43 @@ void WAVExporter::addSamples(sample_t *left,
         RG_DEBUG << "addSamples not running";
         return;
     }
-    size_t spacel = m_leftChannelBuffer->getWriteSpace();
-    size_t spacer = m_rightChannelBuffer->getWriteSpace();
-    if (spacel < numSamples || spacer < numSamples) {
+    if (m_buffer->getWriteSpace() < numSamples) {
         RG_WARNING << "export to audio buffer overflow";
         return;
     }
-    m_leftChannelBuffer->write(left, numSamples);
-    m_rightChannelBuffer->write(right, numSamples);
+    const sample_t *channels[2] = { left, right };
+    m_buffer->write(channels, numSamples);
 }
 
 void WAVExporter::update()
 {
     if (!m_audioWriteStream)
         return;
-    if (!m_leftChannelBuffer)
-        return;
-    if (!m_rightChannelBuffer)
+    if (!m_buffer)
         return;
 
     if (m_running) {
-        size_t spacel = m_leftChannelBuffer->getReadSpace();
-        size_t spacer = m_rightChannelBuffer->getReadSpace();
-        size_t toRead = spacel;
-        if (spacer < spacel) toRead = spacer;
+        // Write the interleaved frames straight from the ring buffer.
+        const sample_t *first, *second;
+        size_t firstFrames, secondFrames;
+        const size_t toRead = m_buffer->getReadRegions(
+                first, firstFrames, second, secondFrames);
         if (toRead > 0) {
-            sample_t lbuf[toRead];
-            sample_t rbuf[toRead];
-            sample_t ileaveBuf[2 * toRead];
             RG_DEBUG << "update read" << toRead;
-            m_leftChannelBuffer->read(lbuf, toRead);
-            m_rightChannelBuffer->read(rbuf, toRead);
 #ifndef NDEBUG
             // Gather samples squared for debugging.
             double ssq = 0.0;
-#endif
-            // For each interleaved sample...
-            for (size_t is=0; is<toRead; is++) {
-                // interleave
-                sample_t s0 = lbuf[is];
-                sample_t s1 = rbuf[is];
-#ifndef NDEBUG
-                ssq += s0 * s0;
-                ssq += s1 * s1;
-#endif
-                ileaveBuf[is*2] = s0;
-                ileaveBuf[is*2 + 1] = s1;
-            }
-#ifndef NDEBUG
+            for (size_t is = 0; is < firstFrames * 2; ++is)
+                ssq += first[is] * first[is];
+            for (size_t is = 0; is < secondFrames * 2; ++is)
+                ssq += second[is] * second[is];
             RG_DEBUG << "render frames" << toRead << ssq;
 #endif
-            if (m_audioWriteStream)
-                m_audioWriteStream->putInterleavedFrames(toRead, ileaveBuf);
+            if (firstFrames > 0)
+                m_audioWriteStream->putInterleavedFrames(firstFrames, first);
+            if (secondFrames > 0)
+                m_audioWriteStream->putInterleavedFrames(secondFrames, second);
+            m_buffer->skip(toRead);
         }
         if (m_stopRequested) {
             RG_DEBUG << "stop requested - deleting write stream";
@@ -153,8 +135,7 @@ void WAVExporter::update()
 
             // Free all the memory since we are done.
             m_audioWriteStream = nullptr;
-            m_leftChannelBuffer = nullptr;
-            m_rightChannelBuffer = nullptr;
+            m_buffer = nullptr;
         }
     }
 }
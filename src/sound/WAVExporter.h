@@ -19,7 +19,7 @@
 #define RG_WAVEXPORTER_H
 
 typedef float sample_t;
-#include "RingBuffer.h"
+#include "FrameRingBuffer.h"
 
 #include <memory>
 
@@ -71,9 +71,9 @@ private:
     bool m_running{false};
     bool m_stopRequested{false};
 
-    // Lock-free buffers written by the audio thread and read by the GUI thread.
-    std::unique_ptr<RingBuffer<sample_t>> m_leftChannelBuffer;
-    std::unique_ptr<RingBuffer<sample_t>> m_rightChannelBuffer;
+    // Lock-free buffer written by the audio thread and read by the GUI
+    // thread.  Stereo, interleaved.
+    std::unique_ptr<FrameRingBuffer<sample_t>> m_buffer;
 
 };
 
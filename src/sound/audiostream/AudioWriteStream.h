@@ -58,7 +58,7 @@ public:
     size_t getChannelCount() const { return m_target.getChannelCount(); }
     size_t getSampleRate() const { return m_target.getSampleRate(); }
 
-    virtual bool putInterleavedFrames(size_t count, float *frames) = 0;
+    virtual bool putInterleavedFrames(size_t count, const float *frames) = 0;
 
     void remove()
     {
@@ -0,0 +1,67 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*-  vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+
+#include "MappedWavFileReadStream.h"
+
+namespace Rosegarden
+{
+
+// See WavFileReadStream::initStaticObjects() for why this is created
+// explicitly from main.cpp.
+
+static AudioReadStreamBuilder<MappedWavFileReadStream> * mappedwavbuilder;
+
+void
+MappedWavFileReadStream::initStaticObjects()
+{
+    mappedwavbuilder = new AudioReadStreamBuilder<MappedWavFileReadStream>(
+        QUrl("http://breakfastquay.com/rdf/rosegarden/fileio/MappedWavFileReadStream"),
+        QStringList() << "wav" << "bwf"
+    );
+}
+
+
+MappedWavFileReadStream::MappedWavFileReadStream(QString path) :
+    m_file(path),
+    m_offset(0)
+{
+    m_channelCount = 0;
+    m_sampleRate = 0;
+
+    if (!m_file.isOK()  ||  m_file.getFrameCount() == 0)
+        return;
+
+    m_channelCount = m_file.getChannels();
+    m_sampleRate = m_file.getSampleRate();
+}
+
+MappedWavFileReadStream::~MappedWavFileReadStream()
+{
+}
+
+size_t
+MappedWavFileReadStream::getFrames(size_t count, float *frames)
+{
+    if (!m_channelCount  ||  count == 0)
+        return 0;
+
+    const size_t got = m_file.getInterleavedFrames(m_offset, count, frames);
+    m_offset += got;
+
+    return got;
+}
+
+}
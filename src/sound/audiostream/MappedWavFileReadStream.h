@@ -0,0 +1,53 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*-  vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+
+#ifndef RG_MAPPED_WAV_FILE_READ_STREAM_H
+#define RG_MAPPED_WAV_FILE_READ_STREAM_H
+
+#include "AudioReadStream.h"
+#include "sound/MappedWavFile.h"
+
+#include <rosegardenprivate_export.h>
+
+namespace Rosegarden
+{
+
+/// AudioReadStream for WAV and BWF files using MappedWavFile.
+/**
+ * Registered ahead of WavFileReadStream for the extensions it handles.
+ * For files it can't read (compressed WAV, odd block alignments) isOK()
+ * is false and AudioReadStreamFactory moves on to the other readers.
+ */
+class ROSEGARDENPRIVATE_EXPORT MappedWavFileReadStream : public AudioReadStream
+{
+public:
+    explicit MappedWavFileReadStream(QString path);
+    ~MappedWavFileReadStream() override;
+
+    static void initStaticObjects();
+
+    QString getError() const override { return m_file.getError(); }
+
+protected:
+    size_t getFrames(size_t count, float *frames) override;
+
+    MappedWavFile m_file;
+    size_t m_offset;
+};
+
+}
+
+#endif
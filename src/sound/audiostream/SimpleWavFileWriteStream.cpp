@@ -165,7 +165,7 @@ SimpleWavFileWriteStream::writeFormatChunk()
 }
 
 bool
-SimpleWavFileWriteStream::putInterleavedFrames(size_t count, float *frames)
+SimpleWavFileWriteStream::putInterleavedFrames(size_t count, const float *frames)
 {
     if (!m_file || !getChannelCount()) return false;
     if (count == 0) return false;
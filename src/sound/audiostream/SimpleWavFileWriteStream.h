@@ -41,7 +41,7 @@ public:
 
     virtual QString getError() const override { return m_error; }
 
-    virtual bool putInterleavedFrames(size_t count, float *frames) override;
+    virtual bool putInterleavedFrames(size_t count, const float *frames) override;
 
 protected:
     int m_bitDepth;
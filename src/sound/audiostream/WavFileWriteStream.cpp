@@ -78,7 +78,7 @@ WavFileWriteStream::~WavFileWriteStream()
 }
 
 bool
-WavFileWriteStream::putInterleavedFrames(size_t count, float *frames)
+WavFileWriteStream::putInterleavedFrames(size_t count, const float *frames)
 {
     if (!m_file || !getChannelCount()) return false;
     if (count == 0) return false;
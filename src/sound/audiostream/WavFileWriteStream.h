@@ -39,7 +39,7 @@ public:
 
     QString getError() const override { return m_error; }
 
-    bool putInterleavedFrames(size_t count, float *frames) override;
+    bool putInterleavedFrames(size_t count, const float *frames) override;
 
 protected:
     SF_INFO m_fileInfo;
@@ -0,0 +1,124 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#include "sound/BeatTracker.h"
+
+#include "clicktrack.h"
+
+#include <QTest>
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace Rosegarden;
+
+/// Unit test and benchmark for BeatTracker
+class TestBeatTracker : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testTempo_data();
+    void testTempo();
+    void testSilence();
+    void benchmark();
+};
+
+namespace
+{
+    using ClickTrack::sampleRate;
+
+    /// A click track at a fixed tempo, accented on the first of four.
+    /**
+     * The click positions are returned in clicks.
+     */
+    std::vector<float> makeClickTrack(long frames, double bpm,
+                                      std::vector<long> &clicks)
+    {
+        const double period = 60.0 * sampleRate / bpm;
+
+        clicks.clear();
+        for (int k = 0; ; ++k) {
+            const long position = std::lround(sampleRate / 10 + k * period);
+            if (position >= frames - 3000)
+                break;
+            clicks.push_back(position);
+        }
+
+        return ClickTrack::make(frames, clicks, false, 4);
+    }
+}
+
+void TestBeatTracker::testTempo_data()
+{
+    QTest::addColumn<double>("bpm");
+
+    QTest::newRow("70") << 70.0;
+    QTest::newRow("90") << 90.0;
+    QTest::newRow("123") << 123.0;
+    QTest::newRow("150") << 150.0;
+}
+
+void TestBeatTracker::testTempo()
+{
+    QFETCH(double, bpm);
+
+    std::vector<long> clicks;
+    std::vector<float> samples =
+            makeClickTrack(sampleRate * 30, bpm, clicks);
+
+    BeatTracker tracker(sampleRate);
+    const std::vector<long> beats =
+            tracker.findBeats(&samples[0], long(samples.size()));
+
+    QVERIFY(std::fabs(tracker.getTempo() - bpm) < 0.5);
+
+    QCOMPARE(beats.size(), clicks.size());
+    for (size_t i = 0; i < clicks.size(); ++i) {
+        // Sample accurate, give or take a couple.
+        QVERIFY(std::abs(beats[i] - clicks[i]) <= 2);
+    }
+}
+
+void TestBeatTracker::testSilence()
+{
+    std::vector<float> samples(sampleRate * 5, 0.0f);
+
+    BeatTracker tracker(sampleRate);
+    QVERIFY(tracker.findBeats(&samples[0], long(samples.size())).empty());
+    QCOMPARE(tracker.getTempo(), 0.0);
+}
+
+void TestBeatTracker::benchmark()
+{
+    // Five minutes of clicks.
+    std::vector<long> clicks;
+    std::vector<float> samples =
+            makeClickTrack(sampleRate * 300, 123.0, clicks);
+
+    BeatTracker tracker(sampleRate);
+    std::vector<long> beats;
+
+    QBENCHMARK {
+        beats = tracker.findBeats(&samples[0], long(samples.size()));
+    }
+
+    QCOMPARE(beats.size(), clicks.size());
+}
+
+QTEST_MAIN(TestBeatTracker)
+
+#include "beattracker.moc"
@@ -0,0 +1,448 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#include "gui/editors/guitar/Chord.h"
+#include "gui/editors/guitar/ChordMap.h"
+#include "gui/editors/guitar/ChordXmlHandler.h"
+#include "gui/editors/guitar/Fingering.h"
+#include "document/io/XMLReader.h"
+
+#include <QFile>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <set>
+#include <vector>
+
+using namespace Rosegarden;
+using namespace Rosegarden::Guitar;
+
+/// Unit test and benchmark for the guitar chord dictionary
+class TestChordMap : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testExtList();
+    void testChordRange();
+    void testRemove();
+    void testContaining();
+    void testCache();
+    void benchmarkOldBrowse();
+    void benchmarkBrowse();
+    void benchmarkOldContaining();
+    void benchmarkContaining();
+    void benchmarkParseXml();
+    void benchmarkLoadCache();
+};
+
+namespace
+{
+    typedef std::set<Chord, Chord::ChordCmp> ChordSet;
+
+    namespace Old
+    {
+        // ChordMap::getExtList() and getChords() as they were, walking
+        // the whole set of chords for the root.
+
+        QStringList getExtList(const ChordSet &chords, const QString &root)
+        {
+            QStringList extList;
+            QString currentExt = "ZZ";
+
+            for (ChordSet::const_iterator i = chords.lower_bound(Chord(root));
+                 i != chords.end(); ++i) {
+                if (i->getRoot() != root)
+                    break;
+                if (i->getExt() != currentExt) {
+                    extList.push_back(i->getExt());
+                    currentExt = i->getExt();
+                }
+            }
+
+            return extList;
+        }
+
+        ChordMap::chordarray getChords(const ChordSet &chords,
+                                       const QString &root,
+                                       const QString &ext)
+        {
+            ChordMap::chordarray res;
+
+            for (ChordSet::const_iterator i =
+                     chords.lower_bound(Chord(root, ext));
+                 i != chords.end(); ++i) {
+                if (i->getRoot() != root || i->getExt() != ext)
+                    break;
+                res.push_back(*i);
+            }
+
+            return res;
+        }
+
+        /// Checking every chord, as the dialog would have had to.
+        ChordMap::chordarray getChordsContaining(const ChordSet &chords,
+                                                 const Fingering &positions)
+        {
+            ChordMap::chordarray res;
+
+            for (const Chord &chord : chords) {
+                const Fingering fingering = chord.getFingering();
+                bool match = true;
+                for (unsigned int i = 0; i < positions.getNbStrings(); ++i) {
+                    if (positions[i] >= Fingering::OPEN &&
+                        fingering[i] != positions[i]) {
+                        match = false;
+                        break;
+                    }
+                }
+                if (match)
+                    res.push_back(chord);
+            }
+
+            return res;
+        }
+    }
+
+    const char *const extensions[] = {
+        "", "m", "7", "5", "m7", "maj7", "sus2", "sus4", "dim", "aug",
+        "9", "m9", "add9", "6", "m6", "13", "7#9", "7b9", "m7b5", "11"
+    };
+
+    /// Generate fingerings along the neck for every root and extension.
+    template <class Insert>
+    void generate(int count, Insert insert)
+    {
+        const QStringList roots = ChordMap::getRootList();
+        const int perChord = count / (roots.size() * 20) + 1;
+
+        int n = 0;
+        for (const QString &root : roots) {
+            for (const char *ext : extensions) {
+                for (int f = 0; f < perChord && n < count; ++f, ++n) {
+                    Fingering fingering;
+                    for (unsigned int s = 0; s < fingering.getNbStrings(); ++s) {
+                        const unsigned int h =
+                            (unsigned(n) * 131u + s) * 2654435761u;
+                        const int v = (h >> 16) % 17;
+                        // Some muted and open strings, the rest within
+                        // a few frets of each other.
+                        fingering[s] = (v == 0 ? Fingering::MUTED :
+                                        v == 1 ? Fingering::OPEN :
+                                        1 + f % 12 + v % 4);
+                    }
+                    Chord chord(root, ext);
+                    chord.setFingering(fingering);
+                    chord.setUserChord(n % 3 == 0);
+                    insert(chord);
+                }
+            }
+        }
+    }
+
+    void fill(ChordMap &map, ChordSet *set, int count)
+    {
+        generate(count, [&](const Chord &chord) {
+            map.insert(chord);
+            if (set) set->insert(chord);
+        });
+    }
+
+    bool equal(const ChordMap::chordarray &a, const ChordMap::chordarray &b)
+    {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (a[i] < b[i] || b[i] < a[i]) return false;
+            if (a[i].isUserChord() != b[i].isUserChord()) return false;
+        }
+        return true;
+    }
+
+    Fingering makePositions(int string1, int fret1,
+                            int string2 = -1, int fret2 = 0)
+    {
+        Fingering positions;
+        positions[string1] = fret1;
+        if (string2 >= 0)
+            positions[string2] = fret2;
+        return positions;
+    }
+
+    const int testChords = 2000;
+    const int benchmarkChords = 100000;
+}
+
+void TestChordMap::testExtList()
+{
+    ChordMap map;
+    ChordSet set;
+    fill(map, &set, testChords);
+
+    for (const QString &root : ChordMap::getRootList())
+        QCOMPARE(map.getExtList(root), Old::getExtList(set, root));
+
+    QVERIFY(map.getExtList("H").isEmpty());
+
+    // No extension comes first.
+    QCOMPARE(map.getExtList("A").first(), QString());
+}
+
+void TestChordMap::testChordRange()
+{
+    ChordMap map;
+    ChordSet set;
+    fill(map, &set, testChords);
+
+    for (const QString &root : ChordMap::getRootList()) {
+        for (const QString &ext : map.getExtList(root)) {
+            const ChordMap::chordarray expected =
+                Old::getChords(set, root, ext);
+            QVERIFY(!expected.empty());
+            QVERIFY(equal(map.getChords(root, ext), expected));
+
+            std::pair<ChordMap::const_iterator, ChordMap::const_iterator>
+                range = map.getChordRange(root, ext);
+            QVERIFY(equal(ChordMap::chordarray(range.first, range.second),
+                          expected));
+        }
+    }
+
+    std::pair<ChordMap::const_iterator, ChordMap::const_iterator> range =
+        map.getChordRange("A", "no such extension");
+    QVERIFY(range.first == range.second);
+}
+
+void TestChordMap::testRemove()
+{
+    ChordMap map;
+    Chord first("C", "m");
+    first.setFingering(Fingering(QString("x 3 5 5 4 3")));
+    Chord second("C", "m");
+    second.setFingering(Fingering(QString("x 3 1 0 4 3")));
+    map.insert(first);
+    map.insert(second);
+
+    QCOMPARE(map.getExtList("C"), QStringList() << "m");
+    QCOMPARE(map.getChordsContaining(makePositions(1, 3)).size(), size_t(2));
+
+    map.remove(first);
+    QCOMPARE(map.getExtList("C"), QStringList() << "m");
+    QCOMPARE(map.getChordsContaining(makePositions(1, 3)).size(), size_t(1));
+    QVERIFY(map.getChordsContaining(makePositions(2, 5)).empty());
+
+    // Removing what isn't there changes nothing.
+    map.remove(first);
+    QCOMPARE(map.getChordsContaining(makePositions(1, 3)).size(), size_t(1));
+
+    Chord edited = second;
+    edited.setExt("m7");
+    map.substitute(second, edited);
+    QCOMPARE(map.getExtList("C"), QStringList() << "m7");
+    QCOMPARE(map.getChords("C", "m7").size(), size_t(1));
+    QVERIFY(map.getChords("C", "m").empty());
+
+    map.remove(edited);
+    QVERIFY(map.getExtList("C").isEmpty());
+    QVERIFY(map.getChordsContaining(makePositions(3, 0)).empty());
+}
+
+void TestChordMap::testContaining()
+{
+    ChordMap map;
+    ChordSet set;
+    fill(map, &set, testChords);
+
+    const Fingering queries[] = {
+        makePositions(0, 3),
+        makePositions(5, 0),
+        makePositions(1, 4, 4, 6),
+        makePositions(2, 2, 3, 0),
+        makePositions(0, 30),
+        Fingering()
+    };
+
+    for (const Fingering &positions : queries) {
+        QVERIFY(equal(map.getChordsContaining(positions),
+                      Old::getChordsContaining(set, positions)));
+    }
+
+    // With a limit on the fret span.
+    const ChordMap::chordarray narrow =
+        map.getChordsContaining(makePositions(0, 3), 2);
+    QVERIFY(!narrow.empty());
+    for (const Chord &chord : narrow)
+        QVERIFY(chord.getFingering().getFretSpan() <= 2);
+    QVERIFY(narrow.size() < map.getChordsContaining(makePositions(0, 3)).size());
+}
+
+void TestChordMap::testCache()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString xmlFile = dir.path() + "/chords.xml";
+    const QString cacheFile = dir.path() + "/chords.cache";
+
+    ChordMap map;
+    fill(map, nullptr, testChords);
+    QString errMsg;
+    QVERIFY(map.saveDocument(xmlFile, false, errMsg));
+    QVERIFY(map.saveCache(cacheFile, xmlFile));
+
+    ChordMap loaded;
+    QVERIFY(loaded.loadCache(cacheFile, xmlFile));
+    QVERIFY(!loaded.needSave());
+    QVERIFY(equal(ChordMap::chordarray(loaded.begin(), loaded.end()),
+                  ChordMap::chordarray(map.begin(), map.end())));
+    QCOMPARE(loaded.getExtList("C"), map.getExtList("C"));
+    QVERIFY(equal(loaded.getChordsContaining(makePositions(0, 3)),
+                  map.getChordsContaining(makePositions(0, 3))));
+
+    // Not from this file.
+    ChordMap other;
+    QVERIFY(!other.loadCache(cacheFile, cacheFile));
+    QVERIFY(!other.loadCache(dir.path() + "/missing.cache", xmlFile));
+    QVERIFY(other.begin() == other.end());
+
+    // Out of date once the file changes.
+    QFile xml(xmlFile);
+    QVERIFY(xml.open(QIODevice::Append));
+    xml.write("\n");
+    xml.close();
+    QVERIFY(!other.loadCache(cacheFile, xmlFile));
+}
+
+void TestChordMap::benchmarkOldBrowse()
+{
+    ChordSet set;
+    generate(benchmarkChords, [&](const Chord &chord) { set.insert(chord); });
+
+    size_t chords = 0;
+
+    // What the selector dialog does going through every root and
+    // extension.
+    QBENCHMARK {
+        chords = 0;
+        for (const QString &root : ChordMap::getRootList()) {
+            for (const QString &ext : Old::getExtList(set, root))
+                chords += Old::getChords(set, root, ext).size();
+        }
+    }
+
+    QCOMPARE(chords, set.size());
+}
+
+void TestChordMap::benchmarkBrowse()
+{
+    ChordMap map;
+    fill(map, nullptr, benchmarkChords);
+
+    size_t chords = 0;
+
+    QBENCHMARK {
+        chords = 0;
+        for (const QString &root : ChordMap::getRootList()) {
+            for (const QString &ext : map.getExtList(root)) {
+                std::pair<ChordMap::const_iterator, ChordMap::const_iterator>
+                    range = map.getChordRange(root, ext);
+                chords += std::distance(range.first, range.second);
+            }
+        }
+    }
+
+    QCOMPARE(chords, size_t(std::distance(map.begin(), map.end())));
+}
+
+void TestChordMap::benchmarkOldContaining()
+{
+    ChordSet set;
+    generate(benchmarkChords, [&](const Chord &chord) { set.insert(chord); });
+
+    size_t found = 0;
+
+    QBENCHMARK {
+        found = Old::getChordsContaining(set, makePositions(1, 4, 4, 6)).size();
+    }
+
+    QVERIFY(found > 0);
+}
+
+void TestChordMap::benchmarkContaining()
+{
+    ChordMap map;
+    fill(map, nullptr, benchmarkChords);
+
+    size_t found = 0;
+
+    QBENCHMARK {
+        found = map.getChordsContaining(makePositions(1, 4, 4, 6)).size();
+    }
+
+    QVERIFY(found > 0);
+}
+
+void TestChordMap::benchmarkParseXml()
+{
+    QTemporaryDir dir;
+    const QString xmlFile = dir.path() + "/chords.xml";
+    {
+        ChordMap map;
+        fill(map, nullptr, benchmarkChords);
+        QString errMsg;
+        QVERIFY(map.saveDocument(xmlFile, false, errMsg));
+    }
+
+    size_t chords = 0;
+
+    QBENCHMARK {
+        ChordMap map;
+        ChordXmlHandler handler(map);
+        QFile file(xmlFile);
+        XMLReader reader;
+        reader.setHandler(&handler);
+        reader.parse(file);
+        chords = std::distance(map.begin(), map.end());
+    }
+
+    QVERIFY(chords > 0);
+}
+
+void TestChordMap::benchmarkLoadCache()
+{
+    QTemporaryDir dir;
+    const QString xmlFile = dir.path() + "/chords.xml";
+    const QString cacheFile = dir.path() + "/chords.cache";
+    {
+        ChordMap map;
+        fill(map, nullptr, benchmarkChords);
+        QString errMsg;
+        QVERIFY(map.saveDocument(xmlFile, false, errMsg));
+        QVERIFY(map.saveCache(cacheFile, xmlFile));
+    }
+
+    size_t chords = 0;
+
+    QBENCHMARK {
+        ChordMap map;
+        QVERIFY(map.loadCache(cacheFile, xmlFile));
+        chords = std::distance(map.begin(), map.end());
+    }
+
+    QVERIFY(chords > 0);
+}
+
+QTEST_MAIN(TestChordMap)
+
+#include "chordmap.moc"
@@ -0,0 +1,74 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#ifndef RG_TEST_CLICKTRACK_H
+#define RG_TEST_CLICKTRACK_H
+
+#include <cmath>
+#include <vector>
+
+
+/// Synthetic click tracks for the audio analysis tests.
+namespace ClickTrack
+{
+    const unsigned int sampleRate = 44100;
+
+    /// Simple LCG so that the test material is the same every run.
+    class Noise
+    {
+    public:
+        float next()
+        {
+            m_seed = m_seed * 1664525u + 1013904223u;
+            return float(m_seed >> 8) / float(1 << 24) * 2.0f - 1.0f;
+        }
+    private:
+        unsigned int m_seed{1};
+    };
+
+    /// A decaying click at each of clicks, over a faint noise floor.
+    /**
+     * A tonal click is a 1kHz tone, otherwise it is a burst of noise.
+     * Every accentEvery'th click, starting with the first, is twice as
+     * loud as the others.
+     */
+    inline std::vector<float> make(long frames,
+                                   const std::vector<long> &clicks,
+                                   bool tonal = false,
+                                   int accentEvery = 1)
+    {
+        Noise noise;
+        std::vector<float> samples(frames);
+        for (long i = 0; i < frames; ++i)
+            samples[i] = 0.001f * noise.next();
+
+        for (size_t k = 0; k < clicks.size(); ++k) {
+            const float level = (k % accentEvery == 0 ? 0.8f : 0.4f);
+            const long click = clicks[k];
+            for (long t = 0; t < 3000  &&  click + t < frames; ++t) {
+                float value;
+                if (tonal)
+                    value = float(cos(2 * M_PI * 1000.0 * t / sampleRate));
+                else
+                    value = (t == 0 ? 1.0f : noise.next());
+                samples[click + t] += level * std::exp(-t / 300.0f) * value;
+            }
+        }
+
+        return samples;
+    }
+}
+
+#endif
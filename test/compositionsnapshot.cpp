@@ -0,0 +1,221 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#include "base/BaseProperties.h"
+#include "base/Composition.h"
+#include "base/CompositionSnapshot.h"
+#include "base/Event.h"
+#include "base/NotationTypes.h"
+#include "base/Segment.h"
+
+#include <QTest>
+#include <QThread>
+
+#include <atomic>
+
+using namespace Rosegarden;
+
+/// Unit test for CompositionSnapshot and CompositionSnapshotter
+/**
+ * testConcurrentEdit() is most useful when built with
+ * -fsanitize=thread.
+ */
+class TestCompositionSnapshot : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testContents();
+    void testSharing();
+    void testConcurrentEdit();
+};
+
+namespace
+{
+    Segment *makeSegment(TrackId track, timeT start, int notes)
+    {
+        Segment *segment = new Segment;
+        segment->setTrack(track);
+        segment->setStartTime(start);
+        for (int i = 0; i < notes; ++i) {
+            Event *note = new Event(Note::EventType, start + i * 240, 240);
+            note->set<Int>(BaseProperties::PITCH, 60 + i % 12);
+            segment->insert(note);
+        }
+        return segment;
+    }
+
+    /// Something that depends on every event in the snapshot.
+    long checksum(const CompositionSnapshot &snapshot)
+    {
+        long sum = 0;
+        for (const CompositionSnapshot::SegmentInfo &segment :
+                 snapshot.getSegments()) {
+            const SegmentSnapshot &events = *segment.events;
+            sum += segment.startTime + segment.track;
+            for (size_t i = 0; i < events.size(); ++i)
+                sum += events.getTime(i) * 3 + events.getPitch(i);
+        }
+        return sum;
+    }
+
+    /// Traverses a snapshot over and over.
+    class Reader : public QThread
+    {
+    public:
+        Reader(CompositionSnapshot::Ptr snapshot, long expected) :
+            m_snapshot(snapshot),
+            m_expected(expected),
+            m_stop(false),
+            m_passes(0),
+            m_ok(true)
+        {
+        }
+
+        void stop()  { m_stop.store(true); }
+        int getPasses() const  { return m_passes.load(); }
+        bool isOK() const  { return m_ok.load(); }
+
+    protected:
+        void run() override
+        {
+            while (!m_stop.load()) {
+                if (checksum(*m_snapshot) != m_expected)
+                    m_ok.store(false);
+                ++m_passes;
+            }
+        }
+
+    private:
+        CompositionSnapshot::Ptr m_snapshot;
+        long m_expected;
+        std::atomic<bool> m_stop;
+        std::atomic<int> m_passes;
+        std::atomic<bool> m_ok;
+    };
+}
+
+void TestCompositionSnapshot::testContents()
+{
+    Composition composition;
+    composition.addTrack(new Track(1));
+    composition.addSegment(makeSegment(1, 0, 10));
+    composition.addSegment(makeSegment(1, 4800, 5));
+
+    CompositionSnapshotter snapshotter(composition);
+    const CompositionSnapshot::Ptr snapshot = snapshotter.takeSnapshot(7);
+
+    QCOMPARE(snapshot->getVersion(), 7u);
+    QCOMPARE(snapshot->getStartMarker(), composition.getStartMarker());
+    QCOMPARE(snapshot->getEndMarker(), composition.getEndMarker());
+    QCOMPARE(snapshot->getTracks().size(), size_t(1));
+    QCOMPARE(snapshot->getSegments().size(), size_t(2));
+    QCOMPARE(snapshot->getTempoChanges().size(),
+             size_t(composition.getTempoChangeCount()));
+
+    Composition::const_iterator live = composition.begin();
+    for (const CompositionSnapshot::SegmentInfo &segment :
+             snapshot->getSegments()) {
+        QCOMPARE(segment.runtimeId, (*live)->getRuntimeId());
+        QCOMPARE(segment.startTime, (*live)->getStartTime());
+        QCOMPARE(segment.events->size(), (*live)->size());
+        ++live;
+    }
+}
+
+void TestCompositionSnapshot::testSharing()
+{
+    Composition composition;
+    composition.addTrack(new Track(1));
+    Segment *unchanged = makeSegment(1, 0, 10);
+    Segment *edited = makeSegment(1, 4800, 10);
+    composition.addSegment(unchanged);
+    composition.addSegment(edited);
+
+    CompositionSnapshotter snapshotter(composition);
+    const CompositionSnapshot::Ptr first = snapshotter.takeSnapshot(1);
+
+    edited->insert(new Event(Note::EventType, 9600, 240));
+
+    const CompositionSnapshot::Ptr second = snapshotter.takeSnapshot(2);
+
+    // The unchanged segment's events are shared, the edited one's not.
+    QVERIFY(first->getSegments()[0].events ==
+            second->getSegments()[0].events);
+    QVERIFY(first->getSegments()[1].events !=
+            second->getSegments()[1].events);
+    QCOMPARE(first->getSegments()[1].events->size(), size_t(10));
+    QCOMPARE(second->getSegments()[1].events->size(), size_t(11));
+
+    // Nothing changed, so everything is shared.
+    const CompositionSnapshot::Ptr third = snapshotter.takeSnapshot(2);
+    QVERIFY(second->getSegments()[1].events ==
+            third->getSegments()[1].events);
+}
+
+void TestCompositionSnapshot::testConcurrentEdit()
+{
+    Composition composition;
+    composition.addTrack(new Track(1));
+    composition.addTrack(new Track(2));
+    Segment *first = makeSegment(1, 0, 500);
+    Segment *second = makeSegment(2, 0, 500);
+    composition.addSegment(first);
+    composition.addSegment(second);
+
+    CompositionSnapshotter snapshotter(composition);
+    const CompositionSnapshot::Ptr snapshot = snapshotter.takeSnapshot(1);
+    const long expected = checksum(*snapshot);
+
+    Reader reader(snapshot, expected);
+    reader.start();
+
+    // Edit the live composition every way we can while the reader runs.
+    for (int round = 0; round < 200; ++round) {
+        // Events in and out.
+        Event *note = new Event(Note::EventType, round * 10, 240);
+        note->set<Int>(BaseProperties::PITCH, 100);
+        first->insert(note);
+        if (round % 2)
+            first->eraseSingle(*first->begin());
+
+        // Move a segment about.
+        second->setStartTime(round * 240);
+
+        // Segments in and out.
+        Segment *extra = makeSegment(2, 96000, 50);
+        composition.addSegment(extra);
+        if (round % 3 == 0)
+            composition.deleteSegment(extra);
+
+        // New snapshots sharing with the old one as they go.
+        snapshotter.takeSnapshot(round + 2);
+    }
+
+    // Make sure the reader got a good look while all that went on.
+    while (reader.getPasses() < 10)
+        QThread::msleep(1);
+
+    reader.stop();
+    reader.wait();
+
+    QVERIFY(reader.isOK());
+    QCOMPARE(checksum(*snapshot), expected);
+    QVERIFY(checksum(*snapshotter.takeSnapshot(1000)) != expected);
+}
+
+QTEST_MAIN(TestCompositionSnapshot)
+
+#include "compositionsnapshot.moc"
@@ -0,0 +1,296 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#include "base/BaseProperties.h"
+#include "base/Composition.h"
+#include "base/CompositionSnapshot.h"
+#include "base/Event.h"
+#include "base/MidiTypes.h"
+#include "base/NotationTypes.h"
+#include "base/Segment.h"
+#include "base/Track.h"
+#include "document/io/CsoundExporter.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <sstream>
+#include <string>
+
+using namespace Rosegarden;
+
+/// Unit test and benchmark for CsoundExporter
+class TestCsoundExporter : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testExport();
+    void testWriteFile();
+    void benchmarkOldExport();
+    void benchmarkExport();
+    void benchmarkSnapshotAfterEdit();
+};
+
+namespace
+{
+    /// Notes with the odd rest and controller.
+    Segment *makeSegment(TrackId track, int count)
+    {
+        Segment *segment = new Segment;
+        segment->setTrack(track);
+        segment->setLabel("Segment " + std::to_string(track));
+
+        for (int i = 0; i < count; ++i) {
+            const timeT time = i * 240;
+
+            if (i % 10 == 9) {
+                segment->insert(new Event(Note::EventRestType, time, 240));
+                continue;
+            }
+            if (i % 10 == 5) {
+                Event *controller = new Event(Controller::EventType, time, 0);
+                controller->set<Int>(Controller::NUMBER, 7);
+                controller->set<Int>(Controller::VALUE, i % 128);
+                segment->insert(controller);
+                continue;
+            }
+
+            Event *note = new Event(Note::EventType, time, 240);
+            note->set<Int>(BaseProperties::PITCH, 40 + i % 48);
+            // Every so often, leave the velocity out.
+            if (i % 7 != 0)
+                note->set<Int>(BaseProperties::VELOCITY, 64 + i % 64);
+            segment->insert(note);
+        }
+
+        return segment;
+    }
+
+    void fill(Composition &composition, int tracks, int count)
+    {
+        composition.setCopyrightNote("Copyright the test");
+        composition.addTempoAtTime(0, Composition::getTempoForQpm(120));
+        composition.addTempoAtTime(960 * 8, Composition::getTempoForQpm(90));
+
+        for (TrackId id = 0; id < TrackId(tracks); ++id) {
+            Track *track = new Track(id);
+            track->setLabel("Track " + std::to_string(id));
+            composition.addTrack(track);
+            composition.addSegment(makeSegment(id, count));
+        }
+    }
+
+    const int benchmarkTracks = 16;
+    const int benchmarkEvents = 10000;
+
+    namespace Old
+    {
+        double convertTime(timeT t)
+        {
+            return double(t) / double(Note(Note::Crotchet).getDuration());
+        }
+
+        /// CsoundExporter::write() as it was, walking the Segments.
+        void write(Composition &composition, std::ostream &str)
+        {
+            str << ";; Csound score file written by Rosegarden\n\n";
+            if (composition.getCopyrightNote() != "") {
+                str << ";; Copyright note:\n;; "
+                    << composition.getCopyrightNote() << "\n";
+            }
+
+            for (Composition::iterator i = composition.begin();
+                 i != composition.end(); ++i) {
+
+                str << "\n;; Segment: \"" << (*i)->getLabel() << "\"\n";
+                str << ";; on Track: \""
+                    << composition.getTrackById((*i)->getTrack())->getLabel()
+                    << "\"\n";
+                str << ";;\n;; Inst\tStart\tDur\tAmp\tPch\n"
+                    << ";; ----\t----\t---\t-----\t----\n";
+
+                for (Segment::iterator j = (*i)->begin();
+                     j != (*i)->end(); ++j) {
+
+                    if ((*j)->isa(Note::EventType)) {
+
+                        long pitch = 0;
+                        (*j)->get<Int>(BaseProperties::PITCH, pitch);
+
+                        long velocity = 127;
+                        (*j)->get<Int>(BaseProperties::VELOCITY, velocity);
+
+                        str << "   i"
+                            << ((*i)->getTrack() + 1) << "\t"
+                            << convertTime((*j)->getAbsoluteTime()) << "\t"
+                            << convertTime((*j)->getDuration()) << "\t"
+                            << velocity << "\t"
+                            << 3 + (pitch / 12)
+                            << ((pitch % 12) < 10 ? ".0" : ".")
+                            << pitch % 12 << "\t\n";
+
+                    } else {
+                        str << ";; Event type: " << (*j)->getType()
+                            << std::endl;
+                    }
+                }
+            }
+
+            const int tempoCount = composition.getTempoChangeCount();
+
+            if (tempoCount > 0) {
+
+                str << "\nt ";
+
+                for (int i = 0; i < tempoCount - 1; ++i) {
+                    std::pair<timeT, tempoT> tempoChange =
+                        composition.getTempoChange(i);
+                    const timeT myTime = tempoChange.first;
+                    const timeT nextTime =
+                        composition.getTempoChange(i + 1).first;
+                    const int tempo =
+                        int(Composition::getTempoQpm(tempoChange.second));
+                    str << convertTime(myTime) << " " << tempo << " "
+                        << convertTime(nextTime) << " " << tempo << " ";
+                }
+
+                str << convertTime(
+                        composition.getTempoChange(tempoCount - 1).first)
+                    << " "
+                    << int(Composition::getTempoQpm(
+                        composition.getTempoChange(tempoCount - 1).second))
+                    << std::endl;
+            }
+
+            str << "\ne" << std::endl;
+        }
+    }
+
+    std::string exportSnapshot(CompositionSnapshot::Ptr snapshot)
+    {
+        std::ostringstream str;
+        CsoundExporter(nullptr, snapshot, std::string()).write(str);
+        return str.str();
+    }
+}
+
+void TestCsoundExporter::testExport()
+{
+    Composition composition;
+    fill(composition, 3, 200);
+
+    CompositionSnapshotter snapshotter(composition);
+    const std::string score = exportSnapshot(snapshotter.takeSnapshot(1));
+
+    std::ostringstream expected;
+    Old::write(composition, expected);
+    QCOMPARE(score, expected.str());
+
+    QVERIFY(score.find(";; Copyright note:\n;; Copyright the test") !=
+            std::string::npos);
+    QVERIFY(score.find(";; on Track: \"Track 2\"") != std::string::npos);
+    QVERIFY(score.find(";; Event type: controller") != std::string::npos);
+    QVERIFY(score.find("\nt 0 120 8 120 8 90\n") != std::string::npos);
+}
+
+void TestCsoundExporter::testWriteFile()
+{
+    Composition composition;
+    fill(composition, 2, 100);
+
+    CompositionSnapshotter snapshotter(composition);
+    const CompositionSnapshot::Ptr snapshot = snapshotter.takeSnapshot(1);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("score.sco");
+
+    CsoundExporter exporter(nullptr, snapshot, path.toStdString());
+    QVERIFY(exporter.write());
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll().toStdString(), exportSnapshot(snapshot));
+
+    CsoundExporter missing(nullptr, snapshot,
+                           dir.filePath("no/such/dir.sco").toStdString());
+    QVERIFY(!missing.write());
+}
+
+void TestCsoundExporter::benchmarkOldExport()
+{
+    // The whole export on the GUI thread, walking every Segment.
+    Composition composition;
+    fill(composition, benchmarkTracks, benchmarkEvents);
+
+    size_t size = 0;
+
+    QBENCHMARK {
+        std::ostringstream str;
+        Old::write(composition, str);
+        size = str.str().size();
+    }
+
+    QVERIFY(size > 0);
+}
+
+void TestCsoundExporter::benchmarkExport()
+{
+    // The same from the document's snapshotter, which has seen the
+    // composition before.  Only takeSnapshot() is left on the GUI thread.
+    Composition composition;
+    fill(composition, benchmarkTracks, benchmarkEvents);
+
+    CompositionSnapshotter snapshotter(composition);
+    snapshotter.takeSnapshot(1);
+
+    size_t size = 0;
+
+    QBENCHMARK {
+        size = exportSnapshot(snapshotter.takeSnapshot(1)).size();
+    }
+
+    QVERIFY(size > 0);
+}
+
+void TestCsoundExporter::benchmarkSnapshotAfterEdit()
+{
+    // What is left on the GUI thread when one segment has changed since
+    // the last snapshot.
+    Composition composition;
+    fill(composition, benchmarkTracks, benchmarkEvents);
+
+    CompositionSnapshotter snapshotter(composition);
+    snapshotter.takeSnapshot(1);
+
+    Segment *edited = *composition.begin();
+    unsigned version = 1;
+
+    QBENCHMARK {
+        Event *note = new Event(Note::EventType, 120, 240);
+        note->set<Int>(BaseProperties::PITCH, 60);
+        edited->insert(note);
+        snapshotter.takeSnapshot(++version);
+        edited->eraseSingle(note);
+    }
+
+    QVERIFY(version > 1);
+}
+
+QTEST_MAIN(TestCsoundExporter)
+
+#include "csoundexporter.moc"
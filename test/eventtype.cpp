@@ -0,0 +1,264 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#include "base/Event.h"
+#include "base/EventTypeName.h"
+#include "base/MidiTypes.h"
+#include "base/NotationTypes.h"
+
+#include <QTest>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Rosegarden;
+
+/// Unit test and benchmark for EventTypeName and Event::isa()
+class TestEventType : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testInterning();
+    void testIsa();
+    void testXml();
+    void benchmarkOldIsa();
+    void benchmarkOldGetType();
+    void benchmarkIsa();
+};
+
+namespace
+{
+    typedef std::vector<std::unique_ptr<Event>> EventVector;
+
+    /// Mostly notes, as in a typical Segment.
+    void fill(EventVector &events, int count)
+    {
+        for (int i = 0; i < count; ++i) {
+            const timeT time = i * 240;
+            switch (i % 10) {
+            case 3:
+                events.emplace_back(new Event(Note::EventRestType, time, 240));
+                break;
+            case 5:
+                events.emplace_back(new Event(Controller::EventType, time));
+                break;
+            case 7:
+                events.emplace_back(new Event(PitchBend::EventType, time));
+                break;
+            default:
+                events.emplace_back(new Event(Note::EventType, time, 240));
+                break;
+            }
+        }
+    }
+
+    const int benchmarkEvents = 100000;
+
+    namespace Old
+    {
+        /// Event as it was before types were interned: the type is a
+        /// std::string in the shared EventData, and getType() returns a
+        /// copy of it.
+        class Event
+        {
+        public:
+            Event(const std::string &type, timeT absoluteTime,
+                  timeT duration = 0) :
+                m_data(new EventData{type, absoluteTime, duration, 0})
+            { }
+
+            std::string getType() const  { return m_data->m_type; }
+            bool isa(const std::string &type) const
+                { return (m_data->m_type == type); }
+
+        private:
+            struct EventData
+            {
+                std::string m_type;
+                timeT m_absoluteTime;
+                timeT m_duration;
+                short m_subOrdering;
+            };
+            std::unique_ptr<EventData> m_data;
+        };
+
+        typedef std::vector<std::unique_ptr<Event>> EventVector;
+
+        /// The same events as the other fill().
+        void fill(EventVector &events, int count)
+        {
+            for (int i = 0; i < count; ++i) {
+                const timeT time = i * 240;
+                switch (i % 10) {
+                case 3:
+                    events.emplace_back(new Event("rest", time, 240));
+                    break;
+                case 5:
+                    events.emplace_back(new Event("controller", time));
+                    break;
+                case 7:
+                    events.emplace_back(new Event("pitchbend", time));
+                    break;
+                default:
+                    events.emplace_back(new Event("note", time, 240));
+                    break;
+                }
+            }
+        }
+
+        // Note::EventType and Note::EventRestType were std::strings.
+        const std::string noteType = "note";
+        const std::string restType = "rest";
+    }
+}
+
+void TestEventType::testInterning()
+{
+    const EventTypeName empty;
+    QCOMPARE(empty.getId(), 0u);
+    QCOMPARE(empty.getName(), std::string());
+    QCOMPARE(EventTypeName("").getId(), 0u);
+
+    const EventTypeName note("note");
+    QVERIFY(note == Note::EventType);
+    QCOMPARE(note.getId(), Note::EventType.getId());
+    QCOMPARE(note.getName(), std::string("note"));
+    QVERIFY(note != Note::EventRestType);
+
+    // Same name, same ID, however it arrives.
+    const std::string name = "testInterning";
+    const unsigned count = EventTypeName::getTypeCount();
+    const EventTypeName first(name);
+    const EventTypeName second(name.c_str());
+    QCOMPARE(first.getId(), second.getId());
+    QCOMPARE(EventTypeName::getTypeCount(), count + 1);
+    QVERIFY(first.getId() < EventTypeName::getTypeCount());
+
+    // Comparisons with plain strings.
+    QVERIFY(first == name);
+    QVERIFY(name == first);
+    QVERIFY(first == "testInterning");
+    QVERIFY(first != "note");
+    const std::string &asString = first;
+    QCOMPARE(asString, name);
+}
+
+void TestEventType::testIsa()
+{
+    const Event note(Note::EventType, 0, 480);
+    QVERIFY(note.isa(Note::EventType));
+    QVERIFY(!note.isa(Note::EventRestType));
+    QVERIFY(note.isa(std::string("note")));
+    QVERIFY(note.isa("note"));
+    QVERIFY(!note.isa("rest"));
+    QVERIFY(note.getType() == Note::EventType);
+    QCOMPARE(note.getType().getName(), std::string(Note::EventType));
+
+    // A type nobody has seen before.
+    const Event custom("testIsa", 0);
+    QVERIFY(custom.isa("testIsa"));
+    QVERIFY(custom.isa(EventTypeName("testIsa")));
+    QVERIFY(!custom.isa(Note::EventType));
+
+    // Copies keep the type.
+    const Event copy(custom, 960);
+    QVERIFY(copy.isa(custom.getType()));
+}
+
+void TestEventType::testXml()
+{
+    // The type is still written as the string.
+    const Event note(Note::EventType, 0, 480);
+    const std::string xml = note.toXmlString(0);
+    QVERIFY(xml.find("type=\"note\"") != std::string::npos);
+
+    const Event controller(Controller::EventType, 0);
+    QVERIFY(controller.toXmlString(0).find("type=\"controller\"") !=
+            std::string::npos);
+}
+
+void TestEventType::benchmarkOldIsa()
+{
+    Old::EventVector events;
+    Old::fill(events, benchmarkEvents);
+
+    int notes = 0;
+    int rests = 0;
+
+    // isa() as it was: a string compare against the type constant.
+    QBENCHMARK {
+        notes = rests = 0;
+        for (const std::unique_ptr<Old::Event> &event : events) {
+            if (event->isa(Old::noteType))
+                ++notes;
+            else if (event->isa(Old::restType))
+                ++rests;
+        }
+    }
+
+    QCOMPARE(notes, benchmarkEvents / 10 * 7);
+    QCOMPARE(rests, benchmarkEvents / 10);
+}
+
+void TestEventType::benchmarkOldGetType()
+{
+    Old::EventVector events;
+    Old::fill(events, benchmarkEvents);
+
+    int notes = 0;
+    int rests = 0;
+
+    // The other common form, which copied the type string each time.
+    QBENCHMARK {
+        notes = rests = 0;
+        for (const std::unique_ptr<Old::Event> &event : events) {
+            if (event->getType() == Old::noteType)
+                ++notes;
+            else if (event->getType() == Old::restType)
+                ++rests;
+        }
+    }
+
+    QCOMPARE(notes, benchmarkEvents / 10 * 7);
+    QCOMPARE(rests, benchmarkEvents / 10);
+}
+
+void TestEventType::benchmarkIsa()
+{
+    EventVector events;
+    fill(events, benchmarkEvents);
+
+    int notes = 0;
+    int rests = 0;
+
+    QBENCHMARK {
+        notes = rests = 0;
+        for (const std::unique_ptr<Event> &event : events) {
+            if (event->isa(Note::EventType))
+                ++notes;
+            else if (event->isa(Note::EventRestType))
+                ++rests;
+        }
+    }
+
+    QCOMPARE(notes, benchmarkEvents / 10 * 7);
+    QCOMPARE(rests, benchmarkEvents / 10);
+}
+
+QTEST_MAIN(TestEventType)
+
+#include "eventtype.moc"
@@ -0,0 +1,146 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#include "base/Composition.h"
+#include "base/NotationTypes.h"
+#include "base/RealTime.h"
+#include "document/RosegardenDocument.h"
+#include "gui/seqmanager/MEBIterator.h"
+#include "gui/seqmanager/MetronomeMapper.h"
+#include "sound/MappedEvent.h"
+
+#include <QSharedPointer>
+#include <QTest>
+
+#include <vector>
+
+using namespace Rosegarden;
+
+/// Unit test for MetronomeMapper
+class TestMetronomeMapper : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestMetronomeMapper() :
+        m_doc(nullptr,  // parent
+              {},  // audioPluginManager
+              true,  // skipAutoload
+              true,  // clearCommandHistory
+              false)  // enableSound
+    {
+    }
+
+private Q_SLOTS:
+    void initTestCase();
+    void testTempoRefresh();
+    void testShortBar();
+
+private:
+    RosegardenDocument m_doc;
+};
+
+namespace
+{
+    /// The times of the metronome ticks, leaving out any MIDI clocks.
+    std::vector<RealTime> tickTimes(QSharedPointer<MetronomeMapper> mapper)
+    {
+        std::vector<RealTime> times;
+
+        MEBIterator iter(mapper);
+        QReadLocker locker(iter.getLock());
+
+        while (!iter.atEnd()) {
+            const MappedEvent *event = iter.peek();
+            if (event->getType() == MappedEvent::MidiNoteOneShot)
+                times.push_back(event->getEventTime());
+            ++iter;
+        }
+
+        return times;
+    }
+}
+
+void TestMetronomeMapper::initTestCase()
+{
+    // Make sure settings end up in the right place.
+    QCoreApplication::setOrganizationName("rosegardenmusic");
+
+    RosegardenDocument::currentDocument = &m_doc;
+
+    Composition &composition = m_doc.getComposition();
+    composition.setEndMarker(composition.getBarStart(16));
+}
+
+void TestMetronomeMapper::testTempoRefresh()
+{
+    Composition &composition = m_doc.getComposition();
+
+    QSharedPointer<MetronomeMapper> mapper(new MetronomeMapper(&m_doc));
+
+    const std::vector<RealTime> before = tickTimes(mapper);
+    QVERIFY(!before.empty());
+
+    // Where each tick is in the composition.
+    std::vector<timeT> musicalTimes;
+    for (const RealTime &time : before) {
+        musicalTimes.push_back(composition.getElapsedTimeForRealTime(time));
+        QCOMPARE(composition.getElapsedRealTime(musicalTimes.back()), time);
+    }
+
+    // Halve the tempo from bar 4, then refresh as
+    // SequenceManager::tempoChanged() does.
+    const timeT bar4 = composition.getBarStart(4);
+    composition.addTempoAtTime(bar4, composition.getTempoAtTime(bar4) / 2);
+    mapper->refresh();
+
+    const std::vector<RealTime> after = tickTimes(mapper);
+    QCOMPARE(after.size(), before.size());
+
+    // The ticks stay where they were in the composition, but those
+    // after bar 4 sound later.
+    for (size_t i = 0; i < after.size(); ++i) {
+        QCOMPARE(after[i], composition.getElapsedRealTime(musicalTimes[i]));
+        if (musicalTimes[i] > bar4)
+            QVERIFY(after[i] > before[i]);
+        else
+            QCOMPARE(after[i], before[i]);
+    }
+}
+
+void TestMetronomeMapper::testShortBar()
+{
+    Composition &composition = m_doc.getComposition();
+
+    // Cut bar 2 short at its third beat with a change to 3/4.
+    const timeT bar2 = composition.getBarStart(2);
+    const int timeSig = composition.addTimeSignature(
+            bar2 + (composition.getBarEnd(2) - bar2) / 2,
+            TimeSignature(3, 4));
+
+    QSharedPointer<MetronomeMapper> mapper(new MetronomeMapper(&m_doc));
+    const std::vector<RealTime> times = tickTimes(mapper);
+
+    composition.removeTimeSignature(timeSig);
+
+    // The rest of the 4/4 bar would land on the 3/4 bar's beats.
+    QVERIFY(!times.empty());
+    for (size_t i = 1; i < times.size(); ++i)
+        QVERIFY(times[i - 1] < times[i]);
+}
+
+QTEST_MAIN(TestMetronomeMapper)
+
+#include "metronomemapper.moc"
@@ -0,0 +1,324 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#include "sound/Midi.h"
+#include "sound/MidiEvent.h"
+#include "sound/MidiTrackEncoder.h"
+
+#include <QTest>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Rosegarden;
+
+/// Unit test and benchmark for MidiTrackEncoder
+class TestMidiTrackEncoder : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testVarLength();
+    void testAgainstOldWriter();
+    void testRoundTrip();
+    void benchmarkOldWriter();
+    void benchmarkEncoder();
+};
+
+namespace
+{
+    typedef std::vector<MidiEvent *> Track;
+
+    /// Owns the events in a Track.
+    struct TrackHolder
+    {
+        ~TrackHolder()
+        {
+            for (MidiEvent *event : track)
+                delete event;
+        }
+        Track track;
+    };
+
+    /// A bit of everything, with plenty of running status.
+    void fill(Track &track, int count)
+    {
+        track.push_back(new MidiEvent(0, MIDI_FILE_META_EVENT,
+                                      MIDI_TRACK_NAME, "Track name"));
+        track.push_back(new MidiEvent(0, MIDI_PROG_CHANGE | 2, 17));
+        track.push_back(new MidiEvent(0, MIDI_SYSTEM_EXCLUSIVE,
+                                      std::string("\x43\x10\x4c\xf7", 4)));
+
+        for (int i = 0; i < count; ++i) {
+            const MidiByte pitch = 36 + i % 60;
+            track.push_back(new MidiEvent(
+                    i % 5 ? 0 : 480, MIDI_NOTE_ON | 2, pitch, 100));
+            track.push_back(new MidiEvent(
+                    240, MIDI_NOTE_OFF | 2, pitch, 0));
+            if (i % 50 == 0)
+                track.push_back(new MidiEvent(
+                        10, MIDI_CTRL_CHANGE | 2, MIDI_CONTROLLER_RESET, 0));
+            if (i % 20 == 0)
+                track.push_back(new MidiEvent(
+                        0, MIDI_CTRL_CHANGE | 2, 7, i % 128));
+            if (i % 30 == 0)
+                track.push_back(new MidiEvent(
+                        0, MIDI_PITCH_BEND | 2, 0, 64));
+            if (i % 70 == 0)
+                track.push_back(new MidiEvent(
+                        0, MIDI_FILE_META_EVENT, MIDI_SET_TEMPO,
+                        std::string("\x07\xa1\x20", 3)));
+        }
+
+        // A delta needing the full four bytes.
+        track.push_back(new MidiEvent(0x0fffffff, MIDI_FILE_META_EVENT,
+                                      MIDI_END_OF_TRACK, ""));
+    }
+
+    /// MidiFile::longToVarBuffer() as it was.
+    std::string oldVarBuffer(unsigned long value)
+    {
+        long buffer = value & 0x7f;
+
+        while ((value >>= 7 ) > 0) {
+            buffer <<= 8;
+            buffer |= 0x80;
+            buffer += (value & 0x7f);
+        }
+
+        std::string returnString;
+
+        while (true) {
+            returnString += (MidiByte)(buffer & 0xff);
+            if (buffer & 0x80)
+                buffer >>= 8;
+            else
+                break;
+        }
+
+        return returnString;
+    }
+
+    /// MidiFile::writeTrack() as it was, without the file.
+    std::string oldWriter(const Track &track)
+    {
+        MidiByte previousEventCode = 0;
+        std::string trackBuffer;
+        timeT skippedTime = 0;
+
+        for (const MidiEvent *event : track) {
+            const MidiEvent &midiEvent = *event;
+
+            if (midiEvent.getEventCode() == MIDI_CTRL_CHANGE  &&
+                midiEvent.getData1() == MIDI_CONTROLLER_RESET) {
+                skippedTime += midiEvent.getTime();
+                continue;
+            }
+
+            trackBuffer += oldVarBuffer(midiEvent.getTime() + skippedTime);
+            skippedTime = 0;
+
+            if (midiEvent.isMeta()) {
+                trackBuffer += MIDI_FILE_META_EVENT;
+                trackBuffer += midiEvent.getMetaEventCode();
+                trackBuffer += oldVarBuffer(
+                        midiEvent.getMetaMessage().length());
+                trackBuffer += midiEvent.getMetaMessage();
+                previousEventCode = 0;
+            } else {
+                if ((midiEvent.getEventCode() != previousEventCode) ||
+                    (midiEvent.getEventCode() == MIDI_SYSTEM_EXCLUSIVE)) {
+                    trackBuffer += midiEvent.getEventCode();
+                    previousEventCode = midiEvent.getEventCode();
+                }
+
+                switch (midiEvent.getMessageType()) {
+                case MIDI_NOTE_ON:
+                case MIDI_NOTE_OFF:
+                case MIDI_PITCH_BEND:
+                case MIDI_CTRL_CHANGE:
+                case MIDI_POLY_AFTERTOUCH:
+                    trackBuffer += midiEvent.getData1();
+                    trackBuffer += midiEvent.getData2();
+                    break;
+                case MIDI_PROG_CHANGE:
+                case MIDI_CHNL_AFTERTOUCH:
+                    trackBuffer += midiEvent.getData1();
+                    break;
+                case MIDI_SYSTEM_EXCLUSIVE:
+                    trackBuffer += oldVarBuffer(
+                            midiEvent.getMetaMessage().length());
+                    trackBuffer += midiEvent.getMetaMessage();
+                    break;
+                default:
+                    break;
+                }
+            }
+        }
+
+        const unsigned long length = trackBuffer.length();
+        std::string chunk = "MTrk";
+        chunk += char((length >> 24) & 0xff);
+        chunk += char((length >> 16) & 0xff);
+        chunk += char((length >> 8) & 0xff);
+        chunk += char(length & 0xff);
+        return chunk + trackBuffer;
+    }
+
+    unsigned long readVar(const std::string &chunk, size_t &position)
+    {
+        unsigned long value = 0;
+        unsigned char byte;
+        do {
+            byte = chunk[position++];
+            value = (value << 7) | (byte & 0x7f);
+        } while (byte & 0x80);
+        return value;
+    }
+
+    const int benchmarkNotes = 200000;
+}
+
+void TestMidiTrackEncoder::testVarLength()
+{
+    const unsigned long values[] = {
+        0, 0x40, 0x7f, 0x80, 0x2000, 0x3fff, 0x4000, 0x100000,
+        0x1fffff, 0x200000, 0x8000000, 0xfffffff, 0x10000000, 0xffffffff
+    };
+
+    for (unsigned long value : values) {
+        TrackHolder holder;
+        holder.track.push_back(new MidiEvent(value, MIDI_NOTE_ON, 60, 100));
+
+        std::string chunk;
+        MidiTrackEncoder::encode(holder.track, chunk);
+
+        QCOMPARE(chunk, oldWriter(holder.track));
+
+        size_t position = 8;
+        QCOMPARE(readVar(chunk, position), value);
+    }
+}
+
+void TestMidiTrackEncoder::testAgainstOldWriter()
+{
+    TrackHolder holder;
+    fill(holder.track, 1000);
+
+    std::string chunk;
+    MidiTrackEncoder::encode(holder.track, chunk);
+
+    QCOMPARE(chunk.size(), oldWriter(holder.track).size());
+    QVERIFY(chunk == oldWriter(holder.track));
+
+    // Empty tracks still get a header.
+    TrackHolder empty;
+    MidiTrackEncoder::encode(empty.track, chunk);
+    QCOMPARE(chunk, std::string("MTrk\0\0\0\0", 8));
+}
+
+void TestMidiTrackEncoder::testRoundTrip()
+{
+    // Decode what was encoded and make sure every event comes back.
+    TrackHolder holder;
+    fill(holder.track, 100);
+
+    std::string chunk;
+    MidiTrackEncoder::encode(holder.track, chunk);
+
+    const size_t length = (size_t(MidiByte(chunk[4])) << 24) |
+                          (size_t(MidiByte(chunk[5])) << 16) |
+                          (size_t(MidiByte(chunk[6])) << 8) |
+                          size_t(MidiByte(chunk[7]));
+    QCOMPARE(length, chunk.size() - 8);
+
+    size_t position = 8;
+    MidiByte runningStatus = 0;
+    timeT skippedTime = 0;
+
+    for (const MidiEvent *event : holder.track) {
+        if (event->getEventCode() == MIDI_CTRL_CHANGE  &&
+            event->getData1() == MIDI_CONTROLLER_RESET) {
+            skippedTime += event->getTime();
+            continue;
+        }
+
+        QCOMPARE(timeT(readVar(chunk, position)),
+                 event->getTime() + skippedTime);
+        skippedTime = 0;
+
+        MidiByte status = chunk[position];
+        if (status & 0x80)
+            ++position;
+        else
+            status = runningStatus;
+
+        QCOMPARE(status, event->getEventCode());
+
+        if (event->isMeta()) {
+            QCOMPARE(MidiByte(chunk[position++]), event->getMetaEventCode());
+            const size_t size = readVar(chunk, position);
+            QCOMPARE(chunk.substr(position, size), event->getMetaMessage());
+            position += size;
+            runningStatus = 0;
+        } else if (status == MIDI_SYSTEM_EXCLUSIVE) {
+            const size_t size = readVar(chunk, position);
+            QCOMPARE(chunk.substr(position, size), event->getMetaMessage());
+            position += size;
+            runningStatus = status;
+        } else {
+            QCOMPARE(MidiByte(chunk[position++]), event->getData1());
+            if (event->getMessageType() != MIDI_PROG_CHANGE  &&
+                event->getMessageType() != MIDI_CHNL_AFTERTOUCH)
+                QCOMPARE(MidiByte(chunk[position++]), event->getData2());
+            runningStatus = status;
+        }
+    }
+
+    QCOMPARE(position, chunk.size());
+}
+
+void TestMidiTrackEncoder::benchmarkOldWriter()
+{
+    TrackHolder holder;
+    fill(holder.track, benchmarkNotes);
+
+    size_t size = 0;
+
+    QBENCHMARK {
+        size = oldWriter(holder.track).size();
+    }
+
+    QVERIFY(size > 0);
+}
+
+void TestMidiTrackEncoder::benchmarkEncoder()
+{
+    TrackHolder holder;
+    fill(holder.track, benchmarkNotes);
+
+    std::string chunk;
+
+    QBENCHMARK {
+        MidiTrackEncoder::encode(holder.track, chunk);
+    }
+
+    QVERIFY(!chunk.empty());
+}
+
+QTEST_MAIN(TestMidiTrackEncoder)
+
+#include "miditrackencoder.moc"
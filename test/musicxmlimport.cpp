@@ -0,0 +1,526 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#include "base/Composition.h"
+#include "base/Event.h"
+#include "base/Segment.h"
+#include "base/Studio.h"
+#include "base/TimeSignature.h"
+#include "base/Track.h"
+#include "document/RosegardenDocument.h"
+#include "document/io/MusicXMLLoader.h"
+#include "document/io/MusicXMLPartReader.h"
+#include "document/io/MusicXMLXMLHandler.h"
+#include "document/io/XMLReader.h"
+
+#include <QFile>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <cstring>
+#include <memory>
+
+using namespace Rosegarden;
+
+/// Unit test and benchmark for MusicXMLPartReader
+/**
+ * Checks that importing through it builds the same document as reading
+ * the whole file with XMLReader, as MusicXMLLoader used to.
+ */
+class TestMusicXMLImport : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void testAgainstOld();
+    void testThreadCounts();
+    void testSplit();
+    void testFallback();
+    void testMalformed();
+    void testHandlerError();
+    void benchmarkOldLoad();
+    void benchmarkLoad();
+
+private:
+    QString write(const QString &name, const QByteArray &data);
+
+    QTemporaryDir m_dir;
+};
+
+namespace
+{
+    typedef std::unique_ptr<RosegardenDocument> DocumentPtr;
+
+    DocumentPtr makeDocument()
+    {
+        return DocumentPtr(new RosegardenDocument(
+                nullptr,  // parent
+                {},  // audioPluginManager
+                true,  // skipAutoload
+                true,  // clearCommandHistory
+                false));  // enableSound
+    }
+
+    namespace Old
+    {
+        /// What MusicXMLLoader::load() used to do.
+        bool load(const QString &fileName, RosegardenDocument *doc)
+        {
+            doc->getComposition().clear();
+            doc->getStudio().unassignAllInstruments();
+
+            MusicXMLXMLHandler handler(doc);
+
+            XMLReader reader;
+            reader.setHandler(&handler);
+
+            QFile file(fileName);
+            return reader.parse(file);
+        }
+    }
+
+    /// MusicXMLLoader::load() with a given number of threads.
+    bool load(const QString &fileName, RosegardenDocument *doc,
+              int threads)
+    {
+        doc->getComposition().clear();
+        doc->getStudio().unassignAllInstruments();
+
+        MusicXMLXMLHandler handler(doc);
+
+        MusicXMLPartReader reader;
+        reader.setHandler(&handler);
+        reader.setThreadCount(threads);
+
+        QFile file(fileName);
+        return reader.parse(file);
+    }
+
+    /// Everything the import puts in the document.
+    QStringList describe(RosegardenDocument *doc)
+    {
+        QStringList result;
+        const Composition &composition = doc->getComposition();
+
+        for (const Composition::TrackMap::value_type &pair :
+                 composition.getTracks()) {
+            const Track *track = pair.second;
+            result << QString("track %1 position %2 label %3 "
+                              "instrument %4 bracket %5")
+                      .arg(track->getId())
+                      .arg(track->getPosition())
+                      .arg(QString::fromStdString(track->getLabel()))
+                      .arg(track->getInstrument())
+                      .arg(track->getStaffBracket());
+        }
+
+        for (int i = 0; i < composition.getTimeSignatureCount(); ++i) {
+            const std::pair<timeT, TimeSignature> change =
+                composition.getTimeSignatureChange(i);
+            result << QString("time signature %1 %2/%3")
+                      .arg(change.first)
+                      .arg(change.second.getNumerator())
+                      .arg(change.second.getDenominator());
+        }
+
+        for (const Segment *segment : composition) {
+            result << QString("segment track %1 start %2 end %3 label %4")
+                      .arg(segment->getTrack())
+                      .arg(segment->getStartTime())
+                      .arg(segment->getEndMarkerTime())
+                      .arg(QString::fromStdString(segment->getLabel()));
+            for (const Event *event : *segment)
+                result << QString::fromStdString(event->toXmlString(0));
+        }
+
+        return result;
+    }
+
+    /// A partwise score.
+    /**
+     * Parts alternate between a grand staff with two voices and a single
+     * staff, in bracketed and braced groups.  There are chords, ties across
+     * bar lines, slurs, beams, dynamics, a time signature change and a key
+     * change.
+     */
+    QByteArray score(int parts, int measures,
+                     const QByteArray &between = "\n  ",
+                     const QByteArray &encoding = "UTF-8")
+    {
+        static const char steps[] = "CDEFGAB";
+
+        QByteArray xml;
+        xml += "<?xml version=\"1.0\" encoding=\"" + encoding +
+               "\" standalone=\"no\"?>\n"
+               "<!DOCTYPE score-partwise PUBLIC "
+               "\"-//Recordare//DTD MusicXML 3.0 Partwise//EN\" "
+               "\"http://www.musicxml.org/dtds/partwise.dtd\">\n"
+               "<score-partwise version=\"3.0\">\n"
+               "  <work><work-title>Generated</work-title></work>\n"
+               "  <part-list>\n";
+
+        for (int part = 0; part < parts; ++part) {
+            const QByteArray id = "P" + QByteArray::number(part + 1);
+            if (part % 4 == 0) {
+                xml += "    <part-group type=\"start\" number=\"1\">"
+                       "<group-symbol>" +
+                       QByteArray(part % 8 == 0 ? "bracket" : "brace") +
+                       "</group-symbol></part-group>\n";
+            }
+            xml += "    <score-part id=\"" + id + "\">\n"
+                   "      <part-name>Part " + QByteArray::number(part + 1) +
+                   "</part-name>\n"
+                   "      <score-instrument id=\"" + id + "-I1\">"
+                   "<instrument-name>Instrument</instrument-name>"
+                   "</score-instrument>\n"
+                   "      <midi-instrument id=\"" + id + "-I1\">"
+                   "<midi-channel>" + QByteArray::number(part % 16 + 1) +
+                   "</midi-channel><midi-program>" +
+                   QByteArray::number(part % 128 + 1) +
+                   "</midi-program></midi-instrument>\n"
+                   "    </score-part>\n";
+            if (part % 4 == 3  ||  part == parts - 1)
+                xml += "    <part-group type=\"stop\" number=\"1\"/>\n";
+        }
+        xml += "  </part-list>";
+
+        for (int part = 0; part < parts; ++part) {
+            const bool grandStaff = (part % 2 == 0);
+            xml += between;
+            xml += "<part id=\"P" + QByteArray::number(part + 1) + "\">\n";
+
+            for (int measure = 0; measure < measures; ++measure) {
+                const int beats = (measure * 2 >= measures) ? 3 : 4;
+                xml += "    <measure number=\"" +
+                       QByteArray::number(measure + 1) + "\">\n";
+
+                if (measure == 0  ||  measure * 2 == measures) {
+                    xml += "      <attributes>\n";
+                    if (measure == 0)
+                        xml += "        <divisions>2</divisions>\n";
+                    xml += "        <key><fifths>" +
+                           QByteArray::number(measure == 0 ? part % 5 - 2 : 1) +
+                           "</fifths><mode>major</mode></key>\n"
+                           "        <time><beats>" +
+                           QByteArray::number(beats) +
+                           "</beats><beat-type>4</beat-type></time>\n";
+                    if (measure == 0) {
+                        if (grandStaff) {
+                            xml += "        <staves>2</staves>\n"
+                                   "        <clef number=\"1\"><sign>G</sign>"
+                                   "<line>2</line></clef>\n"
+                                   "        <clef number=\"2\"><sign>F</sign>"
+                                   "<line>4</line></clef>\n";
+                        } else {
+                            xml += "        <clef><sign>C</sign>"
+                                   "<line>3</line></clef>\n";
+                        }
+                    }
+                    xml += "      </attributes>\n";
+                }
+
+                if (measure % 4 == 0) {
+                    xml += "      <direction placement=\"below\">\n"
+                           "        <direction-type><dynamics><" +
+                           QByteArray(measure % 8 == 0 ? "p" : "f") +
+                           "/></dynamics></direction-type>\n"
+                           "      </direction>\n";
+                }
+
+                // Voice 1: eighths and quarters, a chord on the first
+                // beat, a slur over the bar and a tie into the next bar.
+                for (int beat = 0; beat < beats; ++beat) {
+                    const int pitch = (part * 3 + measure + beat) % 7;
+                    const bool tieFromLast =
+                        (beat == 0  &&  measure % 2 == 1);
+                    const bool tieToNext =
+                        (beat == beats - 1  &&  measure % 2 == 0  &&
+                         measure + 1 < measures);
+                    const char step = (tieFromLast || tieToNext) ?
+                        'G' : steps[pitch];
+                    const bool eighths = (beat == 1);
+
+                    for (int n = 0; n < (eighths ? 2 : 1); ++n) {
+                        xml += "      <note>\n"
+                               "        <pitch><step>" + QByteArray(1, step) +
+                               "</step>" +
+                               QByteArray(pitch == 3 ?
+                                          "<alter>1</alter>" : "") +
+                               "<octave>5</octave></pitch>\n"
+                               "        <duration>" +
+                               QByteArray(eighths ? "1" : "2") +
+                               "</duration>\n";
+                        if (tieFromLast)
+                            xml += "        <tie type=\"stop\"/>\n";
+                        if (tieToNext)
+                            xml += "        <tie type=\"start\"/>\n";
+                        xml += "        <voice>1</voice>\n"
+                               "        <type>" +
+                               QByteArray(eighths ? "eighth" : "quarter") +
+                               "</type>\n";
+                        if (grandStaff)
+                            xml += "        <staff>1</staff>\n";
+                        if (eighths) {
+                            xml += "        <beam number=\"1\">" +
+                                   QByteArray(n == 0 ? "begin" : "end") +
+                                   "</beam>\n";
+                        }
+                        xml += "        <notations>";
+                        if (tieFromLast) xml += "<tied type=\"stop\"/>";
+                        if (tieToNext) xml += "<tied type=\"start\"/>";
+                        if (beat == beats - 1  &&  measure % 3 == 0)
+                            xml += "<slur number=\"1\" type=\"start\"/>";
+                        if (beat == 0  &&  measure % 3 == 1)
+                            xml += "<slur number=\"1\" type=\"stop\"/>";
+                        xml += "</notations>\n"
+                               "      </note>\n";
+                    }
+
+                    if (beat == 0  &&  !tieFromLast) {
+                        xml += "      <note>\n"
+                               "        <chord/>\n"
+                               "        <pitch><step>" +
+                               QByteArray(1, steps[(pitch + 2) % 7]) +
+                               "</step><octave>5</octave></pitch>\n"
+                               "        <duration>2</duration>\n"
+                               "        <voice>1</voice>\n"
+                               "        <type>quarter</type>\n" +
+                               QByteArray(grandStaff ?
+                                          "        <staff>1</staff>\n" : "") +
+                               "      </note>\n";
+                    }
+                }
+
+                if (!grandStaff) {
+                    xml += "    </measure>\n";
+                    continue;
+                }
+
+                // Voice 2 on the lower staff: a rest then a long note.
+                xml += "      <backup><duration>" +
+                       QByteArray::number(beats * 2) +
+                       "</duration></backup>\n"
+                       "      <note>\n"
+                       "        <rest/>\n"
+                       "        <duration>2</duration>\n"
+                       "        <voice>2</voice>\n"
+                       "        <type>quarter</type>\n"
+                       "        <staff>2</staff>\n"
+                       "      </note>\n"
+                       "      <note>\n"
+                       "        <pitch><step>" +
+                       QByteArray(1, steps[(part + measure) % 7]) +
+                       "</step><octave>3</octave></pitch>\n"
+                       "        <duration>" +
+                       QByteArray::number(beats * 2 - 2) +
+                       "</duration>\n"
+                       "        <voice>2</voice>\n"
+                       "        <type>half</type>\n" +
+                       QByteArray(beats == 3 ? "" : "        <dot/>\n") +
+                       "        <staff>2</staff>\n"
+                       "      </note>\n"
+                       "    </measure>\n";
+            }
+
+            xml += "  </part>";
+        }
+
+        xml += "\n</score-partwise>\n";
+        return xml;
+    }
+
+    /// Load fileName both ways and compare.
+    void compare(const QString &fileName, bool expectedOk = true)
+    {
+        DocumentPtr expected = makeDocument();
+        DocumentPtr actual = makeDocument();
+
+        QCOMPARE(Old::load(fileName, expected.get()), expectedOk);
+
+        MusicXMLLoader loader;
+        QCOMPARE(loader.load(fileName, actual.get()), expectedOk);
+
+        QCOMPARE(describe(actual.get()), describe(expected.get()));
+    }
+
+    const int benchmarkParts = 24;
+    const int benchmarkMeasures = 200;
+}
+
+void TestMusicXMLImport::initTestCase()
+{
+    // Make sure settings end up in the right place.
+    QCoreApplication::setOrganizationName("rosegardenmusic");
+
+    QVERIFY(m_dir.isValid());
+}
+
+QString TestMusicXMLImport::write(const QString &name,
+                                  const QByteArray &data)
+{
+    const QString fileName = m_dir.filePath(name);
+    QFile file(fileName);
+    if (!file.open(QFile::WriteOnly)) return QString();
+    file.write(data);
+    return fileName;
+}
+
+void TestMusicXMLImport::testAgainstOld()
+{
+    const QString fileName = write("score.xml", score(10, 12));
+    QVERIFY(!fileName.isEmpty());
+
+    DocumentPtr doc = makeDocument();
+    QVERIFY(Old::load(fileName, doc.get()));
+    const QStringList description = describe(doc.get());
+    QVERIFY(description.size() > 500);
+    QVERIFY(!description.filter("time signature").isEmpty());
+
+    compare(fileName);
+}
+
+void TestMusicXMLImport::testThreadCounts()
+{
+    const QString fileName = write("threads.xml", score(7, 6));
+
+    DocumentPtr expected = makeDocument();
+    QVERIFY(Old::load(fileName, expected.get()));
+
+    for (int threads : { 1, 2, 3, 16 }) {
+        DocumentPtr actual = makeDocument();
+        QVERIFY(load(fileName, actual.get(), threads));
+        QCOMPARE(describe(actual.get()), describe(expected.get()));
+    }
+}
+
+void TestMusicXMLImport::testSplit()
+{
+    const QByteArray data = score(3, 2);
+    MusicXMLPartReader::Layout layout;
+    QVERIFY(MusicXMLPartReader::split(data, layout));
+
+    QCOMPARE(layout.rootName, QByteArray("score-partwise"));
+    QVERIFY(data.left(layout.rootEnd).endsWith(
+            "<score-partwise version=\"3.0\">"));
+    QCOMPARE(int(layout.parts.size()), 3);
+    for (size_t i = 0; i < layout.parts.size(); ++i) {
+        const QByteArray part = data.mid(
+                layout.parts[i].first,
+                layout.parts[i].second - layout.parts[i].first);
+        QVERIFY(part.startsWith(
+                "<part id=\"P" + QByteArray::number(int(i) + 1) + "\">"));
+        QVERIFY(part.endsWith("</part>"));
+    }
+
+    // Markup that looks like a part but isn't.
+    QVERIFY(MusicXMLPartReader::split(
+            "<score-partwise>\n"
+            "<part-list><score-part id=\"P1\"><part-name>a > b</part-name>"
+            "</score-part></part-list>\n"
+            "<!-- <part id=\"P0\"> -->\n"
+            "<part id=\"P1\"><measure number=\"1\"><words a='</part>'/>"
+            "<![CDATA[</part>]]></measure></part>\n"
+            "<part id=\"P2\"/>\n"
+            "</score-partwise>\n", layout));
+    QCOMPARE(int(layout.parts.size()), 2);
+
+    // Things that have to be read in one piece.
+    const char *const fallbacks[] = {
+        "<?xml version=\"1.0\" encoding=\"ISO-8859-1\"?>"
+            "<score-partwise><part/></score-partwise>",
+        "<!DOCTYPE score-partwise [<!ENTITY x \"y\">]>"
+            "<score-partwise><part/></score-partwise>",
+        "<score-timewise><measure><part/></measure></score-timewise>",
+        "<score-partwise><part/> text <part/></score-partwise>",
+        "<score-partwise><part/><!-- c --><part/></score-partwise>",
+        "<score-partwise><part/><other/><part/></score-partwise>",
+        "<score-partwise><part-list/></score-partwise>",
+        "<score-partwise><part><measure></part></score-partwise>",
+        "<score-partwise><part/>"
+    };
+    for (const char *fallback : fallbacks)
+        QVERIFY2(!MusicXMLPartReader::split(fallback, layout), fallback);
+}
+
+void TestMusicXMLImport::testFallback()
+{
+    // Something between the parts.
+    compare(write("between.xml", score(3, 2, "\n  <!-- next -->\n  ")));
+
+    // Not UTF-8.
+    QByteArray latin1 = score(3, 2, "\n  ", "ISO-8859-1");
+    latin1.replace("Part 2", "Partie \xe9");
+    compare(write("latin1.xml", latin1));
+
+    // Line ends the reader normalizes, between the parts.
+    compare(write("crlf.xml", score(3, 2, "\r\n  \r  ")));
+}
+
+void TestMusicXMLImport::testMalformed()
+{
+    // Mismatched tags in the third part.
+    QByteArray data = score(5, 4);
+    const int third = data.indexOf("<part id=\"P3\">");
+    const int note = data.indexOf("</pitch>", third);
+    data.replace(note, int(strlen("</pitch>")), "</pitched>");
+    compare(write("malformed.xml", data));
+}
+
+void TestMusicXMLImport::testHandlerError()
+{
+    // A part that isn't in the part-list.
+    QByteArray data = score(5, 4);
+    data.replace("<part id=\"P4\">", "<part id=\"P9\">");
+    compare(write("undefined.xml", data), false);
+}
+
+void TestMusicXMLImport::benchmarkOldLoad()
+{
+    const QString fileName = write(
+            "benchmark.xml", score(benchmarkParts, benchmarkMeasures));
+
+    int segments = 0;
+
+    QBENCHMARK {
+        DocumentPtr doc = makeDocument();
+        QVERIFY(Old::load(fileName, doc.get()));
+        segments = int(doc->getComposition().getNbSegments());
+    }
+
+    QVERIFY(segments > 0);
+}
+
+void TestMusicXMLImport::benchmarkLoad()
+{
+    const QString fileName = write(
+            "benchmark.xml", score(benchmarkParts, benchmarkMeasures));
+
+    int segments = 0;
+
+    QBENCHMARK {
+        DocumentPtr doc = makeDocument();
+        MusicXMLLoader loader;
+        QVERIFY(loader.load(fileName, doc.get()));
+        segments = int(doc->getComposition().getNbSegments());
+    }
+
+    QVERIFY(segments > 0);
+}
+
+QTEST_MAIN(TestMusicXMLImport)
+
+#include "musicxmlimport.moc"
@@ -0,0 +1,188 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#include "base/Composition.h"
+#include "base/Event.h"
+#include "base/NotationTypes.h"
+#include "base/Segment.h"
+#include "document/RosegardenDocument.h"
+#include "gui/editors/notation/NotationView.h"
+#include "gui/editors/notation/NotePixmapFactory.h"
+#include "misc/ConfigGroups.h"
+#include "misc/Preferences.h"
+
+#include <QFont>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QTest>
+
+#include <vector>
+
+using namespace Rosegarden;
+
+/// Benchmark for notation rendering and the settings it reads
+/**
+ * Layout and rendering read "showinvisibles" for invisible elements and
+ * the text fonts for text.  They used to construct a QSettings for each.
+ */
+class TestNotationRender : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestNotationRender() :
+        m_doc(nullptr,  // parent
+              {},  // audioPluginManager
+              true,  // skipAutoload
+              true,  // clearCommandHistory
+              false)  // enableSound
+    {
+    }
+
+private Q_SLOTS:
+    void initTestCase();
+    void testTextFont();
+    void benchmarkOldSettings();
+    void benchmarkPreferences();
+    void benchmarkRender();
+
+private:
+    RosegardenDocument m_doc;
+    std::vector<Segment *> m_segments;
+};
+
+namespace
+{
+    namespace Old
+    {
+        /// What rendering used to read for each element.
+        int read(const Event *event)
+        {
+            int result = 0;
+
+            QSettings settings;
+            settings.beginGroup(NotationOptionsConfigGroup);
+            if (settings.value("showinvisibles", true).toBool())
+                ++result;
+            settings.endGroup();
+
+            if (event->isa(Text::EventType)) {
+                settings.beginGroup(NotationViewConfigGroup);
+                const QString font = settings.value(
+                        "textfont",
+                        QFont(NotePixmapFactory::defaultSerifFontFamily))
+                    .toString();
+                result += font.size();
+            }
+
+            return result;
+        }
+    }
+
+    int read(const Event *event)
+    {
+        int result = 0;
+
+        if (Preferences::getShowInvisibles())
+            ++result;
+
+        if (event->isa(Text::EventType)) {
+            result += Preferences::getNotationTextFont(
+                    NotePixmapFactory::defaultSerifFontFamily).size();
+        }
+
+        return result;
+    }
+}
+
+void TestNotationRender::initTestCase()
+{
+    // Make sure settings end up in the right place, and not in the
+    // user's own configuration, as testTextFont() writes to it.
+    QStandardPaths::setTestModeEnabled(true);
+    QCoreApplication::setOrganizationName("rosegardenmusic");
+
+    RosegardenDocument::currentDocument = &m_doc;
+
+    const QString input = QFINDTESTDATA("../data/examples/mozart-quartet.rg");
+    QVERIFY(!input.isEmpty()); // file not found
+    QVERIFY(m_doc.openDocument(
+            input,
+            false,  // permanent
+            true,  // squelchProgressDialog
+            false));  // enableLock
+
+    for (Segment *segment : m_doc.getComposition())
+        m_segments.push_back(segment);
+    QVERIFY(!m_segments.empty());
+}
+
+void TestNotationRender::testTextFont()
+{
+    // The cache reads what the configuration page writes, and is
+    // stored the same way.
+    const QFont font("Test Serif", 13);
+    Preferences::setNotationTextFont(font);
+    QCOMPARE(Preferences::getNotationTextFont(
+                     NotePixmapFactory::defaultSerifFontFamily),
+             font.toString());
+
+    QSettings settings;
+    settings.beginGroup(NotationViewConfigGroup);
+    QCOMPARE(settings.value("textfont").value<QFont>(), font);
+}
+
+void TestNotationRender::benchmarkOldSettings()
+{
+    int total = 0;
+
+    QBENCHMARK {
+        total = 0;
+        for (const Segment *segment : m_segments) {
+            for (const Event *event : *segment)
+                total += Old::read(event);
+        }
+    }
+
+    QVERIFY(total > 0);
+}
+
+void TestNotationRender::benchmarkPreferences()
+{
+    int total = 0;
+
+    QBENCHMARK {
+        total = 0;
+        for (const Segment *segment : m_segments) {
+            for (const Event *event : *segment)
+                total += read(event);
+        }
+    }
+
+    QVERIFY(total > 0);
+}
+
+void TestNotationRender::benchmarkRender()
+{
+    // Layout and render every staff.
+    QBENCHMARK {
+        NotationView view(&m_doc, m_segments);
+        QVERIFY(view.getCurrentSegment());
+    }
+}
+
+QTEST_MAIN(TestNotationRender)
+
+#include "notationrender.moc"
@@ -0,0 +1,153 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#include "sound/OnsetDetector.h"
+
+#include "clicktrack.h"
+
+#include <QTest>
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace Rosegarden;
+
+/// Unit test and benchmark for OnsetDetector
+class TestOnsetDetector : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testTonalClicks();
+    void testNoiseBursts();
+    void testSilence();
+    void testAnalysis();
+    void benchmark();
+};
+
+namespace
+{
+    using ClickTrack::sampleRate;
+
+    /// A click track with slightly irregular spacing.
+    /**
+     * The click positions are returned in clicks.
+     */
+    std::vector<float> makeClickTrack(long frames, bool tonal,
+                                      std::vector<long> &clicks)
+    {
+        clicks.clear();
+        long position = sampleRate / 10;
+        for (int k = 0; position < frames - long(sampleRate) / 2; ++k) {
+            clicks.push_back(position);
+            position += sampleRate / 4 + (k % 7) * 97;
+        }
+
+        return ClickTrack::make(frames, clicks, tonal);
+    }
+
+    void checkOnsets(const std::vector<long> &onsets,
+                     const std::vector<long> &clicks)
+    {
+        QCOMPARE(onsets.size(), clicks.size());
+        for (size_t i = 0; i < clicks.size(); ++i) {
+            // Sample accurate, give or take a couple.
+            QVERIFY(std::abs(onsets[i] - clicks[i]) <= 2);
+        }
+    }
+}
+
+void TestOnsetDetector::testTonalClicks()
+{
+    std::vector<long> clicks;
+    std::vector<float> samples =
+            makeClickTrack(sampleRate * 10, true, clicks);
+
+    OnsetDetector detector(sampleRate, 50);
+    checkOnsets(detector.findOnsets(&samples[0], long(samples.size())),
+                clicks);
+
+    // Same again on a single thread.
+    detector.setThreadCount(1);
+    checkOnsets(detector.findOnsets(&samples[0], long(samples.size())),
+                clicks);
+}
+
+void TestOnsetDetector::testNoiseBursts()
+{
+    std::vector<long> clicks;
+    std::vector<float> samples =
+            makeClickTrack(sampleRate * 10, false, clicks);
+
+    OnsetDetector detector(sampleRate, 50);
+    checkOnsets(detector.findOnsets(&samples[0], long(samples.size())),
+                clicks);
+}
+
+void TestOnsetDetector::testSilence()
+{
+    std::vector<float> samples(sampleRate, 0.0f);
+
+    OnsetDetector detector(sampleRate, 100);
+    QVERIFY(detector.findOnsets(&samples[0], long(samples.size())).empty());
+}
+
+void TestOnsetDetector::testAnalysis()
+{
+    std::vector<long> clicks;
+    std::vector<float> samples =
+            makeClickTrack(sampleRate * 10, false, clicks);
+
+    // As AudioSplitDialog keeps it, for a region starting a second in.
+    OnsetAnalysis analysis;
+    analysis.sampleRate = sampleRate;
+    analysis.startFrame = sampleRate;
+    analysis.samples = samples;
+    OnsetDetector(sampleRate, 1).getOnsetEnvelope(
+            &samples[0], long(samples.size()), analysis.envelope);
+
+    // The envelope doesn't depend on the sensitivity, so picking the
+    // onsets out of it again finds what a fresh pass would.
+    for (int sensitivity : { 1, 20, 50, 80, 100 }) {
+        OnsetDetector detector(sampleRate, sensitivity);
+        std::vector<long> expected =
+                detector.findOnsets(&samples[0], long(samples.size()));
+        for (long &onset : expected)
+            onset += analysis.startFrame;
+        QCOMPARE(detector.findOnsets(analysis), expected);
+    }
+}
+
+void TestOnsetDetector::benchmark()
+{
+    // Five minutes of clicks.
+    std::vector<long> clicks;
+    std::vector<float> samples =
+            makeClickTrack(sampleRate * 300, false, clicks);
+
+    OnsetDetector detector(sampleRate, 50);
+    std::vector<long> onsets;
+
+    QBENCHMARK {
+        onsets = detector.findOnsets(&samples[0], long(samples.size()));
+    }
+
+    QCOMPARE(onsets.size(), clicks.size());
+}
+
+QTEST_MAIN(TestOnsetDetector)
+
+#include "onsetdetector.moc"
@@ -0,0 +1,523 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#include "base/Event.h"
+#include "base/NotationTypes.h"
+
+#include <QTest>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Rosegarden;
+
+/// Unit test and benchmark for the Key, Clef and Pitch spelling tables
+/**
+ * The expected values below were taken from the string-comparing code
+ * the tables replaced.  The exhaustive spelling checks are too big to
+ * list, so for each key they are reduced to a digest of every result
+ * in a fixed order; spellings[] has the old code's digests.
+ */
+class TestPitchTables : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testKeys();
+    void testKeyConstructors();
+    void testClefs();
+    void testAccidentalHeights();
+    void testRawToDisplay();
+    void testDisplayStrategies();
+    void testDisplayToRaw();
+    void benchmarkSpelling();
+};
+
+namespace
+{
+    struct KeyData
+    {
+        const char *name;
+        bool minor;
+        bool sharp;
+        int tonicPitch;
+        int accidentalCount;
+        /// getAccidentalForStep() for steps 0 to 6: '#', 'b' or '.'.
+        const char *steps;
+        const char *rosegarden2Name;
+        const char *equivalent;
+    };
+
+    /// In name order, as Key has always kept them.
+    const KeyData keys[] = {
+        { "A major",   false, true,   9, 3, "..#..##", "A  maj / F# min", "F# minor" },
+        { "A minor",   true,  false,  9, 0, ".......", "C  maj / A  min", "C major" },
+        { "A# minor",  true,  true,  10, 7, "#######", "C# maj / A# min", "C# major" },
+        { "Ab major",  false, false,  8, 4, "bb.bb..", "Ab maj / F  min", "F minor" },
+        { "Ab minor",  true,  false,  8, 7, "bbbbbbb", "Cb maj / Ab min", "Cb major" },
+        { "B major",   false, true,  11, 5, ".##.###", "B  maj / G# min", "G# minor" },
+        { "B minor",   true,  true,  11, 2, ".#..#..", "D  maj / B  min", "D major" },
+        { "Bb major",  false, false, 10, 2, "b..b...", "Bb maj / G  min", "G minor" },
+        { "Bb minor",  true,  false, 10, 5, "b.bb.bb", "Db maj / Bb min", "Db major" },
+        { "C major",   false, true,   0, 0, ".......", "C  maj / A  min", "A minor" },
+        { "C minor",   true,  false,  0, 3, "..b..bb", "Eb maj / C  min", "Eb major" },
+        { "C# major",  false, true,   1, 7, "#######", "C# maj / A# min", "A# minor" },
+        { "C# minor",  true,  true,   1, 4, "##.##..", "E  maj / C# min", "E major" },
+        { "Cb major",  false, false, 11, 7, "bbbbbbb", "Cb maj / Ab min", "Ab minor" },
+        { "D major",   false, true,   2, 2, "..#...#", "D  maj / B  min", "B minor" },
+        { "D minor",   true,  false,  2, 1, ".....b.", "F  maj / D  min", "F major" },
+        { "D# minor",  true,  true,   3, 6, "#####.#", "F# maj / D# min", "F# major" },
+        { "Db major",  false, false,  1, 5, "bb.bbb.", "Db maj / Bb min", "Bb minor" },
+        { "E major",   false, true,   4, 4, ".##..##", "E  maj / C# min", "C# minor" },
+        { "E minor",   true,  true,   4, 1, ".#.....", "G  maj / E  min", "G major" },
+        { "Eb major",  false, false,  3, 3, "b..bb..", "Eb maj / C  min", "C minor" },
+        { "Eb minor",  true,  false,  3, 6, "b.bbbbb", "Gb maj / Eb min", "Gb major" },
+        { "F major",   false, false,  5, 1, "...b...", "F  maj / D  min", "D minor" },
+        { "F minor",   true,  false,  5, 4, "..bb.bb", "Ab maj / F  min", "Ab major" },
+        { "F# major",  false, true,   6, 6, "###.###", "F# maj / D# min", "D# minor" },
+        { "F# minor",  true,  true,   6, 3, "##..#..", "A  maj / F# min", "A major" },
+        { "G major",   false, true,   7, 1, "......#", "G  maj / E  min", "E minor" },
+        { "G minor",   true,  false,  7, 2, "..b..b.", "Bb maj / G  min", "Bb major" },
+        { "G# minor",  true,  true,   8, 5, "##.##.#", "B  maj / G# min", "B major" },
+        { "Gb major",  false, false,  6, 6, "bbbbbb.", "Gb maj / Eb min", "Eb minor" },
+        { "undefined", false, true,   0, 0, ".......", "C  maj / A  min", "A minor" },
+    };
+
+    // Names rather than the Clef constants, which may not have been
+    // made yet when this table is.
+    struct ClefData
+    {
+        const char *name;
+        int pitchOffset;
+        /// With no octave offset.
+        int octave;
+        int axisHeight;
+        /// Key::getAccidentalHeights() for seven sharps and seven flats.
+        /// Keys with fewer get the first so many.
+        std::vector<int> sharpHeights;
+        std::vector<int> flatHeights;
+    };
+
+    const ClefData clefs[] = {
+        { "treble",        0,  0, 2,
+          { 8, 5, 9, 6, 3, 7, 4 },
+          { 4, 7, 3, 6, 2, 5, 1 } },
+        { "french",       -2,  0, 0,
+          { 6, 3, 7, 4, 1, 5, 2 },
+          { 2, 5, 1, 4, 0, 3, -1 } },
+        { "soprano",      -5, -1, 0,
+          { 3, 0, 4, 1, -2, 2, -1 },
+          { -1, 2, -2, 1, -3, 0, -4 } },
+        { "mezzosoprano", -3, -1, 2,
+          { 5, 2, 6, 3, 0, 4, 1 },
+          { 1, 4, 0, 3, -1, 2, -2 } },
+        { "alto",         -1, -1, 4,
+          { 7, 4, 8, 5, 2, 6, 3 },
+          { 3, 6, 2, 5, 1, 4, 0 } },
+        { "tenor",         1, -1, 6,
+          { 2, 6, 3, 7, 4, 8, 5 },
+          { 5, 8, 4, 7, 3, 6, 2 } },
+        { "baritone",      3, -1, 8,
+          { 4, 8, 5, 2, 6, 3, 7 },
+          { 7, 3, 6, 2, 5, 8, 4 } },
+        { "varbaritone",  -4, -2, 4,
+          { 4, 1, 5, 2, -1, 3, 0 },
+          { 0, 3, -1, 2, -2, 1, -3 } },
+        { "bass",         -2, -2, 6,
+          { 6, 3, 7, 4, 1, 5, 2 },
+          { 2, 5, 1, 4, 0, 3, -1 } },
+        { "subbass",       0, -2, 8,
+          { 8, 5, 9, 6, 3, 7, 4 },
+          { 4, 7, 3, 6, 2, 5, 1 } },
+        { "twobar",        0, -1, 4,
+          { 8, 5, 9, 6, 3, 7, 4 },
+          { 4, 7, 3, 6, 2, 5, 1 } },
+        { "undefined",    -2, -1, 6,
+          { 6, 3, 7, 4, 1, 5, 2 },
+          { 2, 5, 1, 4, 0, 3, -1 } },
+    };
+
+    /// Digests of the exhaustive checks, per key, in the order of keys[].
+    struct SpellingData
+    {
+        const char *key;
+        uint32_t accidentalAtHeight;
+        uint32_t rawToDisplay;
+        uint32_t strategies;
+        uint32_t displayToRaw;
+    };
+
+    const SpellingData spellings[] = {
+        { "A major",   0xa5c97b67, 0x807ff2c6, 0x72236c8f, 0xaba0fc9e },
+        { "A minor",   0x8e341ab9, 0x2a453949, 0xe0a205ed, 0x30db3571 },
+        { "A# minor",  0xf2cdc571, 0x1157c469, 0xd22082ee, 0x0789aafa },
+        { "Ab major",  0xd37c9789, 0xbcbe4ed5, 0xc2f65df6, 0x90773131 },
+        { "Ab minor",  0x40a211d5, 0xc10b062a, 0xf22b3b8b, 0xb8fe8cb1 },
+        { "B major",   0x9796af43, 0x234481aa, 0x5b9b3b0d, 0x6dcda8bd },
+        { "B minor",   0x76fa8247, 0x807ff2c6, 0xc9923cab, 0x56ab9c71 },
+        { "Bb major",  0xa6463e79, 0x0c1c72fd, 0x3c1538b9, 0x50bf71d0 },
+        { "Bb minor",  0xca85a77b, 0xbcbe4ed5, 0xfb72a4bc, 0xef38ab91 },
+        { "C major",   0x8e341ab9, 0x56665741, 0xaf0aae11, 0x30db3571 },
+        { "C minor",   0x82eca9ab, 0x0c1c72fd, 0x194e66d9, 0xcaecfff1 },
+        { "C# major",  0xf2cdc571, 0x8b195db6, 0xaf0fb432, 0x0789aafa },
+        { "C# minor",  0xb9209573, 0x234481aa, 0x449a06c9, 0xf3fbbb5e },
+        { "Cb major",  0x40a211d5, 0xfa31bc4d, 0xd0a5e521, 0xb8fe8cb1 },
+        { "D major",   0x76fa8247, 0x943021e2, 0x371c503f, 0x56ab9c71 },
+        { "D minor",   0x9f7825e7, 0x56665741, 0xdab555e5, 0x171a1cd0 },
+        { "D# minor",  0xb4f05f8d, 0x8b195db6, 0x83ad85f7, 0x0cdde3dd },
+        { "Db major",  0xca85a77b, 0xd91d9351, 0x92e985a8, 0xef38ab91 },
+        { "E major",   0xb9209573, 0x19b0b5c9, 0xce5174cc, 0xf3fbbb5e },
+        { "E minor",   0x2c950a07, 0x943021e2, 0x40162171, 0x730d16f1 },
+        { "Eb major",  0x82eca9ab, 0x81cbe32a, 0x7bb9586b, 0xcaecfff1 },
+        { "Eb minor",  0xea4f33a9, 0xd91d9351, 0x8fad9cab, 0x827e0771 },
+        { "F major",   0x9f7825e7, 0xa7e65bfe, 0x6244e1fb, 0x171a1cd0 },
+        { "F minor",   0xd37c9789, 0x81cbe32a, 0xc09fdda1, 0x90773131 },
+        { "F# major",  0xb4f05f8d, 0x2300aef9, 0xa7b77721, 0x0cdde3dd },
+        { "F# minor",  0xa5c97b67, 0x19b0b5c9, 0x43de84c0, 0xaba0fc9e },
+        { "G major",   0x2c950a07, 0x2a453949, 0x5d858817, 0x730d16f1 },
+        { "G minor",   0xa6463e79, 0xa7e65bfe, 0x4bab6d33, 0x50bf71d0 },
+        { "G# minor",  0x9796af43, 0x2300aef9, 0x1ea6e46d, 0x6dcda8bd },
+        { "Gb major",  0xea4f33a9, 0xc10b062a, 0x30a7d5fd, 0x827e0771 },
+        { "undefined", 0x8e341ab9, 0x56665741, 0xaf0aae11, 0x30db3571 },
+    };
+
+    /// Pitch(pitch, 0).getHeightOnStaff(Clef(), useSharps) for every
+    /// pitch, flats then sharps.
+    const uint32_t cMajorHeights = 0x72213f5f;
+
+    /// A few spellings to read, for when a digest doesn't match.
+    struct SpotData
+    {
+        const char *key;
+        const char *clef;
+        int pitch;
+        const Accidental *accidental;
+        int height;
+        const Accidental *displayAccidental;
+    };
+
+    const SpotData spots[] = {
+        { "C major",  "treble", 60, &Accidentals::NoAccidental,  -2, &Accidentals::NoAccidental },
+        { "D major",  "treble", 61, &Accidentals::NoAccidental,  -2, &Accidentals::NoAccidental },
+        { "Db major", "treble", 61, &Accidentals::NoAccidental,  -1, &Accidentals::NoAccidental },
+        { "F# major", "treble", 65, &Accidentals::NoAccidental,   0, &Accidentals::NoAccidental },
+        { "Cb major", "treble", 59, &Accidentals::NoAccidental,  -2, &Accidentals::NoAccidental },
+        { "C major",  "treble", 61, &Accidentals::Flat,          -1, &Accidentals::Flat },
+        { "C major",  "bass",   48, &Accidentals::NoAccidental,   3, &Accidentals::NoAccidental },
+        { "A minor",  "alto",   68, &Accidentals::NoAccidental,   8, &Accidentals::Sharp },
+        { "Eb major", "bass",   54, &Accidentals::NoAccidental,   7, &Accidentals::Flat },
+        { "C# major", "treble", 60, &Accidentals::NoAccidental,  -3, &Accidentals::NoAccidental },
+        { "G major",  "tenor",  66, &Accidentals::Natural,        9, &Accidentals::NoAccidental },
+        { "Bb minor", "treble", 71, &Accidentals::NoAccidental,   5, &Accidentals::Flat },
+    };
+
+    /// FNV-1a, over each result in turn.
+    class Digest
+    {
+    public:
+        void add(int value)
+        {
+            for (int i = 0; i < 4; ++i)
+                addByte((unsigned(value) >> (i * 8)) & 0xff);
+        }
+
+        void add(const std::string &value)
+        {
+            for (char c : value)
+                addByte(static_cast<unsigned char>(c));
+            add(int(value.size()));
+        }
+
+        uint32_t get() const  { return m_hash; }
+
+    private:
+        void addByte(unsigned byte)
+        {
+            m_hash ^= byte;
+            m_hash *= 16777619u;
+        }
+
+        uint32_t m_hash{2166136261u};
+    };
+
+    // Pointers, as the Accidentals may not have been made yet either.
+    const Accidental *const accidentals[] = {
+        &Accidentals::NoAccidental, &Accidentals::Sharp, &Accidentals::Flat,
+        &Accidentals::Natural, &Accidentals::DoubleSharp,
+        &Accidentals::DoubleFlat, &Accidentals::QuarterSharp,
+        &Accidentals::ThreeQuarterFlat
+    };
+
+    const Accidentals::NoAccidentalStrategy strategies[] = {
+        Accidentals::UseSharps, Accidentals::UseFlats,
+        Accidentals::UseKeySharpness, Accidentals::UseKey
+    };
+
+    Accidental getStepAccidental(char step)
+    {
+        if (step == '#') return Accidentals::Sharp;
+        if (step == 'b') return Accidentals::Flat;
+        return Accidentals::NoAccidental;
+    }
+}
+
+void TestPitchTables::testKeys()
+{
+    for (const KeyData &data : keys) {
+        const Key key(data.name);
+
+        QCOMPARE(key.getName(), std::string(data.name));
+        QCOMPARE(key.isMinor(), data.minor);
+        QCOMPARE(key.isSharp(), data.sharp);
+        QCOMPARE(key.getTonicPitch(), data.tonicPitch);
+        QCOMPARE(key.getAccidentalCount(), data.accidentalCount);
+        QCOMPARE(key.getRosegarden2Name(), std::string(data.rosegarden2Name));
+        QCOMPARE(key.getEquivalent().getName(), std::string(data.equivalent));
+
+        for (int step = 0; step < 7; ++step)
+            QCOMPARE(key.getAccidentalForStep(step),
+                     getStepAccidental(data.steps[step]));
+
+        std::unique_ptr<Event> event(key.getAsEvent(0));
+        QVERIFY(Key::isValid(*event));
+        QCOMPARE(Key(*event).getName(), std::string(data.name));
+    }
+
+    QVERIFY_EXCEPTION_THROWN(Key("H major"), Key::BadKeyName);
+    QVERIFY_EXCEPTION_THROWN(Key(""), Key::BadKeyName);
+
+    // The keys come back in the order they always did.
+    for (bool minor : { false, true }) {
+        std::vector<std::string> expected;
+        for (const KeyData &data : keys) {
+            if (data.minor == minor)
+                expected.push_back(data.name);
+        }
+
+        std::vector<std::string> names;
+        for (const Key &key : Key::getKeys(minor))
+            names.push_back(key.getName());
+
+        QCOMPARE(names, expected);
+    }
+}
+
+void TestPitchTables::testKeyConstructors()
+{
+    // Both constructors take the first match in name order.
+
+    for (bool minor : { false, true }) {
+        for (bool sharp : { false, true }) {
+            for (int count = 0; count <= 8; ++count) {
+                std::string expected;
+                for (const KeyData &data : keys) {
+                    if (data.accidentalCount == count &&
+                        data.minor == minor &&
+                        (data.sharp == sharp || data.accidentalCount == 0)) {
+                        expected = data.name;
+                        break;
+                    }
+                }
+
+                if (expected.empty()) {
+                    QVERIFY_EXCEPTION_THROWN(Key(count, sharp, minor),
+                                             Key::BadKeySpec);
+                } else {
+                    QCOMPARE(Key(count, sharp, minor).getName(), expected);
+                }
+            }
+        }
+
+        for (int tonic = 0; tonic < 13; ++tonic) {
+            std::string expected;
+            for (const KeyData &data : keys) {
+                if (data.tonicPitch == tonic && data.minor == minor) {
+                    expected = data.name;
+                    break;
+                }
+            }
+
+            if (expected.empty()) {
+                QVERIFY_EXCEPTION_THROWN(Key(tonic, minor), Key::BadKeySpec);
+            } else {
+                QCOMPARE(Key(tonic, minor).getName(), expected);
+            }
+        }
+    }
+}
+
+void TestPitchTables::testClefs()
+{
+    for (const ClefData &data : clefs) {
+        for (int octaveOffset = -2; octaveOffset <= 2; ++octaveOffset) {
+            const Clef clef(data.name, octaveOffset);
+
+            QCOMPARE(clef.getClefType(), std::string(data.name));
+            QCOMPARE(clef.getPitchOffset(), data.pitchOffset);
+            QCOMPARE(clef.getOctave(), data.octave + octaveOffset);
+            QCOMPARE(clef.getAxisHeight(), data.axisHeight);
+
+            // Copies keep their lookups.
+            Clef copy;
+            copy = clef;
+            QCOMPARE(copy.getPitchOffset(), data.pitchOffset);
+            QCOMPARE(Clef(clef).getOctave(), data.octave + octaveOffset);
+        }
+
+        if (std::string(data.name) == "undefined") continue;
+
+        std::unique_ptr<Event> event(Clef(data.name, 1).getAsEvent(0));
+        QVERIFY(Clef::isValid(*event));
+        QVERIFY(Clef(*event) == Clef(data.name, 1));
+        QCOMPARE(Clef(*event).getOctave(), data.octave + 1);
+    }
+
+    QVERIFY_EXCEPTION_THROWN(Clef("piccolo"), Clef::BadClefName);
+    QCOMPARE(Clef().getClefType(), Clef::Treble);
+    QCOMPARE(Clef().getAxisHeight(), 2);
+}
+
+void TestPitchTables::testAccidentalHeights()
+{
+    for (size_t k = 0; k < sizeof(keys) / sizeof(keys[0]); ++k) {
+        const Key key(keys[k].name);
+        QCOMPARE(std::string(spellings[k].key), key.getName());
+
+        Digest digest;
+
+        for (const ClefData &data : clefs) {
+            const Clef clef(data.name);
+
+            const std::vector<int> &heights =
+                    key.isSharp() ? data.sharpHeights : data.flatHeights;
+            QCOMPARE(key.getAccidentalHeights(clef),
+                     std::vector<int>(heights.begin(),
+                                      heights.begin() +
+                                              key.getAccidentalCount()));
+
+            for (int height = -30; height <= 30; ++height)
+                digest.add(key.getAccidentalAtHeight(height, clef));
+        }
+
+        QCOMPARE(digest.get(), spellings[k].accidentalAtHeight);
+    }
+}
+
+void TestPitchTables::testRawToDisplay()
+{
+    for (const SpotData &spot : spots) {
+        const Pitch pitch(spot.pitch, *spot.accidental);
+        QCOMPARE(pitch.getHeightOnStaff(Clef(spot.clef), Key(spot.key)),
+                 spot.height);
+        QCOMPARE(pitch.getDisplayAccidental(Key(spot.key)),
+                 *spot.displayAccidental);
+    }
+
+    for (size_t k = 0; k < sizeof(keys) / sizeof(keys[0]); ++k) {
+        const Key key(keys[k].name);
+        Digest digest;
+
+        for (const ClefData &data : clefs) {
+            for (int octaveOffset = -1; octaveOffset <= 1; ++octaveOffset) {
+                const Clef clef(data.name, octaveOffset);
+
+                for (int pitch = 0; pitch < 128; ++pitch) {
+                    for (const Accidental *accidental : accidentals) {
+                        const Pitch p(pitch, *accidental);
+                        digest.add(p.getHeightOnStaff(clef, key));
+                    }
+                }
+            }
+        }
+
+        QCOMPARE(digest.get(), spellings[k].rawToDisplay);
+    }
+}
+
+void TestPitchTables::testDisplayStrategies()
+{
+    for (size_t k = 0; k < sizeof(keys) / sizeof(keys[0]); ++k) {
+        const Key key(keys[k].name);
+        Digest digest;
+
+        for (int pitch = 0; pitch < 128; ++pitch) {
+            for (const Accidental *accidental : accidentals) {
+                const Pitch p(pitch, *accidental);
+
+                for (Accidentals::NoAccidentalStrategy strategy :
+                         strategies)
+                    digest.add(p.getDisplayAccidental(key, strategy));
+            }
+        }
+
+        QCOMPARE(digest.get(), spellings[k].strategies);
+    }
+
+    // getHeightOnStaff(clef, useSharps) goes through C major.
+    Digest digest;
+    for (int pitch = 0; pitch < 128; ++pitch) {
+        for (bool useSharps : { false, true })
+            digest.add(Pitch(pitch).getHeightOnStaff(Clef(), useSharps));
+    }
+    QCOMPARE(digest.get(), cMajorHeights);
+}
+
+void TestPitchTables::testDisplayToRaw()
+{
+    for (size_t k = 0; k < sizeof(keys) / sizeof(keys[0]); ++k) {
+        const Key key(keys[k].name);
+        Digest digest;
+
+        for (const ClefData &data : clefs) {
+            for (int octaveOffset = -1; octaveOffset <= 1; ++octaveOffset) {
+                const Clef clef(data.name, octaveOffset);
+
+                for (int height = -30; height <= 40; ++height) {
+                    for (const Accidental *accidental : accidentals) {
+                        const Pitch p(height, clef, key, *accidental);
+                        digest.add(p.getPerformancePitch());
+                    }
+                }
+            }
+        }
+
+        QCOMPARE(digest.get(), spellings[k].displayToRaw);
+    }
+}
+
+void TestPitchTables::benchmarkSpelling()
+{
+    // What notation layout does for each note.
+    const Key key("Eb major");
+    const Clef clef(Clef::Bass);
+    int total = 0;
+
+    QBENCHMARK {
+        total = 0;
+        for (int i = 0; i < 100; ++i) {
+            for (int pitch = 0; pitch < 128; ++pitch) {
+                total += Pitch(pitch).getHeightOnStaff(clef, key);
+            }
+        }
+    }
+
+    QVERIFY(total != 0);
+}
+
+QTEST_MAIN(TestPitchTables)
+
+#include "pitchtables.moc"
@@ -14,9 +14,13 @@
 */
 
 #include "base/RealTime.h"
+#include "base/Composition.h"
 
 #include <QTest>
 
+#include <cmath>
+#include <vector>
+
 using namespace Rosegarden;
 
 /// Unit test for RealTime
@@ -27,8 +31,43 @@ class TestRealTime : public QObject
 private Q_SLOTS:
     void test();
     void testFrameConversion();
+    void testNanoseconds();
+    void testTempoConversion();
+    void benchmarkOldTempoConversion();
+    void benchmarkTempoConversion();
 };
 
+namespace
+{
+    namespace Old
+    {
+        const timeT crotchet = 960;
+
+        /// What Composition::time2RealTime() used to do.
+        RealTime time2RealTime(timeT t, tempoT tempo)
+        {
+            double dt =
+                (double(t) * 100000 * 60) / (double(tempo) * crotchet);
+
+            int sec = int(dt);
+            int nsec = int((dt - sec) * 1000000000);
+
+            return RealTime(sec, nsec);
+        }
+
+        /// What Composition::realTime2Time() used to do.
+        timeT realTime2Time(RealTime rt, tempoT tempo)
+        {
+            double tsec =
+                (double(rt.sec) * crotchet) * (tempo / (60.0 * 100000.0));
+            double tnsec = (double(rt.nsec) * crotchet) * (tempo / 100000.0);
+
+            double dt = tsec + (tnsec / 60000000000.0);
+            return (timeT)(dt + (dt < 0 ? -1e-6 : 1e-6));
+        }
+    }
+}
+
 void TestRealTime::test()
 {
     // These come out in the test output with "QDEBUG" on the front.
@@ -143,6 +182,129 @@ void TestRealTime::testFrameConversion()
     }
 }
 
+void TestRealTime::testNanoseconds()
+{
+    QCOMPARE(RealTime(2, 500000000).toNanoseconds(), 2500000000LL);
+    QCOMPARE(RealTime(-2, -500000000).toNanoseconds(), -2500000000LL);
+    QCOMPARE(RealTime::fromNanoseconds(-2500000000LL), RealTime(-2, -500000000));
+    QCOMPARE(RealTime::fromNanoseconds(0), RealTime::zero());
+
+    // Summing nanoseconds must agree with the normalising arithmetic,
+    // signs included.
+    const int secs[] = { -2000000, -3, -1, 0, 1, 2, 59, 2000000 };
+    const int nsecs[] = { -999999999, -500000000, -1, 0, 1, 500000000,
+                          999999999 };
+
+    for (const int &s1 : secs) {
+        for (const int &n1 : nsecs) {
+            const RealTime a(s1, n1);
+            QCOMPARE(RealTime::fromNanoseconds(a.toNanoseconds()), a);
+
+            for (const int &s2 : secs) {
+                for (const int &n2 : nsecs) {
+                    const RealTime b(s2, n2);
+
+                    const RealTime sum = RealTime::fromNanoseconds(
+                            a.toNanoseconds() + b.toNanoseconds());
+                    QCOMPARE(sum.sec, (a + b).sec);
+                    QCOMPARE(sum.nsec, (a + b).nsec);
+
+                    const RealTime difference = RealTime::fromNanoseconds(
+                            a.toNanoseconds() - b.toNanoseconds());
+                    QCOMPARE(difference.sec, (a - b).sec);
+                    QCOMPARE(difference.nsec, (a - b).nsec);
+                }
+            }
+        }
+    }
+}
+
+void TestRealTime::testTempoConversion()
+{
+    Composition composition;
+
+    // 120qpm: a crotchet is exactly half a second.
+    const timeT crotchet = 960;
+    QCOMPARE(composition.getElapsedRealTime(crotchet),
+             RealTime(0, 500000000));
+    QCOMPARE(composition.getElapsedRealTime(-crotchet * 7),
+             RealTime(-3, -500000000));
+    QCOMPARE(composition.getElapsedTimeForRealTime(RealTime(1, 0)),
+             crotchet * 2);
+
+    // Awkward tempi, where a tick is not a whole number of nanoseconds.
+    const double tempi[] = { 120.0, 97.3, 61.0, 173.21 };
+
+    std::vector<timeT> times;
+    times.push_back(0);
+    for (timeT t = 1; t < 50000000; t = t * 3 + 1) {
+        times.push_back(t);
+        times.push_back(-t);
+    }
+
+    for (const double &qpm : tempi) {
+        composition.setCompositionDefaultTempo(
+                Composition::getTempoForQpm(qpm));
+        const tempoT tempo = composition.getCompositionDefaultTempo();
+        const double nsPerTick = 60.0e9 * 100000 / (double(tempo) * crotchet);
+
+        for (const timeT &t : times) {
+            const RealTime rt = composition.getElapsedRealTime(t);
+
+            // Within a nanosecond of the floating point answer.
+            QVERIFY(std::fabs(rt.toNanoseconds() - t * nsPerTick) <
+                    1.0 + std::fabs(t * nsPerTick) * 1e-12);
+
+            // Ticks survive the round trip exactly.
+            QCOMPARE(composition.getElapsedTimeForRealTime(rt), t);
+
+            // And a real time just before the next tick still maps to t.
+            if (t >= 0) {
+                const RealTime next = composition.getElapsedRealTime(t + 1);
+                QCOMPARE(composition.getElapsedTimeForRealTime(
+                                 next - RealTime(0, 1)), t);
+            }
+        }
+    }
+}
+
+void TestRealTime::benchmarkOldTempoConversion()
+{
+    const tempoT tempo = Composition::getTempoForQpm(97.3);
+
+    // Not every tick survives this round trip.  Count them so the loop
+    // isn't optimised away.
+    int misses = 0;
+
+    QBENCHMARK {
+        misses = 0;
+        for (timeT t = 0; t < 1000000; t += 7) {
+            if (Old::realTime2Time(Old::time2RealTime(t, tempo), tempo) != t)
+                ++misses;
+        }
+    }
+
+    QVERIFY(misses >= 0);
+}
+
+void TestRealTime::benchmarkTempoConversion()
+{
+    const tempoT tempo = Composition::getTempoForQpm(97.3);
+
+    int misses = 0;
+
+    QBENCHMARK {
+        misses = 0;
+        for (timeT t = 0; t < 1000000; t += 7) {
+            if (Composition::realTime2Time(
+                        Composition::time2RealTime(t, tempo), tempo) != t)
+                ++misses;
+        }
+    }
+
+    QCOMPARE(misses, 0);
+}
+
 QTEST_MAIN(TestRealTime)
 
 #include "realtime.moc"
@@ -0,0 +1,326 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#include "sound/RingBuffer.h"
+#include "sound/FrameRingBuffer.h"
+
+#include <QTest>
+#include <QThread>
+
+#include <vector>
+
+using namespace Rosegarden;
+
+/// Unit test and benchmark for RingBuffer and FrameRingBuffer
+/**
+ * The threaded tests are most useful when built with
+ * -fsanitize=thread.
+ */
+class TestRingBuffer : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testReadWrite();
+    void testRegions();
+    void testFrames();
+    void testThreaded();
+    void testThreadedFrames();
+    void benchmark();
+};
+
+namespace
+{
+    const int total = 1000000;
+
+    /// Writes 0, 1, 2, ... in irregular blocks.
+    class Writer : public QThread
+    {
+    public:
+        explicit Writer(RingBuffer<int, 2> &buffer) : m_buffer(buffer)  { }
+
+    protected:
+        void run() override
+        {
+            std::vector<int> block(97);
+            int next = 0;
+            int size = 1;
+            while (next < total) {
+                size = size % 97 + 1;
+                const int n = std::min(size, total - next);
+                for (int i = 0; i < n; ++i)
+                    block[i] = next + i;
+                next += int(m_buffer.write(&block[0], n));
+            }
+        }
+
+    private:
+        RingBuffer<int, 2> &m_buffer;
+    };
+
+    /// Reads and checks the sequence, through the regions or a copy.
+    class Reader : public QThread
+    {
+    public:
+        Reader(RingBuffer<int, 2> &buffer, int reader) :
+            m_buffer(buffer),
+            m_reader(reader)
+        {
+        }
+
+        bool ok{true};
+
+    protected:
+        void run() override
+        {
+            std::vector<int> block(61);
+            int expected = 0;
+            while (expected < total) {
+                if (m_reader == 0) {
+                    const int n = int(m_buffer.read(&block[0], 61, 0));
+                    for (int i = 0; i < n; ++i)
+                        ok = ok && (block[i] == expected++);
+                } else {
+                    const int *first, *second;
+                    size_t firstCount, secondCount;
+                    const size_t n = m_buffer.getReadRegions(
+                            first, firstCount, second, secondCount, 1);
+                    for (size_t i = 0; i < firstCount; ++i)
+                        ok = ok && (first[i] == expected++);
+                    for (size_t i = 0; i < secondCount; ++i)
+                        ok = ok && (second[i] == expected++);
+                    m_buffer.skip(n, 1);
+                }
+            }
+        }
+
+    private:
+        RingBuffer<int, 2> &m_buffer;
+        int m_reader;
+    };
+
+    /// Writes frames of (n, -n).
+    class FrameWriter : public QThread
+    {
+    public:
+        explicit FrameWriter(FrameRingBuffer<int> &buffer) : m_buffer(buffer)  { }
+
+    protected:
+        void run() override
+        {
+            std::vector<int> left(64), right(64);
+            const int *channels[2] = { &left[0], &right[0] };
+            int next = 0;
+            while (next < total) {
+                const int n = std::min(64, total - next);
+                for (int i = 0; i < n; ++i) {
+                    left[i] = next + i;
+                    right[i] = -(next + i);
+                }
+                next += int(m_buffer.write(channels, n));
+            }
+        }
+
+    private:
+        FrameRingBuffer<int> &m_buffer;
+    };
+}
+
+void TestRingBuffer::testReadWrite()
+{
+    RingBuffer<int> buffer(7);
+
+    QCOMPARE(buffer.getSize(), size_t(7));
+    QCOMPARE(buffer.getWriteSpace(), size_t(7));
+    QCOMPARE(buffer.getReadSpace(), size_t(0));
+
+    const int data[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    QCOMPARE(buffer.write(data, 5), size_t(5));
+
+    int out[9];
+    QCOMPARE(buffer.read(out, 3), size_t(3));
+    QCOMPARE(out[2], 3);
+
+    // Wraps around, and is limited to the space available.
+    QCOMPARE(buffer.write(data, 9), size_t(5));
+    QCOMPARE(buffer.getReadSpace(), size_t(7));
+    QCOMPARE(buffer.getWriteSpace(), size_t(0));
+
+    QCOMPARE(buffer.readOne(), 4);
+    QCOMPARE(buffer.peek(), 5);
+    QCOMPARE(buffer.skip(1), size_t(1));
+
+    // Short reads are zero filled.
+    QCOMPARE(buffer.read(out, 9), size_t(5));
+    QCOMPARE(out[0], 1);
+    QCOMPARE(out[4], 5);
+    QCOMPARE(out[5], 0);
+    QCOMPARE(out[8], 0);
+
+    QCOMPARE(buffer.readOne(), 0);
+}
+
+void TestRingBuffer::testRegions()
+{
+    RingBuffer<int> buffer(7);
+
+    const int data[] = { 1, 2, 3, 4, 5, 6 };
+    buffer.write(data, 6);
+    buffer.skip(6);
+
+    int *first, *second;
+    size_t firstCount, secondCount;
+    QCOMPARE(buffer.getWriteRegions(first, firstCount, second, secondCount),
+             size_t(7));
+    QCOMPARE(firstCount, size_t(2));
+    QCOMPARE(secondCount, size_t(5));
+    for (int i = 0; i < 2; ++i)
+        first[i] = 10 + i;
+    for (int i = 0; i < 3; ++i)
+        second[i] = 12 + i;
+    QCOMPARE(buffer.commitWrite(5), size_t(5));
+
+    const int *readFirst, *readSecond;
+    QCOMPARE(buffer.getReadRegions(readFirst, firstCount,
+                                   readSecond, secondCount),
+             size_t(5));
+    QCOMPARE(firstCount, size_t(2));
+    QCOMPARE(secondCount, size_t(3));
+    QCOMPARE(readFirst[1], 11);
+    QCOMPARE(readSecond[2], 14);
+
+    int out[5];
+    QCOMPARE(buffer.read(out, 5), size_t(5));
+    for (int i = 0; i < 5; ++i)
+        QCOMPARE(out[i], 10 + i);
+}
+
+void TestRingBuffer::testFrames()
+{
+    FrameRingBuffer<int> buffer(2, 5);
+
+    QCOMPARE(buffer.getWriteSpace(), size_t(5));
+
+    const int left[] = { 1, 2, 3, 4, 5, 6 };
+    const int right[] = { -1, -2, -3, -4, -5, -6 };
+    const int *channels[2] = { left, right };
+
+    QCOMPARE(buffer.write(channels, 3), size_t(3));
+    QCOMPARE(buffer.skip(2), size_t(2));
+
+    // This one wraps, and is limited to the space available.
+    QCOMPARE(buffer.write(channels, 6), size_t(4));
+    QCOMPARE(buffer.getReadSpace(), size_t(5));
+
+    const int *first, *second;
+    size_t firstFrames, secondFrames;
+    QCOMPARE(buffer.getReadRegions(first, firstFrames, second, secondFrames),
+             size_t(5));
+    QCOMPARE(firstFrames + secondFrames, size_t(5));
+
+    std::vector<int> interleaved(first, first + firstFrames * 2);
+    interleaved.insert(interleaved.end(), second, second + secondFrames * 2);
+
+    const int expected[] = { 3, -3, 1, -1, 2, -2, 3, -3, 4, -4 };
+    for (int i = 0; i < 10; ++i)
+        QCOMPARE(interleaved[i], expected[i]);
+}
+
+void TestRingBuffer::testThreaded()
+{
+    RingBuffer<int, 2> buffer(1023);
+
+    Writer writer(buffer);
+    Reader copyReader(buffer, 0);
+    Reader regionReader(buffer, 1);
+
+    copyReader.start();
+    regionReader.start();
+    writer.start();
+
+    writer.wait();
+    copyReader.wait();
+    regionReader.wait();
+
+    QVERIFY(copyReader.ok);
+    QVERIFY(regionReader.ok);
+    QCOMPARE(buffer.getReadSpace(0), size_t(0));
+    QCOMPARE(buffer.getReadSpace(1), size_t(0));
+}
+
+void TestRingBuffer::testThreadedFrames()
+{
+    FrameRingBuffer<int> buffer(2, 511);
+
+    FrameWriter writer(buffer);
+    writer.start();
+
+    bool ok = true;
+    int expected = 0;
+    while (expected < total) {
+        const int *first, *second;
+        size_t firstFrames, secondFrames;
+        const size_t n =
+                buffer.getReadRegions(first, firstFrames, second, secondFrames);
+        for (size_t i = 0; i < firstFrames; ++i, ++expected) {
+            ok = ok && first[i * 2] == expected;
+            ok = ok && first[i * 2 + 1] == -expected;
+        }
+        for (size_t i = 0; i < secondFrames; ++i, ++expected) {
+            ok = ok && second[i * 2] == expected;
+            ok = ok && second[i * 2 + 1] == -expected;
+        }
+        buffer.skip(n);
+    }
+
+    writer.wait();
+
+    QVERIFY(ok);
+}
+
+void TestRingBuffer::benchmark()
+{
+    // Stereo blocks through one ring per channel, as PlayableAudioFile
+    // does, against one interleaved frame ring.
+    const size_t blockSize = 512;
+    std::vector<float> left(blockSize, 0.5f), right(blockSize, -0.5f);
+    std::vector<float> out(blockSize * 2);
+
+    RingBuffer<float> leftBuffer(blockSize * 8 - 1);
+    RingBuffer<float> rightBuffer(blockSize * 8 - 1);
+    FrameRingBuffer<float> frameBuffer(2, blockSize * 8 - 1);
+    const float *channels[2] = { &left[0], &right[0] };
+
+    QBENCHMARK {
+        for (int i = 0; i < 10000; ++i) {
+            leftBuffer.write(&left[0], blockSize);
+            rightBuffer.write(&right[0], blockSize);
+            leftBuffer.read(&out[0], blockSize);
+            rightBuffer.read(&out[blockSize], blockSize);
+
+            frameBuffer.write(channels, blockSize);
+            const float *first, *second;
+            size_t firstFrames, secondFrames;
+            frameBuffer.skip(frameBuffer.getReadRegions(
+                    first, firstFrames, second, secondFrames));
+        }
+    }
+
+    QCOMPARE(frameBuffer.getReadSpace(), size_t(0));
+}
+
+QTEST_MAIN(TestRingBuffer)
+
+#include "ringbuffer.moc"
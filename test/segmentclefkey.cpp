@@ -0,0 +1,197 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#include "base/Event.h"
+#include "base/NotationTypes.h"
+#include "base/Segment.h"
+
+#include <QTest>
+
+using namespace Rosegarden;
+
+/// Unit test and benchmark for Segment's clef and key lookups
+class TestSegmentClefKey : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testEmpty();
+    void testClefAtTime();
+    void testKeyAtTime();
+    void testErase();
+    void testSetStartTime();
+    void benchmarkLookup();
+};
+
+namespace
+{
+    /// A clef change every 4 bars and a key change every 8.
+    void fill(Segment &segment, int bars)
+    {
+        const std::string clefs[] = { Clef::Treble, Clef::Bass, Clef::Alto };
+        const std::string keys[] = { "C major", "G major", "F major" };
+
+        for (int bar = 0; bar < bars; ++bar) {
+            const timeT time = bar * 3840;
+            if (bar % 4 == 0)
+                segment.insert(Clef(clefs[bar / 4 % 3]).getAsEvent(time));
+            if (bar % 8 == 0)
+                segment.insert(Key(keys[bar / 8 % 3]).getAsEvent(time));
+            for (int beat = 0; beat < 4; ++beat)
+                segment.insert(new Event(Note::EventType, time + beat * 960,
+                                         960));
+        }
+    }
+
+    const int benchmarkBars = 2000;
+}
+
+void TestSegmentClefKey::testEmpty()
+{
+    Segment segment;
+    segment.insert(new Event(Note::EventType, 960, 960));
+
+    timeT ctime = -1;
+    QVERIFY(segment.getClefAtTime(2000, ctime) == Clef());
+    QCOMPARE(ctime, segment.getStartTime());
+
+    timeT ktime = -1;
+    QVERIFY(segment.getKeyAtTime(2000, ktime) == Key());
+    QCOMPARE(ktime, segment.getStartTime());
+
+    timeT nextTime = -1;
+    QVERIFY(!segment.getNextClefTime(0, nextTime));
+    QVERIFY(!segment.getNextKeyTime(0, nextTime));
+}
+
+void TestSegmentClefKey::testClefAtTime()
+{
+    Segment segment;
+    segment.insert(new Event(Note::EventType, 0, 960));
+    segment.insert(Clef(Clef::Bass).getAsEvent(960));
+    segment.insert(Clef(Clef::Alto).getAsEvent(1920));
+    // Keys in between mustn't get in the way.
+    segment.insert(Key("D major").getAsEvent(1920));
+    segment.insert(Key("A major").getAsEvent(2400));
+
+    timeT ctime = -1;
+    QVERIFY(segment.getClefAtTime(0, ctime) == Clef());
+    QCOMPARE(ctime, timeT(0));
+    QVERIFY(segment.getClefAtTime(960, ctime) == Clef(Clef::Bass));
+    QCOMPARE(ctime, timeT(960));
+    QVERIFY(segment.getClefAtTime(1919, ctime) == Clef(Clef::Bass));
+    QCOMPARE(ctime, timeT(960));
+    QVERIFY(segment.getClefAtTime(5000, ctime) == Clef(Clef::Alto));
+    QCOMPARE(ctime, timeT(1920));
+
+    timeT nextTime = -1;
+    QVERIFY(segment.getNextClefTime(0, nextTime));
+    QCOMPARE(nextTime, timeT(960));
+    QVERIFY(segment.getNextClefTime(960, nextTime));
+    QCOMPARE(nextTime, timeT(1920));
+    QVERIFY(!segment.getNextClefTime(1920, nextTime));
+}
+
+void TestSegmentClefKey::testKeyAtTime()
+{
+    Segment segment;
+    segment.insert(new Event(Note::EventType, 0, 960));
+    segment.insert(Key("D major").getAsEvent(1920));
+    segment.insert(Clef(Clef::Bass).getAsEvent(2000));
+    segment.insert(Key("A major").getAsEvent(2400));
+
+    timeT ktime = -1;
+    QVERIFY(segment.getKeyAtTime(1000, ktime) == Key());
+    QCOMPARE(ktime, timeT(0));
+    QVERIFY(segment.getKeyAtTime(2000, ktime) == Key("D major"));
+    QCOMPARE(ktime, timeT(1920));
+    QVERIFY(segment.getKeyAtTime(2400, ktime) == Key("A major"));
+    QCOMPARE(ktime, timeT(2400));
+
+    timeT nextTime = -1;
+    QVERIFY(segment.getNextKeyTime(1920, nextTime));
+    QCOMPARE(nextTime, timeT(2400));
+    QVERIFY(!segment.getNextKeyTime(2400, nextTime));
+}
+
+void TestSegmentClefKey::testErase()
+{
+    Segment segment;
+    segment.insert(new Event(Note::EventType, 0, 960));
+    Event *first = Key("D major").getAsEvent(960);
+    Event *duplicate = Key("E major").getAsEvent(960);
+    segment.insert(first);
+    segment.insert(duplicate);
+
+    // The later insert wins, as it is later in the Segment.
+    QVERIFY(segment.getKeyAtTime(960) == Key("E major"));
+
+    // Erasing one of a duplicated pair erases that one (bug#1485643).
+    QVERIFY(segment.eraseSingle(duplicate));
+    QVERIFY(segment.getKeyAtTime(960) == Key("D major"));
+
+    Event *clef = Clef(Clef::Bass).getAsEvent(960);
+    segment.insert(clef);
+    QVERIFY(segment.getClefAtTime(1000) == Clef(Clef::Bass));
+    QVERIFY(segment.eraseSingle(clef));
+    QVERIFY(segment.getClefAtTime(1000) == Clef());
+
+    segment.clear();
+    timeT nextTime = -1;
+    QVERIFY(!segment.getNextKeyTime(0, nextTime));
+}
+
+void TestSegmentClefKey::testSetStartTime()
+{
+    Segment segment;
+    fill(segment, 8);
+
+    segment.setStartTime(3840);
+
+    timeT ctime = -1;
+    QVERIFY(segment.getClefAtTime(3840 + 4 * 3840, ctime) ==
+            Clef(Clef::Bass));
+    QCOMPARE(ctime, timeT(3840 + 4 * 3840));
+
+    timeT nextTime = -1;
+    QVERIFY(segment.getNextClefTime(3840, nextTime));
+    QCOMPARE(nextTime, timeT(3840 + 4 * 3840));
+}
+
+void TestSegmentClefKey::benchmarkLookup()
+{
+    Segment segment;
+    fill(segment, benchmarkBars);
+
+    // What layout does: the clef and key for every element.
+    int bassNotes = 0;
+
+    QBENCHMARK {
+        bassNotes = 0;
+        for (const Event *event : segment) {
+            if (!event->isa(Note::EventType)) continue;
+            const timeT time = event->getAbsoluteTime();
+            if (segment.getClefAtTime(time) == Clef(Clef::Bass))
+                ++bassNotes;
+            segment.getKeyAtTime(time);
+        }
+    }
+
+    QVERIFY(bassNotes > 0);
+}
+
+QTEST_MAIN(TestSegmentClefKey)
+
+#include "segmentclefkey.moc"
@@ -0,0 +1,224 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#include "base/BaseProperties.h"
+#include "base/Event.h"
+#include "base/MidiTypes.h"
+#include "base/NotationTypes.h"
+#include "base/Segment.h"
+#include "base/SegmentSnapshot.h"
+
+#include <QTest>
+
+using namespace Rosegarden;
+
+/// Unit test and benchmark for SegmentSnapshot
+class TestSegmentSnapshot : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testColumns();
+    void testProperties();
+    void testEmpty();
+    void benchmarkSegment();
+    void benchmarkSnapshot();
+    void benchmarkScan();
+};
+
+namespace
+{
+    /// Notes with the odd rest and controller.
+    void fill(Segment &segment, int count)
+    {
+        for (int i = 0; i < count; ++i) {
+            const timeT time = i * 240;
+
+            if (i % 10 == 9) {
+                segment.insert(new Event(Note::EventRestType, time, 240));
+                continue;
+            }
+            if (i % 10 == 5) {
+                Event *controller = new Event(Controller::EventType, time, 0);
+                controller->set<Int>(Controller::NUMBER, 7);
+                controller->set<Int>(Controller::VALUE, i % 128);
+                segment.insert(controller);
+                continue;
+            }
+
+            Event *note = new Event(Note::EventType, time, 240);
+            note->set<Int>(BaseProperties::PITCH, 40 + i % 48);
+            // Every so often, leave the velocity out.
+            if (i % 7 != 0)
+                note->set<Int>(BaseProperties::VELOCITY, 64 + i % 64);
+            segment.insert(note);
+        }
+    }
+
+    const int benchmarkEvents = 100000;
+
+    /// The note scan the benchmarks time, through a snapshot.
+    long scan(const SegmentSnapshot &snapshot)
+    {
+        long total = 0;
+        const SegmentSnapshot::TypeId noteType =
+                snapshot.findType(Note::EventType);
+        for (size_t i = 0; i < snapshot.size(); ++i) {
+            if (!snapshot.isa(i, noteType))
+                continue;
+            long velocity = snapshot.getVelocity(i);
+            if (velocity == SegmentSnapshot::NoValue)
+                velocity = 127;
+            total += snapshot.getTime(i) + snapshot.getDuration(i) +
+                     snapshot.getPitch(i) + velocity;
+        }
+        return total;
+    }
+}
+
+void TestSegmentSnapshot::testColumns()
+{
+    Segment segment;
+    fill(segment, 1000);
+
+    const SegmentSnapshot snapshot(segment);
+
+    QCOMPARE(snapshot.size(), segment.size());
+    QCOMPARE(snapshot.getStartTime(), segment.getStartTime());
+    QCOMPARE(snapshot.getEndMarkerTime(), segment.getEndMarkerTime());
+
+    const SegmentSnapshot::TypeId noteType =
+            snapshot.findType(Note::EventType);
+    QVERIFY(noteType != SegmentSnapshot::NoType);
+    QCOMPARE(snapshot.getTypeName(noteType), Note::EventType);
+    QCOMPARE(snapshot.findType("no such type"), SegmentSnapshot::NoType);
+
+    size_t i = 0;
+    for (Segment::const_iterator it = segment.begin();
+         it != segment.end();
+         ++it, ++i) {
+        const Event *event = *it;
+
+        QCOMPARE(snapshot.getTime(i), event->getAbsoluteTime());
+        QCOMPARE(snapshot.getDuration(i), event->getDuration());
+        QCOMPARE(snapshot.getTypeName(snapshot.getType(i)),
+                 event->getType());
+        QCOMPARE(snapshot.isa(i, noteType), event->isa(Note::EventType));
+
+        long value = SegmentSnapshot::NoValue;
+        event->get<Int>(BaseProperties::PITCH, value);
+        QCOMPARE(snapshot.getPitch(i), value);
+
+        value = SegmentSnapshot::NoValue;
+        event->get<Int>(BaseProperties::VELOCITY, value);
+        QCOMPARE(snapshot.getVelocity(i), value);
+    }
+}
+
+void TestSegmentSnapshot::testProperties()
+{
+    Segment segment;
+    fill(segment, 100);
+
+    const SegmentSnapshot::Ptr snapshot = SegmentSnapshot::create(
+            segment, std::vector<PropertyName>(1, Controller::VALUE));
+
+    size_t i = 0;
+    for (Segment::const_iterator it = segment.begin();
+         it != segment.end();
+         ++it, ++i) {
+        long value = SegmentSnapshot::NoValue;
+        (*it)->get<Int>(Controller::VALUE, value);
+        QCOMPARE(snapshot->getProperty(i, Controller::VALUE), value);
+
+        // Not asked for.
+        QCOMPARE(snapshot->getProperty(i, Controller::NUMBER),
+                 SegmentSnapshot::NoValue);
+    }
+}
+
+void TestSegmentSnapshot::testEmpty()
+{
+    Segment segment;
+    const SegmentSnapshot snapshot(segment);
+
+    QVERIFY(snapshot.empty());
+    QCOMPARE(snapshot.findType(Note::EventType), SegmentSnapshot::NoType);
+}
+
+void TestSegmentSnapshot::benchmarkSegment()
+{
+    // What the notation preview does, and CsoundExporter used to.
+    Segment segment;
+    fill(segment, benchmarkEvents);
+
+    long total = 0;
+
+    QBENCHMARK {
+        total = 0;
+        for (Segment::const_iterator it = segment.begin();
+             it != segment.end();
+             ++it) {
+            const Event *event = *it;
+            if (!event->isa(Note::EventType))
+                continue;
+            long pitch = 0;
+            long velocity = 127;
+            event->get<Int>(BaseProperties::PITCH, pitch);
+            event->get<Int>(BaseProperties::VELOCITY, velocity);
+            total += event->getAbsoluteTime() + event->getDuration() +
+                     pitch + velocity;
+        }
+    }
+
+    QVERIFY(total > 0);
+}
+
+void TestSegmentSnapshot::benchmarkSnapshot()
+{
+    // The same, building the snapshot first, as a one-off reader would.
+    Segment segment;
+    fill(segment, benchmarkEvents);
+
+    long total = 0;
+
+    QBENCHMARK {
+        const SegmentSnapshot snapshot(segment);
+        total = scan(snapshot);
+    }
+
+    QVERIFY(total > 0);
+}
+
+void TestSegmentSnapshot::benchmarkScan()
+{
+    // The same, through a snapshot made beforehand and shared, as
+    // CompositionSnapshot readers do.
+    Segment segment;
+    fill(segment, benchmarkEvents);
+    const SegmentSnapshot snapshot(segment);
+
+    long total = 0;
+
+    QBENCHMARK {
+        total = scan(snapshot);
+    }
+
+    QVERIFY(total > 0);
+}
+
+QTEST_MAIN(TestSegmentSnapshot)
+
+#include "segmentsnapshot.moc"
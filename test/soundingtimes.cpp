@@ -0,0 +1,275 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#include "base/BaseProperties.h"
+#include "base/Event.h"
+#include "base/NotationTypes.h"
+#include "base/Segment.h"
+#include "base/SegmentPerformanceHelper.h"
+
+#include <QTest>
+
+#include <string>
+#include <vector>
+
+using namespace Rosegarden;
+
+/// Unit test and benchmark for SegmentPerformanceHelper::getSoundingTimes()
+/**
+ * Checks it against asking getSoundingAbsoluteTime() and
+ * getSoundingDuration() for each event, as InternalSegmentMapper used to.
+ */
+class TestSoundingTimes : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testTies();
+    void testGraceNotes();
+    void testBogusTies();
+    void testEndMarker();
+    void benchmarkPerEvent();
+    void benchmarkSoundingTimes();
+};
+
+namespace
+{
+    using namespace BaseProperties;
+
+    Event *makeNote(timeT time, timeT duration, int pitch,
+                    bool tiedBackward = false, bool tiedForward = false)
+    {
+        Event *note = new Event(Note::EventType, time, duration);
+        note->set<Int>(PITCH, pitch);
+        if (tiedBackward)
+            note->set<Bool>(TIED_BACKWARD, true);
+        if (tiedForward)
+            note->set<Bool>(TIED_FORWARD, true);
+        return note;
+    }
+
+    Event *makeGraceNote(timeT time, timeT duration, int pitch,
+                         int subOrdering)
+    {
+        Event *note = new Event(Note::EventType, time, duration, subOrdering);
+        note->set<Int>(PITCH, pitch);
+        note->set<Bool>(IS_GRACE_NOTE, true);
+        return note;
+    }
+
+    /// Chords tied across beats, a held bass, rests and grace notes.
+    void fill(Segment &segment, int bars)
+    {
+        for (int bar = 0; bar < bars; ++bar) {
+            const timeT barTime = bar * 3840;
+
+            // Tied chains of 4, 2 and 8 notes on three voices.
+            const int pitches[] = { 60, 64, 67 };
+            const int chainLengths[] = { 4, 2, 8 };
+            for (int voice = 0; voice < 3; ++voice) {
+                const int length = chainLengths[voice];
+                const timeT duration = 3840 / 8;
+                for (int n = 0; n < 8; ++n) {
+                    const int inChain = n % length;
+                    segment.insert(makeNote(barTime + n * duration, duration,
+                                            pitches[voice] + bar % 5,
+                                            inChain != 0,
+                                            inChain != length - 1));
+                }
+            }
+
+            // A held bass note, tied over the bar line every other bar.
+            segment.insert(makeNote(barTime, 3840, 36 + bar % 12 - bar % 2,
+                                    bar % 2 == 1, bar % 2 == 0));
+
+            segment.insert(new Event(Note::EventRestType, barTime, 960));
+            segment.insert(Clef(Clef::Treble).getAsEvent(barTime));
+
+            // Grace notes, single and a chord of two.
+            if (bar % 2 == 0) {
+                segment.insert(makeGraceNote(barTime + 960, 120, 72, -2));
+                segment.insert(makeGraceNote(barTime + 960, 120, 74, -1));
+                segment.insert(makeGraceNote(barTime + 960, 120, 77, -1));
+                segment.insert(makeNote(barTime + 960, 960, 76));
+            }
+        }
+    }
+
+    struct Sounding
+    {
+        const Event *event;
+        timeT time;
+        timeT duration;
+    };
+
+    /// What InternalSegmentMapper used to do for each event.
+    std::vector<Sounding> perEvent(Segment &segment)
+    {
+        std::vector<Sounding> result;
+        for (Segment::iterator i = segment.begin();
+             segment.isBeforeEndMarker(i); ++i) {
+            if ((*i)->isa(Note::EventRestType)) continue;
+            SegmentPerformanceHelper helper(segment);
+            const timeT time = helper.getSoundingAbsoluteTime(i);
+            const timeT duration = helper.getSoundingDuration(i);
+            result.push_back(Sounding{*i, time, duration});
+        }
+        return result;
+    }
+
+    std::vector<std::string> describe(const Segment &segment)
+    {
+        std::vector<std::string> result;
+        for (const Event *event : segment)
+            result.push_back(event->toXmlString(0));
+        return result;
+    }
+
+    /// Fill two Segments the same way and compare.
+    void compare(void (*fillFunction)(Segment &))
+    {
+        Segment expected;
+        Segment actual;
+        fillFunction(expected);
+        fillFunction(actual);
+
+        const std::vector<Sounding> expectedTimes = perEvent(expected);
+
+        SegmentPerformanceHelper::SoundingTimeMap times;
+        SegmentPerformanceHelper(actual).getSoundingTimes(times);
+
+        QCOMPARE(times.size(), expectedTimes.size());
+
+        Segment::iterator i = actual.begin();
+        for (const Sounding &sounding : expectedTimes) {
+            while ((*i)->isa(Note::EventRestType)) ++i;
+            QVERIFY(times.find(*i) != times.end());
+            QCOMPARE(times[*i].absoluteTime, sounding.time);
+            QCOMPARE(times[*i].duration, sounding.duration);
+            ++i;
+        }
+
+        // Including anything done to bogus ties and grace notes on the
+        // way.
+        QCOMPARE(describe(actual), describe(expected));
+    }
+
+    void fillTies(Segment &segment)  { fill(segment, 16); }
+
+    void fillGraceNotes(Segment &segment)
+    {
+        // Grace notes before a chord, before nothing, and at odd times.
+        segment.insert(makeGraceNote(0, 120, 72, -1));
+        segment.insert(makeNote(0, 960, 60));
+        segment.insert(makeNote(0, 480, 64));
+        segment.insert(makeGraceNote(960, 60, 71, -3));
+        segment.insert(makeGraceNote(960, 60, 72, -2));
+        segment.insert(makeGraceNote(960, 60, 74, -1));
+        segment.insert(makeNote(960, 960, 67, false, true));
+        segment.insert(makeNote(1920, 960, 67, true));
+        segment.insert(makeGraceNote(3000, 120, 72, -1));
+        segment.insert(new Event(Note::EventRestType, 3000, 960));
+    }
+
+    void fillBogusTies(Segment &segment)
+    {
+        // Tied back to nothing, forward to nothing, to the wrong pitch,
+        // and past a shorter note of another pitch.
+        segment.insert(makeNote(0, 480, 60, true, false));
+        segment.insert(makeNote(480, 480, 62, false, true));
+        segment.insert(makeNote(1920, 480, 64, false, true));
+        segment.insert(makeNote(2400, 480, 65, true, false));
+        segment.insert(makeNote(2880, 960, 67, false, true));
+        segment.insert(makeNote(2880, 240, 48));
+        segment.insert(makeNote(3840, 480, 67, true, true));
+        segment.insert(makeNote(4320, 480, 67, true, false));
+    }
+
+    void fillEndMarker(Segment &segment)
+    {
+        fill(segment, 4);
+        // Cut through a tied chain.
+        segment.setEndMarkerTime(3 * 3840 + 3840 / 8 * 5);
+    }
+
+    const int benchmarkBars = 1000;
+    const int benchmarkRepeats = 4;
+}
+
+void TestSoundingTimes::testTies()
+{
+    compare(fillTies);
+}
+
+void TestSoundingTimes::testGraceNotes()
+{
+    compare(fillGraceNotes);
+}
+
+void TestSoundingTimes::testBogusTies()
+{
+    compare(fillBogusTies);
+}
+
+void TestSoundingTimes::testEndMarker()
+{
+    compare(fillEndMarker);
+}
+
+void TestSoundingTimes::benchmarkPerEvent()
+{
+    Segment segment;
+    fill(segment, benchmarkBars);
+
+    timeT total = 0;
+
+    // The mapper going through a Segment that repeats.
+    QBENCHMARK {
+        total = 0;
+        for (int repeat = 0; repeat < benchmarkRepeats; ++repeat) {
+            for (const Sounding &sounding : perEvent(segment))
+                total += sounding.duration;
+        }
+    }
+
+    QVERIFY(total > 0);
+}
+
+void TestSoundingTimes::benchmarkSoundingTimes()
+{
+    Segment segment;
+    fill(segment, benchmarkBars);
+
+    timeT total = 0;
+
+    QBENCHMARK {
+        total = 0;
+        SegmentPerformanceHelper::SoundingTimeMap times;
+        SegmentPerformanceHelper(segment).getSoundingTimes(times);
+        for (int repeat = 0; repeat < benchmarkRepeats; ++repeat) {
+            for (Segment::iterator i = segment.begin();
+                 segment.isBeforeEndMarker(i); ++i) {
+                if ((*i)->isa(Note::EventRestType)) continue;
+                total += times[*i].duration;
+            }
+        }
+    }
+
+    QVERIFY(total > 0);
+}
+
+QTEST_MAIN(TestSoundingTimes)
+
+#include "soundingtimes.moc"
@@ -0,0 +1,309 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#include "base/BaseProperties.h"
+#include "base/Composition.h"
+#include "base/CompositionTimeSliceAdapter.h"
+#include "base/Event.h"
+#include "base/NotationQuantizer.h"
+#include "base/NotationTypes.h"
+#include "base/Segment.h"
+#include "base/Selection.h"
+#include "base/Sets.h"
+
+#include <QTest>
+
+#include <utility>
+#include <vector>
+
+using namespace Rosegarden;
+
+/// Unit test and benchmark for CompositionTimeSliceAdapter
+class TestTimeSliceAdapter : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testAgainstOld();
+    void testRange();
+    void testSelection();
+    void testDecrement();
+    void testFindTime();
+    void testEmpty();
+    void benchmarkOldIteration();
+    void benchmarkIteration();
+    void benchmarkChords();
+};
+
+namespace
+{
+    typedef std::vector<std::pair<Event *, int>> EventList;
+
+    namespace Old
+    {
+        /// The linear scan CompositionTimeSliceAdapter used to do on
+        /// every increment.
+        EventList merge(Composition &composition, timeT begin, timeT end)
+        {
+            std::vector<Segment *> segments(composition.begin(),
+                                            composition.end());
+            std::vector<Segment::iterator> itrs;
+            for (Segment *segment : segments)
+                itrs.push_back(segment->findTime(begin));
+
+            EventList result;
+
+            while (true) {
+                Event *e = nullptr;
+                size_t pos = 0;
+                int track = -1;
+
+                for (size_t i = 0; i < segments.size(); ++i) {
+                    if (!segments[i]->isBeforeEndMarker(itrs[i])) continue;
+                    Event *candidate = *itrs[i];
+                    if (!e || *candidate < *e ||
+                        (!(*e < *candidate) && candidate < e)) {
+                        e = candidate;
+                        track = segments[i]->getTrack();
+                        pos = i;
+                    }
+                }
+
+                if (!e || e->getAbsoluteTime() >= end) break;
+
+                result.push_back(std::make_pair(e, track));
+                ++itrs[pos];
+            }
+
+            return result;
+        }
+    }
+
+    EventList iterate(const CompositionTimeSliceAdapter &adapter)
+    {
+        EventList result;
+        for (CompositionTimeSliceAdapter::iterator i = adapter.begin();
+             i != adapter.end(); ++i)
+            result.push_back(std::make_pair(*i, i.getTrack()));
+        return result;
+    }
+
+    /// Staggered notes and chords on each track, with some events
+    /// at identical times and sub-orderings across tracks.
+    void fill(Composition &composition, int tracks, int bars)
+    {
+        for (int track = 0; track < tracks; ++track) {
+            Segment *segment = new Segment;
+            segment->setTrack(track);
+            composition.addSegment(segment);
+
+            const timeT offset = (track % 3) * 120;
+            const timeT duration = 240 * (track % 4 + 1);
+
+            for (timeT t = offset; t < bars * 3840; t += duration) {
+                Event *note = new Event(Note::EventType, t, duration);
+                note->set<Int>(BaseProperties::PITCH, 36 + (track * 7) % 48);
+                segment->insert(note);
+
+                if (track % 5 == 0) {
+                    Event *third = new Event(Note::EventType, t, duration);
+                    third->set<Int>(BaseProperties::PITCH,
+                                    40 + (track * 7) % 48);
+                    segment->insert(third);
+                }
+            }
+
+            if (track % 8 == 0)
+                segment->insert(Key("D major").getAsEvent(3840));
+        }
+    }
+
+    const int benchmarkTracks = 64;
+    const int benchmarkBars = 100;
+}
+
+void TestTimeSliceAdapter::testAgainstOld()
+{
+    Composition composition;
+    fill(composition, 12, 8);
+
+    CompositionTimeSliceAdapter adapter(&composition);
+    const EventList expected =
+        Old::merge(composition, 0, composition.getDuration());
+
+    QVERIFY(!expected.empty());
+    QVERIFY(iterate(adapter) == expected);
+
+    // A second pass reuses the merge.
+    QVERIFY(iterate(adapter) == expected);
+}
+
+void TestTimeSliceAdapter::testRange()
+{
+    Composition composition;
+    fill(composition, 12, 8);
+
+    CompositionTimeSliceAdapter adapter(&composition, 3840 + 100, 7680);
+    QVERIFY(iterate(adapter) ==
+            Old::merge(composition, 3840 + 100, 7680));
+}
+
+void TestTimeSliceAdapter::testSelection()
+{
+    Composition composition;
+    fill(composition, 6, 4);
+
+    SegmentSelection selection;
+    int track = 0;
+    for (Segment *segment : composition) {
+        if (track++ % 2 == 0) selection.insert(segment);
+    }
+
+    CompositionTimeSliceAdapter adapter(&composition, &selection);
+    const EventList events = iterate(adapter);
+    QVERIFY(!events.empty());
+    for (const std::pair<Event *, int> &event : events)
+        QCOMPARE(event.second % 2, 0);
+}
+
+void TestTimeSliceAdapter::testDecrement()
+{
+    Composition composition;
+    fill(composition, 12, 4);
+
+    CompositionTimeSliceAdapter adapter(&composition);
+    const EventList forwards = iterate(adapter);
+
+    // Backwards from the end, including before anything has been
+    // merged.
+    CompositionTimeSliceAdapter fresh(&composition);
+    EventList backwards;
+    CompositionTimeSliceAdapter::iterator i = fresh.end();
+    while (i != fresh.begin()) {
+        --i;
+        backwards.push_back(std::make_pair(*i, i.getTrack()));
+    }
+    QVERIFY(EventList(backwards.rbegin(), backwards.rend()) == forwards);
+
+    // Copies move independently.
+    CompositionTimeSliceAdapter::iterator j = adapter.begin();
+    ++j; ++j; ++j;
+    CompositionTimeSliceAdapter::iterator k = j;
+    ++k;
+    QVERIFY(*k == forwards[4].first);
+    --k; --k;
+    QVERIFY(*k == forwards[2].first);
+    QVERIFY(*j == forwards[3].first);
+}
+
+void TestTimeSliceAdapter::testFindTime()
+{
+    Composition composition;
+    fill(composition, 12, 8);
+
+    CompositionTimeSliceAdapter adapter(&composition);
+    const EventList events = iterate(adapter);
+
+    CompositionTimeSliceAdapter fresh(&composition);
+    for (timeT t : { timeT(0), timeT(100), timeT(3840), timeT(20000),
+                     timeT(5000), timeT(1) }) {
+        size_t expected = 0;
+        while (expected < events.size() &&
+               events[expected].first->getAbsoluteTime() < t)
+            ++expected;
+        CompositionTimeSliceAdapter::iterator i = fresh.findTime(t);
+        QVERIFY(*i == events[expected].first);
+
+        // And carry on from there.
+        ++i;
+        QVERIFY(*i == events[expected + 1].first);
+    }
+
+    QVERIFY(fresh.findTime(composition.getDuration()) == fresh.end());
+}
+
+void TestTimeSliceAdapter::testEmpty()
+{
+    Composition composition;
+    composition.addSegment(new Segment);
+
+    CompositionTimeSliceAdapter adapter(&composition);
+    QVERIFY(adapter.begin() == adapter.end());
+    QVERIFY(*adapter.begin() == nullptr);
+    QCOMPARE(adapter.begin().getTrack(), -1);
+    QVERIFY(adapter.findTime(0) == adapter.end());
+
+    CompositionTimeSliceAdapter::iterator i = adapter.end();
+    --i;
+    QVERIFY(i == adapter.end());
+}
+
+void TestTimeSliceAdapter::benchmarkOldIteration()
+{
+    Composition composition;
+    fill(composition, benchmarkTracks, benchmarkBars);
+
+    size_t count = 0;
+
+    QBENCHMARK {
+        count = Old::merge(composition, 0, composition.getDuration()).size();
+    }
+
+    QVERIFY(count > 0);
+}
+
+void TestTimeSliceAdapter::benchmarkIteration()
+{
+    Composition composition;
+    fill(composition, benchmarkTracks, benchmarkBars);
+
+    size_t count = 0;
+
+    QBENCHMARK {
+        CompositionTimeSliceAdapter adapter(&composition);
+        count = iterate(adapter).size();
+    }
+
+    QVERIFY(count > 0);
+}
+
+void TestTimeSliceAdapter::benchmarkChords()
+{
+    Composition composition;
+    fill(composition, benchmarkTracks, benchmarkBars);
+
+    int chords = 0;
+
+    // What AnalysisHelper::labelChords() does.
+    QBENCHMARK {
+        chords = 0;
+        CompositionTimeSliceAdapter adapter(&composition);
+        for (CompositionTimeSliceAdapter::iterator i = adapter.begin();
+             i != adapter.end(); ++i) {
+            if (!(*i)->isa(Note::EventType)) continue;
+            GlobalChord chord(adapter, i,
+                              composition.getNotationQuantizer());
+            if (chord.size() == 0) continue;
+            ++chords;
+            i = chord.getFinalElement();
+        }
+    }
+
+    QVERIFY(chords > 0);
+}
+
+QTEST_MAIN(TestTimeSliceAdapter)
+
+#include "timesliceadapter.moc"
@@ -0,0 +1,421 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#include "base/BaseProperties.h"
+#include "base/Composition.h"
+#include "base/Event.h"
+#include "base/MidiTypes.h"
+#include "base/NotationTypes.h"
+#include "base/Segment.h"
+#include "base/TriggerSegment.h"
+
+#include <QTest>
+
+#include <cstdint>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Rosegarden;
+
+/// Unit test and benchmark for TriggerSegmentRec::ExpandInto()
+/**
+ * The expected expansions were taken from the event-by-event expansion
+ * the templates replaced, for triggers of every adjustment mode, with
+ * and without retuning, tied and masked, and nested.  Each score is
+ * checked against a digest of every expanded event, and a few of the
+ * expansions are spelled out.
+ */
+class TestTriggerExpansion : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testExpansion();
+    void testNested();
+    void testTriggerSegmentChange();
+    void benchmarkExpansion();
+};
+
+namespace
+{
+    // Pointers, as the strings may not have been made yet when this is.
+    const std::string *const adjustments[] = {
+        &BaseProperties::TRIGGER_SEGMENT_ADJUST_NONE,
+        &BaseProperties::TRIGGER_SEGMENT_ADJUST_SQUISH,
+        &BaseProperties::TRIGGER_SEGMENT_ADJUST_SYNC_START,
+        &BaseProperties::TRIGGER_SEGMENT_ADJUST_SYNC_END
+    };
+
+    Event *makeNote(timeT time, timeT duration, int pitch, int velocity)
+    {
+        Event *note = new Event(Note::EventType, time, duration);
+        note->set<Int>(BaseProperties::PITCH, pitch);
+        note->set<Int>(BaseProperties::VELOCITY, velocity);
+        return note;
+    }
+
+    /// A trill: alternating 32nds with a clef, key and controller too.
+    Segment *makeTrill(timeT duration)
+    {
+        Segment *segment = new Segment;
+        segment->insert(Clef(Clef::Treble).getAsEvent(0));
+        segment->insert(Key("G major").getAsEvent(0));
+        segment->insert(Controller::makeEvent(0, 1, 64));
+        for (timeT t = 0; t < duration; t += 120) {
+            segment->insert(makeNote(t, 120, t % 240 ? 62 : 60,
+                                     t % 480 ? 90 : 110));
+        }
+        return segment;
+    }
+
+    /// Variant picks the adjustment mode and whether to retune.
+    Event *makeTrigger(timeT time, timeT duration, int pitch, int velocity,
+                       TriggerSegmentId id, int variant)
+    {
+        Event *trigger = makeNote(time, duration, pitch, velocity);
+        trigger->set<Int>(BaseProperties::TRIGGER_SEGMENT_ID, id);
+        trigger->set<Bool>(BaseProperties::TRIGGER_SEGMENT_RETUNE,
+                           variant % 3 != 0);
+        trigger->set<String>(BaseProperties::TRIGGER_SEGMENT_ADJUST_TIMES,
+                             *adjustments[variant % 4]);
+        return trigger;
+    }
+
+    /// Trills on notes of all sorts of lengths, pitches and velocities.
+    Segment *makeScore(Composition &composition, TriggerSegmentId id,
+                       int triggers)
+    {
+        Segment *segment = new Segment;
+        composition.addSegment(segment);
+
+        for (int i = 0; i < triggers; ++i) {
+            const timeT time = i * 960;
+            const timeT duration = 240 * (1 + i % 4);
+            segment->insert(makeTrigger(time, duration, 48 + i % 37,
+                                        40 + i % 80, id, i));
+        }
+
+        return segment;
+    }
+
+    /// Everything that matters about an expanded event.
+    std::string describe(const Event &event)
+    {
+        std::ostringstream str;
+        str << event.getType().getName() << " " << event.getAbsoluteTime()
+            << " " << event.getDuration();
+
+        long value;
+        if (event.get<Int>(BaseProperties::PITCH, value))
+            str << " p" << value;
+        if (event.get<Int>(BaseProperties::VELOCITY, value))
+            str << " v" << value;
+        if (event.get<Int>(Controller::NUMBER, value)) {
+            long controllerValue = 0;
+            event.get<Int>(Controller::VALUE, controllerValue);
+            str << " c" << value << "=" << controllerValue;
+        }
+
+        return str.str();
+    }
+
+    /// FNV-1a, over each result in turn.
+    class Digest
+    {
+    public:
+        void add(int value)
+        {
+            for (int i = 0; i < 4; ++i)
+                addByte((unsigned(value) >> (i * 8)) & 0xff);
+        }
+
+        void add(const std::string &value)
+        {
+            for (char c : value)
+                addByte(static_cast<unsigned char>(c));
+            add(int(value.size()));
+        }
+
+        uint32_t get() const  { return m_hash; }
+
+    private:
+        void addByte(unsigned byte)
+        {
+            m_hash ^= byte;
+            m_hash *= 16777619u;
+        }
+
+        uint32_t m_hash{2166136261u};
+    };
+
+    typedef std::vector<std::string> EventList;
+
+    struct Expansions
+    {
+        /// Of whether each trigger inserted anything, and what.
+        uint32_t digest;
+        int eventCount;
+        /// Keyed by trigger time.
+        std::map<timeT, EventList> events;
+    };
+
+    /// Expand each trigger in the score on its own.
+    Expansions expandAll(const TriggerSegmentRec *rec, Segment *score)
+    {
+        Digest digest;
+        Expansions expansions;
+        expansions.eventCount = 0;
+
+        for (Segment::iterator i = score->begin(); i != score->end(); ++i) {
+            if (!(*i)->has(BaseProperties::TRIGGER_SEGMENT_ID)) continue;
+
+            Segment target;
+            const bool inserted = rec->ExpandInto(&target, i, score, nullptr);
+            digest.add(int(inserted));
+            digest.add(int(target.size()));
+            expansions.eventCount += int(target.size());
+
+            EventList &events = expansions.events[(*i)->getAbsoluteTime()];
+            for (const Event *event : target) {
+                events.push_back(describe(*event));
+                digest.add(events.back());
+            }
+        }
+
+        expansions.digest = digest.get();
+        return expansions;
+    }
+
+    const int benchmarkTriggers = 5000;
+}
+
+void TestTriggerExpansion::testExpansion()
+{
+    Composition composition;
+    TriggerSegmentRec *rec =
+        composition.addTriggerSegment(makeTrill(960), 60, 100);
+    QVERIFY(rec);
+
+    Segment *score = makeScore(composition, rec->getId(), 64);
+
+    // A tied note with its middle masked, so the trill sounds in two
+    // intervals.
+    Event *first = makeTrigger(100000, 240, 64, 100, rec->getId(), 2);
+    first->set<Bool>(BaseProperties::TIED_FORWARD, true);
+    Event *second = makeNote(100240, 240, 64, 100);
+    second->set<Bool>(BaseProperties::TIED_BACKWARD, true);
+    second->set<Bool>(BaseProperties::TIED_FORWARD, true);
+    second->set<Bool>(BaseProperties::TRIGGER_EXPAND, false);
+    Event *third = makeNote(100480, 480, 64, 100);
+    third->set<Bool>(BaseProperties::TIED_BACKWARD, true);
+    score->insert(first);
+    score->insert(second);
+    score->insert(third);
+
+    // Pitches and velocities that clip.
+    score->insert(makeTrigger(110000, 480, 127, 127, rec->getId(), 2));
+    score->insert(makeTrigger(111000, 480, 0, 0, rec->getId(), 2));
+
+    // Running into the end of the score.
+    score->insert(makeTrigger(120000, 960, 60, 100, rec->getId(), 0));
+    score->setEndMarkerTime(120500);
+
+    const Expansions expansions = expandAll(rec, score);
+    QCOMPARE(expansions.eventCount, 423);
+    QCOMPARE(expansions.digest, uint32_t(0x011f98c8));
+
+    // No adjustment: sounds to the end of the score.
+    QCOMPARE(expansions.events.at(0), EventList({
+        "controller 0 0 c1=64",
+        "note 0 120 p60 v50",
+        "note 120 120 p62 v30",
+        "note 240 120 p60 v30",
+        "note 360 120 p62 v30",
+        "note 480 120 p60 v50",
+        "note 600 120 p62 v30",
+        "note 720 120 p60 v30",
+        "note 840 120 p62 v30" }));
+
+    // Squished triggers have always come out empty: the time scale adds
+    // its offset before scaling, which puts every note before the
+    // trigger.
+    QCOMPARE(expansions.events.at(960), EventList());
+
+    // Sync start, retuned, cut off at the end of the trigger.
+    QCOMPARE(expansions.events.at(1920), EventList({
+        "controller 1920 0 c1=64",
+        "note 1920 120 p50 v52",
+        "note 2040 120 p52 v32",
+        "note 2160 120 p50 v32",
+        "note 2280 120 p52 v32",
+        "note 2400 120 p50 v52",
+        "note 2520 120 p52 v32" }));
+
+    // Sync end, not retuned.
+    QCOMPARE(expansions.events.at(2880), EventList({
+        "controller 2880 0 c1=64",
+        "note 2880 120 p60 v53",
+        "note 3000 120 p62 v33",
+        "note 3120 120 p60 v33",
+        "note 3240 120 p62 v33",
+        "note 3360 120 p60 v53",
+        "note 3480 120 p62 v33",
+        "note 3600 120 p60 v33",
+        "note 3720 120 p62 v33" }));
+
+    QCOMPARE(expansions.events.at(100000), EventList({
+        "controller 100000 0 c1=64",
+        "note 100000 120 p64 v110",
+        "note 100120 120 p66 v90",
+        "note 100480 120 p64 v110",
+        "note 100600 120 p66 v90",
+        "note 100720 120 p64 v90",
+        "note 100840 120 p66 v90" }));
+
+    QCOMPARE(expansions.events.at(110000), EventList({
+        "controller 110000 0 c1=64",
+        "note 110000 120 p127 v127",
+        "note 110120 120 p127 v117",
+        "note 110240 120 p127 v117",
+        "note 110360 120 p127 v117" }));
+
+    QCOMPARE(expansions.events.at(111000), EventList({
+        "controller 111000 0 c1=64",
+        "note 111000 120 p0 v10",
+        "note 111120 120 p2 v0",
+        "note 111240 120 p0 v0",
+        "note 111360 120 p2 v0" }));
+
+    QCOMPARE(expansions.events.at(120000), EventList({
+        "controller 120000 0 c1=64",
+        "note 120000 120 p60 v110",
+        "note 120120 120 p62 v90",
+        "note 120240 120 p60 v90",
+        "note 120360 120 p62 v90",
+        "note 120480 20 p60 v110" }));
+}
+
+void TestTriggerExpansion::testNested()
+{
+    // A mordent whose middle note is itself a trill.
+    Composition composition;
+    TriggerSegmentRec *trill =
+        composition.addTriggerSegment(makeTrill(480), 60, 100);
+
+    Segment *mordent = new Segment;
+    mordent->insert(makeNote(0, 120, 60, 100));
+    mordent->insert(makeTrigger(120, 240, 62, 100, trill->getId(), 2));
+    mordent->insert(makeNote(360, 120, 60, 100));
+    TriggerSegmentRec *rec = composition.addTriggerSegment(mordent, 60, 100);
+
+    QVERIFY(!rec->getExpansionTemplate());
+    QVERIFY(trill->getExpansionTemplate());
+
+    Segment *score = makeScore(composition, rec->getId(), 32);
+
+    const Expansions expansions = expandAll(rec, score);
+    QCOMPARE(expansions.eventCount, 206);
+    QCOMPARE(expansions.digest, uint32_t(0x13d34329));
+
+    QCOMPARE(expansions.events.at(0), EventList({
+        "note 0 120 p60 v40",
+        "controller 120 0 c1=64",
+        "note 120 120 p62 v50",
+        "note 240 120 p64 v30",
+        "note 360 120 p60 v40" }));
+}
+
+void TestTriggerExpansion::testTriggerSegmentChange()
+{
+    Composition composition;
+    TriggerSegmentRec *rec =
+        composition.addTriggerSegment(makeTrill(480), 60, 100);
+    Segment *score = makeScore(composition, rec->getId(), 8);
+
+    // Fill the cache.
+    Expansions expansions = expandAll(rec, score);
+    QCOMPARE(expansions.eventCount, 40);
+    QCOMPARE(expansions.digest, uint32_t(0x4537ea56));
+    QCOMPARE(expansions.events.at(0), EventList({
+        "controller 0 0 c1=64",
+        "note 0 120 p60 v50",
+        "note 120 120 p62 v30",
+        "note 240 120 p60 v30",
+        "note 360 120 p62 v30" }));
+
+    const TriggerSegmentRec::ExpansionTemplate *expansion =
+        rec->getExpansionTemplate();
+    QCOMPARE(rec->getExpansionTemplate(), expansion);
+
+    // A new note in the trigger segment must show up.
+    rec->getSegment()->insert(makeNote(60, 60, 72, 100));
+    expansions = expandAll(rec, score);
+    QCOMPARE(expansions.eventCount, 48);
+    QCOMPARE(expansions.digest, uint32_t(0xff04d2da));
+    QCOMPARE(expansions.events.at(0), EventList({
+        "controller 0 0 c1=64",
+        "note 0 120 p60 v50",
+        "note 60 60 p72 v40",
+        "note 120 120 p62 v30",
+        "note 240 120 p60 v30",
+        "note 360 120 p62 v30" }));
+
+    // As must changes to the end marker.
+    rec->getSegment()->setEndMarkerTime(240);
+    expansions = expandAll(rec, score);
+    QCOMPARE(expansions.eventCount, 24);
+    QCOMPARE(expansions.digest, uint32_t(0x9b7ee07e));
+    QCOMPARE(expansions.events.at(0), EventList({
+        "controller 0 0 c1=64",
+        "note 0 120 p60 v50",
+        "note 60 60 p72 v40",
+        "note 120 120 p62 v30" }));
+
+    // And the base pitch and velocity, which aren't in the template.
+    rec->setBasePitch(50);
+    rec->setBaseVelocity(20);
+    expansions = expandAll(rec, score);
+    QCOMPARE(expansions.eventCount, 24);
+    QCOMPARE(expansions.digest, uint32_t(0xa7eaa9ed));
+    QCOMPARE(expansions.events.at(0), EventList({
+        "controller 0 0 c1=64",
+        "note 0 120 p60 v127",
+        "note 60 60 p72 v120",
+        "note 120 120 p62 v110" }));
+}
+
+void TestTriggerExpansion::benchmarkExpansion()
+{
+    Composition composition;
+    TriggerSegmentRec *rec =
+        composition.addTriggerSegment(makeTrill(960), 60, 100);
+    Segment *score = makeScore(composition, rec->getId(), benchmarkTriggers);
+
+    Segment target;
+
+    QBENCHMARK {
+        target.clear();
+        for (Segment::iterator i = score->begin(); i != score->end(); ++i)
+            rec->ExpandInto(&target, i, score, nullptr);
+    }
+
+    QVERIFY(!target.empty());
+}
+
+QTEST_MAIN(TestTriggerExpansion)
+
+#include "triggerexpansion.moc"
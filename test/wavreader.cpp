@@ -0,0 +1,356 @@
+/* -*- c-basic-offset: 4 indent-tabs-mode: nil -*- vi:set ts=8 sts=4 sw=4: */
+
+/*
+    Rosegarden
+    A sequencer and musical notation editor.
+    Copyright 2000-2024 the Rosegarden development team.
+    See the AUTHORS file for more details.
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.  See the file
+    COPYING included with this distribution for more information.
+*/
+
+#include "sound/SampleConversion.h"
+#include "sound/MappedWavFile.h"
+#include "sound/audiostream/MappedWavFileReadStream.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace Rosegarden;
+
+/// Unit test and benchmark for MappedWavFile and the sample conversion
+class TestWavReader : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void testConversion();
+    void testStrided();
+    void testFormats();
+    void testChunks();
+    void testReadStream();
+    void testNotWav();
+    void benchmark();
+
+private:
+    QTemporaryDir m_dir;
+};
+
+namespace
+{
+    /// Sample at a time, the way RIFFAudioFile::convertBytesToSample()
+    /// does it.
+    float reference(const unsigned char *p, SampleFormat format)
+    {
+        switch (format) {
+        case SampleFormat::Unsigned8:
+            return float(int(p[0]) - 128) / 128.0f;
+        case SampleFormat::Signed16:
+            return float(short(p[0] | (p[1] << 8))) / 32768.0f;
+        case SampleFormat::Signed24: {
+            const int value = int((unsigned(p[2]) << 24) |
+                                  (unsigned(p[1]) << 16) |
+                                  (unsigned(p[0]) << 8));
+            return float(value) / 2147483648.0f;
+        }
+        case SampleFormat::Signed32: {
+            const int value = int((unsigned(p[3]) << 24) |
+                                  (unsigned(p[2]) << 16) |
+                                  (unsigned(p[1]) << 8) | p[0]);
+            return float(value) / 2147483648.0f;
+        }
+        case SampleFormat::Float32: {
+            float value;
+            memcpy(&value, p, 4);
+            return value;
+        }
+        case SampleFormat::Unknown:
+        default:
+            return 0;
+        }
+    }
+
+    const SampleFormat formats[] = {
+        SampleFormat::Unsigned8, SampleFormat::Signed16,
+        SampleFormat::Signed24, SampleFormat::Signed32,
+        SampleFormat::Float32
+    };
+
+    /// Bytes that are a valid sample in every format.
+    std::vector<unsigned char> makeSamples(SampleFormat format, size_t count)
+    {
+        const size_t size = getSampleSize(format);
+        std::vector<unsigned char> data(count * size);
+        unsigned int seed = 12345;
+        for (size_t i = 0; i < count; ++i) {
+            seed = seed * 1103515245 + 12345;
+            if (format == SampleFormat::Float32) {
+                const float value = float(int(seed >> 8) % 20001 - 10000) /
+                        10000.0f;
+                memcpy(&data[i * size], &value, size);
+            } else {
+                for (size_t b = 0; b < size; ++b)
+                    data[i * size + b] = (seed >> (b * 8)) & 0xff;
+            }
+        }
+        return data;
+    }
+
+    void putLE(std::string &s, unsigned int value, int bytes)
+    {
+        for (int i = 0; i < bytes; ++i)
+            s += char((value >> (i * 8)) & 0xff);
+    }
+
+    /// A WAV file with the given extra chunks in front of the data.
+    QString writeWav(const QString &path, unsigned int formatTag,
+                     unsigned int channels, unsigned int bits,
+                     const std::vector<unsigned char> &data,
+                     bool extensible = false,
+                     const std::string &extraChunks = std::string())
+    {
+        const unsigned int blockAlign = channels * bits / 8;
+
+        std::string fmt;
+        putLE(fmt, extensible ? 0xFFFE : formatTag, 2);
+        putLE(fmt, channels, 2);
+        putLE(fmt, 44100, 4);
+        putLE(fmt, 44100 * blockAlign, 4);
+        putLE(fmt, blockAlign, 2);
+        putLE(fmt, bits, 2);
+        if (extensible) {
+            putLE(fmt, 22, 2);
+            putLE(fmt, bits, 2);
+            putLE(fmt, 0, 4);
+            // KSDATAFORMAT_SUBTYPE_PCM or _IEEE_FLOAT
+            putLE(fmt, formatTag, 2);
+            fmt += std::string("\x00\x00\x00\x00\x10\x00\x80\x00"
+                               "\x00\xAA\x00\x38\x9B\x71", 14);
+        }
+
+        std::string body = "WAVE";
+        body += "fmt ";
+        putLE(body, fmt.size(), 4);
+        body += fmt;
+        body += extraChunks;
+        body += "data";
+        putLE(body, data.size(), 4);
+        body.append(reinterpret_cast<const char *>(data.data()), data.size());
+
+        std::string file = "RIFF";
+        putLE(file, body.size(), 4);
+        file += body;
+
+        QFile out(path);
+        out.open(QIODevice::WriteOnly);
+        out.write(file.data(), file.size());
+        return path;
+    }
+}
+
+void TestWavReader::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+}
+
+void TestWavReader::testConversion()
+{
+    // Odd count to exercise the tails after the vector loops.
+    const size_t count = 1001;
+
+    for (SampleFormat format : formats) {
+        const std::vector<unsigned char> data = makeSamples(format, count);
+        const size_t size = getSampleSize(format);
+
+        std::vector<float> converted(count);
+        convertToFloat(data.data(), format, size, converted.data(), count);
+
+        std::vector<float> added(count, 1.0f);
+        addToFloat(data.data(), format, size, added.data(), count);
+
+        for (size_t i = 0; i < count; ++i) {
+            const float expected = reference(&data[i * size], format);
+            QCOMPARE(converted[i], expected);
+            QCOMPARE(added[i], 1.0f + expected);
+        }
+    }
+}
+
+void TestWavReader::testStrided()
+{
+    // Every third sample, as for one channel of a three channel file.
+    const size_t count = 333;
+
+    for (SampleFormat format : formats) {
+        const std::vector<unsigned char> data =
+                makeSamples(format, count * 3);
+        const size_t size = getSampleSize(format);
+
+        std::vector<float> converted(count);
+        convertToFloat(&data[size], format, size * 3,
+                       converted.data(), count);
+
+        for (size_t i = 0; i < count; ++i)
+            QCOMPARE(converted[i],
+                     reference(&data[(i * 3 + 1) * size], format));
+    }
+}
+
+void TestWavReader::testFormats()
+{
+    const size_t frames = 500;
+
+    struct Case {
+        unsigned int tag;
+        unsigned int bits;
+        bool extensible;
+        SampleFormat format;
+    };
+    const Case cases[] = {
+        { 1, 8, false, SampleFormat::Unsigned8 },
+        { 1, 16, false, SampleFormat::Signed16 },
+        { 1, 24, true, SampleFormat::Signed24 },
+        { 1, 32, false, SampleFormat::Signed32 },
+        { 3, 32, false, SampleFormat::Float32 },
+        { 3, 32, true, SampleFormat::Float32 }
+    };
+
+    int n = 0;
+    for (const Case &c : cases) {
+        const std::vector<unsigned char> data =
+                makeSamples(c.format, frames * 2);
+        const QString path = writeWav(
+                m_dir.filePath(QString("format%1.wav").arg(n++)),
+                c.tag, 2, c.bits, data, c.extensible);
+
+        MappedWavFile file(path);
+        QVERIFY2(file.isOK(), qPrintable(file.getError()));
+        QCOMPARE(file.getChannels(), 2u);
+        QCOMPARE(file.getSampleRate(), 44100u);
+        QCOMPARE(file.getBitsPerSample(), c.bits);
+        QVERIFY(file.getSampleFormat() == c.format);
+        QCOMPARE(file.getFrameCount(), frames);
+
+        const size_t size = getSampleSize(c.format);
+
+        // Interleaved, starting part way in and running off the end.
+        std::vector<float> interleaved(200 * 2);
+        QCOMPARE(file.getInterleavedFrames(400, 200, interleaved.data()),
+                 size_t(100));
+        for (size_t i = 0; i < 100 * 2; ++i)
+            QCOMPARE(interleaved[i],
+                     reference(&data[(400 * 2 + i) * size], c.format));
+
+        // The right channel on its own.
+        std::vector<float> right(frames);
+        QCOMPARE(file.getChannelFrames(1, 0, frames, right.data()), frames);
+        for (size_t i = 0; i < frames; ++i)
+            QCOMPARE(right[i], reference(&data[(i * 2 + 1) * size],
+                                         c.format));
+    }
+}
+
+void TestWavReader::testChunks()
+{
+    // An odd-sized chunk between "fmt " and "data" must be skipped
+    // along with its pad byte.
+    std::string extra = "LIST";
+    putLE(extra, 5, 4);
+    extra += std::string("abcde\0", 6);
+
+    const std::vector<unsigned char> data =
+            makeSamples(SampleFormat::Signed16, 100);
+    const QString path = writeWav(m_dir.filePath("chunks.wav"),
+                                  1, 1, 16, data, false, extra);
+
+    MappedWavFile file(path);
+    QVERIFY2(file.isOK(), qPrintable(file.getError()));
+    QCOMPARE(file.getFrameCount(), size_t(100));
+    QVERIFY(memcmp(file.getData(), data.data(), data.size()) == 0);
+}
+
+void TestWavReader::testReadStream()
+{
+    const size_t frames = 10000;
+    const std::vector<unsigned char> data =
+            makeSamples(SampleFormat::Signed16, frames * 2);
+    const QString path = writeWav(m_dir.filePath("stream.wav"),
+                                  1, 2, 16, data);
+
+    MappedWavFileReadStream stream(path);
+    QVERIFY(stream.isOK());
+    QCOMPARE(stream.getChannelCount(), size_t(2));
+    QCOMPARE(stream.getSampleRate(), size_t(44100));
+
+    std::vector<float> block(1024 * 2);
+    size_t total = 0;
+    bool ok = true;
+    while (size_t got = stream.getInterleavedFrames(1024, block.data())) {
+        for (size_t i = 0; i < got * 2; ++i)
+            ok = ok && block[i] == reference(&data[(total * 2 + i) * 2],
+                                             SampleFormat::Signed16);
+        total += got;
+    }
+
+    QVERIFY(ok);
+    QCOMPARE(total, frames);
+}
+
+void TestWavReader::testNotWav()
+{
+    const QString path = m_dir.filePath("notwav.wav");
+    QFile out(path);
+    out.open(QIODevice::WriteOnly);
+    out.write("This is not a WAV file at all.");
+    out.close();
+
+    MappedWavFile file(path);
+    QVERIFY(!file.isOK());
+    QVERIFY(!file.getError().isEmpty());
+
+    MappedWavFile missing(m_dir.filePath("missing.wav"));
+    QVERIFY(!missing.isOK());
+
+    // A-law, which is left for libsndfile.
+    const QString alaw = writeWav(m_dir.filePath("alaw.wav"), 6, 1, 8,
+                                  std::vector<unsigned char>(100));
+    QVERIFY(!MappedWavFile(alaw).isOK());
+}
+
+void TestWavReader::benchmark()
+{
+    // Decoding throughput: a minute of 16-bit stereo at 44.1kHz.
+    const size_t frames = 44100 * 60;
+    const QString path = writeWav(
+            m_dir.filePath("benchmark.wav"), 1, 2, 16,
+            makeSamples(SampleFormat::Signed16, frames * 2));
+
+    MappedWavFile file(path);
+    QVERIFY(file.isOK());
+
+    std::vector<float> block(4096 * 2);
+    size_t total = 0;
+
+    QBENCHMARK {
+        total = 0;
+        while (size_t got = file.getInterleavedFrames(total, 4096,
+                                                      block.data()))
+            total += got;
+    }
+
+    QCOMPARE(total, frames);
+}
+
+QTEST_MAIN(TestWavReader)
+
+#include "wavreader.moc"